@@ -0,0 +1,108 @@
+#include "bench.h"
+
+#include "taco/index_notation/index_notation.h"
+
+using namespace std;
+
+namespace taco {
+namespace bench {
+
+/// Number of columns of the dense factor matrices in SpMM, SDDMM, MTTKRP and
+/// TTM.
+static const int rank = 32;
+
+static const vector<int> matrixSizes = {256, 1024};
+static const vector<int> tensorSizes = {32, 64};
+
+static Format dense(int order) {
+  return Format(vector<ModeFormatPack>(order, Dense));
+}
+
+vector<Kernel> matrixKernels() {
+  IndexVar i("i"), j("j"), k("k");
+  auto csrFormat = [](const Format&) { return CSR; };
+  return {
+    {"SpMV", 2,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n}, false}, {{n,n}, true}, {{n}, false}};
+      },
+      [](const Format&) { return dense(1); },
+      [=](vector<Tensor<double>>& t) {
+        t[0](i) = t[1](i,j) * t[2](j);
+      },
+      matrixSizes},
+    {"SpMM", 2,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,rank}, false}, {{n,n}, true}, {{n,rank}, false}};
+      },
+      [](const Format&) { return dense(2); },
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,k) * t[2](k,j);
+      },
+      matrixSizes},
+    {"SpGEMM", 2,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,n}, false}, {{n,n}, true}, {{n,n}, true}};
+      },
+      csrFormat,
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,k) * t[2](k,j);
+      },
+      matrixSizes},
+    {"SDDMM", 2,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,n}, false}, {{n,n}, true},
+                {{n,rank}, false}, {{rank,n}, false}};
+      },
+      csrFormat,
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,j) * t[2](i,k) * t[3](k,j);
+      },
+      matrixSizes},
+    {"SpAdd", 2,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,n}, false}, {{n,n}, true}, {{n,n}, true}};
+      },
+      csrFormat,
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,j) + t[2](i,j);
+      },
+      matrixSizes}
+  };
+}
+
+vector<Kernel> tensorKernels() {
+  IndexVar i("i"), j("j"), k("k"), l("l");
+  return {
+    {"MTTKRP", 3,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,rank}, false}, {{n,n,n}, true},
+                {{n,rank}, false}, {{n,rank}, false}};
+      },
+      [](const Format&) { return dense(2); },
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,k,l) * t[2](k,j) * t[3](l,j);
+      },
+      tensorSizes},
+    {"TTV", 3,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,n}, false}, {{n,n,n}, true}, {{n}, false}};
+      },
+      [](const Format&) { return Format({Dense,Sparse}); },
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j) = t[1](i,j,k) * t[2](k);
+      },
+      tensorSizes},
+    {"TTM", 3,
+      [](int n) -> vector<OperandSpec> {
+        return {{{n,n,rank}, false}, {{n,n,n}, true}, {{rank,n}, false}};
+      },
+      [](const Format&) { return Format({Dense,Sparse,Dense}); },
+      [=](vector<Tensor<double>>& t) {
+        t[0](i,j,k) = t[1](i,j,l) * t[2](k,l);
+      },
+      tensorSizes}
+  };
+}
+
+}}
@@ -0,0 +1,276 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "taco/error.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+
+namespace taco {
+namespace bench {
+
+static const map<util::FillMethod, string> fillNames = {
+  {util::FillMethod::Dense,       "Dense"},
+  {util::FillMethod::Uniform,     "Uniform"},
+  {util::FillMethod::Random,      "Random"},
+  {util::FillMethod::Sparse,      "Sparse"},
+  {util::FillMethod::SlicingH,    "SlicingH"},
+  {util::FillMethod::SlicingV,    "SlicingV"},
+  {util::FillMethod::FEM,         "FEM"},
+  {util::FillMethod::HyperSparse, "HyperSparse"},
+  {util::FillMethod::Blocked,     "Blocked"}
+};
+
+static const map<Phase, string> phaseNames = {
+  {Phase::Pack,     "pack"},
+  {Phase::Compile,  "compile"},
+  {Phase::Assemble, "assemble"},
+  {Phase::Compute,  "compute"}
+};
+
+/// The fill methods supported by `util::fillTensor` for tensors of an order.
+static vector<util::FillMethod> fillMethods(int order) {
+  switch (order) {
+    case 2:
+      return {util::FillMethod::Dense, util::FillMethod::Uniform,
+              util::FillMethod::Random, util::FillMethod::Sparse,
+              util::FillMethod::SlicingH, util::FillMethod::SlicingV,
+              util::FillMethod::FEM, util::FillMethod::HyperSparse,
+              util::FillMethod::Blocked};
+    case 3:
+      return {util::FillMethod::Dense, util::FillMethod::Uniform,
+              util::FillMethod::Random, util::FillMethod::Sparse,
+              util::FillMethod::HyperSparse};
+    default:
+      taco_ierror << "No fill methods for tensors of order " << order;
+      return {};
+  }
+}
+
+typedef vector<pair<vector<int>,double>> Components;
+
+static Components getComponents(const Tensor<double>& tensor) {
+  Components components;
+  for (auto& component : tensor) {
+    components.push_back({component.first.toVector(), component.second});
+  }
+  return components;
+}
+
+/// Tensors and inputs of one benchmark instance. The operands are packed; the
+/// result has its expression assigned but has not been compiled.
+struct Instance {
+  vector<Tensor<double>> tensors;
+  vector<Components>     components;
+  size_t                 nnz = 0;
+};
+
+static Instance makeInstance(const Kernel& kernel, const Format& format,
+                             util::FillMethod fill, int n) {
+  Instance instance;
+  vector<OperandSpec> shapes = kernel.shapes(n);
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    const OperandSpec& shape = shapes[i];
+    const string name = string(1, (char)('A' + i));
+    if (i == 0) {
+      instance.tensors.push_back(Tensor<double>(name, shape.dimensions,
+                                                kernel.resultFormat(format)));
+      instance.components.push_back({});
+      continue;
+    }
+
+    Format operandFormat = shape.sparse
+        ? format : Format(vector<ModeFormatPack>(shape.dimensions.size(), Dense));
+    Tensor<double> operand(name, shape.dimensions, operandFormat);
+    util::fillTensor(operand, shape.sparse ? fill : util::FillMethod::Dense);
+    instance.components.push_back(getComponents(operand));
+    if (shape.sparse) {
+      instance.nnz += instance.components.back().size();
+    }
+    instance.tensors.push_back(operand);
+  }
+  kernel.assign(instance.tensors);
+  return instance;
+}
+
+/// Disables the compute kernel cache while in scope so that every compile()
+/// lowers and runs the C compiler.
+class KernelCacheDisabler {
+public:
+  KernelCacheDisabler() {
+    const char* value = getenv("CACHE_KERNELS");
+    hadValue = (value != nullptr);
+    if (hadValue) {
+      oldValue = value;
+    }
+    setenv("CACHE_KERNELS", "0", 1);
+  }
+
+  ~KernelCacheDisabler() {
+    if (hadValue) {
+      setenv("CACHE_KERNELS", oldValue.c_str(), 1);
+    } else {
+      unsetenv("CACHE_KERNELS");
+    }
+  }
+
+private:
+  bool   hadValue;
+  string oldValue;
+};
+
+static void runPhase(benchmark::State& state, const Kernel& kernel,
+                     const Format& format, util::FillMethod fill, Phase phase) {
+  const int n = (int)state.range(0);
+  Instance instance = makeInstance(kernel, format, fill, n);
+  Tensor<double>& result = instance.tensors[0];
+
+  switch (phase) {
+    case Phase::Pack: {
+      // Time packing of the coordinates of every sparse operand.
+      vector<OperandSpec> shapes = kernel.shapes(n);
+      for (auto _ : state) {
+        state.PauseTiming();
+        vector<Tensor<double>> operands;
+        for (size_t i = 1; i < shapes.size(); ++i) {
+          if (!shapes[i].sparse) {
+            continue;
+          }
+          Tensor<double> operand(shapes[i].dimensions, format);
+          operand.reserve(instance.components[i].size());
+          for (auto& component : instance.components[i]) {
+            operand.insert(component.first, component.second);
+          }
+          operands.push_back(operand);
+        }
+        state.ResumeTiming();
+        for (auto& operand : operands) {
+          operand.pack();
+        }
+      }
+      break;
+    }
+    case Phase::Compile: {
+      KernelCacheDisabler disableCache;
+      for (auto _ : state) {
+        state.PauseTiming();
+        instance.tensors[0] = Tensor<double>(result.getName(),
+                                             result.getDimensions(),
+                                             result.getFormat());
+        kernel.assign(instance.tensors);
+        state.ResumeTiming();
+        instance.tensors[0].compile();
+      }
+      break;
+    }
+    case Phase::Assemble: {
+      result.compile();
+      for (auto _ : state) {
+        state.PauseTiming();
+        kernel.assign(instance.tensors);
+        state.ResumeTiming();
+        result.assemble();
+      }
+      break;
+    }
+    case Phase::Compute: {
+      result.compile();
+      for (auto _ : state) {
+        state.PauseTiming();
+        kernel.assign(instance.tensors);
+        result.assemble();
+        state.ResumeTiming();
+        result.compute();
+      }
+      break;
+    }
+  }
+
+  state.counters["nnz"] = (double)instance.nnz;
+}
+
+void registerKernel(const Kernel& kernel, const vector<NamedFormat>& formats) {
+  for (const NamedFormat& format : formats) {
+    for (util::FillMethod fill : fillMethods(kernel.sparseOrder)) {
+      for (auto& phase : phaseNames) {
+        const string name = kernel.name + "/" + format.name + "/" +
+                            fillNames.at(fill) + "/" + phase.second;
+        const Kernel k = kernel;
+        const Format f = format.format;
+        const Phase p = phase.first;
+        auto* bench = benchmark::RegisterBenchmark(name.c_str(),
+            [k, f, fill, p](benchmark::State& state) {
+              // Report kernels that fail to lower or compile for a format
+              // instead of aborting the whole run.
+              try {
+                runPhase(state, k, f, fill, p);
+              } catch (const TacoException& e) {
+                state.SkipWithError(e.what());
+              }
+            });
+        for (int size : kernel.sizes) {
+          bench->Arg(size);
+        }
+        bench->Unit(benchmark::kMillisecond)->UseRealTime();
+      }
+    }
+  }
+}
+
+}}
+
+using namespace taco;
+using namespace taco::bench;
+
+static bool hasFlag(const vector<char*>& args, const string& flag) {
+  for (char* arg : args) {
+    if (string(arg).compare(0, flag.size(), flag) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int main(int argc, char* argv[]) {
+  const vector<NamedFormat> matrixFormats = {
+    {"CSR",  CSR},
+    {"DCSR", DCSR},
+    {"COO",  COO(2)}
+  };
+  const vector<NamedFormat> tensorFormats = {
+    {"CSF",  Format({Sparse,Sparse,Sparse})},
+    {"COO",  COO(3)}
+  };
+  for (const Kernel& kernel : matrixKernels()) {
+    registerKernel(kernel, matrixFormats);
+  }
+  for (const Kernel& kernel : tensorKernels()) {
+    registerKernel(kernel, tensorFormats);
+  }
+
+  // Write results as JSON by default so that runs can be compared across
+  // commits (e.g. with Google Benchmark's tools/compare.py).
+  vector<char*> args(argv, argv + argc);
+  string outFlag = "--benchmark_out=taco-bench.json";
+  string outFormatFlag = "--benchmark_out_format=json";
+  if (!hasFlag(args, "--benchmark_out=")) {
+    args.push_back(&outFlag[0]);
+  }
+  if (!hasFlag(args, "--benchmark_out_format=")) {
+    args.push_back(&outFormatFlag[0]);
+  }
+  int numArgs = (int)args.size();
+  args.push_back(nullptr);
+
+  benchmark::Initialize(&numArgs, args.data());
+  if (benchmark::ReportUnrecognizedArguments(numArgs, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
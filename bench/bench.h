@@ -0,0 +1,66 @@
+#ifndef TACO_BENCH_H
+#define TACO_BENCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "taco/tensor.h"
+#include "taco/format.h"
+#include "taco/util/fill.h"
+
+namespace taco {
+namespace bench {
+
+/// The stages of the tensor lifecycle that are timed separately.
+enum class Phase {
+  Pack, Compile, Assemble, Compute
+};
+
+/// An operand of a benchmarked kernel. Sparse operands take the format and fill
+/// method under test; dense operands are always filled densely.
+struct OperandSpec {
+  std::vector<int> dimensions;
+  bool             sparse;
+};
+
+/// A benchmarked kernel. `tensors[0]` is the result, followed by the operands
+/// in the order of `operands`.
+struct Kernel {
+  std::string name;
+
+  /// Order of the sparse operand; selects the formats and fill methods.
+  int sparseOrder;
+
+  /// Dimensions of the result and operands for problem size `n`.
+  std::function<std::vector<OperandSpec>(int n)> shapes;
+
+  /// Format of the result given the format of the sparse operand(s).
+  std::function<Format(const Format&)> resultFormat;
+
+  /// Assign the kernel's index expression to `tensors[0]`.
+  std::function<void(std::vector<Tensor<double>>& tensors)> assign;
+
+  /// Problem sizes to benchmark.
+  std::vector<int> sizes;
+};
+
+/// A named sparse format under test.
+struct NamedFormat {
+  std::string name;
+  Format      format;
+};
+
+/// Kernels over sparse matrices (SpMV, SpMM, SpGEMM, SDDMM, sparse add).
+std::vector<Kernel> matrixKernels();
+
+/// Kernels over sparse order-3 tensors (MTTKRP, TTV, TTM).
+std::vector<Kernel> tensorKernels();
+
+/// Register a benchmark for every phase, format and fill method of `kernel`.
+void registerKernel(const Kernel& kernel, const std::vector<NamedFormat>& formats);
+
+}}
+#endif
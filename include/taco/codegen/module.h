@@ -1,13 +1,18 @@
 #ifndef TACO_MODULE_H
 #define TACO_MODULE_H
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <utility>
 
 #include "taco/target.h"
+#include "taco/instrumentation.h"
 #include "taco/ir/ir.h"
+#include "taco/ir/ir_interpreter.h"
 
 namespace taco {
 namespace ir {
@@ -16,13 +21,35 @@ class Module {
 public:
   /// Create a module for some target
   Module(Target target=getTargetFromEnvironment())
-    : lib_handle(nullptr), moduleFromUserSource(false), target(target) {
+    : lib_handle(nullptr), moduleFromUserSource(false), target(target),
+      compiled(false) {
     setJITLibname();
     setJITTmpdir();
   }
 
+  ~Module();
+
   /// Compile the source into a library, returning its full path
   std::string compile();
+
+  /// Generate the source and compile it into a library on a background
+  /// thread. Until the library has been loaded, the functions called with
+  /// `callFuncPacked` are interpreted (see `Interpreter`) if they can be, while
+  /// all other uses of the library wait for it to be loaded.
+  void compileInBackground();
+
+  /// Prepare to interpret the functions instead of compiling them, which saves
+  /// running the C compiler for kernels that do little work. Returns false,
+  /// and prepares nothing, if some function cannot be interpreted. The library
+  /// is compiled if it is needed later, e.g. by `getFuncPtr`.
+  bool interpret();
+
+  /// True once the library has been loaded.
+  bool isCompiled() const;
+
+  /// Wait until the library has been loaded. Rethrows the error of a failed
+  /// background compilation.
+  void waitForCompile() const;
   
   /// Compile the module into a source file located at the specified location
   /// path and prefix.  The generated source will be path/prefix.{.c|.bc, .h}
@@ -46,6 +73,13 @@ public:
 
   /// Call a raw function in this module and return the result
   int callFuncPackedRaw(std::string name, void** args);
+
+  /// Call a raw function in this module and return the result. If the module
+  /// was generated with kernel profiling enabled, then `profile` is set to the
+  /// profiling counters of this call; otherwise it is cleared. The counters of
+  /// a profiled function live in one buffer of the library, so concurrent
+  /// calls of it are serialized.
+  int callFuncPackedRaw(std::string name, void** args, KernelProfile* profile);
   
   /// Call a raw function in this module and return the result
   int callFuncPackedRaw(std::string name, std::vector<void*> args) {
@@ -61,6 +95,12 @@ public:
   int callFuncPacked(std::string name, std::vector<void*> args) {
     return callFuncPacked(name, args.data());
   }
+
+  /// Call a function using the taco_tensor_t interface, return the result and
+  /// set `profile` to the profiling counters of the call.
+  int callFuncPacked(std::string name, void** args, KernelProfile* profile) {
+    return callFuncPackedRaw("_shim_"+name, args, profile);
+  }
   
   /// Set the source of the module
   void setSource(std::string source);
@@ -78,8 +118,28 @@ private:
 
   Target target;
   
+  /// Interpreters of the functions with shims, by shim name, that are used
+  /// while the library is compiled in the background.
+  std::map<std::string, Interpreter> interpreters;
+  std::shared_future<void> pendingCompile;
+  std::atomic<bool> compiled;
+  std::mutex compileMutex;
+  /// Serializes the calls of functions generated with profiling counters.
+  std::mutex profileMutex;
+
   void setJITLibname();
   void setJITTmpdir();
+
+  /// Write the source and shims of the module, returning the command that
+  /// compiles them into the library at `fullpath`.
+  std::string generateSource(const std::string& fullpath);
+
+  /// Load the library and point its runtime globals at taco's.
+  void load(const std::string& fullpath);
+
+  /// Add the allocation statistics gathered by instrumented kernels to the
+  /// instrumentation counters and reset them.
+  void collectAllocStats();
 };
 
 } // namespace ir
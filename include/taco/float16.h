@@ -0,0 +1,48 @@
+#ifndef TACO_FLOAT16_H
+#define TACO_FLOAT16_H
+
+#include <cstdint>
+
+namespace taco {
+
+/// An IEEE 754 half precision float.  Values are stored as their 16 bits and
+/// converted to single precision (rounding to nearest even on the way back)
+/// for arithmetic, like the kernels do.
+class float16 {
+public:
+  float16() = default;
+  float16(float value);
+
+  operator float() const;
+
+  /// Returns the bits of the value.
+  uint16_t getBits() const;
+
+  /// Returns the half precision float with the given bits.
+  static float16 fromBits(uint16_t bits);
+
+private:
+  uint16_t bits;
+};
+
+/// A brain float: a single precision float truncated to its upper 16 bits,
+/// which keeps the 8-bit exponent but only 7 bits of mantissa.
+class bfloat16 {
+public:
+  bfloat16() = default;
+  bfloat16(float value);
+
+  operator float() const;
+
+  /// Returns the bits of the value.
+  uint16_t getBits() const;
+
+  /// Returns the brain float with the given bits.
+  static bfloat16 fromBits(uint16_t bits);
+
+private:
+  uint16_t bits;
+};
+
+}
+#endif
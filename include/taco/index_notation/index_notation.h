@@ -118,6 +118,8 @@ public:
   /// ```
   /// A(i,j) = 1.0;
   /// ```
+  IndexExpr(float16);
+  IndexExpr(bfloat16);
   IndexExpr(float);
   IndexExpr(double);
 
@@ -270,6 +272,8 @@ public:
   Literal(long);
   Literal(long long);
   Literal(int8_t);
+  Literal(float16);
+  Literal(bfloat16);
   Literal(float);
   Literal(double);
   Literal(std::complex<float>);
@@ -501,10 +505,15 @@ public:
   /// variables sizes therefore equals the size of the original index
   /// variable.  Note that in the generated code, when the size of the
   /// inner index variable does not perfectly divide the original index
-  /// variable, a \textit{tail strategy} is employed such as emitting a variable
-  /// sized loop that handles remaining iterations.
-  /// Preconditions: splitFactor is a positive nonzero integer
-  IndexStmt split(IndexVar i, IndexVar i1, IndexVar i2, size_t splitFactor) const; // TODO: TailStrategy
+  /// variable, a \textit{tail strategy} handles the remaining iterations:
+  /// Guard checks every iteration, Peel runs the last strip in a separate
+  /// guarded loop so the other strips run without checks, and RoundUp emits
+  /// no checks at all.
+  /// Preconditions: splitFactor is a positive nonzero integer.  With RoundUp,
+  /// splitFactor must divide the size of the original index variable, which
+  /// must not be a position variable.
+  IndexStmt split(IndexVar i, IndexVar i1, IndexVar i2, size_t splitFactor,
+                  TailStrategy tailStrategy=TailStrategy::Guard) const;
 
   /// The divide transformation splits one index variable into
   /// two nested index variables, where the size of the outer
@@ -537,6 +546,31 @@ public:
   /// reorder takes a new ordering for a set of index variables that are directly nested in the iteration order
   IndexStmt reorder(std::vector<IndexVar> reorderedvars) const;
 
+  /// The tile transformation blocks a set of directly nested index
+  /// variables in one step.  Each variable is split by its tile size, and
+  /// the loops over the tiles are moved outside the loops within them, so
+  /// that tiling `i` and `j` by 16 iterates over `i0, j0, i1, j1`, where
+  /// `i0` and `j0` are named after `i` and `j`.  The tail strategy is used for
+  /// each split.
+  ///
+  /// Preconditions:
+  /// The variables must be directly nested, as for reorder, and there must be
+  /// a positive tile size for each variable.
+  IndexStmt tile(std::vector<IndexVar> vars, std::vector<size_t> sizes,
+                 TailStrategy tailStrategy=TailStrategy::Guard) const;
+
+  /// Tiles a set of directly nested index variables at several levels, e.g.
+  /// for caches of different sizes.  sizes[v] lists the tile sizes of vars[v]
+  /// from the outermost level in, and each size must be a multiple of the
+  /// next.  tileVars[v] are the variables that iterate over each level of
+  /// tiles of vars[v], from the outermost level in, followed by the variable
+  /// within the innermost tiles.  The loops are nested level by level, so
+  /// tiling `i` and `j` by {64, 8} iterates over `i0, j0, i1, j1, i2, j2`.
+  IndexStmt tile(std::vector<IndexVar> vars,
+                 std::vector<std::vector<IndexVar>> tileVars,
+                 std::vector<std::vector<size_t>> sizes,
+                 TailStrategy tailStrategy=TailStrategy::Guard) const;
+
   /// The parallelize
   /// transformation tags an index variable for parallel execution.  The
   /// transformation takes as an argument the type of parallel hardware
@@ -637,7 +671,10 @@ public:
 
   /// The unroll
   /// primitive unrolls the corresponding loop by a statically-known
-  /// integer number of iterations
+  /// integer number of iterations.  If the loop body runs an inner loop, the
+  /// inner loops of the unrolled iterations are jammed into one, so that e.g.
+  /// unrolling the loop over a block of columns keeps an accumulator for each
+  /// column in a register.  Loops in GPU kernels are unrolled by the compiler.
   /// Preconditions: unrollFactor is a positive nonzero integer
   IndexStmt unroll(IndexVar i, size_t unrollFactor) const;
 };
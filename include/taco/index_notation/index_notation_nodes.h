@@ -180,7 +180,8 @@ struct ReductionNode : public IndexExprNode {
   }
 
   IndexExpr op;  // The binary reduction operator, which is a `BinaryExprNode`
-                 // with undefined operands)
+                 // with undefined operands or a semiring `CallIntrinsicNode`
+                 // without arguments
   IndexVar var;
   IndexExpr a;
 };
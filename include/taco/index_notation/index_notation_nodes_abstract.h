@@ -7,6 +7,7 @@
 #include "taco/type.h"
 #include "taco/util/uncopyable.h"
 #include "taco/util/intrusive_ptr.h"
+#include "taco/util/node_pool.h"
 
 namespace taco {
 
@@ -19,6 +20,7 @@ class Precompute;
 
 /// A node of a scalar index expression tree.
 struct IndexExprNode : public util::Manageable<IndexExprNode>,
+                       public util::PoolAllocated,
                        private util::Uncopyable {
 public:
   IndexExprNode();
@@ -50,6 +52,7 @@ private:
 
 /// A node in a tensor index expression tree
 struct IndexStmtNode : public util::Manageable<IndexStmtNode>,
+                       public util::PoolAllocated,
                        private util::Uncopyable {
 public:
   IndexStmtNode();
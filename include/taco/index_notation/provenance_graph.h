@@ -30,6 +30,7 @@ bool operator==(const IndexVarRel&, const IndexVarRel&);
 /// Index variable relations are used to track how new index variables are derived
 /// in the scheduling language
 struct IndexVarRelNode : public util::Manageable<IndexVarRelNode>,
+                         public util::PoolAllocated,
                          private util::Uncopyable {
   IndexVarRelNode() : relType(UNDEFINED) {}
   IndexVarRelNode(IndexVarRelType type) : relType(type) {}
@@ -76,12 +77,14 @@ struct IndexVarRelNode : public util::Manageable<IndexVarRelNode>,
 /// The split relation takes a parentVar's iteration space and stripmines into an outervar that iterates over splitFactor-sized
 /// iterations over innerVar
 struct SplitRelNode : public IndexVarRelNode {
-  SplitRelNode(IndexVar parentVar, IndexVar outerVar, IndexVar innerVar, size_t splitFactor);
+  SplitRelNode(IndexVar parentVar, IndexVar outerVar, IndexVar innerVar, size_t splitFactor,
+               TailStrategy tailStrategy=TailStrategy::Guard);
 
   const IndexVar& getParentVar() const;
   const IndexVar& getOuterVar() const;
   const IndexVar& getInnerVar() const;
   const size_t& getSplitFactor() const;
+  TailStrategy getTailStrategy() const;
 
   void print(std::ostream& stream) const;
   bool equals(const SplitRelNode &rel) const;
@@ -332,6 +335,13 @@ public:
   /// does the index variable have an exact bound known at compile-time
   bool hasExactBound(IndexVar indexVar) const;
 
+  /// how the iterations past the end of an index variable are handled if it is
+  /// split (Guard if it is not)
+  TailStrategy getTailStrategy(IndexVar indexVar) const;
+
+  /// the factor an index variable is split by (0 if it is not split)
+  size_t getSplitFactor(IndexVar indexVar) const;
+
   /// Once indexVar is defined what new variables become recoverable
   /// returned in order of recovery (ie if parent being recovered allows its parent to also be recovered then parent comes first)
   std::vector<IndexVar> newlyRecoverableParents(IndexVar indexVar, std::set<IndexVar> previouslyDefined) const;
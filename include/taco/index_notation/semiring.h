@@ -0,0 +1,121 @@
+#ifndef TACO_SEMIRING_H
+#define TACO_SEMIRING_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "taco/type.h"
+#include "taco/ir/ir.h"
+#include "taco/index_notation/intrinsic.h"
+
+namespace taco {
+
+class IndexExpr;
+class IndexVar;
+class Reduction;
+
+/// A semiring (⊕, ⊗) that index expressions can be computed over instead of
+/// (+, *), such as the (min, +) semiring of shortest paths.  The values that
+/// sparse tensors do not store are the zero of the semiring, which is the
+/// identity of ⊕ and annihilates ⊗, so products only iterate over the
+/// coordinates that all their operands store and reductions start from it.
+///
+///   Semiring s = minPlus();
+///   y(j) = s.reduce(i, s.multiply(x(i), A(i,j)));
+class Semiring {
+public:
+  /// The operators that semirings are built from.
+  enum Operator {Plus, Times, Min, Max, Or, And};
+
+  /// Create the (+, *) semiring.
+  Semiring();
+
+  /// Create the (add, multiply) semiring.
+  Semiring(Operator add, Operator multiply);
+
+  /// Returns the ⊕ operator.
+  Operator getAdd() const;
+
+  /// Returns the ⊗ operator.
+  Operator getMultiply() const;
+
+  /// Returns the ⊕ operator as a reduction operator of reductions and compound
+  /// assignments, e.g. `Assignment(y(j), expr, s.getAddOperator())`.
+  IndexExpr getAddOperator() const;
+
+  /// Returns `a ⊗ b`.
+  IndexExpr multiply(IndexExpr a, IndexExpr b) const;
+
+  /// Returns the ⊕ reduction of `expr` over `i`.
+  Reduction reduce(IndexVar i, IndexExpr expr) const;
+
+  /// Returns the zero of the semiring, which is the identity of ⊕ and the
+  /// annihilator of ⊗.
+  ir::Expr getZero(Datatype type) const;
+
+  /// Returns the one of the semiring, which is the identity of ⊗.
+  ir::Expr getOne(Datatype type) const;
+
+  /// Returns the identity of an operator (e.g. infinity for min).
+  static ir::Expr getIdentity(Operator op, Datatype type);
+
+  /// Returns the name of an operator (e.g. "min").
+  static std::string getName(Operator op);
+
+private:
+  Operator addOp;
+  Operator multiplyOp;
+};
+
+bool operator==(const Semiring&, const Semiring&);
+bool operator!=(const Semiring&, const Semiring&);
+std::ostream& operator<<(std::ostream&, const Semiring&);
+
+/// The (+, *) semiring of linear algebra.
+Semiring plusTimes();
+
+/// The (min, +) semiring of shortest paths.
+Semiring minPlus();
+
+/// The (max, +) semiring of longest paths.
+Semiring maxPlus();
+
+/// The (max, min) semiring of widest paths.
+Semiring maxMin();
+
+/// The (or, and) semiring of reachability over booleans.
+Semiring orAnd();
+
+/// A semiring operator.  Called with two arguments it is the ⊗ of a semiring,
+/// which is zero if either argument is.  Without arguments it is the ⊕ of a
+/// semiring, as the operator of reductions and compound assignments.
+class SemiringIntrinsic : public Intrinsic {
+public:
+  SemiringIntrinsic(Semiring::Operator op);
+
+  Semiring::Operator getOperator() const;
+
+  std::string getName() const;
+  Datatype inferReturnType(const std::vector<Datatype>&) const;
+  ir::Expr lower(const std::vector<ir::Expr>&) const;
+  std::vector<std::vector<size_t>>
+  zeroPreservingArgs(const std::vector<IndexExpr>&) const;
+
+private:
+  Semiring::Operator op;
+};
+
+/// Returns the value that results reduced into with the reduction operator
+/// `op` start from, which is zero for sums (and undefined operators).
+ir::Expr getReductionIdentity(IndexExpr op, Datatype type);
+
+/// Emits IR that reduces `b` into `a` with the reduction operator `op`.
+ir::Expr lowerReduction(IndexExpr op, ir::Expr a, ir::Expr b);
+
+/// True if `op` is the reduction operator of a sum.
+bool isSumReduction(IndexExpr op);
+
+}
+#endif
@@ -203,8 +203,18 @@ IndexStmt reorderLoopsTopologically(IndexStmt stmt);
 IndexStmt scalarPromote(IndexStmt stmt);
 
 /**
- * Insert where statements with temporaries into the following statements kinds:
- * 1. The result is a is scattered into but does not support random insert.
+ * Insert where statements with dense vector workspaces, sized by the result
+ * dimension they stand in for, into the following statement kinds:
+ * 1. A result mode that does not support random insert is scattered into,
+ *    because the loop of its index variable is nested in a reduction loop
+ *    (e.g. SpGEMM, masked SpGEMM and sparse tensor contractions).
+ * 2. A reduction into a scalar temporary is nested in the loop of a free
+ *    variable that an operand stores below the reduction variable, so that the
+ *    free variable cannot be iterated outside (e.g. `A = B*C + D`).  The
+ *    reduction is gathered into a workspace with the free loop innermost, and
+ *    terms added to it are accumulated into the workspace too.
+ * Only one result mode is replaced by a workspace, so statements that scatter
+ * into several modes are left unchanged.
  */
 IndexStmt insertTemporaries(IndexStmt stmt);
 }
@@ -0,0 +1,126 @@
+#ifndef TACO_INSTRUMENTATION_H
+#define TACO_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace taco {
+
+/// Instrumentation of the tensor lifecycle. When enabled, taco times each
+/// phase (pack, compile, lower, C compilation, assemble, compute, ...) and
+/// maintains counters such as kernel cache hits and misses and the bytes
+/// allocated by generated code for `pos`, `crd` and `vals` arrays. Collection
+/// is disabled by default and costs a single flag check per phase when off.
+///
+/// Allocation counters are gathered by code that the code generator emits
+/// only while instrumentation is enabled, so they cover kernels generated
+/// after instrumentation was turned on.
+
+/// Aggregated timing statistics of one instrumented phase.
+struct PhaseStatistics {
+  size_t count = 0;
+  double totalTime = 0.0;  ///< milliseconds
+  double minTime = 0.0;    ///< milliseconds
+  double maxTime = 0.0;    ///< milliseconds
+};
+
+/// A single timed occurrence of a phase.
+struct PhaseEvent {
+  std::string phase;
+  std::string detail;    ///< e.g. the tensor or kernel the phase ran for
+  double      start;     ///< microseconds since instrumentation was reset
+  double      duration;  ///< microseconds
+  uint64_t    thread;
+};
+
+/// Enable or disable collection of instrumentation data.
+void setInstrumentationEnabled(bool enabled);
+
+/// True if instrumentation data is being collected.
+bool isInstrumentationEnabled();
+
+/// Clear all collected phase timings, events and counters.
+void resetInstrumentation();
+
+/// Add `amount` to the named counter (if instrumentation is enabled).
+void addToCounter(const std::string& name, int64_t amount = 1);
+
+/// Get the value of the named counter, or zero if it has not been incremented.
+int64_t getCounter(const std::string& name);
+
+/// Get all counters.
+std::map<std::string,int64_t> getCounters();
+
+/// Get aggregated timing statistics for every phase that has been recorded.
+std::map<std::string,PhaseStatistics> getPhaseStatistics();
+
+/// Get the recorded phase events in the order they finished. At most
+/// `maxPhaseEvents` events are kept; later events only update the statistics.
+std::vector<PhaseEvent> getPhaseEvents();
+const size_t maxPhaseEvents = 1 << 20;
+
+/// Write the recorded phase events and counters in the Chrome trace event
+/// format (load with chrome://tracing or Perfetto).
+void writeChromeTrace(std::ostream& os);
+
+/// Get the recorded phase events and counters as a Chrome trace JSON string.
+std::string getChromeTrace();
+
+/// Times the enclosing scope as one occurrence of a phase.
+class ScopedPhaseTimer {
+public:
+  ScopedPhaseTimer(const char* phase);
+  ScopedPhaseTimer(const char* phase, const std::string& detail);
+  ~ScopedPhaseTimer();
+
+  ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+  void operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+  const char* phase;
+  std::string detail;
+  bool        enabled;
+  std::chrono::steady_clock::time_point begin;
+};
+
+/// Enable or disable profiling of generated kernels. While enabled, the code
+/// generator instruments kernels with counters of loop iterations, merge
+/// lattice case hits, binary searches, reallocations and per-thread work in
+/// parallel loops, which `ir::Module::callFuncPackedRaw` can return to the
+/// caller. Only kernels generated while profiling is enabled are instrumented;
+/// other kernels have no profiling overhead.
+void setKernelProfilingEnabled(bool enabled);
+
+/// True if the code generator instruments kernels with profiling counters.
+bool isKernelProfilingEnabled();
+
+/// A profiling counter of a generated kernel, e.g. the number of iterations
+/// of a loop (`for i`) or how often a merge lattice case was taken.
+struct KernelProfileCounter {
+  std::string name;
+  int64_t     count;
+};
+typedef std::vector<KernelProfileCounter> KernelProfile;
+
+/// Names of the counters maintained by taco.
+namespace counters {
+const std::string kernelCacheHits     = "kernel_cache.hits";
+const std::string kernelCacheMisses   = "kernel_cache.misses";
+const std::string helperCacheHits     = "helper_cache.hits";
+const std::string helperCacheMisses   = "helper_cache.misses";
+const std::string posBytes            = "alloc.pos_bytes";
+const std::string crdBytes            = "alloc.crd_bytes";
+const std::string valsBytes           = "alloc.vals_bytes";
+const std::string otherBytes          = "alloc.other_bytes";
+const std::string reallocs            = "alloc.reallocs";
+const std::string frozenIndexReuses   = "frozen_index.reuses";
+const std::string frozenIndexRebuilds = "frozen_index.rebuilds";
+const std::string fusedAssignments    = "fusion.fused_assignments";
+}
+
+}
+#endif
@@ -9,6 +9,7 @@
 #include "taco/error.h"
 #include "taco/util/intrusive_ptr.h"
 #include "taco/util/uncopyable.h"
+#include "taco/util/node_pool.h"
 #include "taco/storage/typed_value.h"
 #include <cstring>
 #include "taco/ir_tags.h"
@@ -82,7 +83,7 @@ enum class TensorProperty {
 };
 
 /** Base class for backend IR */
-struct IRNode : private util::Uncopyable {
+struct IRNode : private util::Uncopyable, public util::PoolAllocated {
   IRNode() {}
   virtual ~IRNode() {}
   virtual void accept(IRVisitorStrict *v) const = 0;
@@ -92,12 +93,17 @@ struct IRNode : private util::Uncopyable {
    */
   virtual IRNodeType type_info() const = 0;
 
+  /// Reference count, or Immortal for nodes that are never freed and may be
+  /// shared across threads without touching the count.
   mutable long ref = 0;
+  static const long Immortal = -1;
   friend void acquire(const IRNode* node) {
-    ++(node->ref);
+    if (node->ref != Immortal) {
+      ++(node->ref);
+    }
   }
   friend void release(const IRNode* node) {
-    if (--(node->ref) == 0) {
+    if (node->ref != Immortal && --(node->ref) == 0) {
       delete node;
     }
   }
@@ -205,14 +211,9 @@ std::ostream &operator<<(std::ostream &os, const Expr &);
 struct Literal : public ExprNode<Literal> {
   TypedComponentPtr value;
 
-  static Expr make(TypedComponentVal val, Datatype type) {
-    taco_iassert(isScalar(type));
-    Literal *lit = new Literal;
-    lit->type = type;
-    lit->value = TypedComponentPtr(type, malloc(type.getNumBytes()));
-    *(lit->value) = val;
-    return lit;
-  }
+  /// Small integer and boolean literals are interned, so making one again
+  /// returns the same node.
+  static Expr make(TypedComponentVal val, Datatype type);
 
   template <typename T>
   static Expr make(T val, Datatype type) {
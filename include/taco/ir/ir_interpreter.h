@@ -0,0 +1,47 @@
+#ifndef TACO_IR_INTERPRETER_H
+#define TACO_IR_INTERPRETER_H
+
+#include <memory>
+#include <string>
+
+#include "taco/ir/ir.h"
+
+namespace taco {
+namespace ir {
+
+/// Runs lowered functions (`Function` statements) directly against the
+/// `taco_tensor_t` storage of their arguments, without generating and
+/// compiling C code. The function is translated once into a tree of
+/// pre-resolved operations (variables are bound to frame slots and types are
+/// resolved ahead of time), which can then be called any number of times,
+/// also concurrently from several threads.
+///
+/// The interpreter behaves like the generated C code, except that parallel
+/// loops run serially. Functions with nodes it does not support (complex
+/// components, coroutines, and calls of unknown functions) can be detected
+/// with `isSupported` and must be compiled instead.
+class Interpreter {
+public:
+  Interpreter();
+
+  /// Prepare to interpret a lowered function.
+  explicit Interpreter(Stmt func);
+
+  /// True if the function can be interpreted.
+  bool isSupported() const;
+
+  /// Describes why the function cannot be interpreted.
+  std::string getUnsupportedReason() const;
+
+  /// Call the function with its arguments packed as for its shim: pointers to
+  /// the `taco_tensor_t` of each output and then of each input. Returns the
+  /// value the generated code would return.
+  int call(void** args) const;
+
+private:
+  struct Content;
+  std::shared_ptr<const Content> content;
+};
+
+}}
+#endif
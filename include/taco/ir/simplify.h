@@ -12,5 +12,25 @@ ir::Expr simplify(const ir::Expr& expr);
 /// Simplifies a statement (e.g. by applying constant copy propagation).
 ir::Stmt simplify(const ir::Stmt& stmt);
 
+/// Hoists loop invariant index arithmetic out of loops, and loop invariant
+/// loads out of loop bounds and conditions, into variables declared before the
+/// loops (e.g. `int32_t iB2 = i * B2_dimension;` before a loop over `j`).
+ir::Stmt hoistLoopInvariants(const ir::Stmt& stmt);
+
+/// Replaces products of the variables of serial loops and loop invariant
+/// strides by variables that are incremented by the stride each iteration.
+ir::Stmt reduceStrength(const ir::Stmt& stmt);
+
+/// Replaces integer expressions by the variables that were declared to hold
+/// their value, if the operands of the expressions have not changed since.
+ir::Stmt eliminateCommonSubexpressions(const ir::Stmt& stmt);
+
+/// Unrolls the serial loops that are tagged with an unroll factor, followed by
+/// a remainder loop if the factor may not divide their trip count.  If each
+/// iteration runs one inner loop, the inner loops of the unrolled iterations
+/// are jammed into one, whose reductions into the same location accumulate in
+/// a scalar (unroll-and-jam).  Loops that cannot be unrolled keep their tag.
+ir::Stmt unrollLoops(const ir::Stmt& stmt);
+
 }}
 #endif
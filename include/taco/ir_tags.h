@@ -27,6 +27,19 @@ enum class BoundType {
   MinExact, MinConstraint, MaxExact, MaxConstraint
 };
 extern const char *BoundType_NAMES[];
+
+/// TailStrategy::Guard skips the iterations past the end of the split variable
+/// with a check in every iteration
+/// TailStrategy::Peel checks once per strip and runs the strips that reach past
+/// the end in a separate, guarded copy of the loop
+/// TailStrategy::RoundUp emits no checks, so the extent of the split variable
+/// must be a multiple of the split factor (e.g. by padding the tensors). This
+/// is checked when splitting and compiling, and position variables, whose
+/// extents are only known at runtime, cannot be rounded up.
+enum class TailStrategy {
+  Guard, Peel, RoundUp
+};
+extern const char *TailStrategy_NAMES[];
 }
 
 #endif //TACO_IR_TAGS_H
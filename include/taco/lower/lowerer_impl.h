@@ -8,6 +8,7 @@
 #include <taco/index_notation/index_notation.h>
 
 #include "taco/lower/iterator.h"
+#include "taco/lower/merge_lattice.h"
 #include "taco/util/scopedset.h"
 #include "taco/util/uncopyable.h"
 #include "taco/ir_tags.h"
@@ -47,6 +48,38 @@ class Stmt;
 class Expr;
 }
 
+/// The analyses of a statement that do not depend on whether assembly or
+/// compute code is generated from it.  Lowerers that share an analysis reuse
+/// the IR variables, iterators, provenance graph and merge lattices computed
+/// by the first of them to lower the statement, so that the assemble and
+/// compute functions of a kernel are lowered from one analysis.  Lowerers that
+/// share an analysis must have the same settings.
+struct LoweringAnalysis {
+  /// The statement that was analysed, and whether its tensors are packed
+  /// and unpacked.
+  IndexStmt stmt;
+  bool pack = false;
+  bool unpack = false;
+
+  /// IR variables of the results, arguments and temporaries.
+  std::vector<ir::Expr> resultsIR;
+  std::vector<ir::Expr> argumentsIR;
+  std::map<TensorVar, ir::Expr> tensorVars;
+
+  Iterators iterators;
+  ProvenanceGraph provGraph;
+  std::map<IndexVar, ir::Expr> indexVarToExprMap;
+
+  /// Merge lattices of the foralls of the statement, for the index variables
+  /// defined and the where temporaries written to results around them.  The
+  /// foralls are held so that nodes made while lowering, which are freed
+  /// right after, cannot be mistaken for others allocated at their address.
+  std::vector<std::tuple<Forall,
+                         std::set<IndexVar>,
+                         std::map<TensorVar, const AccessNode*>,
+                         MergeLattice>> mergeLattices;
+};
+
 class LowererImpl : public util::Uncopyable {
 public:
   LowererImpl();
@@ -56,6 +89,25 @@ public:
   ir::Stmt lower(IndexStmt stmt, std::string name, 
                  bool assemble, bool compute, bool pack, bool unpack);
 
+  /// Allocate the arrays of sparse results once, for the number of nonzeros
+  /// passed to the kernel in the `vals_size` field of the result, and shrink
+  /// them to fit after assembly, instead of starting from a default capacity.
+  /// Arrays still grow if the capacity turns out to be too small.
+  void setPresizeResults(bool presizeResults);
+
+  /// Zero-initialize result values and temporaries outside of parallel loops
+  /// in parallel, with the same (runtime) schedule as parallel compute loops,
+  /// so that their pages are first touched by the threads that compute them.
+  void setFirstTouch(bool firstTouch);
+
+  /// Compute values of 16-bit floats in `accumulatorType` rather than in
+  /// Float32 if it is a float type, and values of 8-bit integers in it rather
+  /// than in Int32 if it is an integer type.
+  void setAccumulatorType(Datatype accumulatorType);
+
+  /// Share the analyses of the statements lowered with other lowerers.
+  void setAnalysis(std::shared_ptr<LoweringAnalysis> analysis);
+
 protected:
 
   /// Lower an assignment statement.
@@ -253,6 +305,10 @@ protected:
   /// Retrieve the chain of iterators that iterate over the access expression.
   std::vector<Iterator> getIterators(Access) const;
 
+  /// Retrieve the merge lattice of a forall, from the shared analysis if it
+  /// was made there for the same index variables and where temporaries.
+  MergeLattice getMergeLattice(Forall forall);
+
   /// Retrieve the access expressions that have been exhausted.
   std::set<Access> getExhaustedAccesses(MergePoint, MergeLattice) const;
 
@@ -304,7 +360,8 @@ protected:
   ir::Stmt finalizeResultArrays(std::vector<Access> writes);
 
   /**
-   * Replace scalar tensor pointers with stack scalar for lowering.
+   * Replace scalar tensor pointers with stack scalar for lowering.  Results
+   * are initialized to the identity of the operator they are reduced with.
    */
   ir::Stmt defineScalarVariable(TensorVar var, bool zero);
 
@@ -320,6 +377,24 @@ protected:
    */
   ir::Stmt zeroInitValues(ir::Expr tensor, ir::Expr begin, ir::Expr size);
 
+  /// Returns the value that reductions into a tensor start from, which is
+  /// zero unless it is reduced with a semiring operator.
+  ir::Expr getReductionIdentity(TensorVar var) const;
+  ir::Expr getReductionIdentity(ir::Expr tensor) const;
+
+  /// Returns the type that values stored as `type` are computed in, which is
+  /// wider than 16-bit floats and 8-bit integers.
+  Datatype getComputeType(Datatype type) const;
+
+  /// Load a value from a values array, widening it to its compute type.
+  ir::Expr loadValue(ir::Expr values, ir::Expr loc) const;
+
+  /// Store a value into a values array, rounding it to the array's type.
+  ir::Stmt storeValue(ir::Expr values, ir::Expr loc, ir::Expr value,
+                      bool atomic=false,
+                      ParallelUnit atomicParallelUnit=ParallelUnit::NotParallel)
+                      const;
+
   /// Declare position variables and initialize them with a locate.
   ir::Stmt declLocatePosVars(std::vector<Iterator> iterators);
 
@@ -381,6 +456,9 @@ protected:
 private:
   bool assemble;
   bool compute;
+  bool presizeResults = false;
+  bool firstTouch = false;
+  Datatype accumulatorType;
 
   int markAssignsAtomicDepth = 0;
   ParallelUnit atomicParallelUnit;
@@ -405,6 +483,10 @@ private:
   /// Map form temporary to bitGuard var if accelerating dense workspace
   std::map<TensorVar, ir::Expr> tempToBitGuard;
 
+  /// Map from tensors reduced into with operators other than sums to the
+  /// reduction operators
+  std::map<TensorVar, IndexExpr> reductionOperators;
+
   /// Map from result tensors to variables tracking values array capacity.
   std::map<ir::Expr, ir::Expr> capacityVars;
 
@@ -423,6 +505,9 @@ private:
   /// Keep track of relations between IndexVars
   ProvenanceGraph provGraph;
 
+  /// Analyses shared with other lowerers, if any
+  std::shared_ptr<LoweringAnalysis> analysis;
+
   bool ignoreVectorize = false; // already being taken into account
 
   std::vector<ir::Stmt> whereConsumers;
@@ -174,10 +174,23 @@ protected:
   /// Check if other mode format is identical. Can assume that this method will 
   /// always be called with an argument that is of the same class.
   virtual bool equals(const ModeFormatImpl& other) const;
+
+  /// Get the number of entries to initially allocate the arrays of an appended
+  /// mode for: the result's capacity hint if the lowerer presizes results (see
+  /// `capacityHintVarName`) and `allocSize` otherwise.
+  static ir::Expr getInitialCapacity(Mode mode, long long allocSize);
+
+  /// True if the arrays of an appended mode are allocated from the result's
+  /// capacity hint, and should be shrunk to fit when the level is finalized.
+  static bool isPresized(Mode mode);
 };
 
 static const int DEFAULT_ALLOC_SIZE = 1 << 20;
 
+/// The name of the mode variable that holds the number of nonzeros that the
+/// lowerer presizes the arrays of an appended result mode for.
+static const std::string capacityHintVarName = "capacity_hint";
+
 }
 #endif
 
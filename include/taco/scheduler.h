@@ -0,0 +1,82 @@
+#ifndef TACO_SCHEDULER_H
+#define TACO_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "taco/taco_scheduler_t.h"
+
+namespace taco {
+
+/// Schedulers run the parallel loops of generated kernels as tasks instead of
+/// OpenMP parallel regions, e.g. to share a service's thread pool or to let
+/// kernels that are computed concurrently from several threads share one pool
+/// without oversubscribing cores. Kernels ask for the scheduler of the thread
+/// that calls them each time they reach a parallel loop, and run the loop with
+/// its OpenMP pragma if there is none (the default). The thread scheduler
+/// takes precedence over the process scheduler.
+///
+/// Loops that update memory atomically or assign to variables declared outside
+/// of the loop always run with their OpenMP pragma, as do all loops of kernels
+/// instrumented with profiling counters. Parallel loops nested in a task run
+/// serially.
+
+/// Set the scheduler of every thread that has no thread scheduler.
+void setScheduler(const taco_scheduler_t& scheduler);
+
+/// Run parallel loops with OpenMP on threads that have no thread scheduler.
+void resetScheduler();
+
+/// Set the scheduler of the calling thread.
+void setThreadScheduler(const taco_scheduler_t& scheduler);
+
+/// Fall back to the process scheduler on the calling thread.
+void resetThreadScheduler();
+
+/// Get the scheduler of the calling thread, or nullptr if parallel loops run
+/// with OpenMP.
+const taco_scheduler_t* getScheduler();
+
+/// The function through which generated kernels get the scheduler of the
+/// calling thread.
+typedef taco_scheduler_t* (*SchedulerGetter)();
+SchedulerGetter getKernelSchedulerGetter();
+
+/// A pool of worker threads that run parallel loops with work stealing. Each
+/// worker owns a lock-free Chase-Lev deque: it splits the ranges it runs in
+/// half, pushes one half to the bottom of its deque and keeps the other, while
+/// idle workers steal the largest remaining ranges from the top of other
+/// workers' deques. Threads that submit a loop help to run it until it
+/// completes, so loops may be submitted concurrently from any number of
+/// threads and from within tasks of the pool.
+class WorkStealingPool {
+public:
+  /// Create a pool with `numWorkers` worker threads (one less than the number
+  /// of hardware threads if zero, since the submitting thread helps too).
+  explicit WorkStealingPool(int numWorkers=0);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  void operator=(const WorkStealingPool&) = delete;
+
+  /// Get a scheduler that runs parallel loops on this pool.
+  taco_scheduler_t getScheduler();
+
+  /// Get the number of worker threads.
+  int getNumWorkers() const;
+
+  /// Run `task(begin, end)` over chunks of [begin, end) and wait for them.
+  void parallelFor(int64_t begin, int64_t end,
+                   const std::function<void(int64_t,int64_t)>& task);
+
+  /// Get the process-wide pool, which is created on first use.
+  static WorkStealingPool& getDefault();
+
+  struct Content;
+private:
+  std::unique_ptr<Content> content;
+};
+
+}
+#endif
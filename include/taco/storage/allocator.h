@@ -0,0 +1,87 @@
+#ifndef TACO_STORAGE_ALLOCATOR_H
+#define TACO_STORAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+
+#include "taco/taco_allocator_t.h"
+
+namespace taco {
+
+/// Allocators route the memory of tensor arrays to a custom memory source, such
+/// as huge pages, an aligned pool or a service's memory accounting. The current
+/// allocator is used by `makeArray` and by generated kernels to allocate their
+/// results (`pos`, `crd` and `vals` arrays). Kernel temporaries (workspaces)
+/// are allocated with the temporary allocator, which defaults to the current
+/// allocator. Arrays remember the allocator they were allocated with and are
+/// freed through it, even if the current allocator has since changed, so the
+/// context of an allocator must outlive the arrays allocated with it.
+///
+/// Allocators must not be changed while kernels are executing.
+
+/// Set the allocator of tensor arrays and generated kernels.
+void setAllocator(const taco_allocator_t& allocator);
+
+/// Get the allocator of tensor arrays and generated kernels.
+const taco_allocator_t& getAllocator();
+
+/// Set the allocator of the temporaries of generated kernels.
+void setTemporaryAllocator(const taco_allocator_t& allocator);
+
+/// Allocate the temporaries of generated kernels with the current allocator.
+void resetTemporaryAllocator();
+
+/// Get the allocator of the temporaries of generated kernels.
+const taco_allocator_t& getTemporaryAllocator();
+
+/// The allocator and temporary allocator tables that generated kernels call
+/// through. Their contents are replaced when the allocators are set.
+/// @{
+taco_allocator_t* getKernelAllocatorTable();
+taco_allocator_t* getKernelTemporaryAllocatorTable();
+/// @}
+
+/// Allocators that call malloc, realloc and free (the default).
+taco_allocator_t mallocAllocator();
+
+/// Allocators that align allocations to `alignment` bytes (a power of two).
+taco_allocator_t alignedAllocator(size_t alignment=64);
+
+/// Allocators that back allocations of at least 2MB with transparent huge
+/// pages (whole 2MB-aligned pages advised with MADV_HUGEPAGE where supported).
+/// Smaller allocations are aligned to 64 bytes.
+taco_allocator_t hugePageAllocator();
+
+/// True if the allocators allocate with the same functions and context.
+bool operator==(const taco_allocator_t&, const taco_allocator_t&);
+bool operator!=(const taco_allocator_t&, const taco_allocator_t&);
+
+/// A bump allocator for kernel temporaries that are discarded together, e.g.
+/// after each evaluation. Memory is carved from large blocks, freeing is a
+/// no-op and `reset` releases every allocation at once while keeping the
+/// largest block for reuse. Allocation is thread safe.
+class BumpArena {
+public:
+  /// Create an arena that allocates blocks of at least `blockSize` bytes.
+  explicit BumpArena(size_t blockSize=1<<20);
+  ~BumpArena();
+
+  BumpArena(const BumpArena&) = delete;
+  void operator=(const BumpArena&) = delete;
+
+  /// Get an allocator that allocates from this arena.
+  taco_allocator_t getAllocator();
+
+  /// Release all allocations. No memory from the arena may be used after this.
+  void reset();
+
+  /// Get the number of bytes allocated since the last reset.
+  size_t getBytesAllocated() const;
+
+private:
+  struct Content;
+  std::unique_ptr<Content> content;
+};
+
+}
+#endif
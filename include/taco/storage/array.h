@@ -5,6 +5,7 @@
 #include <ostream>
 #include <taco/type.h>
 #include <taco/storage/typed_value.h>
+#include "taco/taco_allocator_t.h"
 #include "taco/util/collections.h"
 
 namespace taco {
@@ -24,12 +25,20 @@ public:
   /// Construct an array of elements of the given type.
   Array(Datatype type, void* data, size_t size, Policy policy=Free);
 
+  /// Construct an array of elements of the given type, whose data was
+  /// allocated with (and will be freed with) the given allocator.
+  Array(Datatype type, void* data, size_t size,
+        const taco_allocator_t& allocator);
+
   /// Returns the type of the array elements
   const Datatype& getType() const;
 
   /// Returns the number of array elements
   size_t getSize() const;
 
+  /// Returns the memory reclamation policy of the array
+  Policy getPolicy() const;
+
   /// Returns the array data.
   /// @{
   const void* getData() const;
@@ -63,7 +72,8 @@ Array makeArray(T* data, size_t size, Array::Policy policy=Array::UserOwns) {
   return Array(type<T>(), data, size, policy);
 }
 
-/// Construct an array of elements of the given type.
+/// Construct an array of elements of the given type, allocated with the
+/// current allocator (see taco/storage/allocator.h).
 Array makeArray(Datatype type, size_t size);
 
 /// Construct an Array from the values.
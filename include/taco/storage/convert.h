@@ -0,0 +1,34 @@
+/// Conversions of packed tensors between formats. Unlike packing, which sorts
+/// and packs a buffer of inserted coordinates, conversions read the index of
+/// a packed tensor directly and build the index of the target format from it,
+/// so that e.g. transposing a CSR matrix into CSC costs a single counting sort
+/// over its nonzeros.
+
+#ifndef TACO_STORAGE_CONVERT_H
+#define TACO_STORAGE_CONVERT_H
+
+#include <vector>
+
+#include "taco/format.h"
+#include "taco/storage/storage.h"
+
+namespace taco {
+
+/// True if tensors stored in the `source` format can be converted into the
+/// `target` format. Both formats may only have dense, compressed and singleton
+/// modes with 32-bit index arrays, and must have the same order.
+bool canConvert(const Format& source, const Format& target);
+
+/// Convert a packed tensor into another format with its modes permuted, such
+/// that mode `i` of the result is mode `modeOrdering[i]` of `source`. The
+/// components are sorted into the level order of the target format with
+/// stable counting sorts, one per target level that is not already in order
+/// in the source, and the target index is then built level by level. Both
+/// steps run in parallel with OpenMP. Explicit zeros are dropped if
+/// `removeZeros` is set, and are otherwise stored like any other component.
+TensorStorage convert(const TensorStorage& source,
+                      const std::vector<int>& modeOrdering,
+                      const Format& format, bool removeZeros=false);
+
+}
+#endif
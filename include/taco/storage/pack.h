@@ -48,5 +48,14 @@ TensorStorage pack(std::vector<int> dimensions, Format format,
   return pack(type<V>(), dimensions, format, coordinates, values.data());
 }
 
+/// Copy the index and value arrays of a packed tensor into new arrays, in
+/// parallel over the tensor's top-level positions and with the runtime
+/// schedule of generated kernels. Operating systems place each page on the
+/// NUMA node of the thread that first writes it, so each thread's share of the
+/// tensor ends up on its own node. Tensors with modes other than dense,
+/// compressed and singleton modes, or with index arrays that are not 32-bit,
+/// are left unchanged.
+void distributeFirstTouch(TensorStorage& storage);
+
 }
 #endif
@@ -0,0 +1,18 @@
+/// This file defines the runtime struct through which generated code allocates
+/// memory.  Note: this file must be valid C99, not C++.
+/// This *must* be kept in sync with the version used in codegen_c.cpp
+
+#ifndef TACO_ALLOCATOR_T_DEFINED
+#define TACO_ALLOCATOR_T_DEFINED
+
+#include <stddef.h>
+
+typedef struct taco_allocator_t {
+  void* (*alloc)(void* context, size_t size, size_t alignment);
+  void* (*realloc)(void* context, void* ptr, size_t size, size_t alignment);
+  void  (*free)(void* context, void* ptr);
+  size_t alignment;  // alignment passed to alloc and realloc
+  void*  context;    // user data passed to every call
+} taco_allocator_t;
+
+#endif
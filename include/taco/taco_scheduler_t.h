@@ -0,0 +1,22 @@
+/// This file defines the runtime struct through which generated code runs
+/// parallel loops on a task scheduler.  Note: this file must be valid C99, not
+/// C++.
+/// This *must* be kept in sync with the version used in codegen_c.cpp
+
+#ifndef TACO_SCHEDULER_T_DEFINED
+#define TACO_SCHEDULER_T_DEFINED
+
+#include <stdint.h>
+
+/// A chunk of a parallel loop: runs the iterations [begin, end).
+typedef void (*taco_task_t)(void* closure, int64_t begin, int64_t end);
+
+typedef struct taco_scheduler_t {
+  /// Run `task(closure, b, e)` over disjoint chunks [b, e) that cover
+  /// [begin, end), and return once every chunk has completed.
+  void (*parallel_for)(void* context, int64_t begin, int64_t end,
+                       taco_task_t task, void* closure);
+  void* context;  // user data passed to every call
+} taco_scheduler_t;
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef TACO_TENSOR_H
 #define TACO_TENSOR_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -8,6 +9,8 @@
 #include <utility>
 #include <array>
 #include <mutex>
+#include <future>
+#include <thread>
 
 #include "taco/type.h"
 #include "taco/format.h"
@@ -39,6 +42,10 @@ struct AccessTensorNode;
 template <typename CType>
 struct ScalarAccess;
 
+class BoundKernel;
+enum class ParallelSchedule;
+enum class ThreadPlacement;
+
 /// TensorBase is the super-class for all tensors. You can use it directly to
 /// avoid templates, or you can use the templated `Tensor<T>` that inherits from
 /// `TensorBase`.
@@ -437,6 +444,27 @@ public:
   /// Set to true to perform the assemble and compute stages simultaneously.
   void setAssembleWhileCompute(bool assembleWhileCompute);
 
+  /// Freeze the assembled index (the sparsity pattern) of the tensor. While
+  /// the index is frozen, assembling the same expression again reuses the
+  /// existing index and value array, so that re-evaluating an expression only
+  /// runs the compute kernel. The index is reassembled if a different
+  /// expression is assigned or if the index of an operand changes structure,
+  /// as detected by a fingerprint of the operands' index arrays. Freezing
+  /// turns off assembleWhileCompute, since it requires a separate compute
+  /// kernel that does not assemble.
+  void freezeIndex();
+
+  /// Unfreeze the index, so that every assembly rebuilds it.
+  void unfreezeIndex();
+
+  /// True if the index of the tensor is frozen.
+  bool isIndexFrozen() const;
+
+  /// Compile (and, unless assembling while computing, assemble) the tensor and
+  /// return a handle to its compute kernel that is bound to the storage of the
+  /// tensor and its operands. See `BoundKernel`.
+  BoundKernel bindKernel();
+
   /// Get the source code of the kernel functions.
   std::string getSource() const;
 
@@ -459,6 +487,28 @@ public:
   /// Get the size of the initial index allocations.
   size_t getAllocSize() const;
 
+  /// Set to true to allocate the index and value arrays of a sparse result
+  /// once, for an upper bound on its number of nonzeros, and shrink them to
+  /// fit after assembly, instead of starting from a default capacity and
+  /// doubling the arrays as they fill up. The bound is the capacity hint, if
+  /// set, and is otherwise computed from the sizes of the operands: a sum has
+  /// at most as many nonzeros as its terms together and a product at most as
+  /// many as its sparsest factor. Bounds larger than both the operands and
+  /// the alloc size are clamped to the larger of the two, and arrays still
+  /// grow if the bound turns out to be too small.
+  void setPresizeResult(bool presizeResult);
+
+  /// True if the arrays of the result are presized.
+  bool isResultPresized() const;
+
+  /// Set the number of nonzeros to presize the result for, e.g. an exact count
+  /// from a symbolic pass or a previous evaluation. Zero (the default) computes
+  /// a bound from the operands. Setting a hint presizes the result.
+  void setCapacityHint(size_t capacityHint);
+
+  /// Get the number of nonzeros to presize the result for (zero if unset).
+  size_t getCapacityHint() const;
+
   /// Get the taco_tensor_t representation of this tensor.
   taco_tensor_t* getTacoTensorT();
 
@@ -485,13 +535,47 @@ public:
   friend std::ostream& operator<<(std::ostream&, TensorBase&);
 
   friend struct AccessTensorNode;
+  friend class BoundKernel;
   std::vector<TensorBase> getDependentTensors();
 private:
   static std::shared_ptr<ir::Module> getHelperFunctions(
       const Format& format, Datatype ctype, const std::vector<int>& dimensions);
-  static std::shared_ptr<ir::Module> getComputeKernel(const IndexStmt stmt);
-  static void cacheComputeKernel(const IndexStmt stmt, 
-                                 const std::shared_ptr<ir::Module> kernel);
+
+  typedef std::shared_future<std::shared_ptr<ir::Module>> ModuleFuture;
+
+  /// Find the cached kernel of a statement that is isomorphic to the
+  /// statement `scheduledStmt` was concretized from, which may still be
+  /// compiling.
+  static bool findComputeKernel(const IndexStmt scheduledStmt,
+                                bool assembleWhileCompute, bool presizeResult,
+                                bool firstTouch, bool interpret,
+                                Datatype accumulatorType, ModuleFuture* kernel);
+
+  /// Get the cached kernel of `stmt`, which may still be compiling. If there
+  /// is none, `compiled` is cached as its kernel and `reserved` is set, and
+  /// the caller must then compile the kernel and fulfill `compiled`, or
+  /// uncache it if compilation fails.
+  static ModuleFuture getComputeKernel(const IndexStmt stmt,
+                                       const IndexStmt scheduledStmt,
+                                       bool assembleWhileCompute,
+                                       bool presizeResult, bool firstTouch,
+                                       bool interpret,
+                                       Datatype accumulatorType,
+                                       const ModuleFuture& compiled,
+                                       bool* reserved);
+  static void uncacheComputeKernel(const IndexStmt stmt);
+
+  /// Lower and compile the kernels of a concrete statement into a new module.
+  void compileKernel(IndexStmt stmtToCompile, bool assembleWhileCompute,
+                     bool presizeResult, bool firstTouch, bool interpret,
+                     Datatype accumulatorType);
+
+  /// Get the number of nonzeros to presize the result arrays for.
+  size_t getResultCapacity() const;
+
+  /// Estimate the work of computing the tensor from the number of components
+  /// stored by the operands and by the dense modes of the result.
+  size_t getEstimatedWork() const;
 
   /* --- Compiler Methods --- */
   bool neverPacked();
@@ -508,6 +592,11 @@ private:
 
   void syncValues();
 
+  void fusePendingOperands();
+
+  void recordFrozenIndex();
+  bool isFrozenIndexValid();
+
   template<typename CType>
   iterator_wrapper<int,CType> iteratorPacked();
   
@@ -515,6 +604,14 @@ private:
   void insertUnsynced(const std::vector<int>& coordinate, CType value);
 
 protected:
+  /// Store the components of this tensor in `result`, whose format may
+  /// differ, with mode `i` of `result` being mode `modeOrdering[i]` of this
+  /// tensor. Explicit zeros are dropped if `removeZeros` is set. Returns false
+  /// if the formats are not supported by the conversion kernels (see
+  /// `convert`).
+  bool convertInto(TensorBase& result, const std::vector<int>& modeOrdering,
+                   bool removeZeros) const;
+
   template <typename T, typename CType>
   void insertUnchecked(
       const typename const_iterator<T,CType>::Coordinates& coordinate, 
@@ -530,16 +627,90 @@ private:
   typedef std::vector<std::tuple<Format,
                                  Datatype,
                                  std::vector<int>,
-                                 std::shared_ptr<ir::Module>>> HelperFuncsCache;
+                                 ModuleFuture>> HelperFuncsCache;
   static HelperFuncsCache helperFunctions;
   static std::mutex helperFunctionsMutex;
 
-  typedef std::vector<std::pair<IndexStmt, 
-                                std::shared_ptr<ir::Module>>> KernelsCache;
+  typedef std::vector<std::tuple<IndexStmt,
+                                 IndexStmt,  // scheduled statement
+                                 bool,  // assembleWhileCompute
+                                 bool,  // presizeResult
+                                 bool,  // firstTouch
+                                 bool,  // interpret
+                                 Datatype,  // accumulatorType
+                                 ModuleFuture>> KernelsCache;
   static KernelsCache computeKernels;
   static std::mutex computeKernelsMutex;
 };
 
+/// A compute kernel bound to the storage of a tensor and its operands, for
+/// evaluating the same expression many times with low latency (e.g. when
+/// scoring a stream of requests against fixed operand shapes). The kernel's
+/// function pointer is resolved and its argument vector is packed once, when
+/// the kernel is bound, so calling it costs a function call: it does not look
+/// up the kernel, sync operands, time phases or save and restore the OpenMP
+/// settings. taco's parallel schedule, number of threads and thread placement
+/// are recorded when the kernel is bound, and applied to the OpenMP settings
+/// of a thread when it calls the kernel (OpenMP settings are per thread), where
+/// they remain after the call. Calls from the thread that made the last call
+/// do not apply them again.
+///
+/// Operands are bound by reference: writing new values into the bound arrays
+/// of an operand is seen by the next call. To point an operand at another
+/// tensor with the same type, format and dimensions, use `bind`. If the index
+/// or value arrays of a bound tensor are replaced (e.g. by packing it again),
+/// call `refresh` before the next call.
+class BoundKernel {
+public:
+  /// Create an undefined bound kernel.
+  BoundKernel();
+
+  /// Compute the result from the bound operands.
+  void operator()();
+
+  /// Bind `operand`, a tensor accessed by the result's expression, to the
+  /// storage of `tensor`, which must have the same component type, format and
+  /// dimensions.
+  void bind(const TensorBase& operand, const TensorBase& tensor);
+
+  /// Reread the index and value arrays of the result and the bound operands.
+  void refresh();
+
+  /// Get the result tensor that the kernel computes.
+  const TensorBase& getResult() const;
+
+  /// True if the kernel has been bound to a tensor.
+  bool defined() const;
+
+private:
+  friend class TensorBase;
+  BoundKernel(TensorBase result);
+
+  typedef int (*KernelFunction)(void**);
+
+  TensorBase                  result;
+  std::shared_ptr<ir::Module> module;
+  KernelFunction              function;
+  bool                        assembleWhileCompute;
+
+  /// The tensor whose storage is passed at each argument position (the result
+  /// is at position 0), and the argument position of each original operand.
+  std::vector<TensorBase>     boundTensors;
+  std::map<TensorBase,size_t> operandArguments;
+  std::vector<void*>          arguments;
+
+  /// The number of nonzeros to presize the result for, if it is presized.
+  size_t                      resultCapacity;
+
+  /// The parallel execution settings when the kernel was bound, and the last
+  /// thread they were applied to.
+  ParallelSchedule            schedule;
+  int                         chunkSize;
+  int                         numThreads;
+  ThreadPlacement             placement;
+  std::thread::id             configuredThread;
+};
+
 /// A reference to a tensor. Tensor object copies copies the reference, and
 /// subsequent method calls affect both tensor references. To deeply copy a
 /// tensor (for instance to change the format) compute a copy index expression
@@ -580,7 +751,10 @@ public:
 
   CType at(const std::vector<int>& coordinate);
 
-  /// Simple transpose that packs a new tensor from the values in the current tensor.
+  /// Transpose the tensor into a new tensor, with mode `i` of the new tensor
+  /// being mode `newModeOrdering[i]` of this one. Tensors with dense,
+  /// compressed and singleton modes are converted directly from their index
+  /// (see `convert`); others are inserted into and packed by the new tensor.
   Tensor<CType> transpose(std::string name, std::vector<int> newModeOrdering) const;
   Tensor<CType> transpose(std::vector<int> newModeOrdering) const;
   Tensor<CType> transpose(std::vector<int> newModeOrdering, Format format) const;
@@ -848,6 +1022,8 @@ struct TensorBase::Content {
 
   size_t             allocSize;
   size_t             valuesSize;
+  bool               presizeResult;
+  size_t             capacityHint;
 
   ir::Stmt           assembleFunc;
   ir::Stmt           computeFunc;
@@ -863,7 +1039,18 @@ struct TensorBase::Content {
   bool               needsCompile;
   bool               needsAssemble;
   bool               needsCompute;
+
+  // The index arrays of the operands (and a hash of their contents) that the
+  // frozen index was assembled from
+  bool               indexFrozen;
+  Assignment         frozenAssignment;
+  std::vector<Array> frozenOperandIndices;
+  size_t             frozenOperandIndicesHash;
+
+  // Tensors evaluated concurrently (e.g. from Python) may share this tensor as
+  // an operand, so the dependent tensors are guarded by a mutex
   std::vector<std::weak_ptr<TensorBase::Content>> dependentTensors;
+  std::mutex         dependentTensorsMutex;
   unsigned int       uniqueId;
 
   Content(std::string name, Datatype dataType, const std::vector<int>& dimensions,
@@ -1123,6 +1310,9 @@ Tensor<CType> Tensor<CType>::transpose(std::string name, std::vector<int> newMod
   }
 
   Tensor<CType> newTensor(name, newDimensions, format);
+  if (convertInto(newTensor, newModeOrdering, false)) {
+    return newTensor;
+  }
   for (auto& value : *this) {
     std::vector<int> newCoordinate;
     for (int mode : newModeOrdering) {
@@ -1137,6 +1327,13 @@ Tensor<CType> Tensor<CType>::transpose(std::string name, std::vector<int> newMod
 template <typename CType>
 Tensor<CType> Tensor<CType>::removeExplicitZeros(Format format) const {
   Tensor<CType> newTensor(getDimensions(), format);
+  std::vector<int> modeOrdering(getOrder());
+  for (int i = 0; i < getOrder(); i++) {
+    modeOrdering[i] = i;
+  }
+  if (convertInto(newTensor, modeOrdering, true)) {
+    return newTensor;
+  }
   for (const auto& elem : *this) {
     if (elem.second != static_cast<CType>(0)) {
       newTensor.insertUnchecked<int,CType>(elem.first, elem.second);
@@ -1205,13 +1402,103 @@ void taco_set_parallel_schedule(ParallelSchedule sched, int chunk_size = 0);
 /// will be replaced by a scheduling language in the future.
 void taco_get_parallel_schedule(ParallelSchedule *sched, int *chunk_size);
 
+/// Placement of the threads of parallel tensor computations on the CPUs of the
+/// machine's NUMA nodes.
+enum class ThreadPlacement {
+  /// Leave thread placement to the operating system and the OpenMP runtime.
+  Default,
+  /// Pin threads to the CPUs of one node before moving on to the next node.
+  Close,
+  /// Pin consecutive threads to CPUs of different nodes, round-robin.
+  Spread
+};
+
 /// Set maximum number of threads to use for parallel execution of tensor
 /// computations. This will be replaced by a scheduling language in the future.
 void taco_set_num_threads(int num_threads);
 
+/// Set maximum number of threads to use for parallel execution of tensor
+/// computations and how to place them on the machine's NUMA nodes.
+void taco_set_num_threads(int num_threads, ThreadPlacement placement);
+
 /// Get maximum number of threads to use for parallel execution of tensor 
 /// computations. This will be replaced by a scheduling language in the future.
 int taco_get_num_threads();
 
+/// Set how to place the threads of parallel tensor computations. Threads are
+/// pinned to CPUs (including the thread that calls the kernel, as thread 0)
+/// when the next kernel is called. Placement requires OpenMP support and is
+/// ignored otherwise.
+void taco_set_thread_placement(ThreadPlacement placement);
+
+/// Get how the threads of parallel tensor computations are placed.
+ThreadPlacement taco_get_thread_placement();
+
+/// Enable or disable NUMA-aware first-touch initialization. Operating systems
+/// place a page on the NUMA node of the thread that first writes it, so when
+/// enabled, kernels zero-initialize result values and temporaries in parallel
+/// with the same schedule as their compute loops, and `pack` copies the index
+/// and value arrays of tensors in parallel over their top-level positions, so
+/// that each thread mostly accesses pages on its own node. Affects kernels
+/// compiled and tensors packed after the call, and requires OpenMP support.
+void taco_set_numa_first_touch(bool enabled);
+
+/// True if NUMA-aware first-touch initialization is enabled.
+bool taco_get_numa_first_touch();
+
+/// Enable or disable kernel fusion. When enabled, compiling a tensor inlines
+/// the pending (not yet computed) assignments of operands that are factors of
+/// its expression, so that a chain such as `T(i,j) = B(i,k)*C(k,j);
+/// A(i,j) = T(i,j)*D(i,j)` is computed by one kernel, with the reductions of
+/// the producers computed into temporaries (`where` statements) instead of
+/// materializing the intermediate tensors. Fused producers are left pending
+/// and are only computed if they are read.
+void taco_set_kernel_fusion(bool enabled);
+
+/// True if kernel fusion is enabled.
+bool taco_get_kernel_fusion();
+
+/// Set the maximum number of C compilers that run at the same time. Kernels
+/// compiled from more threads than that wait for a compiler to finish, so
+/// that many threads evaluating new expressions at once do not saturate the
+/// machine. Defaults to the `TACO_COMPILE_THREADS` environment variable, or to
+/// half the number of hardware threads.
+void taco_set_max_compile_threads(int num_threads);
+
+/// Get the maximum number of C compilers that run at the same time.
+int taco_get_max_compile_threads();
+
+/// Enable or disable background compilation of kernels. While enabled, new
+/// kernels are compiled on the compiler threads, and tensors are assembled and
+/// computed by interpreting the lowered kernels until the compiled kernels are
+/// loaded. Kernels the interpreter does not support wait for the compiler.
+void taco_set_background_compile(bool enabled);
+
+/// True if kernels are compiled in the background.
+bool taco_get_background_compile();
+
+/// Set the estimated work (roughly the number of components stored by the
+/// operands and by the dense modes of the result) below which kernels are
+/// interpreted instead of compiled, so that small problems do not pay for
+/// running the C compiler. Kernels the interpreter does not support are always
+/// compiled. Defaults to the `TACO_INTERPRETER_THRESHOLD` environment
+/// variable, or to 0, which compiles every kernel.
+void taco_set_interpreter_threshold(size_t work);
+
+/// Get the estimated work below which kernels are interpreted.
+size_t taco_get_interpreter_threshold();
+
+/// Set the type that kernels compute values of 16-bit floats and 8-bit
+/// integers in. Such values are only stored in their narrow types: they are
+/// widened when loaded, reduced into temporaries and scalars of the wider type,
+/// and rounded back when stored. Float types only apply to 16-bit floats and
+/// integer types only to 8-bit integers. Defaults to an undefined type, which
+/// computes 16-bit floats in Float32 and 8-bit integers in Int32.
+void taco_set_accumulator_type(Datatype type);
+
+/// Get the type that 16-bit floats and 8-bit integers are computed in, or an
+/// undefined type if they are computed in their defaults.
+Datatype taco_get_accumulator_type();
+
 }
 #endif
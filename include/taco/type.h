@@ -6,13 +6,15 @@
 #include <vector>
 #include <initializer_list>
 #include "taco/error.h"
+#include "taco/float16.h"
 #include <complex>
 #include <memory>
 
 namespace taco {
 
 /// A basic taco type. These can be boolean, integer, unsigned integer, float
-/// or complex float at different precisions.
+/// or complex float at different precisions.  The 16-bit floats are storage
+/// types: kernels compute with them in single precision.
 class Datatype {
 public:
   /// The kind of type this object represents.
@@ -28,6 +30,8 @@ public:
     Int32,
     Int64,
     Int128,
+    Float16,
+    BFloat16,
     Float32,
     Float64,
     Complex64,
@@ -82,6 +86,8 @@ extern Datatype Int32;
 extern Datatype Int64;
 extern Datatype Int128;
 Datatype Float(int bits = sizeof(double)*8);
+extern Datatype Float16;
+extern Datatype BFloat16;
 extern Datatype Float32;
 extern Datatype Float64;
 Datatype Complex(int bits);
@@ -143,6 +149,14 @@ template<> inline Datatype type<int8_t>() {
   return Int8;
 }
 
+template<> inline Datatype type<float16>() {
+  return Float16;
+}
+
+template<> inline Datatype type<bfloat16>() {
+  return BFloat16;
+}
+
 template<> inline Datatype type<float>() {
   return Float32;
 }
@@ -175,6 +189,8 @@ union ComponentTypeUnion {
   int64_t int64Value;
   long long int128Value;
 
+  float16 float16Value;
+  bfloat16 bfloat16Value;
   float float32Value;
   double float64Value;
 
@@ -33,7 +33,8 @@ const std::map<FillMethod,double> fillFactors = {
     {FillMethod::HyperSparse, 0.005},
     {FillMethod::SlicingH, 0.01},
     {FillMethod::SlicingV, 0.01},
-    {FillMethod::FEM, 0.0}
+    {FillMethod::FEM, 0.0},
+    {FillMethod::Blocked, 0.0}
 };
 const double doubleLowerBound = -10e6;
 const double doubleUpperBound =  10e6;
@@ -45,7 +46,7 @@ void fillVector(TensorBase& tens, const FillMethod& fill, double fillValue);
 void fillMatrix(TensorBase& tens, const FillMethod& fill, double fillValue);
 void fillTensor3(TensorBase& tens, const FillMethod& fill, double fillValue);
 
-void fillTensor(TensorBase& tens, const FillMethod& fill, double fillValue/*=-1.0*/) {
+inline void fillTensor(TensorBase& tens, const FillMethod& fill, double fillValue/*=-1.0*/) {
   double filling;
   if (fillValue==-1)
     filling=fillFactors.at(fill);
@@ -70,7 +71,7 @@ void fillTensor(TensorBase& tens, const FillMethod& fill, double fillValue/*=-1.
   }
 }
 
-void fillVector(TensorBase& tensor, const FillMethod& fill, double fillValue) {
+inline void fillVector(TensorBase& tensor, const FillMethod& fill, double fillValue) {
   // Random values
   std::uniform_real_distribution<double> unif(doubleLowerBound,
                                               doubleUpperBound);
@@ -104,7 +105,7 @@ void fillVector(TensorBase& tensor, const FillMethod& fill, double fillValue) {
       // Random positions
       std::vector<int> positions(vectorSize);
       for (int i=0; i<vectorSize; i++) {
-        positions.push_back(i);
+        positions[i] = i;
       }
       srand(static_cast<unsigned>(time(NULL)));
       std::random_shuffle(positions.begin(),positions.end());
@@ -123,7 +124,7 @@ void fillVector(TensorBase& tensor, const FillMethod& fill, double fillValue) {
   tensor.pack();
 }
 
-void fillMatrix(TensorBase& tens, const FillMethod& fill, double fillValue) {
+inline void fillMatrix(TensorBase& tens, const FillMethod& fill, double fillValue) {
   // Random values
   std::uniform_real_distribution<double> unif(doubleLowerBound,
                                               doubleUpperBound);
@@ -138,7 +139,6 @@ void fillMatrix(TensorBase& tens, const FillMethod& fill, double fillValue) {
   std::random_shuffle(pos.begin(),pos.end());
   std::vector<std::vector<int>> positions(tens.getOrder());
   for (int j=0; j<tens.getOrder(); j++) {
-    positions.push_back(std::vector<int>(tensorSize[j]));
     for (int i=0; i<tensorSize[j]; i++)
       positions[j].push_back(i);
     srand(static_cast<unsigned>(time(NULL)));
@@ -235,7 +235,7 @@ void fillMatrix(TensorBase& tens, const FillMethod& fill, double fillValue) {
   tens.pack();
 }
 
-void fillTensor3(TensorBase& tens, const FillMethod& fill, double fillValue) {
+inline void fillTensor3(TensorBase& tens, const FillMethod& fill, double fillValue) {
   // Random values
   std::uniform_real_distribution<double> unif(doubleLowerBound,
                                               doubleUpperBound);
@@ -250,8 +250,7 @@ void fillTensor3(TensorBase& tens, const FillMethod& fill, double fillValue) {
   std::random_shuffle(pos.begin(),pos.end());
   std::vector<std::vector<int>> positions(tens.getOrder());
   for (int j=0; j<tens.getOrder(); j++) {
-    positions.push_back(std::vector<int>(tensorSize[j]));
-    for (int i=0; i<tensorSize[0]; i++)
+    for (int i=0; i<tensorSize[j]; i++)
       positions[j].push_back(i);
     srand(static_cast<unsigned>(time(0)));
     std::random_shuffle(positions[j].begin(),positions[j].end());
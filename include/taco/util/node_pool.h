@@ -0,0 +1,45 @@
+#ifndef TACO_UTIL_NODE_POOL_H
+#define TACO_UTIL_NODE_POOL_H
+
+#include <cstddef>
+
+namespace taco {
+namespace util {
+
+/// Allocates `size` bytes for a node of index notation or the IR.  Small nodes
+/// are carved out of large chunks by size class, and the blocks of freed nodes
+/// are kept by the thread that freed them for the next node of the same size,
+/// so rewriting trees does not go through malloc.  Larger sizes fall back to
+/// operator new.
+void* allocateNode(size_t size);
+
+/// Frees a node of `size` bytes that was allocated by allocateNode.
+void freeNode(void* node, size_t size);
+
+/// Statistics of the node pools.
+struct NodePoolStatistics {
+  /// The number of pooled nodes that the calling thread allocated, less the
+  /// number that it freed.
+  long liveNodes;
+
+  /// The number of bytes of the chunks that all threads carve nodes out of.
+  size_t chunkBytes;
+};
+
+NodePoolStatistics getNodePoolStatistics();
+
+/// Base class of the nodes that are allocated from the node pools.  Nodes must
+/// have a virtual destructor if they are deleted through a base class, so
+/// that they are freed with the size they were allocated with.
+struct PoolAllocated {
+  static void* operator new(size_t size) {
+    return allocateNode(size);
+  }
+
+  static void operator delete(void* node, size_t size) {
+    freeNode(node, size);
+  }
+};
+
+}}
+#endif
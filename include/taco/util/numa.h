@@ -0,0 +1,34 @@
+#ifndef TACO_UTIL_NUMA_H
+#define TACO_UTIL_NUMA_H
+
+#include <vector>
+
+namespace taco {
+namespace util {
+
+/// Get the CPUs of each NUMA node that the process may run on, in node order.
+/// All CPUs are reported as one node if the topology is unknown.
+std::vector<std::vector<int>> getNumaNodeCpus();
+
+/// Get the CPU to place thread `thread` on. Close placement fills the CPUs of
+/// one node before moving on to the next, while spread placement distributes
+/// consecutive threads round-robin across the nodes. Threads wrap around when
+/// there are more threads than CPUs.
+int getPlacementCpu(const std::vector<std::vector<int>>& nodeCpus, int thread,
+                    bool spread);
+
+/// Pin the calling thread to a CPU. Returns false if pinning is unsupported
+/// or fails.
+bool pinThread(int cpu);
+
+/// Place the threads of OpenMP parallel regions that the calling thread starts
+/// with `numThreads` threads. If `pin` is true the worker threads are pinned
+/// under close or spread placement, otherwise they may run on every CPU of the
+/// process again. The calling thread itself is never pinned. The OpenMP runtime
+/// reuses its threads across parallel regions, so they keep their placement in
+/// later regions. Does nothing if the placement has not changed since the last
+/// call from the calling thread, or if taco is built without OpenMP.
+void placeOpenMPThreads(int numThreads, bool pin, bool spread);
+
+}}
+#endif
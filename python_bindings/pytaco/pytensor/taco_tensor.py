@@ -1,6 +1,8 @@
 import operator
+import threading
 import numpy as np
-from scipy.sparse import csr_matrix, csc_matrix
+from concurrent.futures import ThreadPoolExecutor
+from scipy.sparse import csr_matrix, csc_matrix, coo_matrix
 from ..core import core_modules as _cm
 
 default_mode = _cm.compressed
@@ -19,6 +21,17 @@ _dtype_to_tensor = {_cm.bool:    _cm.TensorBool,
 
 _dtype_error = "Invalid datatype. Must be bool, float32/64, (u)int8, (u)int16, (u)int32 or (u)int64"
 
+_async_executor = None
+_async_executor_lock = threading.Lock()
+
+
+def _get_async_executor():
+    global _async_executor
+    with _async_executor_lock:
+        if _async_executor is None:
+            _async_executor = ThreadPoolExecutor(thread_name_prefix="pytaco")
+        return _async_executor
+
 
 class tensor:
     """ A mathematical tensor.
@@ -310,6 +323,104 @@ class tensor:
         """
         self._tensor.compute()
 
+    def evaluate_async(self):
+        """
+            Compile, assemble and compute as needed on a background thread.
+
+            Compilation and computation release the GIL, so other Python threads (including other asynchronous
+            evaluations) run while this tensor is evaluated. The tensor and its operands must not be modified
+            until the evaluation has finished.
+
+            Returns
+            ---------
+            future: concurrent.futures.Future
+                A future that completes with this tensor once it has been evaluated, or with the exception raised
+                by the evaluation.
+
+            Examples
+            ----------
+            >>> import pytaco as pt
+            >>> a = pt.from_array(np.arange(4).reshape(2, 2))
+            >>> b = pt.tensor([2, 2], pt.dense)
+            >>> i, j = pt.get_index_vars(2)
+            >>> b[i, j] = a[i, j] * 2
+            >>> b.evaluate_async().result()[1, 1]
+            6
+        """
+        def evaluate():
+            self._tensor.evaluate()
+            return self
+
+        return _get_async_executor().submit(evaluate)
+
+    def get_index_arrays(self):
+        """
+            Returns views of the index arrays of each level of the tensor without copying them.
+
+            Levels are listed in storage order (see :attr:`format`). Dense levels have no index arrays, compressed
+            levels have a ``pos`` and a ``crd`` array and singleton levels have a ``crd`` array. The tensor is
+            evaluated first if it has a pending computation.
+
+            Notes
+            -------
+            The views are read only and keep the underlying data alive, even after the tensor is destroyed. They no
+            longer reflect the tensor once taco replaces its storage, for instance when the tensor is packed again
+            after inserts or recomputed.
+
+            Returns
+            ---------
+            index_arrays: list of lists of numpy.ndarray
+                A list with the ``int32`` index arrays of each level.
+
+            Examples
+            ----------
+            >>> import pytaco as pt
+            >>> t = pt.tensor([2, 3], pt.csr)
+            >>> t.insert([0, 2], 1)
+            >>> t.insert([1, 0], 2)
+            >>> t.get_index_arrays()
+            [[], [array([0, 1, 2], dtype=int32), array([2, 0], dtype=int32)]]
+        """
+        return [[_read_only(arr) for arr in level] for level in self._tensor.get_index_arrays()]
+
+    def get_values_array(self):
+        """
+            Returns a view of the values of the tensor, in storage order, without copying them.
+
+            The tensor is evaluated first if it has a pending computation. Like :func:`get_index_arrays`, the view is
+            read only and keeps the values alive.
+
+            Returns
+            ---------
+            values: numpy.ndarray
+                A 1D array with the stored values of the tensor.
+        """
+        return _read_only(self._tensor.get_values_array())
+
+    def freeze_index(self):
+        """
+            Freezes the assembled index (the sparsity pattern) of the tensor.
+
+            While the index is frozen, re-evaluating the same expression reuses the existing index and only computes
+            new values, which avoids assembly in iterative computations where the structure of the operands does not
+            change. The index is rebuilt automatically if a different expression is assigned or if the structure of
+            an operand changes.
+        """
+        self._tensor.freeze_index()
+
+    def unfreeze_index(self):
+        """
+            Unfreezes the index of the tensor so that every evaluation assembles it again.
+        """
+        self._tensor.unfreeze_index()
+
+    @property
+    def index_frozen(self):
+        """
+            True if the index of the tensor is frozen.
+        """
+        return self._tensor.is_index_frozen()
+
     def __iter__(self):
         return iter(self._tensor)
 
@@ -408,17 +519,17 @@ class tensor:
         """
         return self.to_array()
 
-    def to_sp_csr(self):
+    def to_sp_csr(self, copy=True):
         """
             Same as :func:`to_sp_csr`.
         """
-        return to_sp_csr(self)
+        return to_sp_csr(self, copy)
 
-    def to_sp_csc(self):
+    def to_sp_csc(self, copy=True):
         """
             Same as :func:`to_sp_csc`.
         """
-        return to_sp_csc(self)
+        return to_sp_csc(self, copy)
 
     def copy(self):
         """
@@ -513,14 +624,38 @@ def remove_explicit_zeros(t, new_fmt=None, new_dtype=None):
     return tensor._fromCppTensor(t._tensor.remove_explicit_zeros(new_fmt))
 
 
+def _read_only(arr):
+    arr.flags.writeable = False
+    return arr
+
+
+def _as_index_array(arr):
+    # Generated kernels use 32-bit index arrays, so wider indices (e.g. scipy's int64) must be narrowed, which copies.
+    arr = np.asarray(arr)
+    if arr.dtype == np.int32 and arr.flags["C_CONTIGUOUS"]:
+        return arr
+    if arr.size > 0 and (arr.min() < 0 or arr.max() > np.iinfo(np.int32).max):
+        raise ValueError("Index values must be non-negative and fit in 32 bits")
+    return np.ascontiguousarray(arr, dtype=np.int32)
+
+
+def _from_arrays(cpp_tensor, arrays, copy):
+    t = tensor._fromCppTensor(cpp_tensor)
+    if not copy:
+        # The tensor points to the arrays, so keep them alive for as long as the tensor
+        t._base = arrays
+    return t
+
+
 def _from_matrix(inp_mat, copy, csr):
     matrix = inp_mat
     if not inp_mat.has_sorted_indices:
         matrix = inp_mat.sorted_indices()
 
-    indptr, indices, data = matrix.indptr, matrix.indices, matrix.data
+    indptr, indices = _as_index_array(matrix.indptr), _as_index_array(matrix.indices)
+    data = np.ascontiguousarray(matrix.data)
     shape = matrix.shape
-    return tensor._fromCppTensor(_cm.fromSpMatrix(indptr, indices, data, shape, copy, csr))
+    return _from_arrays(_cm.fromSpMatrix(indptr, indices, data, shape, copy, csr), (indptr, indices, data), copy)
 
 
 def from_sp_csr(matrix, copy=True):
@@ -569,6 +704,93 @@ def from_sp_csc(matrix, copy=True):
     return _from_matrix(matrix, copy, False)
 
 
+def from_sp_coo(matrix, copy=True):
+    """
+    Convert a sparse scipy matrix to a COO taco tensor.
+
+    Initializes a taco tensor from a scipy.sparse.coo_matrix object. This function copies the data by default.
+
+    Parameters
+    -----------
+    matrix: scipy.sparse.coo_matrix
+        A sparse scipy matrix to use to initialize the tensor.
+
+    copy: boolean, optional
+        If true, taco copies the data from scipy and stores it. Otherwise, taco points to the same data as scipy.
+
+    Notes
+    -------
+    Taco requires the coordinates of a COO tensor to be sorted and unique. Matrices that are not in canonical format
+    are converted to it first, which copies them. Taco's kernels use 32-bit indices, so ``int64`` index arrays are
+    narrowed to ``int32``, which also copies them.
+
+    Returns
+    --------
+    t: tensor
+        A taco tensor pointing to the same underlying data as the scipy matrix if copy was set to False. Otherwise,
+        returns a taco tensor containing data copied from the scipy matrix.
+    """
+    if not matrix.has_canonical_format:
+        matrix = matrix.copy()
+        matrix.sum_duplicates()
+
+    rows, cols = _as_index_array(matrix.row), _as_index_array(matrix.col)
+    data = np.ascontiguousarray(matrix.data)
+    return _from_arrays(_cm.fromSpCOO(rows, cols, data, matrix.shape, copy), (rows, cols, data), copy)
+
+
+def from_index_arrays(shape, fmt, index_arrays, values, copy=True):
+    """
+    Creates a tensor from the index arrays of each level of a format and its values.
+
+    This is the inverse of :func:`tensor.get_index_arrays` and :func:`tensor.get_values_array`, and lets tensors of
+    any order and format cross between python and taco without copying their data.
+
+    Parameters
+    -----------
+    shape: list of ints
+        The shape of the tensor.
+
+    fmt: :class:`format`
+        The format of the tensor.
+
+    index_arrays: list of lists of numpy.ndarray
+        The index arrays of each level of the format in storage order: an empty list for dense levels and a
+        ``[pos, crd]`` pair for compressed levels. The coordinates of each segment of a ``crd`` array must be sorted.
+
+    values: numpy.ndarray
+        The stored values of the tensor in storage order.
+
+    copy: boolean, optional
+        If true, taco copies the arrays and stores them. Otherwise, taco points to the same data as the arrays.
+
+    Notes
+    -------
+    Taco's kernels use 32-bit indices, so index arrays of other integer types are converted to ``int32``, which copies
+    them.
+
+    Examples
+    ----------
+    >>> import numpy as np
+    >>> import pytaco as pt
+    >>> pos = np.array([0, 2, 3], dtype=np.int32)
+    >>> crd = np.array([0, 2, 1], dtype=np.int32)
+    >>> t = pt.from_index_arrays([2, 3], pt.csr, [[], [pos, crd]], np.array([1.0, 2.0, 3.0]), copy=False)
+    >>> t[1, 1]
+    3.0
+
+    Returns
+    --------
+    t: tensor
+        A taco tensor pointing to the same underlying data as the arrays if copy was set to False. Otherwise,
+        returns a taco tensor containing copies of the arrays.
+    """
+    index_arrays = [[_as_index_array(arr) for arr in level] for level in index_arrays]
+    values = np.ascontiguousarray(values)
+    cpp_tensor = _cm.fromIndexArrays(list(shape), fmt, index_arrays, values, copy)
+    return _from_arrays(cpp_tensor, (index_arrays, values), copy)
+
+
 def from_array(array, copy=True):
 
     """Convert a numpy array to a tensor.
@@ -699,13 +921,24 @@ def to_array(t):
     return np.array(t.to_dense(), copy=True)
 
 
-def to_sp_csr(t):
+def _to_sp_matrix(t, copy, csr):
+    t = as_tensor(t, copy=False)
+    if not copy and t.format == (_cm.csr if csr else _cm.csc):
+        _, (pos, crd) = t.get_index_arrays()
+        matrix_type = csr_matrix if csr else csc_matrix
+        return matrix_type((t.get_values_array(), crd, pos), shape=t.shape, copy=False)
+
+    arrs = _cm.to_sp_matrix(t._tensor, csr)
+    return (csr_matrix if csr else csc_matrix)((arrs[2], arrs[1], arrs[0]), shape=t.shape)
+
+
+def to_sp_csr(t, copy=True):
     """
 
     Converts a taco tensor to a scipy csr_matrix.
 
     Takes a matrix from taco in any format and converts the matrix to a scipy sparse csr matrix. This method removes
-    explicit zeros from the original taco tensor during the conversion.
+    explicit zeros from the original taco tensor during the conversion, unless the matrix is shared without a copy.
 
     Parameters
     -----------
@@ -713,29 +946,32 @@ def to_sp_csr(t):
         A taco tensor to convert to a scipy.csr_matrix array. The tensor must be of order 2 (i.e it must be a matrix).
         If the order of the tensor is not equal to 2, a value error is thrown.
 
+    copy: boolean, optional
+        If false and t is stored in the CSR format, the scipy matrix shares the (read only) index and value arrays of
+        t. Otherwise, the data is copied.
+
 
     Notes
     -------
-    The data and index values are always copied when making the scipy sparse array
+    The data and index values are copied when making the scipy sparse array unless copy is false and t is CSR.
 
 
     Returns
     ---------
     matrix: scipy.sparse.csr_matrix
-        A matrix containing a copy of the data from the original order 2 tensor t.
+        A matrix containing the data from the original order 2 tensor t.
 
     """
-    arrs = _cm.to_sp_matrix(t._tensor, True)
-    return csr_matrix((arrs[2], arrs[1], arrs[0]), shape=t.shape)
+    return _to_sp_matrix(t, copy, True)
 
 
-def to_sp_csc(t):
+def to_sp_csc(t, copy=True):
     """
 
     Converts a taco tensor to a scipy csc_matrix.
 
     Takes a matrix from taco in any format and converts the matrix to a scipy sparse csc matrix. This method removes
-    explicit zeros from the original taco tensor during the conversion.
+    explicit zeros from the original taco tensor during the conversion, unless the matrix is shared without a copy.
 
     Parameters
     -----------
@@ -743,20 +979,23 @@ def to_sp_csc(t):
         A taco tensor to convert to a scipy.csc_matrix array. The tensor must be of order 2 (i.e it must be a matrix).
         If the order of the tensor is not equal to 2, a value error is thrown.
 
+    copy: boolean, optional
+        If false and t is stored in the CSC format, the scipy matrix shares the (read only) index and value arrays of
+        t. Otherwise, the data is copied.
+
 
     Notes
     -------
-    The data and index values are always copied when making the scipy sparse array
+    The data and index values are copied when making the scipy sparse array unless copy is false and t is CSC.
 
 
     Returns
     ---------
     matrix: scipy.sparse.csc_matrix
-        A matrix containing a copy of the data from the original order 2 tensor t.
+        A matrix containing the data from the original order 2 tensor t.
 
 """
-    arrs = _cm.to_sp_matrix(t._tensor, False)
-    return csc_matrix((arrs[2], arrs[1], arrs[0]), shape=t.shape)
+    return _to_sp_matrix(t, copy, False)
 
 
 def as_tensor(obj, copy=True):
@@ -806,6 +1045,9 @@ def as_tensor(obj, copy=True):
     if isinstance(obj, csr_matrix):
         return from_sp_csr(obj, copy)
 
+    if isinstance(obj, coo_matrix):
+        return from_sp_coo(obj, copy)
+
     # Try converting object to numpy array. This will ignore the copy flag
     arr = np.array(obj)
     return from_array(arr, True)
@@ -135,9 +135,12 @@ static py::tuple toSpMatrix(Tensor<T> &tensor, bool tocsr) {
   }
 
   // Force computation of the tensor
-  tensor.pack();
-  if(tensor.needsCompute()){
-    tensor.evaluate();
+  {
+    py::gil_scoped_release release;
+    tensor.pack();
+    if(tensor.needsCompute()){
+      tensor.evaluate();
+    }
   }
 
   int *ptr, *idx;
@@ -201,6 +204,202 @@ static py::tuple toSpMatrix(Tensor<T> &tensor, bool tocsr) {
 
 }
 
+static py::dtype toNumpyDtype(const Datatype& type) {
+  switch (type.getKind()) {
+    case Datatype::Bool:    return py::dtype::of<bool>();
+    case Datatype::UInt8:   return py::dtype::of<uint8_t>();
+    case Datatype::UInt16:  return py::dtype::of<uint16_t>();
+    case Datatype::UInt32:  return py::dtype::of<uint32_t>();
+    case Datatype::UInt64:  return py::dtype::of<uint64_t>();
+    case Datatype::Int8:    return py::dtype::of<int8_t>();
+    case Datatype::Int16:   return py::dtype::of<int16_t>();
+    case Datatype::Int32:   return py::dtype::of<int32_t>();
+    case Datatype::Int64:   return py::dtype::of<int64_t>();
+    case Datatype::Float16: return py::dtype("float16");
+    case Datatype::Float32: return py::dtype::of<float>();
+    case Datatype::Float64: return py::dtype::of<double>();
+    default:
+      throw py::value_error("Cannot view arrays of type " + util::toString(type) + " from numpy");
+  }
+}
+
+// Returns a numpy array that views the data of a taco array without copying it. The numpy array holds a reference
+// to the taco array, so the data stays alive for as long as either the tensor storage or the view uses it.
+static py::array arrayView(const Array& array) {
+  const ssize_t itemsize = array.getType().getNumBytes();
+  py::capsule owner(new Array(array), [](void *a) {
+      delete static_cast<Array *>(a);
+  });
+  return py::array(toNumpyDtype(array.getType()), {(ssize_t)array.getSize()}, {itemsize}, array.getData(), owner);
+}
+
+template<typename T>
+static void forceEvaluation(Tensor<T> &tensor) {
+  py::gil_scoped_release release;
+  tensor.pack();
+  if(tensor.needsCompute()){
+    tensor.evaluate();
+  }
+}
+
+// Views of the index arrays of each level of a tensor: none for dense levels, [pos, crd] for compressed levels and
+// [crd] for singleton levels.
+template<typename T>
+static std::vector<std::vector<py::array>> getIndexArrays(Tensor<T> &tensor) {
+  forceEvaluation(tensor);
+
+  const Format& format = tensor.getFormat();
+  const Index& index = tensor.getStorage().getIndex();
+  std::vector<std::vector<py::array>> levels;
+  for(int i = 0; i < tensor.getOrder(); ++i) {
+    const ModeFormat modeType = format.getModeFormats()[i];
+    const ModeIndex& modeIndex = index.getModeIndex(i);
+    std::vector<py::array> arrays;
+    if(modeType.getName() == Sparse.getName()) {
+      arrays.push_back(arrayView(modeIndex.getIndexArray(0)));
+      arrays.push_back(arrayView(modeIndex.getIndexArray(1)));
+    } else if(modeType.getName() == Singleton.getName()) {
+      arrays.push_back(arrayView(modeIndex.getIndexArray(1)));
+    }
+    levels.push_back(arrays);
+  }
+  return levels;
+}
+
+template<typename T>
+static py::array getValuesArray(Tensor<T> &tensor) {
+  forceEvaluation(tensor);
+  return arrayView(tensor.getStorage().getValues());
+}
+
+static Array toIndexArray(py::array_t<int, py::array::c_style> &array, bool copy) {
+  py::buffer_info buf = array.request();
+  if(buf.ndim != 1) {
+    throw py::value_error("Index arrays must be 1D.");
+  }
+  if(copy) {
+    Array result = makeArray(type<int>(), buf.size);
+    memcpy(result.getData(), buf.ptr, buf.size * sizeof(int));
+    return result;
+  }
+  return Array(type<int>(), buf.ptr, buf.size, Array::UserOwns);
+}
+
+static void checkCoordinates(const Array& crd, int dimension, size_t level) {
+  const int* coords = (const int*)crd.getData();
+  for(size_t j = 0; j < crd.getSize(); ++j) {
+    if(coords[j] < 0 || coords[j] >= dimension) {
+      throw py::value_error("The crd array of level " + std::to_string(level) + " has coordinate " +
+                            std::to_string(coords[j]) + " outside of dimension " + std::to_string(dimension) + ".");
+    }
+  }
+}
+
+// Creates a tensor of the given format from the index arrays of each level (laid out as returned by getIndexArrays)
+// and its values. Without copy the tensor points to the numpy values, which the caller must keep alive.
+template<typename T>
+static Tensor<T> tensorFromArrays(const std::vector<int> &dims, const Format &fmt, std::vector<std::vector<Array>> &levels,
+                                  py::array_t<T, py::array::c_style> &values, bool copy) {
+  if((int)dims.size() != fmt.getOrder() || levels.size() != dims.size()) {
+    throw py::value_error("The shape, format and index arrays must have the same number of dimensions.");
+  }
+
+  Tensor<T> tensor(util::uniqueName("A"), dims, fmt);
+  const Format& format = tensor.getFormat();
+
+  std::vector<ModeIndex> modeIndices;
+  size_t numVals = 1;
+  for(size_t i = 0; i < dims.size(); ++i) {
+    const ModeFormat modeType = format.getModeFormats()[i];
+    const int dimension = dims[format.getModeOrdering()[i]];
+    auto& arrays = levels[i];
+    if(modeType.getName() == Dense.getName()) {
+      if(!arrays.empty()) {
+        throw py::value_error("Dense level " + std::to_string(i) + " takes no index arrays.");
+      }
+      modeIndices.push_back(ModeIndex({makeArray({dimension})}));
+      numVals *= dimension;
+    } else if(modeType.getName() == Sparse.getName()) {
+      if(arrays.size() != 2) {
+        throw py::value_error("Compressed level " + std::to_string(i) + " takes a pos and a crd array.");
+      }
+      const Array& pos = arrays[0];
+      const Array& crd = arrays[1];
+      if(pos.getSize() != numVals + 1 || (size_t)((int*)pos.getData())[numVals] != crd.getSize()) {
+        throw py::value_error("The pos and crd arrays of level " + std::to_string(i) + " have inconsistent sizes.");
+      }
+      const int* positions = (const int*)pos.getData();
+      if(positions[0] != 0) {
+        throw py::value_error("The pos array of level " + std::to_string(i) + " must start at 0.");
+      }
+      for(size_t j = 0; j < numVals; ++j) {
+        if(positions[j] > positions[j + 1]) {
+          throw py::value_error("The pos array of level " + std::to_string(i) + " must be non-decreasing.");
+        }
+      }
+      checkCoordinates(crd, dimension, i);
+      modeIndices.push_back(ModeIndex({pos, crd}));
+      numVals = crd.getSize();
+    } else if(modeType.getName() == Singleton.getName()) {
+      if(arrays.size() != 1) {
+        throw py::value_error("Singleton level " + std::to_string(i) + " takes a crd array.");
+      }
+      if(arrays[0].getSize() != numVals) {
+        throw py::value_error("The crd array of level " + std::to_string(i) + " has an inconsistent size.");
+      }
+      checkCoordinates(arrays[0], dimension, i);
+      modeIndices.push_back(ModeIndex({makeArray(type<int>(), 0), arrays[0]}));
+    } else {
+      throw py::value_error("Unsupported mode format " + modeType.getName());
+    }
+  }
+
+  py::buffer_info values_buf = values.request();
+  if(values_buf.ndim != 1 || (size_t)values_buf.size != numVals) {
+    throw py::value_error("Expected a 1D array of " + std::to_string(numVals) + " values.");
+  }
+  T *vals = static_cast<T *>(values_buf.ptr);
+  Array::Policy policy = Array::Policy::UserOwns;
+  if(copy) {
+    vals = new T[values_buf.size];
+    memcpy(vals, values_buf.ptr, values_buf.size * sizeof(T));
+    policy = Array::Policy::Delete;
+  }
+
+  TensorStorage& storage = tensor.getStorage();
+  storage.setIndex(Index(format, modeIndices));
+  storage.setValues(makeArray(vals, values_buf.size, policy));
+  tensor.setStorage(storage);
+  return tensor;
+}
+
+template<typename T>
+static Tensor<T> fromIndexArrays(const std::vector<int> &dims, const Format &fmt,
+                                 std::vector<std::vector<py::array_t<int, py::array::c_style>>> &indexArrays,
+                                 py::array_t<T, py::array::c_style> &values, bool copy) {
+  std::vector<std::vector<Array>> levels;
+  for(auto& arrays : indexArrays) {
+    levels.push_back({});
+    for(auto& array : arrays) {
+      levels.back().push_back(toIndexArray(array, copy));
+    }
+  }
+  return tensorFromArrays<T>(dims, fmt, levels, values, copy);
+}
+
+// Creates a COO matrix from the row and column coordinates of its nonzeros, which must be sorted by row and then
+// column and free of duplicates.
+template<typename T>
+static Tensor<T> fromSpCOO(py::array_t<int, py::array::c_style> &rows, py::array_t<int, py::array::c_style> &cols,
+                           py::array_t<T, py::array::c_style> &data, const std::vector<int> &dims, bool copy) {
+  Array pos = makeArray(type<int>(), 2);
+  ((int*)pos.getData())[0] = 0;
+  ((int*)pos.getData())[1] = (int)rows.size();
+
+  std::vector<std::vector<Array>> levels = {{pos, toIndexArray(rows, copy)}, {toIndexArray(cols, copy)}};
+  return tensorFromArrays<T>(dims, COO(2), levels, data, copy);
+}
+
 template<typename CType, typename idxVar>
 static inline Access accessGetter(Tensor<CType>& tensor, idxVar& var) {
   return tensor(var);
@@ -302,6 +501,10 @@ static void declareTensor(py::module &m, const std::string typestr) {
 
   m.def("fromSpMatrix", &fromSpMatrix<int, CType>);
 
+  m.def("fromSpCOO", &fromSpCOO<CType>);
+
+  m.def("fromIndexArrays", &fromIndexArrays<CType>);
+
   std::string pyClassName = std::string("Tensor") + typestr;
   py::class_<typedTensor, TensorBase>(m, pyClassName.c_str(), py::buffer_protocol())
 
@@ -329,9 +532,12 @@ static void declareTensor(py::module &m, const std::string typestr) {
               }
 
               // Force computation of the tensor
-              t.pack();
-              if(t.needsCompute()){
-                t.evaluate();
+              {
+                py::gil_scoped_release release;
+                t.pack();
+                if(t.needsCompute()){
+                  t.evaluate();
+                }
               }
 
               void *ptr = t.getStorage().getValues().getData();
@@ -376,16 +582,29 @@ static void declareTensor(py::module &m, const std::string typestr) {
 
           .def("format", &TensorBase::getFormat)
 
-          .def("pack", &typedTensor::pack)
+          // The lifecycle methods may run C compilers and long kernels, so they
+          // release the GIL to let other Python threads run meanwhile
+          .def("pack", &typedTensor::pack, py::call_guard<py::gil_scoped_release>())
 
           // only bind .compile(), not .compile(IndexStmt, bool)
-          .def("compile", [](typedTensor &self) { self.compile(); } )
+          .def("compile", [](typedTensor &self) { self.compile(); },
+               py::call_guard<py::gil_scoped_release>())
+
+          .def("assemble", &typedTensor::assemble, py::call_guard<py::gil_scoped_release>())
+
+          .def("evaluate", &typedTensor::evaluate, py::call_guard<py::gil_scoped_release>())
 
-          .def("assemble", &typedTensor::assemble)
+          .def("compute", &typedTensor::compute, py::call_guard<py::gil_scoped_release>())
 
-          .def("evaluate", &typedTensor::evaluate)
+          .def("get_index_arrays", &getIndexArrays<CType>)
 
-          .def("compute", &typedTensor::compute)
+          .def("get_values_array", &getValuesArray<CType>)
+
+          .def("freeze_index", &typedTensor::freezeIndex)
+
+          .def("unfreeze_index", &typedTensor::unfreezeIndex)
+
+          .def("is_index_frozen", &typedTensor::isIndexFrozen)
 
           .def("insert", &insert<CType>)
 
@@ -393,7 +612,7 @@ static void declareTensor(py::module &m, const std::string typestr) {
 
           .def("transpose", [](typedTensor &self, std::vector<int> dims, Format format, std::string name) -> typedTensor {
               return self.transpose(name, dims, format);
-          }, py::is_operator())
+          }, py::is_operator(), py::call_guard<py::gil_scoped_release>())
 
           .def("__getitem__", [](typedTensor& self, const int &index) -> CType {
                return elementGetter<CType>(self, {index});
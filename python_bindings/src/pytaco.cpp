@@ -6,6 +6,7 @@
 #include "pyTensor.h"
 #include "pyTensorIO.h"
 #include "pyParsers.h"
+#include "taco/instrumentation.h"
 
 
 void addHelpers(py::module &m) {
@@ -38,7 +39,7 @@ number_of_threads: int
 )");
 
 
-  m.def("set_num_threads", &taco::taco_set_num_threads, py::arg("num_threads"), R"(
+  m.def("set_num_threads", (void(*)(int)) &taco::taco_set_num_threads, py::arg("num_threads"), R"(
 set_num_threads(num_threads)
 
 Set the number of threads taco should use to perform computations.
@@ -139,6 +140,273 @@ schedule: tuple (string, int)
 
 )");
 
+  m.def("set_thread_placement", [](std::string placement) {
+    std::transform(placement.begin(), placement.end(), placement.begin(), ::tolower);
+
+    if (placement == "default") {
+      taco::taco_set_thread_placement(taco::ThreadPlacement::Default);
+    } else if (placement == "close") {
+      taco::taco_set_thread_placement(taco::ThreadPlacement::Close);
+    } else if (placement == "spread") {
+      taco::taco_set_thread_placement(taco::ThreadPlacement::Spread);
+    } else {
+      throw py::value_error(R"(Placement can only be "default", "close" or "spread")");
+    }
+  }, py::arg("placement"), R"(
+set_thread_placement(placement)
+
+Sets how the threads of parallel computations are placed on the NUMA nodes of the machine.
+
+Parameters
+-----------
+placement: string
+    "default" leaves placement to the operating system. "close" pins threads to the CPUs of one node before moving on
+    to the next node, and "spread" pins consecutive threads to different nodes. Threads are pinned when the next
+    kernel runs. Placement requires taco to be built with OpenMP and is ignored otherwise.
+
+Examples
+---------
+>>> import pytaco as pt
+>>> pt.set_num_threads(8)
+>>> pt.set_thread_placement("spread")
+)");
+
+  m.def("get_thread_placement", []() {
+    switch (taco::taco_get_thread_placement()) {
+      case taco::ThreadPlacement::Close:
+        return "close";
+      case taco::ThreadPlacement::Spread:
+        return "spread";
+      default:
+        return "default";
+    }
+  }, R"(
+get_thread_placement()
+
+Gets how the threads of parallel computations are placed ("default", "close" or "spread").
+)");
+
+  m.def("set_numa_first_touch", &taco::taco_set_numa_first_touch, py::arg("enabled"), R"(
+set_numa_first_touch(enabled)
+
+Enable or disable NUMA-aware first-touch initialization.
+
+When enabled, kernels zero-initialize results and temporaries in parallel with the same schedule as their
+computation, and packing copies the arrays of tensors in parallel, so that the memory each thread works on is placed on
+its own NUMA node. Affects kernels compiled and tensors packed afterwards, and requires taco to be built with OpenMP.
+
+Parameters
+-----------
+enabled: bool
+    Whether to initialize memory with the threads that compute with it.
+)");
+
+  m.def("get_numa_first_touch", &taco::taco_get_numa_first_touch, R"(
+get_numa_first_touch()
+
+Returns whether NUMA-aware first-touch initialization is enabled.
+)");
+
+  m.def("set_kernel_fusion", &taco::taco_set_kernel_fusion, py::arg("enabled"), R"(
+set_kernel_fusion(enabled)
+
+Enable or disable fusion of dependent tensor assignments.
+
+When enabled, evaluating a tensor whose expression multiplies by tensors that have not been computed yet computes
+the whole chain in one kernel, without materializing the intermediate tensors. For example, the intermediate ``T``
+below is never written to memory when ``A`` is evaluated. Fused intermediates are computed only if they are read.
+
+Examples
+---------
+>>> import pytaco as pt
+>>> pt.set_kernel_fusion(True)
+>>> i, j, k = pt.get_index_vars(3)
+>>> B = pt.tensor([10, 4], pt.dense)
+>>> C = pt.tensor([4, 10], pt.dense)
+>>> D = pt.tensor([10, 10], pt.csr)
+>>> T = pt.tensor([10, 10], pt.dense)
+>>> A = pt.tensor([10, 10], pt.csr)
+>>> T[i, j] = B[i, k] * C[k, j]
+>>> A[i, j] = T[i, j] * D[i, j]
+>>> A.evaluate()
+
+Parameters
+-----------
+enabled: bool
+    Whether to fuse dependent assignments.
+)");
+
+  m.def("get_kernel_fusion", &taco::taco_get_kernel_fusion, R"(
+get_kernel_fusion()
+
+Returns whether fusion of dependent tensor assignments is enabled.
+
+Returns
+--------
+enabled: bool
+    True if kernel fusion is enabled.
+)");
+
+  m.def("set_max_compile_threads", &taco::taco_set_max_compile_threads, py::arg("num_threads"), R"(
+set_max_compile_threads(num_threads)
+
+Sets the maximum number of C compilers that run at the same time.
+
+Threads that need to compile a kernel while that many compilers are running wait for one of them to finish.
+Threads that need the same kernel at the same time share a single compilation of it. Defaults to the
+``TACO_COMPILE_THREADS`` environment variable, or to half the number of hardware threads.
+
+Parameters
+-----------
+num_threads: int
+    The maximum number of concurrent compilations.
+)");
+
+  m.def("get_max_compile_threads", &taco::taco_get_max_compile_threads, R"(
+get_max_compile_threads()
+
+Returns the maximum number of C compilers that run at the same time.
+)");
+
+  m.def("set_background_compile", &taco::taco_set_background_compile, py::arg("enabled"), R"(
+set_background_compile(enabled)
+
+Enable or disable background compilation of kernels.
+
+While enabled, new kernels are compiled in the background and tensors are computed by interpreting the
+lowered kernels until the compiled kernels are loaded, so that the first evaluation of an expression does not
+wait for the C compiler. Kernels that cannot be interpreted wait for the compiler. Disabled by default.
+
+Parameters
+-----------
+enabled: bool
+    Whether kernels are compiled in the background.
+)");
+
+  m.def("get_background_compile", &taco::taco_get_background_compile, R"(
+get_background_compile()
+
+Returns whether kernels are compiled in the background.
+)");
+
+  m.def("set_interpreter_threshold", &taco::taco_set_interpreter_threshold, py::arg("work"), R"(
+set_interpreter_threshold(work)
+
+Sets the estimated work below which kernels are interpreted instead of compiled.
+
+The work of a kernel is estimated from the number of components stored by its operands and by the dense modes
+of its result. Kernels of problems smaller than the threshold run without invoking the C compiler. Defaults
+to the ``TACO_INTERPRETER_THRESHOLD`` environment variable, or to 0, which compiles every kernel.
+
+Parameters
+-----------
+work: int
+    The estimated work below which kernels are interpreted.
+)");
+
+  m.def("get_interpreter_threshold", &taco::taco_get_interpreter_threshold, R"(
+get_interpreter_threshold()
+
+Returns the estimated work below which kernels are interpreted instead of compiled.
+)");
+
+  m.def("set_instrumentation_enabled", &taco::setInstrumentationEnabled,
+        py::arg("enabled"), R"(
+set_instrumentation_enabled(enabled)
+
+Enable or disable collection of per-phase timings and counters.
+
+While enabled, taco times each phase of computing a tensor (packing, lowering, C compilation, assembly and
+computation) and counts kernel cache hits and misses as well as the bytes allocated by generated code for
+``pos``, ``crd`` and ``vals`` arrays. Instrumentation is disabled by default.
+
+Examples
+---------
+>>> import pytaco as pt
+>>> pt.set_instrumentation_enabled(True)
+>>> pt.is_instrumentation_enabled()
+True
+
+Parameters
+-----------
+enabled: bool
+    Whether to collect instrumentation data.
+)");
+
+  m.def("is_instrumentation_enabled", &taco::isInstrumentationEnabled, R"(
+is_instrumentation_enabled()
+
+Returns whether taco is collecting per-phase timings and counters.
+
+Returns
+--------
+enabled: bool
+    True if instrumentation is enabled.
+)");
+
+  m.def("reset_instrumentation", &taco::resetInstrumentation, R"(
+reset_instrumentation()
+
+Clears all phase timings and counters collected so far.
+)");
+
+  m.def("get_counters", [](){
+      py::dict counters;
+      for (auto& counter : taco::getCounters()) {
+        counters[py::str(counter.first)] = counter.second;
+      }
+      return counters;
+  }, R"(
+get_counters()
+
+Gets the instrumentation counters.
+
+Returns
+--------
+counters: dict
+    A dictionary mapping counter names (e.g. ``"kernel_cache.hits"`` or ``"alloc.vals_bytes"``) to their values.
+)");
+
+  m.def("get_phase_statistics", [](){
+      py::dict phases;
+      for (auto& phase : taco::getPhaseStatistics()) {
+        py::dict stats;
+        stats["count"] = phase.second.count;
+        stats["total_ms"] = phase.second.totalTime;
+        stats["min_ms"] = phase.second.minTime;
+        stats["max_ms"] = phase.second.maxTime;
+        phases[py::str(phase.first)] = stats;
+      }
+      return phases;
+  }, R"(
+get_phase_statistics()
+
+Gets timing statistics for each instrumented phase.
+
+Returns
+--------
+statistics: dict
+    A dictionary mapping phase names (e.g. ``"compile"``, ``"cc"`` or ``"compute"``) to dictionaries with the
+    number of times the phase ran (``"count"``) and its total, minimum and maximum time in milliseconds
+    (``"total_ms"``, ``"min_ms"`` and ``"max_ms"``).
+)");
+
+  m.def("get_chrome_trace", &taco::getChromeTrace, R"(
+get_chrome_trace()
+
+Gets the recorded phases and counters in the Chrome trace event format.
+
+Examples
+---------
+>>> import pytaco as pt
+>>> with open("taco-trace.json", "w") as f:
+...     f.write(pt.get_chrome_trace())
+
+Returns
+--------
+trace: str
+    A JSON string that can be loaded with chrome://tracing or Perfetto.
+)");
 
 }
 
@@ -108,6 +108,51 @@ class TestIO(unittest.TestCase):
         for ten, arr in zip(tens, arrs):
             self.assertTrue(np.array_equal(ten.to_array(), arr))
 
+    def test_zero_copy_sp(self):
+        arr = np.array([[1, 0, 2], [0, 0, 3]], dtype=np.float64)
+        csr = csr_matrix(arr)
+        t = pt.from_sp_csr(csr, copy=False)
+        _, (pos, crd) = t.get_index_arrays()
+        self.assertTrue(np.shares_memory(t.get_values_array(), csr.data))
+        self.assertTrue(np.array_equal(pos, csr.indptr))
+        self.assertTrue(np.array_equal(crd, csr.indices))
+
+        exported = t.to_sp_csr(copy=False)
+        self.assertTrue(np.shares_memory(exported.data, csr.data))
+        self.assertEqual((exported != csr).nnz, 0)
+
+        coo = csr.tocoo()
+        coo.row = coo.row.astype(np.int64)
+        self.assertEqual((pt.from_sp_coo(coo, copy=False).to_sp_csr() != csr).nnz, 0)
+
+    def test_zero_copy_index_arrays(self):
+        fmt = pt.format([pt.compressed, pt.dense, pt.compressed])
+        pos0 = np.array([0, 1], dtype=np.int32)
+        crd0 = np.array([1], dtype=np.int32)
+        pos2 = np.array([0, 1, 3], dtype=np.int32)
+        crd2 = np.array([0, 1, 2], dtype=np.int32)
+        vals = np.array([1.0, 2.0, 3.0])
+        t = pt.from_index_arrays([2, 2, 3], fmt, [[pos0, crd0], [], [pos2, crd2]], vals, copy=False)
+        self.assertEqual(t[1, 0, 0], 1.0)
+        self.assertEqual(t[1, 1, 2], 3.0)
+
+        levels = t.get_index_arrays()
+        self.assertEqual(len(levels[1]), 0)
+        self.assertTrue(np.shares_memory(levels[2][1], crd2))
+        self.assertTrue(np.shares_memory(t.get_values_array(), vals))
+        self.assertFalse(t.get_values_array().flags.writeable)
+
+    def test_invalid_index_arrays(self):
+        vals = np.array([1.0, 2.0, 3.0])
+        for pos, crd in [([1, 2, 3], [0, 2, 1]),   # pos does not start at 0
+                         ([0, 2, 2], [0, 2, 1]),   # pos does not end at the size of crd
+                         ([0, 4, 3], [0, 2, 1]),   # pos decreases
+                         ([0, 2, 3], [0, 3, 1]),   # crd out of bounds
+                         ([0, 2, 3], [0, -1, 1])]:
+            with self.assertRaises(ValueError):
+                pt.from_index_arrays([2, 3], pt.csr, [[], [np.array(pos, dtype=np.int32),
+                                                           np.array(crd, dtype=np.int32)]], vals)
+
     def test_iterator(self):
         in_components = [([0, 1], 1.0), ([2, 2], 2.0), ([2, 3], 3.0), ([4, 0], 4.0)]
         A = pt.tensor([5, 5], pt.csr)
@@ -256,6 +301,23 @@ class TestIndexFuncs(unittest.TestCase):
         t = pt.from_array(arr)
         self.assertEqual(-t, -arr)
 
+class TestAsyncEvaluation(unittest.TestCase):
+
+    def test_evaluate_async(self):
+        arr = np.arange(16).reshape([4, 4])
+        t = pt.from_array(arr)
+        i, j = pt.get_index_vars(2)
+        results = []
+        for k in range(4):
+            res = pt.tensor([4], pt.dense)
+            res[i] = t[i, j] * (k + 1)
+            results.append(res)
+
+        futures = [res.evaluate_async() for res in results]
+        for k, future in enumerate(futures):
+            self.assertIs(future.result(), results[k])
+            self.assertEqual(results[k], arr.sum(axis=1) * (k + 1))
+
 class testParsers(unittest.TestCase):
 
     def test_evaluate(self):
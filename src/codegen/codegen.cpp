@@ -70,7 +70,12 @@ bool CodeGen::checkForAlloc(const Function *func) {
 // helper to translate from taco type to C type
 string CodeGen::printCType(Datatype type, bool is_ptr) {
   stringstream ret;
-  ret << type;
+  // 16-bit floats are stored as their bits, since C has no type for them
+  if (type.getKind() == Float16 || type.getKind() == BFloat16) {
+    ret << "uint16_t";
+  } else {
+    ret << type;
+  }
 
   if (is_ptr) {
     ret << "*";
@@ -468,14 +473,18 @@ void CodeGen::resetUniqueNameCounters() {
 }
 
 string CodeGen::genUniqueName(string name) {
-  stringstream os;
-  os << name;
-  if (uniqueNameCounters.count(name) > 0) {
-    os << uniqueNameCounters[name]++;
-  } else {
+  if (uniqueNameCounters.count(name) == 0) {
     uniqueNameCounters[name] = 0;
-  }
-  return os.str();
+    return name;
+  }
+  // Skip numbered names that are taken, e.g. `i0` when `i` is numbered and
+  // a loop over `i0` exists
+  string uniqueName;
+  do {
+    uniqueName = name + to_string(uniqueNameCounters[name]++);
+  } while (uniqueNameCounters.count(uniqueName) > 0);
+  uniqueNameCounters[uniqueName] = 0;
+  return uniqueName;
 }
 
 static vector<const GetProperty*> sortProps(std::map<Expr, std::string, ExprCompare> map) {
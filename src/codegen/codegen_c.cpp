@@ -2,12 +2,16 @@
 #include <fstream>
 #include <dlfcn.h>
 #include <algorithm>
+#include <set>
 #include <unordered_set>
 #include <taco.h>
 
 #include "taco/ir/ir_visitor.h"
+#include "taco/ir/simplify.h"
 #include "codegen_c.h"
+#include "kernel_profiler.h"
 #include "taco/error.h"
+#include "taco/instrumentation.h"
 #include "taco/util/strings.h"
 #include "taco/util/collections.h"
 
@@ -23,7 +27,13 @@ namespace {
 // stdlib.h for malloc/realloc
 // math.h for sqrt
 // MIN preprocessor macro
-// This *must* be kept in sync with taco_tensor_t.h
+// This *must* be kept in sync with taco_tensor_t.h, taco_allocator_t.h and
+// taco_scheduler_t.h.
+// Generated code allocates through the taco_allocator (results) and
+// taco_temporary_allocator (temporaries) tables, which ir::Module points at
+// taco's allocators when it loads the code, and otherwise uses malloc.
+// Similarly, parallel loops ask taco_get_scheduler for a scheduler to run
+// them on, and otherwise run with OpenMP.
 const string cHeaders =
   "#ifndef TACO_C_HEADERS\n"
   "#define TACO_C_HEADERS\n"
@@ -51,9 +61,205 @@ const string cHeaders =
   "  int32_t      vals_size;     // values array size\n"
   "} taco_tensor_t;\n"
   "#endif\n"
+  "#ifndef TACO_ALLOCATOR_T_DEFINED\n"
+  "#define TACO_ALLOCATOR_T_DEFINED\n"
+  "typedef struct taco_allocator_t {\n"
+  "  void* (*alloc)(void* context, size_t size, size_t alignment);\n"
+  "  void* (*realloc)(void* context, void* ptr, size_t size, size_t alignment);\n"
+  "  void  (*free)(void* context, void* ptr);\n"
+  "  size_t alignment;\n"
+  "  void*  context;\n"
+  "} taco_allocator_t;\n"
+  "#endif\n"
+  "taco_allocator_t* taco_allocator = NULL;\n"
+  "taco_allocator_t* taco_temporary_allocator = NULL;\n"
+  "void* taco_alloc(taco_allocator_t* allocator, size_t size) {\n"
+  "  if (allocator == NULL) {\n"
+  "    return malloc(size);\n"
+  "  }\n"
+  "  return allocator->alloc(allocator->context, size, allocator->alignment);\n"
+  "}\n"
+  "void* taco_realloc(taco_allocator_t* allocator, void* ptr, size_t size) {\n"
+  "  if (allocator == NULL) {\n"
+  "    return realloc(ptr, size);\n"
+  "  }\n"
+  "  return allocator->realloc(allocator->context, ptr, size, allocator->alignment);\n"
+  "}\n"
+  "void taco_free(taco_allocator_t* allocator, void* ptr) {\n"
+  "  if (allocator == NULL) {\n"
+  "    free(ptr);\n"
+  "  } else {\n"
+  "    allocator->free(allocator->context, ptr);\n"
+  "  }\n"
+  "}\n"
+  "#ifndef TACO_SCHEDULER_T_DEFINED\n"
+  "#define TACO_SCHEDULER_T_DEFINED\n"
+  "typedef void (*taco_task_t)(void* closure, int64_t begin, int64_t end);\n"
+  "typedef struct taco_scheduler_t {\n"
+  "  void (*parallel_for)(void* context, int64_t begin, int64_t end,\n"
+  "                       taco_task_t task, void* closure);\n"
+  "  void* context;\n"
+  "} taco_scheduler_t;\n"
+  "#endif\n"
+  "taco_scheduler_t* (*taco_get_scheduler)(void) = NULL;\n"
+  "taco_scheduler_t* taco_current_scheduler(void) {\n"
+  "  return taco_get_scheduler == NULL ? NULL : taco_get_scheduler();\n"
+  "}\n"
+  "void* taco_calloc_temporary(size_t num, size_t size) {\n"
+  "  void* ptr = taco_alloc(taco_temporary_allocator, num * size);\n"
+  "  memset(ptr, 0, num * size);\n"
+  "  return ptr;\n"
+  "}\n"
   "int cmp(const void *a, const void *b) {\n"
   "  return *((const int*)a) - *((const int*)b);\n"
   "}\n"
+  "uint64_t taco_guard_bit(int32_t coord) {\n"
+  "  return (uint64_t)1 << (coord & 63);\n"
+  "}\n"
+  "// 16-bit floats are stored as their bits and computed in single precision.\n"
+  "// The conversions are static so that they are inlined into kernels.\n"
+  "#if defined(__F16C__)\n"
+  "#include <immintrin.h>\n"
+  "static inline float taco_half_to_float(uint16_t h) {\n"
+  "  return _cvtsh_ss(h);\n"
+  "}\n"
+  "static inline uint16_t taco_float_to_half(float f) {\n"
+  "  return _cvtss_sh(f, 0);\n"
+  "}\n"
+  "#else\n"
+  "static inline float taco_half_to_float(uint16_t h) {\n"
+  "  uint32_t bits = (uint32_t)(h & 0x7fff) << 13;\n"
+  "  uint32_t exponent = bits & (0x7c00u << 13);\n"
+  "  bits += (uint32_t)(127 - 15) << 23;\n"
+  "  float f;\n"
+  "  if (exponent == (0x7c00u << 13)) {\n"
+  "    bits += (uint32_t)(128 - 16) << 23;\n"
+  "  } else if (exponent == 0) {\n"
+  "    uint32_t magic = 113u << 23;\n"
+  "    float m;\n"
+  "    bits += 1u << 23;\n"
+  "    memcpy(&f, &bits, sizeof(f));\n"
+  "    memcpy(&m, &magic, sizeof(m));\n"
+  "    f -= m;\n"
+  "    memcpy(&bits, &f, sizeof(f));\n"
+  "  }\n"
+  "  bits |= (uint32_t)(h & 0x8000) << 16;\n"
+  "  memcpy(&f, &bits, sizeof(f));\n"
+  "  return f;\n"
+  "}\n"
+  "static inline uint16_t taco_float_to_half(float f) {\n"
+  "  uint32_t bits;\n"
+  "  memcpy(&bits, &f, sizeof(f));\n"
+  "  uint32_t sign = bits & 0x80000000u;\n"
+  "  uint16_t h;\n"
+  "  bits ^= sign;\n"
+  "  if (bits >= (143u << 23)) {\n"
+  "    h = (bits > (255u << 23)) ? 0x7e00 : 0x7c00;\n"
+  "  } else if (bits < (113u << 23)) {\n"
+  "    uint32_t magic = 126u << 23;\n"
+  "    float m;\n"
+  "    memcpy(&f, &bits, sizeof(f));\n"
+  "    memcpy(&m, &magic, sizeof(m));\n"
+  "    f += m;\n"
+  "    memcpy(&bits, &f, sizeof(f));\n"
+  "    h = (uint16_t)(bits - magic);\n"
+  "  } else {\n"
+  "    bits += ((uint32_t)(15 - 127) << 23) + 0xfff + ((bits >> 13) & 1);\n"
+  "    h = (uint16_t)(bits >> 13);\n"
+  "  }\n"
+  "  return h | (uint16_t)(sign >> 16);\n"
+  "}\n"
+  "#endif\n"
+  "static inline float taco_bfloat16_to_float(uint16_t h) {\n"
+  "  uint32_t bits = (uint32_t)h << 16;\n"
+  "  float f;\n"
+  "  memcpy(&f, &bits, sizeof(f));\n"
+  "  return f;\n"
+  "}\n"
+  "static inline uint16_t taco_float_to_bfloat16(float f) {\n"
+  "  uint32_t bits;\n"
+  "  memcpy(&bits, &f, sizeof(f));\n"
+  "  if ((bits & 0x7fffffffu) > (255u << 23)) {\n"
+  "    return (uint16_t)((bits >> 16) | 0x40);\n"
+  "  }\n"
+  "  bits += 0x7fff + ((bits >> 16) & 1);\n"
+  "  return (uint16_t)(bits >> 16);\n"
+  "}\n"
+  "void taco_insertion_sort(int32_t* list, int32_t size) {\n"
+  "  for (int32_t i = 1; i < size; i++) {\n"
+  "    int32_t value = list[i];\n"
+  "    int32_t j = i;\n"
+  "    for (; j > 0 && list[j - 1] > value; j--) {\n"
+  "      list[j] = list[j - 1];\n"
+  "    }\n"
+  "    list[j] = value;\n"
+  "  }\n"
+  "}\n"
+  "void taco_radix_sort(int32_t* list, int32_t size, int shift) {\n"
+  "  if (size <= 32) {\n"
+  "    taco_insertion_sort(list, size);\n"
+  "    return;\n"
+  "  }\n"
+  "  int32_t next[256] = {0};\n"
+  "  int32_t end[256];\n"
+  "  for (int32_t i = 0; i < size; i++) {\n"
+  "    next[(list[i] >> shift) & 255]++;\n"
+  "  }\n"
+  "  int32_t begin = 0;\n"
+  "  for (int b = 0; b < 256; b++) {\n"
+  "    end[b] = begin + next[b];\n"
+  "    next[b] = begin;\n"
+  "    begin = end[b];\n"
+  "  }\n"
+  "  for (int b = 0; b < 256; b++) {\n"
+  "    while (next[b] < end[b]) {\n"
+  "      int32_t value = list[next[b]];\n"
+  "      int digit = (value >> shift) & 255;\n"
+  "      while (digit != b) {\n"
+  "        int32_t displaced = list[next[digit]];\n"
+  "        list[next[digit]++] = value;\n"
+  "        value = displaced;\n"
+  "        digit = (value >> shift) & 255;\n"
+  "      }\n"
+  "      list[next[b]++] = value;\n"
+  "    }\n"
+  "  }\n"
+  "  if (shift > 0) {\n"
+  "    begin = 0;\n"
+  "    for (int b = 0; b < 256; b++) {\n"
+  "      taco_radix_sort(list + begin, end[b] - begin, shift - 8);\n"
+  "      begin = end[b];\n"
+  "    }\n"
+  "  }\n"
+  "}\n"
+  "// Orders the coordinates of a workspace in [0, dimension) whose bits are set\n"
+  "// in `guard`.  Rows with many coordinates relative to the dimension are\n"
+  "// rebuilt by scanning the guard bits in order, and others are radix sorted.\n"
+  "int32_t taco_sort_index_list(int32_t* list, int32_t size,\n"
+  "                             const uint64_t* guard, int32_t dimension) {\n"
+  "  int32_t words = (dimension + 63) / 64;\n"
+  "  if ((int64_t)size * 4 >= words) {\n"
+  "    int32_t p = 0;\n"
+  "    for (int32_t word = 0; word < words; word++) {\n"
+  "      for (uint64_t bits = guard[word]; bits != 0; bits &= bits - 1) {\n"
+  "#if defined(__GNUC__)\n"
+  "        int bit = __builtin_ctzll(bits);\n"
+  "#else\n"
+  "        int bit = 0;\n"
+  "        while (!((bits >> bit) & 1)) bit++;\n"
+  "#endif\n"
+  "        list[p++] = word * 64 + bit;\n"
+  "      }\n"
+  "    }\n"
+  "    return p;\n"
+  "  }\n"
+  "  int shift = 0;\n"
+  "  while (shift + 8 < 31 && ((dimension - 1) >> (shift + 8)) != 0) {\n"
+  "    shift += 8;\n"
+  "  }\n"
+  "  taco_radix_sort(list, size, shift);\n"
+  "  return size;\n"
+  "}\n"
   "int taco_binarySearchAfter(int *array, int arrayStart, int arrayEnd, int target) {\n"
   "  if (array[arrayStart] >= target) {\n"
   "    return arrayStart;\n"
@@ -132,6 +338,15 @@ const string cHeaders =
   "  free(t);\n"
   "}\n"
   "#endif\n";
+
+// Runtime support for kernels instrumented with profiling counters
+const string profileHeaders =
+  "#ifdef _OPENMP\n"
+  "#include <omp.h>\n"
+  "#define TACO_THREAD_NUM() omp_get_thread_num()\n"
+  "#else\n"
+  "#define TACO_THREAD_NUM() 0\n"
+  "#endif\n";
 } // anonymous namespace
 
 // find variables for generating declarations
@@ -233,7 +448,9 @@ protected:
 };
 
 CodeGen_C::CodeGen_C(std::ostream &dest, OutputKind outputKind, bool simplify)
-    : CodeGen(dest, false, simplify, C), out(dest), outputKind(outputKind) {}
+    : CodeGen(dest, false, simplify, C), out(dest), outputKind(outputKind),
+      instrumentAllocations(isInstrumentationEnabled()),
+      profileKernels(isKernelProfilingEnabled()) {}
 
 CodeGen_C::~CodeGen_C() {}
 
@@ -244,12 +461,52 @@ void CodeGen_C::compile(Stmt stmt, bool isFirst) {
   if (isFirst) {
     // output the headers
     out << cHeaders;
+    if (instrumentAllocations && outputKind == ImplementationGen) {
+      out << "int64_t " << allocStatsName << "[" << AllocStatCount << "];\n";
+    }
+    if (profileKernels && outputKind == ImplementationGen) {
+      out << profileHeaders;
+    }
   }
   out << endl;
+
+  if (profileKernels && outputKind == ImplementationGen && isa<Function>(stmt)) {
+    KernelProfiler profiler;
+    stmt = profiler.instrument(stmt);
+    printProfileDecls(to<Function>(stmt)->name, profiler.getCounterNames());
+  }
+
   // generate code for the Stmt
   stmt.accept(this);
 }
 
+static string escapeCString(const string& str) {
+  string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += (c == '\n') ? ' ' : c;
+  }
+  return escaped;
+}
+
+void CodeGen_C::printProfileDecls(const string& funcName,
+                                  const vector<string>& counterNames) {
+  out << "int32_t " << getProfileSizeName(funcName) << " = "
+      << counterNames.size() << ";\n";
+  if (counterNames.empty()) {
+    return;
+  }
+  out << "int64_t " << getProfileBufferName(funcName) << "["
+      << counterNames.size() << "];\n";
+  out << "const char* " << getProfileNamesName(funcName) << "[] = {\n";
+  for (auto& name : counterNames) {
+    out << "  \"" << escapeCString(name) << "\",\n";
+  }
+  out << "};\n";
+}
+
 void CodeGen_C::visit(const Function* func) {
   // if generating a header, protect the function declaration with a guard
   if (outputKind == HeaderGen) {
@@ -262,6 +519,26 @@ void CodeGen_C::visit(const Function* func) {
   funcName = func->name;
   labelCount = 0;
 
+  // Outline parallel loops that can run on a scheduler, printing the body that
+  // the loops were found in
+  Stmt body = func->body;
+  if (isa<Scope>(body)) {
+    body = to<Scope>(body)->scopedStmt;
+  }
+  if (simplify) {
+    // Index arithmetic is hoisted and reused here since the C compiler often
+    // cannot, as stores may alias the index arrays of the tensors
+    body = ir::simplify(body);
+    body = ir::hoistLoopInvariants(body);
+    body = ir::reduceStrength(body);
+    body = ir::eliminateCommonSubexpressions(body);
+    body = ir::simplify(body);
+  }
+  taskLoops.clear();
+  if (outputKind == ImplementationGen && !emittingCoroutine && !profileKernels) {
+    out << printTasks(func, body);
+  }
+
   resetUniqueNameCounters();
   FindVars inputVarFinder(func->inputs, {}, this);
   func->body.accept(&inputVarFinder);
@@ -286,7 +563,7 @@ void CodeGen_C::visit(const Function* func) {
   // find all the vars that are not inputs or outputs and declare them
   resetUniqueNameCounters();
   FindVars varFinder(func->inputs, func->outputs, this);
-  func->body.accept(&varFinder);
+  body.accept(&varFinder);
   varMap = varFinder.varMap;
   localVars = varFinder.localVars;
 
@@ -299,7 +576,7 @@ void CodeGen_C::visit(const Function* func) {
   }
 
   // output body
-  print(func->body);
+  body.accept(this);
 
   // output repack only if we allocated memory
   if (checkForAlloc(func))
@@ -317,6 +594,195 @@ void CodeGen_C::visit(const Function* func) {
   out << "}\n";
 }
 
+static bool isParallelLoop(const For* op) {
+  switch (op->kind) {
+    case LoopKind::Static:
+    case LoopKind::Dynamic:
+    case LoopKind::Runtime:
+    case LoopKind::Static_Chunked:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Finds the outermost parallel loops of a statement.
+struct FindParallelLoops : public IRVisitor {
+  using IRVisitor::visit;
+  vector<const For*> loops;
+
+  void visit(const For* op) {
+    if (isParallelLoop(op)) {
+      loops.push_back(op);
+    } else {
+      IRVisitor::visit(op);
+    }
+  }
+};
+
+/// Finds the variables that the body of a parallel loop uses but does not
+/// declare, which a task function must capture, and whether the loop can run
+/// as tasks. Captured variables are copied into the task, so the loop may not
+/// assign to them, and updates that rely on OpenMP atomics must stay in OpenMP
+/// parallel regions.
+struct FindCaptures : public IRVisitor {
+  using IRVisitor::visit;
+  vector<Expr> uses;
+  set<Expr> declared;
+  vector<Expr> assigned;
+  bool canRunAsTasks = true;
+
+  void use(Expr expr) {
+    if (!util::contains(uses, expr)) {
+      uses.push_back(expr);
+    }
+  }
+
+  void visit(const Var* op) {
+    use(op);
+  }
+
+  void visit(const GetProperty* op) {
+    use(op);
+  }
+
+  void visit(const VarDecl* op) {
+    declared.insert(op->var);
+    op->rhs.accept(this);
+  }
+
+  void visit(const For* op) {
+    declared.insert(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Assign* op) {
+    canRunAsTasks = canRunAsTasks && !op->use_atomics;
+    assigned.push_back(op->lhs);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Store* op) {
+    canRunAsTasks = canRunAsTasks && !op->use_atomics;
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Allocate* op) {
+    assigned.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Free* op) {
+    assigned.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Yield*) {
+    canRunAsTasks = false;
+  }
+
+  void visit(const Sort*) {
+    canRunAsTasks = false;
+  }
+};
+
+string CodeGen_C::printTasks(const Function* func, Stmt body) {
+  resetUniqueNameCounters();
+  FindVars varFinder(func->inputs, func->outputs, this);
+  body.accept(&varFinder);
+
+  FindParallelLoops loopFinder;
+  body.accept(&loopFinder);
+
+  stringstream tasks;
+  for (const For* loop : loopFinder.loops) {
+    auto increment = loop->increment.as<Literal>();
+    if (increment == nullptr || !increment->equalsScalar(1)) {
+      continue;
+    }
+    FindCaptures captureFinder;
+    captureFinder.declared.insert(loop->var);
+    loop->contents.accept(&captureFinder);
+    bool canRunAsTasks = captureFinder.canRunAsTasks;
+    for (auto& var : captureFinder.assigned) {
+      canRunAsTasks = canRunAsTasks && util::contains(captureFinder.declared,
+                                                      var);
+    }
+    if (!canRunAsTasks) {
+      continue;
+    }
+
+    // Capture each variable once, by name
+    TaskLoop task;
+    task.name = funcName + "_task" + util::toString(taskLoops.size());
+    vector<string> types;
+    for (auto& expr : captureFinder.uses) {
+      if (util::contains(captureFinder.declared, expr) ||
+          varFinder.varMap.count(expr) == 0 ||
+          util::contains(task.captures, varFinder.varMap.at(expr))) {
+        continue;
+      }
+      string type;
+      if (auto var = expr.as<Var>()) {
+        type = var->is_tensor ? "taco_tensor_t*"
+                              : printType(var->type, var->is_ptr);
+      } else {
+        auto property = expr.as<GetProperty>();
+        switch (property->property) {
+          case TensorProperty::Values:
+            type = printType(property->tensor.type(), true);
+            break;
+          case TensorProperty::Indices:
+            type = "int*";
+            break;
+          default:
+            type = "int";
+            break;
+        }
+      }
+      task.captures.push_back(varFinder.varMap.at(expr));
+      types.push_back(type);
+    }
+
+    tasks << "struct " << task.name << "_closure {\n";
+    for (size_t i = 0; i < types.size(); i++) {
+      tasks << "  " << types[i] << " " << task.captures[i] << ";\n";
+    }
+    if (types.empty()) {
+      tasks << "  char unused;\n";
+    }
+    tasks << "};\n";
+
+    // Print the loop body as a function that runs a chunk of the loop
+    tasks << "static void " << task.name << "(void* closure, int64_t begin, "
+          << "int64_t end) {\n";
+    tasks << "  struct " << task.name << "_closure* taco_closure = (struct "
+          << task.name << "_closure*)closure;\n";
+    for (size_t i = 0; i < types.size(); i++) {
+      const bool isPtr = types[i].back() == '*' && types[i] != "taco_tensor_t*";
+      tasks << "  " << types[i] << (isPtr ? " " + restrictKeyword() : "")
+            << " " << task.captures[i] << " = taco_closure->"
+            << task.captures[i] << ";\n";
+    }
+    const string loopVar = varFinder.varMap.at(loop->var);
+    tasks << "  for (" << loop->var.type() << " " << loopVar << " = begin; "
+          << loopVar << " < end; " << loopVar << "++) {\n";
+    CodeGen_C taskGen(tasks, ImplementationGen, simplify);
+    taskGen.varMap = varFinder.varMap;
+    taskGen.localVars = varFinder.localVars;
+    taskGen.funcName = funcName;
+    taskGen.emittingCoroutine = false;
+    taskGen.emittingTask = true;
+    taskGen.indent = 1;
+    loop->contents.accept(&taskGen);
+    tasks << "  }\n";
+    tasks << "}\n\n";
+
+    taskLoops.insert({loop, task});
+  }
+  return tasks.str();
+}
+
 void CodeGen_C::visit(const VarDecl* op) {
   if (emittingCoroutine) {
     doIndent();
@@ -396,6 +862,49 @@ static string getAtomicPragma() {
 // Docs for vectorization pragmas:
 // http://clang.llvm.org/docs/LanguageExtensions.html#extensions-for-loop-hint-optimizations
 void CodeGen_C::visit(const For* op) {
+  if (!util::contains(taskLoops, op)) {
+    printFor(op);
+    return;
+  }
+
+  // Run the loop on the scheduler of the calling thread if there is one
+  const TaskLoop& task = taskLoops.at(op);
+  doIndent();
+  stream << "{\n";
+  indent++;
+  doIndent();
+  stream << "taco_scheduler_t* taco_scheduler = taco_current_scheduler();\n";
+  doIndent();
+  stream << keywordString("if") << " (taco_scheduler != NULL) {\n";
+  indent++;
+  doIndent();
+  stream << "struct " << task.name << "_closure taco_closure = {"
+         << (task.captures.empty() ? "0" : util::join(task.captures, ", "))
+         << "};\n";
+  doIndent();
+  stream << "taco_scheduler->parallel_for(taco_scheduler->context, ";
+  parentPrecedence = BOTTOM;
+  op->start.accept(this);
+  stream << ", ";
+  parentPrecedence = BOTTOM;
+  op->end.accept(this);
+  stream << ", " << task.name << ", &taco_closure);\n";
+  indent--;
+  doIndent();
+  stream << "}\n";
+  doIndent();
+  stream << keywordString("else") << " {\n";
+  indent++;
+  printFor(op);
+  indent--;
+  doIndent();
+  stream << "}\n";
+  indent--;
+  doIndent();
+  stream << "}\n";
+}
+
+void CodeGen_C::printFor(const For* op) {
   switch (op->kind) {
     case LoopKind::Vectorized:
       doIndent();
@@ -406,9 +915,11 @@ void CodeGen_C::visit(const For* op) {
     case LoopKind::Dynamic:
     case LoopKind::Runtime:
     case LoopKind::Static_Chunked:
-      doIndent();
-      out << getParallelizePragma(op->kind);
-      out << "\n";
+      if (!emittingTask) {
+        doIndent();
+        out << getParallelizePragma(op->kind);
+        out << "\n";
+      }
       break;
     default:
       if (op->unrollFactor > 0) {
@@ -505,18 +1016,22 @@ void CodeGen_C::visit(const Max* op) {
 void CodeGen_C::visit(const Allocate* op) {
   string elementType = printCType(op->var.type(), false);
 
+  // Tensor arrays are allocated with the result allocator and everything else
+  // (workspaces) with the temporary allocator
+  const string allocator = isa<GetProperty>(op->var) ? "taco_allocator"
+                                                     : "taco_temporary_allocator";
   doIndent();
   op->var.accept(this);
   stream << " = (";
   stream << elementType << "*";
   stream << ")";
   if (op->is_realloc) {
-    stream << "realloc(";
+    stream << "taco_realloc(" << allocator << ", ";
     op->var.accept(this);
     stream << ", ";
   }
   else {
-    stream << "malloc(";
+    stream << "taco_alloc(" << allocator << ", ";
   }
   stream << "sizeof(" << elementType << ")";
   stream << " * ";
@@ -525,6 +1040,52 @@ void CodeGen_C::visit(const Allocate* op) {
   parentPrecedence = TOP;
   stream << ");";
     stream << endl;
+
+  if (instrumentAllocations) {
+    AllocStat stat = AllocStatOtherBytes;
+    if (const GetProperty* property = op->var.as<GetProperty>()) {
+      if (property->property == TensorProperty::Values) {
+        stat = AllocStatValsBytes;
+      } else if (property->property == TensorProperty::Indices) {
+        stat = (property->index == 0) ? AllocStatPosBytes : AllocStatCrdBytes;
+      }
+    }
+    // Statistics are updated with atomic adds, since kernels may allocate in
+    // parallel loops and be called concurrently. Reallocations count the bytes
+    // they grow (or shrink) arrays by.
+    doIndent();
+    stream << "__atomic_fetch_add(&" << allocStatsName << "[" << stat
+           << "], (int64_t)sizeof(" << elementType << ") * ";
+    if (op->is_realloc && op->old_elements.defined()) {
+      stream << "((";
+      parentPrecedence = TOP;
+      op->num_elements.accept(this);
+      stream << ") - (";
+      parentPrecedence = TOP;
+      op->old_elements.accept(this);
+      stream << "))";
+    } else {
+      parentPrecedence = MUL;
+      op->num_elements.accept(this);
+    }
+    parentPrecedence = TOP;
+    stream << ", __ATOMIC_RELAXED);" << endl;
+    if (op->is_realloc) {
+      doIndent();
+      stream << "__atomic_fetch_add(&" << allocStatsName << "["
+             << AllocStatReallocs << "], 1, __ATOMIC_RELAXED);" << endl;
+    }
+  }
+}
+
+void CodeGen_C::visit(const Free* op) {
+  // Kernels only free their temporaries
+  doIndent();
+  stream << "taco_free(taco_temporary_allocator, ";
+  parentPrecedence = Precedence::TOP;
+  op->var.accept(this);
+  stream << ");";
+  stream << endl;
 }
 
 void CodeGen_C::visit(const Sqrt* op) {
@@ -545,6 +1106,24 @@ void CodeGen_C::visit(const Assign* op) {
 
 void CodeGen_C::visit(const Store* op) {
   if (op->use_atomics) {
+    // Integer increments are emitted as atomic adds, which are atomic whether
+    // or not the kernel is compiled with OpenMP
+    const Add* add = op->data.as<Add>();
+    const Load* load = (add != nullptr) ? add->a.as<Load>() : nullptr;
+    if (load != nullptr && op->data.type().isInt() &&
+        load->arr.ptr == op->arr.ptr && load->loc.ptr == op->loc.ptr) {
+      doIndent();
+      stream << "__atomic_fetch_add(&";
+      op->arr.accept(this);
+      stream << "[";
+      parentPrecedence = Precedence::TOP;
+      op->loc.accept(this);
+      stream << "], ";
+      parentPrecedence = Precedence::TOP;
+      add->b.accept(this);
+      stream << ", __ATOMIC_RELAXED);" << endl;
+      return;
+    }
     doIndent();
     stream << getAtomicPragma() << endl;
   }
@@ -564,7 +1143,7 @@ void CodeGen_C::generateShim(const Stmt& func, stringstream &ret) {
   if (returnType.second != Datatype()) {
     ret << "(void**)(parameterPack[0]), ";
     ret << "(char*)(parameterPack[1]), ";
-    ret << "(" << returnType.second << "*)(parameterPack[2]), ";
+    ret << "(" << printCType(returnType.second, true) << ")(parameterPack[2]), ";
     ret << "(int32_t*)(parameterPack[3])";
 
     i = 4;
@@ -11,6 +11,14 @@ namespace taco {
 namespace ir {
 
 
+/// Name of the array of allocation statistics that instrumented kernels
+/// update, and the meaning of its entries.
+const std::string allocStatsName = "taco_alloc_stats";
+enum AllocStat {
+  AllocStatPosBytes, AllocStatCrdBytes, AllocStatValsBytes, AllocStatOtherBytes,
+  AllocStatReallocs, AllocStatCount
+};
+
 class CodeGen_C : public CodeGen {
 public:
   /// Initialize a code generator that generates code to an
@@ -38,6 +46,7 @@ protected:
   void visit(const Min*);
   void visit(const Max*);
   void visit(const Allocate*);
+  void visit(const Free*);
   void visit(const Sqrt*);
   void visit(const Store*);
   void visit(const Assign*);
@@ -52,6 +61,37 @@ protected:
   int labelCount;
   bool emittingCoroutine;
 
+  /// True if allocations should update the allocation statistics array.
+  bool instrumentAllocations;
+
+  /// True if functions should be instrumented with profiling counters.
+  bool profileKernels;
+
+  /// Declare the profiling counters of an instrumented function.
+  void printProfileDecls(const std::string& funcName,
+                         const std::vector<std::string>& counterNames);
+
+  /// A parallel loop that is outlined into a task function, so that it can
+  /// run on a scheduler, and the variables that it captures.
+  struct TaskLoop {
+    std::string name;
+    std::vector<std::string> captures;
+  };
+
+  /// The outlined parallel loops of the function being generated.
+  std::map<const For*, TaskLoop> taskLoops;
+
+  /// True while generating the body of a task function, where parallel loops
+  /// run serially.
+  bool emittingTask = false;
+
+  /// Outline the parallel loops of a function body that can run on a
+  /// scheduler into task functions, and return their code.
+  std::string printTasks(const Function* func, Stmt body);
+
+  /// Print a for loop, with its loop pragma.
+  void printFor(const For* op);
+
   class FindVars;
 
 private:
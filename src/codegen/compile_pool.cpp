@@ -0,0 +1,114 @@
+#include "codegen/compile_pool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "taco/error.h"
+#include "taco/util/env.h"
+
+using namespace std;
+
+namespace taco {
+namespace ir {
+
+struct CompilePool::Content {
+  mutex queueMutex;
+  condition_variable queueCondition;
+  deque<packaged_task<void()>> queue;
+  vector<thread> workers;
+  int maxWorkers;
+  int activeWorkers = 0;  ///< workers that have not exited
+  int idleWorkers = 0;    ///< workers waiting for a job
+  bool stop = false;
+
+  /// Run queued jobs until the pool is stopped or shrunk below the number of
+  /// active workers. Must be called with the queue mutex held.
+  void work(unique_lock<mutex>& lock) {
+    while (true) {
+      idleWorkers++;
+      queueCondition.wait(lock, [this] {
+        return stop || activeWorkers > maxWorkers || !queue.empty();
+      });
+      idleWorkers--;
+      if (activeWorkers > maxWorkers || queue.empty()) {
+        activeWorkers--;
+        return;
+      }
+      packaged_task<void()> job = std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+      job();
+      lock.lock();
+    }
+  }
+};
+
+CompilePool::CompilePool(int maxWorkers) : content(new Content) {
+  content->maxWorkers = std::max(1, maxWorkers);
+}
+
+CompilePool::~CompilePool() {
+  {
+    lock_guard<mutex> lock(content->queueMutex);
+    content->stop = true;
+  }
+  content->queueCondition.notify_all();
+  for (auto& worker : content->workers) {
+    worker.join();
+  }
+}
+
+future<void> CompilePool::submit(function<void()> job) {
+  packaged_task<void()> task(std::move(job));
+  future<void> done = task.get_future();
+  {
+    lock_guard<mutex> lock(content->queueMutex);
+    taco_iassert(!content->stop);
+    content->queue.push_back(std::move(task));
+    if (content->idleWorkers < (int)content->queue.size() &&
+        content->activeWorkers < content->maxWorkers) {
+      // Threads of workers that exited after the pool was shrunk are only
+      // joined when the pool is destroyed
+      content->activeWorkers++;
+      Content* pool = content.get();
+      content->workers.emplace_back([pool] {
+        unique_lock<mutex> lock(pool->queueMutex);
+        pool->work(lock);
+      });
+    }
+  }
+  content->queueCondition.notify_one();
+  return done;
+}
+
+void CompilePool::setMaxWorkers(int maxWorkers) {
+  {
+    lock_guard<mutex> lock(content->queueMutex);
+    content->maxWorkers = std::max(1, maxWorkers);
+  }
+  content->queueCondition.notify_all();
+}
+
+int CompilePool::getMaxWorkers() const {
+  lock_guard<mutex> lock(content->queueMutex);
+  return content->maxWorkers;
+}
+
+CompilePool& CompilePool::getDefault() {
+  static CompilePool pool([] {
+    const int threads = std::atoi(
+        util::getFromEnv("TACO_COMPILE_THREADS", "0").c_str());
+    if (threads > 0) {
+      return threads;
+    }
+    return std::max(1, (int)thread::hardware_concurrency() / 2);
+  }());
+  return pool;
+}
+
+}}
@@ -0,0 +1,47 @@
+#ifndef TACO_COMPILE_POOL_H
+#define TACO_COMPILE_POOL_H
+
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace taco {
+namespace ir {
+
+/// A bounded pool of threads that run the external compiler for generated
+/// code. Modules compiled from many threads at once (e.g. when many requests
+/// hit new expressions concurrently) queue their compiler invocations here,
+/// so that at most `getMaxWorkers()` compilers run at the same time. Workers
+/// are started on demand and exit when the pool is shrunk.
+class CompilePool {
+public:
+  /// Create a pool that runs at most `maxWorkers` jobs at the same time.
+  explicit CompilePool(int maxWorkers);
+  ~CompilePool();
+
+  CompilePool(const CompilePool&) = delete;
+  void operator=(const CompilePool&) = delete;
+
+  /// Queue a job. The future is ready once the job has run, and rethrows the
+  /// exception the job threw, if any.
+  std::future<void> submit(std::function<void()> job);
+
+  /// Set the maximum number of jobs that run at the same time. Running jobs
+  /// are not interrupted when the pool is shrunk.
+  void setMaxWorkers(int maxWorkers);
+
+  /// Get the maximum number of jobs that run at the same time.
+  int getMaxWorkers() const;
+
+  /// Get the pool through which modules run the compiler. Its size defaults
+  /// to the `TACO_COMPILE_THREADS` environment variable, or to half the
+  /// number of hardware threads.
+  static CompilePool& getDefault();
+
+private:
+  struct Content;
+  std::unique_ptr<Content> content;
+};
+
+}}
+#endif
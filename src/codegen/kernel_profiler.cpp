@@ -0,0 +1,203 @@
+#include "kernel_profiler.h"
+
+#include "taco/error.h"
+#include "taco/ir/ir_rewriter.h"
+#include "taco/ir/ir_visitor.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+
+namespace taco {
+namespace ir {
+
+namespace {
+
+/// Finds the calls to the binary search runtime functions in an expression.
+struct FindSearches : public IRVisitor {
+  using IRVisitor::visit;
+
+  vector<string> searches;
+
+  void visit(const Call* op) {
+    if (op->func == "taco_binarySearchAfter" ||
+        op->func == "taco_binarySearchBefore") {
+      searches.push_back(op->func);
+    }
+    IRVisitor::visit(op);
+  }
+};
+
+static vector<string> getSearches(vector<Expr> exprs) {
+  FindSearches finder;
+  for (auto& expr : exprs) {
+    if (expr.defined()) {
+      expr.accept(&finder);
+    }
+  }
+  return finder.searches;
+}
+
+static string getName(Expr var) {
+  const Var* v = var.as<Var>();
+  return (v != nullptr) ? v->name : util::toString(var);
+}
+
+static bool isParallel(const For* op) {
+  switch (op->kind) {
+    case LoopKind::Static:
+    case LoopKind::Dynamic:
+    case LoopKind::Runtime:
+    case LoopKind::Static_Chunked:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Prepend `stmts` to `body`, inside of its scope if it has one.
+static Stmt prepend(vector<Stmt> stmts, Stmt body) {
+  if (const Scope* scope = body.as<Scope>()) {
+    stmts.push_back(scope->scopedStmt);
+    return Scope::make(Block::make(stmts));
+  }
+  stmts.push_back(body);
+  return Block::make(stmts);
+}
+
+struct InstrumentKernel : public IRRewriter {
+  using IRRewriter::visit;
+
+  Expr buffer;
+  vector<string>& counterNames;
+  int parallelDepth = 0;
+
+  InstrumentKernel(Expr buffer, vector<string>& counterNames)
+      : buffer(buffer), counterNames(counterNames) {}
+
+  int addCounter(const string& name) {
+    counterNames.push_back(name);
+    return (int)counterNames.size() - 1;
+  }
+
+  /// Increment the counter at `loc`. Counters are updated atomically, since
+  /// they are shared by parallel loops and by concurrent calls of the kernel.
+  Stmt increment(Expr loc) {
+    Expr count = Add::make(Load::make(buffer, loc),
+                           Literal::make((int64_t)1), Int64);
+    return Store::make(buffer, loc, count, true, ParallelUnit::CPUThread);
+  }
+
+  Stmt increment(int counter) {
+    return increment(Literal::make(counter));
+  }
+
+  /// Count the binary searches in `exprs` before executing `stmt`.
+  Stmt countSearches(Stmt stmt, vector<Expr> exprs, const string& target) {
+    vector<Stmt> stmts;
+    for (auto& search : getSearches(exprs)) {
+      int counter = addCounter("search " + search + " for " + target);
+      stmts.push_back(increment(counter));
+    }
+    if (stmts.empty()) {
+      return stmt;
+    }
+    stmts.push_back(stmt);
+    return Block::make(stmts);
+  }
+
+  void visit(const For* op) {
+    const string loop = "for " + getName(op->var);
+    const int iterations = addCounter(loop);
+    vector<Stmt> prologue = {increment(iterations)};
+
+    const bool parallel = isParallel(op);
+    if (parallel) {
+      parallelDepth++;
+      const int firstThread = (int)counterNames.size();
+      for (int i = 0; i < KernelProfiler::maxProfiledThreads; i++) {
+        addCounter("thread " + util::toString(i) + " " + loop);
+      }
+      Expr thread = Rem::make(Call::make("TACO_THREAD_NUM", {}, Int32),
+                              Literal::make(KernelProfiler::maxProfiledThreads));
+      prologue.push_back(increment(Add::make(Literal::make(firstThread),
+                                             thread)));
+    }
+    Stmt contents = prepend(prologue, rewrite(op->contents));
+    if (parallel) {
+      parallelDepth--;
+    }
+
+    stmt = For::make(op->var, op->start, op->end, op->increment, contents,
+                     op->kind, op->parallel_unit, op->unrollFactor,
+                     op->vec_width);
+    stmt = countSearches(stmt, {op->start, op->end}, getName(op->var));
+  }
+
+  void visit(const While* op) {
+    const int iterations = addCounter("while " + util::toString(op->cond));
+    Stmt contents = prepend({increment(iterations)}, rewrite(op->contents));
+    stmt = While::make(op->cond, contents, op->kind, op->vec_width);
+  }
+
+  void visit(const Case* op) {
+    vector<pair<Expr,Stmt>> clauses;
+    for (size_t i = 0; i < op->clauses.size(); ++i) {
+      auto& clause = op->clauses[i];
+      const bool isElse = (i == op->clauses.size() - 1) && op->alwaysMatch;
+      const int hits = addCounter("case " + (isElse ? string("else")
+                                              : util::toString(clause.first)));
+      clauses.push_back({clause.first,
+                         prepend({increment(hits)}, rewrite(clause.second))});
+    }
+    stmt = Case::make(clauses, op->alwaysMatch);
+  }
+
+  void visit(const VarDecl* op) {
+    stmt = countSearches(op, {op->rhs}, getName(op->var));
+  }
+
+  void visit(const Assign* op) {
+    stmt = countSearches(op, {op->rhs}, getName(op->lhs));
+  }
+
+  void visit(const Allocate* op) {
+    if (!op->is_realloc) {
+      stmt = op;
+      return;
+    }
+    const int reallocs = addCounter("realloc " + util::toString(op->var));
+    stmt = Block::make(op, increment(reallocs));
+  }
+};
+
+}
+
+Stmt KernelProfiler::instrument(Stmt func) {
+  const Function* function = func.as<Function>();
+  taco_iassert(function != nullptr) << "Can only profile functions";
+
+  counterNames.clear();
+  Expr buffer = Var::make(getProfileBufferName(function->name), Int64, true);
+  InstrumentKernel instrumenter(buffer, counterNames);
+  Stmt body = instrumenter.rewrite(function->body);
+  return Function::make(function->name, function->outputs, function->inputs,
+                        body);
+}
+
+const std::vector<std::string>& KernelProfiler::getCounterNames() const {
+  return counterNames;
+}
+
+std::string getProfileBufferName(const std::string& funcName) {
+  return "taco_profile_" + funcName;
+}
+
+std::string getProfileNamesName(const std::string& funcName) {
+  return "taco_profile_" + funcName + "_names";
+}
+
+std::string getProfileSizeName(const std::string& funcName) {
+  return "taco_profile_" + funcName + "_size";
+}
+
+}}
@@ -0,0 +1,46 @@
+#ifndef TACO_KERNEL_PROFILER_H
+#define TACO_KERNEL_PROFILER_H
+
+#include <string>
+#include <vector>
+
+#include "taco/ir/ir.h"
+
+namespace taco {
+namespace ir {
+
+/// Instruments a lowered function with profiling counters. Every `For` and
+/// `While` loop counts its iterations, every merge lattice `Case` clause
+/// counts how often it is taken, statements that call the binary search
+/// runtime functions count the searches, and reallocations are counted.
+/// Parallel loops additionally count the iterations executed by each thread.
+///
+/// The counters are stored in a global int64_t array named by
+/// `getProfileBufferName`, and `getProfileCounterNames` describes each entry.
+class KernelProfiler {
+public:
+  /// Maximum number of threads whose work in a parallel loop is counted
+  /// separately. Threads with higher ids share counters with lower ones.
+  static const int maxProfiledThreads = 64;
+
+  /// Returns the function instrumented with profiling counters.
+  Stmt instrument(Stmt func);
+
+  /// Returns descriptions of the counters added by the last instrumentation.
+  const std::vector<std::string>& getCounterNames() const;
+
+private:
+  std::vector<std::string> counterNames;
+};
+
+/// Name of the array that holds the profiling counters of a function.
+std::string getProfileBufferName(const std::string& funcName);
+
+/// Name of the array of counter descriptions of a function.
+std::string getProfileNamesName(const std::string& funcName);
+
+/// Name of the variable that holds the number of counters of a function.
+std::string getProfileSizeName(const std::string& funcName);
+
+}}
+#endif
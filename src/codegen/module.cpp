@@ -1,5 +1,7 @@
 #include "taco/codegen/module.h"
 
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <dlfcn.h>
@@ -10,10 +12,17 @@
 
 #include "taco/tensor.h"
 #include "taco/error.h"
+#include "taco/instrumentation.h"
+#include "taco/scheduler.h"
+#include "taco/storage/allocator.h"
+#include "taco/util/collections.h"
 #include "taco/util/strings.h"
 #include "taco/util/env.h"
+#include "taco/util/numa.h"
 #include "codegen/codegen_c.h"
 #include "codegen/codegen_cuda.h"
+#include "codegen/compile_pool.h"
+#include "codegen/kernel_profiler.h"
 #include "taco/cuda.h"
 
 using namespace std;
@@ -26,10 +35,16 @@ void Module::setJITTmpdir() {
 }
 
 void Module::setJITLibname() {
+  // The random prefix alone is not unique: user code that reseeds rand() (e.g.
+  // the fill utilities) makes it repeat, and dlopen() then returns the handle
+  // of a previously loaded library. The counter keeps names distinct within
+  // the process; the temporary directory is already unique per process.
+  static std::atomic<unsigned> libCounter(0);
   string chars = "abcdefghijkmnpqrstuvwxyz0123456789";
   libname.resize(12);
   for (int i=0; i<12; i++)
     libname[i] = chars[rand() % chars.length()];
+  libname += "_" + std::to_string(libCounter++);
 }
 
 void Module::addFunction(Stmt func) {
@@ -104,10 +119,16 @@ void writeShims(vector<Stmt> funcs, string path, string prefix) {
 
 } // anonymous namespace
 
-string Module::compile() {
+Module::~Module() {
+  // The background compilation refers to this module
+  if (pendingCompile.valid()) {
+    pendingCompile.wait();
+  }
+}
+
+string Module::generateSource(const string& fullpath) {
   string prefix = tmpdir+libname;
-  string fullpath = prefix + ".so";
-  
+
   string cc;
   string cflags;
   string file_ending;
@@ -134,17 +155,19 @@ string Module::compile() {
     prefix + file_ending + " " + shims_file + " " + 
     "-o " + fullpath + " -lm";
 
-  // open the output file & write out the source
-  compileToSource(tmpdir, libname);
-  
-  // write out the shims
-  writeShims(funcs, tmpdir, libname);
-  
-  // now compile it
-  int err = system(cmd.data());
-  taco_uassert(err == 0) << "Compilation command failed:\n" << cmd
-    << "\nreturned " << err;
+  {
+    ScopedPhaseTimer timer("codegen", libname);
+
+    // open the output file & write out the source
+    compileToSource(tmpdir, libname);
+
+    // write out the shims
+    writeShims(funcs, tmpdir, libname);
+  }
+  return cmd;
+}
 
+void Module::load(const string& fullpath) {
   // use dlsym() to open the compiled library
   if (lib_handle) {
     dlclose(lib_handle);
@@ -152,23 +175,165 @@ string Module::compile() {
   lib_handle = dlopen(fullpath.data(), RTLD_NOW | RTLD_LOCAL);
   taco_uassert(lib_handle) << "Failed to load generated code";
 
+  // Route the allocations of the generated code through taco's allocators
+  auto allocator = (taco_allocator_t**)dlsym(lib_handle, "taco_allocator");
+  if (allocator != nullptr) {
+    *allocator = getKernelAllocatorTable();
+  }
+  auto temporaryAllocator =
+      (taco_allocator_t**)dlsym(lib_handle, "taco_temporary_allocator");
+  if (temporaryAllocator != nullptr) {
+    *temporaryAllocator = getKernelTemporaryAllocatorTable();
+  }
+
+  // Let parallel loops run on the scheduler of the calling thread
+  auto scheduler = (SchedulerGetter*)dlsym(lib_handle, "taco_get_scheduler");
+  if (scheduler != nullptr) {
+    *scheduler = getKernelSchedulerGetter();
+  }
+}
+
+string Module::compile() {
+  waitForCompile();
+  string fullpath = tmpdir + libname + ".so";
+  string cmd = generateSource(fullpath);
+  
+  // now compile it, in the compile pool so that at most a bounded number of
+  // compilers run at the same time
+  int err;
+  {
+    ScopedPhaseTimer timer("cc", libname);
+    CompilePool::getDefault().submit([&cmd, &err] {
+      err = system(cmd.data());
+    }).get();
+  }
+  taco_uassert(err == 0) << "Compilation command failed:\n" << cmd
+    << "\nreturned " << err;
+
+  load(fullpath);
+  compiled = true;
   return fullpath;
 }
 
+void Module::compileInBackground() {
+  waitForCompile();
+  compiled = false;
+  string fullpath = tmpdir + libname + ".so";
+  string cmd = generateSource(fullpath);
+
+  interpreters.clear();
+  if (!should_use_CUDA_codegen()) {
+    for (auto& func : funcs) {
+      Interpreter interpreter(func);
+      if (interpreter.isSupported()) {
+        interpreters.insert({"_shim_" + func.as<Function>()->name,
+                             interpreter});
+      }
+    }
+  }
+
+  const string name = libname;
+  pendingCompile = CompilePool::getDefault().submit([this, cmd, fullpath,
+                                                     name] {
+    int err;
+    {
+      ScopedPhaseTimer timer("cc", name);
+      err = system(cmd.data());
+    }
+    taco_uassert(err == 0) << "Compilation command failed:\n" << cmd
+      << "\nreturned " << err;
+    load(fullpath);
+    compiled.store(true, std::memory_order_release);
+  }).share();
+}
+
+bool Module::interpret() {
+  waitForCompile();
+  map<string, Interpreter> funcInterpreters;
+  for (auto& func : funcs) {
+    Interpreter interpreter(func);
+    if (!interpreter.isSupported()) {
+      return false;
+    }
+    funcInterpreters.insert({"_shim_" + func.as<Function>()->name,
+                             interpreter});
+  }
+  interpreters = std::move(funcInterpreters);
+  compiled = false;
+  return true;
+}
+
+bool Module::isCompiled() const {
+  return compiled.load(std::memory_order_acquire);
+}
+
+void Module::waitForCompile() const {
+  if (pendingCompile.valid() && !isCompiled()) {
+    pendingCompile.get();
+  }
+}
+
 void Module::setSource(string source) {
   this->source << source;
   moduleFromUserSource = true;
 }
 
 string Module::getSource() {
+  if (!isCompiled() && !pendingCompile.valid() && !interpreters.empty()) {
+    // The functions are interpreted, so the source has not been generated
+    lock_guard<mutex> lock(compileMutex);
+    if (source.str().empty()) {
+      compileToSource(tmpdir, libname);
+    }
+  }
   return source.str();
 }
 
 void* Module::getFuncPtr(std::string name) {
+  if (!isCompiled() && !pendingCompile.valid() && !interpreters.empty()) {
+    // The functions were interpreted so far
+    lock_guard<mutex> lock(compileMutex);
+    if (!isCompiled()) {
+      compile();
+    }
+  }
+  waitForCompile();
   return dlsym(lib_handle, name.data());
 }
 
+void Module::collectAllocStats() {
+  int64_t* stats = (int64_t*)getFuncPtr(allocStatsName);
+  if (stats == nullptr) {
+    // The module was generated while instrumentation was disabled
+    return;
+  }
+  // Kernels running concurrently keep adding to the statistics, so each one is
+  // taken and reset in one atomic step
+  auto take = [stats](int stat) {
+    return __atomic_exchange_n(&stats[stat], (int64_t)0, __ATOMIC_RELAXED);
+  };
+  addToCounter(counters::posBytes, take(AllocStatPosBytes));
+  addToCounter(counters::crdBytes, take(AllocStatCrdBytes));
+  addToCounter(counters::valsBytes, take(AllocStatValsBytes));
+  addToCounter(counters::otherBytes, take(AllocStatOtherBytes));
+  addToCounter(counters::reallocs, take(AllocStatReallocs));
+}
+
 int Module::callFuncPackedRaw(std::string name, void** args) {
+  return callFuncPackedRaw(name, args, nullptr);
+}
+
+int Module::callFuncPackedRaw(std::string name, void** args,
+                              KernelProfile* profile) {
+  if (!isCompiled() && util::contains(interpreters, name)) {
+    // The library is still being compiled in the background
+    if (profile != nullptr) {
+      profile->clear();
+    }
+    ScopedPhaseTimer timer("interpret", name);
+    return interpreters.at(name).call(args);
+  }
+
   typedef int (*fnptr_t)(void**);
   static_assert(sizeof(void*) == sizeof(fnptr_t),
     "Unable to cast dlsym() returned void pointer to function pointer");
@@ -194,15 +359,58 @@ int Module::callFuncPackedRaw(std::string name, void** args) {
       break;
   }
   omp_set_num_threads(taco_get_num_threads());
+  const ThreadPlacement placement = taco_get_thread_placement();
+  util::placeOpenMPThreads(taco_get_num_threads(),
+                           placement != ThreadPlacement::Default,
+                           placement == ThreadPlacement::Spread);
 #endif
 
-  int ret = func_ptr(args);
+  // Shims share the profiling counters of the function they call
+  string funcName = name;
+  if (funcName.compare(0, 6, "_shim_") == 0) {
+    funcName = funcName.substr(6);
+  }
+  // Each profiled function counts into one buffer of the library, so calls of
+  // it are serialized, whether or not they read the counters
+  int64_t* counters = nullptr;
+  int32_t numCounters = 0;
+  unique_lock<mutex> profileLock(profileMutex, defer_lock);
+  if (profile != nullptr) {
+    profile->clear();
+  }
+  int32_t* size = (int32_t*)getFuncPtr(getProfileSizeName(funcName));
+  if (size != nullptr && *size > 0) {
+    profileLock.lock();
+    if (profile != nullptr) {
+      numCounters = *size;
+      counters = (int64_t*)getFuncPtr(getProfileBufferName(funcName));
+      memset(counters, 0, numCounters * sizeof(int64_t));
+    }
+  }
+
+  int ret;
+  {
+    ScopedPhaseTimer timer("kernel", name);
+    ret = func_ptr(args);
+  }
 
 #if USE_OPENMP
   omp_set_schedule(existingSched, existingChunkSize);
   omp_set_num_threads(existingNumThreads);
 #endif
 
+  if (isInstrumentationEnabled()) {
+    collectAllocStats();
+  }
+
+  if (counters != nullptr) {
+    const char** names =
+        (const char**)getFuncPtr(getProfileNamesName(funcName));
+    for (int32_t i = 0; i < numCounters; i++) {
+      profile->push_back({names[i], counters[i]});
+    }
+  }
+
   return ret;
 }
 
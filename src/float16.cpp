@@ -0,0 +1,93 @@
+#include "taco/float16.h"
+
+#include <cstring>
+
+namespace taco {
+
+static uint32_t getFloatBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float getFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// The conversions match taco_half_to_float and taco_float_to_half in the
+// preamble of generated kernels
+float16::float16(float value) {
+  const uint32_t sign = getFloatBits(value) & 0x80000000u;
+  uint32_t magnitude = getFloatBits(value) ^ sign;
+  if (magnitude >= (143u << 23)) {
+    // Too large for a half, infinity or NaN
+    bits = (magnitude > (255u << 23)) ? 0x7e00 : 0x7c00;
+  } else if (magnitude < (113u << 23)) {
+    // Subnormal halves are rounded by adding a float whose last mantissa bit
+    // is worth the smallest subnormal half
+    const float magic = getFloat(126u << 23);
+    bits = (uint16_t)(getFloatBits(getFloat(magnitude) + magic) - (126u << 23));
+  } else {
+    // Rebias the exponent and round the mantissa to nearest even
+    const uint32_t odd = (magnitude >> 13) & 1;
+    magnitude += ((uint32_t)(15 - 127) << 23) + 0xfff + odd;
+    bits = (uint16_t)(magnitude >> 13);
+  }
+  bits |= (uint16_t)(sign >> 16);
+}
+
+float16::operator float() const {
+  // Rebias the exponent, and renormalize subnormals by subtracting the value
+  // of the implicit bit they are given
+  const uint32_t exponentMask = 0x7c00u << 13;
+  uint32_t result = (uint32_t)(bits & 0x7fff) << 13;
+  const uint32_t exponent = result & exponentMask;
+  result += (uint32_t)(127 - 15) << 23;
+  if (exponent == exponentMask) {
+    result += (uint32_t)(128 - 16) << 23;
+  } else if (exponent == 0) {
+    result += 1u << 23;
+    result = getFloatBits(getFloat(result) - getFloat(113u << 23));
+  }
+  return getFloat(result | ((uint32_t)(bits & 0x8000) << 16));
+}
+
+uint16_t float16::getBits() const {
+  return bits;
+}
+
+float16 float16::fromBits(uint16_t bits) {
+  float16 value;
+  value.bits = bits;
+  return value;
+}
+
+
+bfloat16::bfloat16(float value) {
+  uint32_t magnitude = getFloatBits(value);
+  if ((magnitude & 0x7fffffffu) > (255u << 23)) {
+    // Keep NaNs quiet rather than rounding them to infinity
+    bits = (uint16_t)((magnitude >> 16) | 0x40);
+  } else {
+    magnitude += 0x7fff + ((magnitude >> 16) & 1);
+    bits = (uint16_t)(magnitude >> 16);
+  }
+}
+
+bfloat16::operator float() const {
+  return getFloat((uint32_t)bits << 16);
+}
+
+uint16_t bfloat16::getBits() const {
+  return bits;
+}
+
+bfloat16 bfloat16::fromBits(uint16_t bits) {
+  bfloat16 value;
+  value.bits = bits;
+  return value;
+}
+
+}
@@ -64,6 +64,12 @@ IndexExpr::IndexExpr(uint32_t val) : IndexExpr(new LiteralNode(val)) {
 IndexExpr::IndexExpr(uint64_t val) : IndexExpr(new LiteralNode(val)) {
 }
 
+IndexExpr::IndexExpr(float16 val) : IndexExpr(new LiteralNode(val)) {
+}
+
+IndexExpr::IndexExpr(bfloat16 val) : IndexExpr(new LiteralNode(val)) {
+}
+
 IndexExpr::IndexExpr(float val) : IndexExpr(new LiteralNode(val)) {
 }
 
@@ -841,6 +847,12 @@ Literal::Literal(long long val) : Literal(new LiteralNode(val)) {
 Literal::Literal(int8_t val) : Literal(new LiteralNode(val)) {
 }
 
+Literal::Literal(float16 val) : Literal(new LiteralNode(val)) {
+}
+
+Literal::Literal(bfloat16 val) : Literal(new LiteralNode(val)) {
+}
+
 Literal::Literal(float val) : Literal(new LiteralNode(val)) {
 }
 
@@ -864,6 +876,8 @@ IndexExpr Literal::zero(Datatype type) {
     case Datatype::Int16:       return Literal(int16_t(0));
     case Datatype::Int32:       return Literal(int32_t(0));
     case Datatype::Int64:       return Literal(int64_t(0));
+    case Datatype::Float16:     return Literal(float16(0.0f));
+    case Datatype::BFloat16:    return Literal(bfloat16(0.0f));
     case Datatype::Float32:     return Literal(float(0.0));
     case Datatype::Float64:     return Literal(double(0.0));
     case Datatype::Complex64:   return Literal(std::complex<float>());
@@ -889,6 +903,8 @@ template int Literal::getVal() const;
 template long Literal::getVal() const;
 template long long Literal::getVal() const;
 template int8_t Literal::getVal() const;
+template float16 Literal::getVal() const;
+template bfloat16 Literal::getVal() const;
 template float Literal::getVal() const;
 template double Literal::getVal() const;
 template std::complex<float> Literal::getVal() const;
@@ -1351,8 +1367,25 @@ IndexStmt IndexStmt::concretize() const {
   return stmt;
 }
 
-IndexStmt IndexStmt::split(IndexVar i, IndexVar i1, IndexVar i2, size_t splitFactor) const {
-  IndexVarRel rel = IndexVarRel(new SplitRelNode(i, i1, i2, splitFactor));
+IndexStmt IndexStmt::split(IndexVar i, IndexVar i1, IndexVar i2, size_t splitFactor,
+                           TailStrategy tailStrategy) const {
+  if (tailStrategy == TailStrategy::RoundUp) {
+    // Positions end at the number of stored components, which the split
+    // factor cannot be known to divide
+    ProvenanceGraph provGraph = ProvenanceGraph(*this);
+    taco_uassert(!provGraph.isPosVariable(i))
+        << "Position variable " << i << " cannot be split with the RoundUp "
+        << "tail strategy";
+    vector<IndexVar> parents = provGraph.getParents(i);
+    if (parents.size() == 1 && provGraph.getSplitFactor(parents[0]) > 0 &&
+        provGraph.getChildren(parents[0])[1] == i) {
+      taco_uassert(provGraph.getSplitFactor(parents[0]) % splitFactor == 0)
+          << "The RoundUp split factor " << splitFactor << " of " << i
+          << " must divide its extent " << provGraph.getSplitFactor(parents[0]);
+    }
+  }
+
+  IndexVarRel rel = IndexVarRel(new SplitRelNode(i, i1, i2, splitFactor, tailStrategy));
   string reason;
 
   // Add predicate to concrete index notation
@@ -1412,6 +1445,68 @@ IndexStmt IndexStmt::reorder(std::vector<IndexVar> reorderedvars) const {
   return transformed;
 }
 
+IndexStmt IndexStmt::tile(std::vector<IndexVar> vars, std::vector<size_t> sizes,
+                          TailStrategy tailStrategy) const {
+  taco_uassert(vars.size() == sizes.size())
+      << "There must be a tile size for each tiled index variable";
+  vector<vector<IndexVar>> tileVars;
+  vector<vector<size_t>> levelSizes;
+  for (size_t v = 0; v < vars.size(); v++) {
+    tileVars.push_back({IndexVar(vars[v].getName() + "0"),
+                        IndexVar(vars[v].getName() + "1")});
+    levelSizes.push_back({sizes[v]});
+  }
+  return tile(vars, tileVars, levelSizes, tailStrategy);
+}
+
+IndexStmt IndexStmt::tile(std::vector<IndexVar> vars,
+                          std::vector<std::vector<IndexVar>> tileVars,
+                          std::vector<std::vector<size_t>> sizes,
+                          TailStrategy tailStrategy) const {
+  taco_uassert(!vars.empty()) << "No index variables to tile";
+  taco_uassert(vars.size() == sizes.size() && vars.size() == tileVars.size())
+      << "There must be tile sizes and tile variables for each tiled index "
+      << "variable";
+  const size_t levels = sizes[0].size();
+  for (size_t v = 0; v < vars.size(); v++) {
+    taco_uassert(levels > 0 && sizes[v].size() == levels)
+        << "Every tiled index variable must be tiled at the same number of "
+        << "levels";
+    taco_uassert(tileVars[v].size() == levels + 1)
+        << "Tiling " << vars[v] << " at " << levels << " levels takes "
+        << levels + 1 << " index variables";
+    for (size_t l = 0; l < levels; l++) {
+      taco_uassert(sizes[v][l] > 0) << "Tile sizes must be positive";
+      taco_uassert(l == 0 || sizes[v][l-1] % sizes[v][l] == 0)
+          << "The tile sizes of " << vars[v] << " must be multiples of the "
+          << "sizes of the tiles within them";
+    }
+  }
+
+  // Split each variable into a loop per level, splitting the tiles of each
+  // level into the tiles of the next
+  IndexStmt transformed = *this;
+  for (size_t v = 0; v < vars.size(); v++) {
+    IndexVar rest = vars[v];
+    for (size_t l = 0; l < levels; l++) {
+      IndexVar inner = (l == levels - 1)
+          ? tileVars[v][levels]
+          : IndexVar(vars[v].getName() + "_rest" + util::toString(l));
+      transformed = transformed.split(rest, tileVars[v][l], inner, sizes[v][l],
+                                      tailStrategy);
+      rest = inner;
+    }
+  }
+
+  vector<IndexVar> order;
+  for (size_t l = 0; l <= levels; l++) {
+    for (size_t v = 0; v < vars.size(); v++) {
+      order.push_back(tileVars[v][l]);
+    }
+  }
+  return transformed.reorder(order);
+}
+
 IndexStmt IndexStmt::parallelize(IndexVar i, ParallelUnit parallel_unit, OutputRaceStrategy output_race_strategy) const {
   string reason;
   IndexStmt transformed = Parallelize(i, parallel_unit, output_race_strategy).apply(*this, &reason);
@@ -2255,17 +2350,20 @@ IndexStmt makeConcreteNotation(IndexStmt stmt) {
 
     void visit(const AssignmentNode* node) {
       // Easiest to just walk down the reduction node until we find something
-      // that's not a reduction
+      // that's not a reduction with the same operator
       vector<IndexVar> topLevelReductions;
       IndexExpr rhs = node->rhs;
-      while (isa<Reduction>(rhs)) {
+      IndexExpr op;
+      while (isa<Reduction>(rhs) &&
+             (!op.defined() || equals(op, to<Reduction>(rhs).getOp()))) {
         Reduction reduction = to<Reduction>(rhs);
         topLevelReductions.push_back(reduction.getVar());
+        op = reduction.getOp();
         rhs = reduction.getExpr();
       }
 
       if (rhs != node->rhs) {
-        stmt = Assignment(node->lhs, rhs, Add());
+        stmt = Assignment(node->lhs, rhs, op);
         for (auto& i : util::reverse(topLevelReductions)) {
           stmt = forall(i, stmt);
         }
@@ -2777,7 +2875,28 @@ private:
   }
 
   void visit(const SequenceNode* op) {
-    taco_not_supported_yet;
+    IndexStmt definition = rewrite(op->definition);
+    IndexStmt mutation = rewrite(op->mutation);
+    // A temporary is only zero if every statement that computes it is zero
+    for (auto& computed : {definition, mutation}) {
+      if (computed.defined()) {
+        for (auto& result : getResults(computed)) {
+          zeroedVars.erase(result);
+        }
+      }
+    }
+    if (!definition.defined()) {
+      stmt = mutation;
+    }
+    else if (!mutation.defined()) {
+      stmt = definition;
+    }
+    else if (definition == op->definition && mutation == op->mutation) {
+      stmt = op;
+    }
+    else {
+      stmt = new SequenceNode(definition, mutation);
+    }
   }
 
   void visit(const MultiNode* op) {
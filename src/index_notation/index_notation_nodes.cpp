@@ -33,7 +33,7 @@ CallIntrinsicNode::CallIntrinsicNode(const std::shared_ptr<Intrinsic>& func,
 // class ReductionNode
 ReductionNode::ReductionNode(IndexExpr op, IndexVar var, IndexExpr a)
     : IndexExprNode(a.getDataType()), op(op), var(var), a(a) {
-  taco_iassert(isa<BinaryExprNode>(op.ptr));
+  taco_iassert(isa<BinaryExprNode>(op.ptr) || isa<CallIntrinsicNode>(op.ptr));
 }
 
 }
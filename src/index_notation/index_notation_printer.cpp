@@ -1,5 +1,6 @@
 #include "taco/index_notation/index_notation_printer.h"
 #include "taco/index_notation/index_notation_nodes.h"
+#include "taco/index_notation/semiring.h"
 
 using namespace std;
 
@@ -60,6 +61,12 @@ void IndexNotationPrinter::visit(const LiteralNode* op) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+      os << (float)op->getVal<float16>();
+      break;
+    case Datatype::BFloat16:
+      os << (float)op->getVal<bfloat16>();
+      break;
     case Datatype::Float32:
       os << op->getVal<float>();
       break;
@@ -166,6 +173,13 @@ void IndexNotationPrinter::visit(const CallIntrinsicNode* op) {
   os << ")";
 }
 
+// Returns the name of a semiring reduction operator
+static std::string getSemiringOperatorName(const CallIntrinsicNode* node) {
+  auto semiringOp = std::dynamic_pointer_cast<SemiringIntrinsic>(node->func);
+  return (semiringOp != nullptr)
+         ? Semiring::getName(semiringOp->getOperator()) : node->func->getName();
+}
+
 void IndexNotationPrinter::visit(const ReductionNode* op) {
   struct ReductionName : IndexNotationVisitor {
     std::string reductionName;
@@ -183,6 +197,9 @@ void IndexNotationPrinter::visit(const ReductionNode* op) {
     void visit(const BinaryExprNode* node) {
       reductionName = "reduction(" + node->getOperatorString() + ")";
     }
+    void visit(const CallIntrinsicNode* node) {
+      reductionName = "reduction(" + getSemiringOperatorName(node) + ")";
+    }
   };
   parentPrecedence = Precedence::REDUCTION;
   os << ReductionName().get(op->op) << "(" << op->var << ", ";
@@ -202,6 +219,9 @@ void IndexNotationPrinter::visit(const AssignmentNode* op) {
     void visit(const BinaryExprNode* node) {
       operatorName = node->getOperatorString();
     }
+    void visit(const CallIntrinsicNode* node) {
+      operatorName = getSemiringOperatorName(node);
+    }
   };
 
   op->lhs.accept(this);
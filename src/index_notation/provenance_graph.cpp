@@ -116,14 +116,17 @@ struct SplitRelNode::Content {
   IndexVar outerVar;
   IndexVar innerVar;
   size_t splitFactor;
+  TailStrategy tailStrategy;
 };
 
-SplitRelNode::SplitRelNode(IndexVar parentVar, IndexVar outerVar, IndexVar innerVar, size_t splitFactor)
+SplitRelNode::SplitRelNode(IndexVar parentVar, IndexVar outerVar, IndexVar innerVar, size_t splitFactor,
+                           TailStrategy tailStrategy)
   : IndexVarRelNode(SPLIT), content(new Content) {
   content->parentVar = parentVar;
   content->outerVar = outerVar;
   content->innerVar = innerVar;
   content->splitFactor = splitFactor;
+  content->tailStrategy = tailStrategy;
 }
 
 const IndexVar& SplitRelNode::getParentVar() const {
@@ -138,14 +141,22 @@ const IndexVar& SplitRelNode::getInnerVar() const {
 const size_t& SplitRelNode::getSplitFactor() const {
   return content->splitFactor;
 }
+TailStrategy SplitRelNode::getTailStrategy() const {
+  return content->tailStrategy;
+}
 
 void SplitRelNode::print(std::ostream &stream) const {
-  stream << "split(" << getParentVar() << ", " << getOuterVar() << ", " << getInnerVar() << ", " << getSplitFactor() << ")";
+  stream << "split(" << getParentVar() << ", " << getOuterVar() << ", " << getInnerVar() << ", " << getSplitFactor();
+  if (getTailStrategy() != TailStrategy::Guard) {
+    stream << ", " << TailStrategy_NAMES[(int) getTailStrategy()];
+  }
+  stream << ")";
 }
 
 bool SplitRelNode::equals(const SplitRelNode &rel) const {
   return getParentVar() == rel.getParentVar() && getOuterVar() == rel.getOuterVar()
-        && getInnerVar() == rel.getInnerVar() && getSplitFactor() == rel.getSplitFactor();
+        && getInnerVar() == rel.getInnerVar() && getSplitFactor() == rel.getSplitFactor()
+        && getTailStrategy() == rel.getTailStrategy();
 }
 
 std::vector<IndexVar> SplitRelNode::getParents() const {
@@ -1147,6 +1158,22 @@ bool ProvenanceGraph::hasExactBound(IndexVar indexVar) const {
   return false;
 }
 
+TailStrategy ProvenanceGraph::getTailStrategy(IndexVar indexVar) const {
+  if (!childRelMap.count(indexVar) ||
+      childRelMap.at(indexVar).getRelType() != SPLIT) {
+    return TailStrategy::Guard;
+  }
+  return childRelMap.at(indexVar).getNode<SplitRelNode>()->getTailStrategy();
+}
+
+size_t ProvenanceGraph::getSplitFactor(IndexVar indexVar) const {
+  if (!childRelMap.count(indexVar) ||
+      childRelMap.at(indexVar).getRelType() != SPLIT) {
+    return 0;
+  }
+  return childRelMap.at(indexVar).getNode<SplitRelNode>()->getSplitFactor();
+}
+
 std::vector<IndexVar> ProvenanceGraph::newlyRecoverableParents(taco::IndexVar indexVar,
                                                    std::set<taco::IndexVar> previouslyDefined) const {
   // for each parent is it not recoverable with previouslyDefined, but yes with previouslyDefined+indexVar
@@ -0,0 +1,270 @@
+#include "taco/index_notation/semiring.h"
+
+#include <complex>
+#include <limits>
+
+#include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/index_notation_nodes.h"
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+
+// class Semiring
+Semiring::Semiring() : Semiring(Plus, Times) {
+}
+
+Semiring::Semiring(Operator add, Operator multiply)
+    : addOp(add), multiplyOp(multiply) {
+}
+
+Semiring::Operator Semiring::getAdd() const {
+  return addOp;
+}
+
+Semiring::Operator Semiring::getMultiply() const {
+  return multiplyOp;
+}
+
+IndexExpr Semiring::getAddOperator() const {
+  if (addOp == Plus) {
+    return Add();
+  }
+  return CallIntrinsic(make_shared<SemiringIntrinsic>(addOp), {});
+}
+
+IndexExpr Semiring::multiply(IndexExpr a, IndexExpr b) const {
+  if (multiplyOp == Times) {
+    return a * b;
+  }
+  return CallIntrinsic(make_shared<SemiringIntrinsic>(multiplyOp), {a, b});
+}
+
+Reduction Semiring::reduce(IndexVar i, IndexExpr expr) const {
+  return Reduction(getAddOperator(), i, expr);
+}
+
+ir::Expr Semiring::getZero(Datatype type) const {
+  return getIdentity(addOp, type);
+}
+
+ir::Expr Semiring::getOne(Datatype type) const {
+  return getIdentity(multiplyOp, type);
+}
+
+template <typename T>
+static ir::Expr getIdentityOf(Semiring::Operator op) {
+  typedef numeric_limits<T> limits;
+  switch (op) {
+    case Semiring::Plus:
+    case Semiring::Or:
+      return ir::Literal::make((T)0);
+    case Semiring::Times:
+    case Semiring::And:
+      return ir::Literal::make((T)1);
+    case Semiring::Min:
+      return ir::Literal::make(limits::has_infinity ? limits::infinity()
+                                                    : limits::max());
+    case Semiring::Max:
+      return ir::Literal::make(limits::has_infinity ? -limits::infinity()
+                                                    : limits::lowest());
+  }
+  taco_ierror;
+  return ir::Expr();
+}
+
+ir::Expr Semiring::getIdentity(Operator op, Datatype type) {
+  switch (type.getKind()) {
+    case Datatype::Bool:
+      return ir::Literal::make(op == Times || op == And || op == Min);
+    case Datatype::UInt8:
+      return getIdentityOf<uint8_t>(op);
+    case Datatype::UInt16:
+      return getIdentityOf<uint16_t>(op);
+    case Datatype::UInt32:
+      return getIdentityOf<uint32_t>(op);
+    case Datatype::UInt64:
+      return getIdentityOf<uint64_t>(op);
+    case Datatype::Int8:
+      return getIdentityOf<int8_t>(op);
+    case Datatype::Int16:
+      return getIdentityOf<int16_t>(op);
+    case Datatype::Int32:
+      return getIdentityOf<int32_t>(op);
+    case Datatype::Int64:
+      return getIdentityOf<int64_t>(op);
+    case Datatype::Float16:
+    case Datatype::BFloat16:
+    case Datatype::Float32:
+      return getIdentityOf<float>(op);
+    case Datatype::Float64:
+      return getIdentityOf<double>(op);
+    case Datatype::Complex64:
+    case Datatype::Complex128:
+      taco_uassert(op == Plus || op == Times)
+          << "Complex values are not ordered, so " << getName(op)
+          << " has no identity";
+      return (op == Plus) ? ir::Literal::zero(type)
+           : (type.getKind() == Datatype::Complex64)
+           ? ir::Literal::make(complex<float>(1.0f))
+           : ir::Literal::make(complex<double>(1.0));
+    case Datatype::UInt128:
+    case Datatype::Int128:
+      taco_not_supported_yet;
+      break;
+    case Datatype::Undefined:
+      taco_ierror;
+      break;
+  }
+  return ir::Expr();
+}
+
+std::string Semiring::getName(Operator op) {
+  switch (op) {
+    case Plus:
+      return "+";
+    case Times:
+      return "*";
+    case Min:
+      return "min";
+    case Max:
+      return "max";
+    case Or:
+      return "or";
+    case And:
+      return "and";
+  }
+  taco_ierror;
+  return "";
+}
+
+bool operator==(const Semiring& a, const Semiring& b) {
+  return a.getAdd() == b.getAdd() && a.getMultiply() == b.getMultiply();
+}
+
+bool operator!=(const Semiring& a, const Semiring& b) {
+  return !(a == b);
+}
+
+std::ostream& operator<<(std::ostream& os, const Semiring& semiring) {
+  return os << "(" << Semiring::getName(semiring.getAdd()) << ", "
+            << Semiring::getName(semiring.getMultiply()) << ")";
+}
+
+Semiring plusTimes() {
+  return Semiring(Semiring::Plus, Semiring::Times);
+}
+
+Semiring minPlus() {
+  return Semiring(Semiring::Min, Semiring::Plus);
+}
+
+Semiring maxPlus() {
+  return Semiring(Semiring::Max, Semiring::Plus);
+}
+
+Semiring maxMin() {
+  return Semiring(Semiring::Max, Semiring::Min);
+}
+
+Semiring orAnd() {
+  return Semiring(Semiring::Or, Semiring::And);
+}
+
+
+// class SemiringIntrinsic
+SemiringIntrinsic::SemiringIntrinsic(Semiring::Operator op) : op(op) {
+}
+
+Semiring::Operator SemiringIntrinsic::getOperator() const {
+  return op;
+}
+
+std::string SemiringIntrinsic::getName() const {
+  // Products are named apart from the elementwise intrinsics, since they
+  // iterate over different coordinates
+  switch (op) {
+    case Semiring::Plus:
+      return "semiring_plus";
+    case Semiring::Times:
+      return "semiring_times";
+    default:
+      return "semiring_" + Semiring::getName(op);
+  }
+}
+
+Datatype SemiringIntrinsic::inferReturnType(
+    const std::vector<Datatype>& argTypes) const {
+  if (argTypes.empty()) {
+    return Datatype();
+  }
+  taco_iassert(argTypes.size() == 2);
+  taco_uassert(argTypes[0] == argTypes[1])
+      << "Semiring operands must have the same type";
+  return argTypes[0];
+}
+
+static ir::Expr lowerOperator(Semiring::Operator op, ir::Expr a, ir::Expr b) {
+  switch (op) {
+    case Semiring::Plus:
+      return ir::Add::make(a, b);
+    case Semiring::Times:
+      return ir::Mul::make(a, b);
+    case Semiring::Min:
+      return ir::Min::make(a, b);
+    case Semiring::Max:
+      return ir::Max::make(a, b);
+    case Semiring::Or:
+      return ir::Or::make(a, b);
+    case Semiring::And:
+      return ir::And::make(a, b);
+  }
+  taco_ierror;
+  return ir::Expr();
+}
+
+ir::Expr SemiringIntrinsic::lower(const std::vector<ir::Expr>& args) const {
+  taco_iassert(args.size() == 2);
+  return lowerOperator(op, args[0], args[1]);
+}
+
+std::vector<std::vector<size_t>>
+SemiringIntrinsic::zeroPreservingArgs(const std::vector<IndexExpr>& args) const {
+  // The semiring zero annihilates products, so they are zero where either
+  // argument is and are computed only where both are stored
+  taco_iassert(args.size() == 2);
+  return {{0}, {1}};
+}
+
+
+ir::Expr getReductionIdentity(IndexExpr op, Datatype type) {
+  if (isSumReduction(op)) {
+    return ir::Literal::zero(type);
+  }
+  taco_iassert(isa<CallIntrinsicNode>(op.ptr));
+  auto semiringOp = dynamic_pointer_cast<SemiringIntrinsic>(
+      to<CallIntrinsicNode>(op.ptr)->func);
+  taco_uassert(semiringOp != nullptr)
+      << "Reductions with " << op << " are not supported";
+  return Semiring::getIdentity(semiringOp->getOperator(), type);
+}
+
+ir::Expr lowerReduction(IndexExpr op, ir::Expr a, ir::Expr b) {
+  if (isSumReduction(op)) {
+    return (b.type().getKind() == Datatype::Bool) ? ir::Or::make(a, b)
+                                                  : ir::Add::make(a, b);
+  }
+  taco_iassert(isa<CallIntrinsicNode>(op.ptr));
+  auto semiringOp = dynamic_pointer_cast<SemiringIntrinsic>(
+      to<CallIntrinsicNode>(op.ptr)->func);
+  taco_uassert(semiringOp != nullptr)
+      << "Reductions with " << op << " are not supported";
+  return lowerOperator(semiringOp->getOperator(), a, b);
+}
+
+bool isSumReduction(IndexExpr op) {
+  return !op.defined() || isa<AddNode>(op.ptr);
+}
+
+}
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <functional>
 #include <limits>
 
 using namespace std;
@@ -1048,122 +1049,258 @@ IndexStmt scalarPromote(IndexStmt stmt) {
   return scalarPromote(stmt, ProvenanceGraph(stmt), true, false);
 }
 
-static bool compare(std::vector<IndexVar> vars1, std::vector<IndexVar> vars2) {
-  return vars1 == vars2;
+// Returns the loops of the perfect loop nest at the top of `stmt`, and the
+// statement they enclose.
+static vector<Forall> getLoopNest(IndexStmt stmt, IndexStmt* body) {
+  vector<Forall> loops;
+  while (isa<Forall>(stmt)) {
+    loops.push_back(to<Forall>(stmt));
+    stmt = loops.back().getStmt();
+  }
+  *body = stmt;
+  return loops;
 }
 
-// TODO Temporary function to insert workspaces into SpMM kernels
-static IndexStmt optimizeSpMM(IndexStmt stmt) {
-  if (!isa<Forall>(stmt)) {
-    return stmt;
+// Wraps `stmt` in the loops, outermost first.
+static IndexStmt makeLoopNest(const vector<Forall>& loops, IndexStmt stmt) {
+  for (auto loop = loops.rbegin(); loop != loops.rend(); ++loop) {
+    stmt = forall(loop->getIndexVar(), stmt, loop->getParallelUnit(),
+                  loop->getOutputRaceStrategy(), loop->getUnrollFactor());
   }
-  Forall foralli = to<Forall>(stmt);
-  IndexVar i = foralli.getIndexVar();
+  return stmt;
+}
 
-  if (!isa<Forall>(foralli.getStmt())) {
-    return stmt;
+// Returns the storage level of `access` that the index variable indexes, or -1.
+static int getLevel(Access access, IndexVar var) {
+  const vector<IndexVar>& vars = access.getIndexVars();
+  const vector<int>& modeOrdering =
+      access.getTensorVar().getFormat().getModeOrdering();
+  for (size_t level = 0; level < modeOrdering.size(); level++) {
+    if (vars[modeOrdering[level]] == var) {
+      return (int)level;
+    }
   }
-  Forall forallk = to<Forall>(foralli.getStmt());
-  IndexVar k = forallk.getIndexVar();
+  return -1;
+}
 
-  if (!isa<Forall>(forallk.getStmt())) {
-    return stmt;
+// A dense workspace for the result mode indexed by `var`, sized by the
+// dimension of that mode.
+static TensorVar makeWorkspace(Access result, IndexVar var) {
+  TensorVar A = result.getTensorVar();
+  const vector<IndexVar>& vars = result.getIndexVars();
+  size_t mode = find(vars.begin(), vars.end(), var) - vars.begin();
+  return TensorVar("w", Type(A.getType().getDataType(),
+                             {A.getType().getShape().getDimension(mode)}),
+                   taco::dense);
+}
+
+// True if the levels of `result` are indexed by the loop variables in order,
+// such that a consumer that loops over them appends to every level in order.
+static bool isInLoopOrder(Access result, const vector<IndexVar>& loopVars) {
+  const vector<IndexVar>& vars = result.getIndexVars();
+  const vector<int>& modeOrdering =
+      result.getTensorVar().getFormat().getModeOrdering();
+  if (vars.size() != loopVars.size()) {
+    return false;
+  }
+  for (size_t level = 0; level < modeOrdering.size(); level++) {
+    if (vars[modeOrdering[level]] != loopVars[level]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct ReplaceTemporary : public IndexNotationRewriter {
+  TensorVar temporary;
+  IndexExpr replacement;
+  ReplaceTemporary(TensorVar temporary, IndexExpr replacement)
+      : temporary(temporary), replacement(replacement) {}
+  using IndexNotationRewriter::visit;
+  void visit(const AccessNode* node) {
+    expr = (node->tensorVar == temporary) ? replacement : IndexExpr(node);
   }
-  Forall forallj = to<Forall>(forallk.getStmt());
-  IndexVar j = forallj.getIndexVar();
+};
 
-  if (!isa<Assignment>(forallj.getStmt())) {
+// Scatters into a dense workspace instead of a result mode that does not
+// support random insert, when the loop over that mode is dominated by a
+// reduction loop:
+//   forall(i, forall(k, forall(j, A(i,j) += B(i,k) * C(k,j))))
+// becomes
+//   forall(i, where(forall(j, A(i,j) = w(j)),
+//                   forall(k, forall(j, w(j) += B(i,k) * C(k,j)))))
+static IndexStmt scatterIntoWorkspace(IndexStmt stmt) {
+  IndexStmt body;
+  vector<Forall> loops = getLoopNest(stmt, &body);
+  if (loops.size() < 2 || !isa<Assignment>(body)) {
     return stmt;
   }
-  Assignment assignment = to<Assignment>(forallj.getStmt());
+  Assignment assignment = to<Assignment>(body);
+  Access result = assignment.getLhs();
+  const vector<IndexVar>& resultVars = result.getIndexVars();
+  auto isFree = [&](IndexVar var) {
+    return util::contains(resultVars, var);
+  };
 
-  if (!isa<Mul>(assignment.getRhs())) {
+  // The loops of the free variables that precede the first reduction loop
+  // enclose the where statement, and only the innermost loop may index a
+  // free variable after it, since workspaces are vectors
+  size_t firstReduction = 0;
+  while (firstReduction < loops.size() &&
+         isFree(loops[firstReduction].getIndexVar())) {
+    firstReduction++;
+  }
+  IndexVar j = loops.back().getIndexVar();
+  if (firstReduction + 1 >= loops.size() || !isFree(j)) {
     return stmt;
   }
-  Mul mul = to<Mul>(assignment.getRhs());
+  for (size_t l = firstReduction; l + 1 < loops.size(); l++) {
+    if (isFree(loops[l].getIndexVar())) {
+      return stmt;
+    }
+  }
 
-  taco_iassert(isa<Access>(assignment.getLhs()));
-  if (!isa<Access>(mul.getA())) {
+  vector<Forall> outer(loops.begin(), loops.begin() + firstReduction);
+  vector<Forall> inner(loops.begin() + firstReduction, loops.end() - 1);
+  vector<IndexVar> consumerVars;
+  for (auto& loop : outer) {
+    consumerVars.push_back(loop.getIndexVar());
+  }
+  consumerVars.push_back(j);
+  if (!isInLoopOrder(result, consumerVars)) {
     return stmt;
   }
-  if (!isa<Access>(mul.getB())) {
+  // Full result levels can be scattered into directly
+  TensorVar A = result.getTensorVar();
+  if (A.getFormat().getModeFormats()[getLevel(result, j)].isFull()) {
     return stmt;
   }
 
-  Access Aaccess = to<Access>(assignment.getLhs());
-  Access Baccess = to<Access>(mul.getA());
-  Access Caccess = to<Access>(mul.getB());
+  TensorVar w = makeWorkspace(result, j);
+  Assignment scatter(w(j), assignment.getRhs(), assignment.getOperator());
+  IndexStmt producer = makeLoopNest(inner, forall(j, scatter));
+  return makeLoopNest(outer, where(forall(j, Assignment(result, w(j))),
+                                   producer));
+}
 
-  if (Aaccess.getIndexVars().size() != 2 ||
-      Baccess.getIndexVars().size() != 2 ||
-      Caccess.getIndexVars().size() != 2) {
+// Gathers a reduction into a dense workspace when the loop of a free
+// variable encloses the reduction loop but the operands store the free
+// variable below the reduction variable, so it cannot be iterated outside:
+//   forall(i, forall(j, where(A(i,j) = t + D(i,j),
+//                             forall(k, t += B(i,k) * C(k,j)))))
+// becomes
+//   forall(i, where(forall(j, A(i,j) = w(j)),
+//                   sequence(forall(k, forall(j, w(j) += B(i,k) * C(k,j))),
+//                            forall(j, w(j) += D(i,j)))))
+// Terms added to the reduction are accumulated into the workspace too, so
+// that the consumer copies a single workspace into the result.
+static IndexStmt gatherIntoWorkspace(IndexStmt stmt) {
+  IndexStmt body;
+  vector<Forall> loops = getLoopNest(stmt, &body);
+  if (loops.empty() || !isa<Where>(body)) {
     return stmt;
   }
-
-  if (!compare(Aaccess.getIndexVars(), {i,j}) ||
-      !compare(Baccess.getIndexVars(), {i,k}) ||
-      !compare(Caccess.getIndexVars(), {k,j})) {
+  Where reduce = to<Where>(body);
+  TensorVar t = reduce.getTemporary();
+  if (t.getOrder() != 0 || !isa<Assignment>(reduce.getConsumer())) {
     return stmt;
   }
-
-  TensorVar A = Aaccess.getTensorVar();
-  if (A.getFormat().getModeFormats()[0].getName() != "dense" ||
-      A.getFormat().getModeFormats()[1].getName() != "compressed" ||
-      A.getFormat().getModeOrdering()[0] != 0 ||
-      A.getFormat().getModeOrdering()[1] != 1) {
+  Assignment consumer = to<Assignment>(reduce.getConsumer());
+  if (consumer.getOperator().defined()) {
     return stmt;
   }
-
-  // I think we can to linear combination of rows as long as there are no permutations in the format and the
-  // level formats are ordered. The i -> k -> j loops should iterate over the data structures without issue.
-  TensorVar B = Baccess.getTensorVar();
-  if (!B.getFormat().getModeFormats()[0].isOrdered() ||
-      !B.getFormat().getModeFormats()[1].isOrdered() ||
-      B.getFormat().getModeOrdering()[0] != 0 ||
-      B.getFormat().getModeOrdering()[1] != 1) {
+  IndexStmt reduction;
+  vector<Forall> inner = getLoopNest(reduce.getProducer(), &reduction);
+  if (inner.empty() || !isa<Assignment>(reduction)) {
+    return stmt;
+  }
+  Assignment producer = to<Assignment>(reduction);
+  if (producer.getLhs().getTensorVar() != t) {
     return stmt;
   }
 
-  TensorVar C = Caccess.getTensorVar();
-  if (!C.getFormat().getModeFormats()[0].isOrdered() ||
-      !C.getFormat().getModeFormats()[1].isOrdered() ||
-      C.getFormat().getModeOrdering()[0] != 0 ||
-      C.getFormat().getModeOrdering()[1] != 1) {
+  // Only the innermost free variable may be stored below a reduction
+  // variable, since workspaces are vectors
+  IndexVar j = loops.back().getIndexVar();
+  bool discordant = false;
+  for (auto& access : getArgumentAccesses(producer)) {
+    const Format& format = access.getTensorVar().getFormat();
+    for (size_t f = 0; f < loops.size(); f++) {
+      int level = getLevel(access, loops[f].getIndexVar());
+      if (level < 0 || format.getModeFormats()[level].hasLocate()) {
+        continue;
+      }
+      for (auto& loop : inner) {
+        int reductionLevel = getLevel(access, loop.getIndexVar());
+        if (reductionLevel >= 0 && reductionLevel < level) {
+          if (f + 1 != loops.size()) {
+            return stmt;
+          }
+          discordant = true;
+        }
+      }
+    }
+  }
+  if (!discordant) {
     return stmt;
   }
 
-  // It's an SpMM statement so return an optimized SpMM statement
-  TensorVar w("w",
-              Type(A.getType().getDataType(), 
-              {A.getType().getShape().getDimension(1)}),
-              taco::dense);
-  return forall(i,
-                where(forall(j,
-                             A(i,j) = w(j)),
-                      forall(k,
-                             forall(j,
-                                    w(j) += B(i,k) * C(k,j)))));
+  Access result = consumer.getLhs();
+  TensorVar w = makeWorkspace(result, j);
+  Assignment accumulate(w(j), producer.getRhs(), producer.getOperator());
+  IndexStmt gather = makeLoopNest(inner, forall(j, accumulate));
+
+  // Split the terms that are added to a sum off the consumer
+  vector<IndexExpr> terms;
+  function<void(IndexExpr)> getTerms = [&](IndexExpr expr) {
+    if (isa<Add>(expr)) {
+      getTerms(to<Add>(expr).getA());
+      getTerms(to<Add>(expr).getB());
+    }
+    else {
+      terms.push_back(expr);
+    }
+  };
+  getTerms(consumer.getRhs());
+  IndexExpr others;
+  bool isTerm = false;
+  bool othersUseTemporary = false;
+  for (auto& term : terms) {
+    if (isa<Access>(term) && to<Access>(term).getTensorVar() == t) {
+      isTerm = true;
+      continue;
+    }
+    match(term,
+      function<void(const AccessNode*)>([&](const AccessNode* op) {
+        othersUseTemporary |= (op->tensorVar == t);
+      })
+    );
+    others = others.defined() ? others + term : term;
+  }
+
+  IndexStmt workspaceConsumer;
+  if (isTerm && !othersUseTemporary && isa<Add>(producer.getOperator())) {
+    if (others.defined()) {
+      gather = sequence(gather, forall(j, w(j) += others));
+    }
+    workspaceConsumer = Assignment(result, w(j));
+  }
+  else {
+    workspaceConsumer = Assignment(result,
+                                   ReplaceTemporary(t, w(j)).rewrite(
+                                       consumer.getRhs()));
+  }
+  vector<Forall> outer(loops.begin(), loops.end() - 1);
+  return makeLoopNest(outer, where(forall(j, workspaceConsumer), gather));
 }
 
 IndexStmt insertTemporaries(IndexStmt stmt)
 {
-  IndexStmt spmm = optimizeSpMM(stmt);
-  if (spmm != stmt) {
-    return spmm;
+  IndexStmt scattered = scatterIntoWorkspace(stmt);
+  if (scattered != stmt) {
+    return scattered;
   }
-
-  // TODO Implement general workspacing when scattering into sparse result modes
-
-  // Result dimensions that are indexed by free variables dominated by a
-  // reduction variable are scattered into.  If any of these are compressed
-  // then we introduce a dense workspace to scatter into instead.  The where
-  // statement must push the reduction loop into the producer side, leaving
-  // only the free variable loops on the consumer side.
-
-  //vector<IndexVar> reductionVars = getReductionVars(stmt);
-  //...
-
-  return stmt;
+  return gatherIntoWorkspace(stmt);
 }
 
 }
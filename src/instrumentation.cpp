@@ -0,0 +1,188 @@
+#include "taco/instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace taco {
+
+typedef chrono::steady_clock Clock;
+
+static atomic<bool> instrumentationEnabled(false);
+static atomic<bool> kernelProfilingEnabled(false);
+
+static mutex instrumentationMutex;
+static Clock::time_point epoch = Clock::now();
+static map<string,int64_t> counterValues;
+static map<string,PhaseStatistics> phaseStatistics;
+static vector<PhaseEvent> phaseEvents;
+
+void setInstrumentationEnabled(bool enabled) {
+  instrumentationEnabled = enabled;
+}
+
+bool isInstrumentationEnabled() {
+  return instrumentationEnabled.load(memory_order_relaxed);
+}
+
+void setKernelProfilingEnabled(bool enabled) {
+  kernelProfilingEnabled = enabled;
+}
+
+bool isKernelProfilingEnabled() {
+  return kernelProfilingEnabled;
+}
+
+void resetInstrumentation() {
+  lock_guard<mutex> lock(instrumentationMutex);
+  epoch = Clock::now();
+  counterValues.clear();
+  phaseStatistics.clear();
+  phaseEvents.clear();
+}
+
+void addToCounter(const string& name, int64_t amount) {
+  if (!isInstrumentationEnabled()) {
+    return;
+  }
+  lock_guard<mutex> lock(instrumentationMutex);
+  counterValues[name] += amount;
+}
+
+int64_t getCounter(const string& name) {
+  lock_guard<mutex> lock(instrumentationMutex);
+  auto it = counterValues.find(name);
+  return (it != counterValues.end()) ? it->second : 0;
+}
+
+map<string,int64_t> getCounters() {
+  lock_guard<mutex> lock(instrumentationMutex);
+  return counterValues;
+}
+
+map<string,PhaseStatistics> getPhaseStatistics() {
+  lock_guard<mutex> lock(instrumentationMutex);
+  return phaseStatistics;
+}
+
+vector<PhaseEvent> getPhaseEvents() {
+  lock_guard<mutex> lock(instrumentationMutex);
+  return phaseEvents;
+}
+
+static void recordPhase(const char* phase, const string& detail,
+                        Clock::time_point begin, Clock::time_point end) {
+  typedef chrono::duration<double, micro> Micros;
+  const double duration = Micros(end - begin).count();
+
+  lock_guard<mutex> lock(instrumentationMutex);
+  PhaseStatistics& stats = phaseStatistics[phase];
+  const double durationMs = duration / 1000.0;
+  stats.minTime = (stats.count == 0) ? durationMs
+                                     : std::min(stats.minTime, durationMs);
+  stats.maxTime = std::max(stats.maxTime, durationMs);
+  stats.totalTime += durationMs;
+  stats.count++;
+
+  if (phaseEvents.size() < maxPhaseEvents) {
+    PhaseEvent event;
+    event.phase = phase;
+    event.detail = detail;
+    event.start = Micros(begin - epoch).count();
+    event.duration = duration;
+    event.thread = hash<thread::id>()(this_thread::get_id());
+    phaseEvents.push_back(event);
+  }
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(const char* phase)
+    : phase(phase), enabled(isInstrumentationEnabled()) {
+  if (enabled) {
+    begin = Clock::now();
+  }
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(const char* phase, const string& detail)
+    : phase(phase), enabled(isInstrumentationEnabled()) {
+  if (enabled) {
+    this->detail = detail;
+    begin = Clock::now();
+  }
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+  if (enabled) {
+    recordPhase(phase, detail, begin, Clock::now());
+  }
+}
+
+static string escapeJSON(const string& str) {
+  stringstream escaped;
+  for (char c : str) {
+    switch (c) {
+      case '"':  escaped << "\\\""; break;
+      case '\\': escaped << "\\\\"; break;
+      case '\n': escaped << "\\n";  break;
+      case '\t': escaped << "\\t";  break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          escaped << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xf]
+                  << "0123456789abcdef"[c & 0xf];
+        } else {
+          escaped << c;
+        }
+    }
+  }
+  return escaped.str();
+}
+
+void writeChromeTrace(ostream& os) {
+  vector<PhaseEvent> events = getPhaseEvents();
+  map<string,int64_t> counters = getCounters();
+
+  // Chrome expects small thread ids, so number threads in order of appearance
+  map<uint64_t,int> threadIds;
+  for (auto& event : events) {
+    threadIds.insert({event.thread, (int)threadIds.size() + 1});
+  }
+
+  os << "{\"traceEvents\":[";
+  string delimiter = "\n";
+  double lastTimestamp = 0.0;
+  for (auto& event : events) {
+    os << delimiter
+       << "{\"name\":\"" << escapeJSON(event.phase) << "\","
+       << "\"cat\":\"taco\",\"ph\":\"X\","
+       << "\"ts\":" << event.start << ","
+       << "\"dur\":" << event.duration << ","
+       << "\"pid\":1,\"tid\":" << threadIds.at(event.thread);
+    if (!event.detail.empty()) {
+      os << ",\"args\":{\"detail\":\"" << escapeJSON(event.detail) << "\"}";
+    }
+    os << "}";
+    delimiter = ",\n";
+    lastTimestamp = std::max(lastTimestamp, event.start + event.duration);
+  }
+  for (auto& counter : counters) {
+    os << delimiter
+       << "{\"name\":\"" << escapeJSON(counter.first) << "\","
+       << "\"cat\":\"taco\",\"ph\":\"C\","
+       << "\"ts\":" << lastTimestamp << ",\"pid\":1,"
+       << "\"args\":{\"value\":" << counter.second << "}}";
+    delimiter = ",\n";
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}" << endl;
+}
+
+string getChromeTrace() {
+  stringstream trace;
+  writeChromeTrace(trace);
+  return trace.str();
+}
+
+}
@@ -85,6 +85,11 @@ Expr Literal::zero(Datatype datatype) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+    case Datatype::BFloat16:
+      // 16-bit floats are computed in single precision
+      zero = Literal::make((float)0.0);
+      break;
     case Datatype::Float32:
       zero = Literal::make((float)0.0);
       break;
@@ -105,6 +110,86 @@ Expr Literal::zero(Datatype datatype) {
     return zero;
 }
 
+// Index arithmetic makes many small literals, so each thread shares one node
+// for each of those values
+static const int64_t MinInternedLiteral = -16;
+static const int64_t MaxInternedLiteral = 255;
+static const int NumInternedLiterals = MaxInternedLiteral - MinInternedLiteral + 1;
+
+/// Returns the interned literals of a type, or nullptr if it is not interned.
+static const Literal** getInternedLiterals(Datatype type) {
+  static const int NumInternedTypes = 9;
+  thread_local const Literal** interned = nullptr;
+  int typeIndex;
+  switch (type.getKind()) {
+    case Datatype::Bool:   typeIndex = 0; break;
+    case Datatype::UInt8:  typeIndex = 1; break;
+    case Datatype::UInt16: typeIndex = 2; break;
+    case Datatype::UInt32: typeIndex = 3; break;
+    case Datatype::UInt64: typeIndex = 4; break;
+    case Datatype::Int8:   typeIndex = 5; break;
+    case Datatype::Int16:  typeIndex = 6; break;
+    case Datatype::Int32:  typeIndex = 7; break;
+    case Datatype::Int64:  typeIndex = 8; break;
+    default:
+      return nullptr;
+  }
+  if (interned == nullptr) {
+    // Interned literals are immortal and live as long as the process
+    interned = new const Literal*[NumInternedTypes * NumInternedLiterals]();
+  }
+  return interned + typeIndex * NumInternedLiterals;
+}
+
+static bool getInternedIndex(const TypedComponentVal& val, Datatype type,
+                             int* index) {
+  const ComponentTypeUnion& value = val.get();
+  int64_t intValue;
+  switch (type.getKind()) {
+    case Datatype::Bool:   intValue = value.boolValue;   break;
+    case Datatype::UInt8:  intValue = value.uint8Value;  break;
+    case Datatype::UInt16: intValue = value.uint16Value; break;
+    case Datatype::UInt32: intValue = value.uint32Value; break;
+    case Datatype::UInt64:
+      if (value.uint64Value > (uint64_t)MaxInternedLiteral) return false;
+      intValue = (int64_t)value.uint64Value;
+      break;
+    case Datatype::Int8:   intValue = value.int8Value;   break;
+    case Datatype::Int16:  intValue = value.int16Value;  break;
+    case Datatype::Int32:  intValue = value.int32Value;  break;
+    case Datatype::Int64:  intValue = value.int64Value;  break;
+    default:
+      return false;
+  }
+  if (intValue < MinInternedLiteral || intValue > MaxInternedLiteral) {
+    return false;
+  }
+  *index = (int)(intValue - MinInternedLiteral);
+  return true;
+}
+
+Expr Literal::make(TypedComponentVal val, Datatype type) {
+  taco_iassert(isScalar(type));
+  const Literal** interned = getInternedLiterals(type);
+  int index = 0;
+  if (interned != nullptr && getInternedIndex(val, type, &index) &&
+      interned[index] != nullptr) {
+    return interned[index];
+  }
+
+  Literal *lit = new Literal;
+  lit->type = type;
+  lit->value = TypedComponentPtr(type, malloc(type.getNumBytes()));
+  *(lit->value) = val;
+  if (interned != nullptr && getInternedIndex(val, type, &index)) {
+    // Interned literals reach IR used by other threads, so they must not be
+    // refcounted
+    lit->ref = IRNode::Immortal;
+    interned[index] = lit;
+  }
+  return lit;
+}
+
 Literal::~Literal() {
   free(value.get());
 }
@@ -222,6 +307,12 @@ bool Literal::equalsScalar(double scalar) const {
     case Datatype::Int128:
       taco_not_supported_yet;
     break;
+    case Datatype::Float16:
+      return compare<float16>(this, scalar);
+    break;
+    case Datatype::BFloat16:
+      return compare<bfloat16>(this, scalar);
+    break;
     case Datatype::Float32:
       return compare<float>(this, scalar);
     break;
@@ -0,0 +1,1431 @@
+#include "taco/ir/ir_interpreter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "taco/error.h"
+#include "taco/taco_tensor_t.h"
+#include "taco/storage/allocator.h"
+#include "taco/util/collections.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+
+namespace taco {
+namespace ir {
+
+namespace {
+
+/// The value of a variable. Which member holds it follows from its type.
+union Value {
+  int64_t i;
+  double  f;
+  void*   p;
+};
+
+/// How values are represented while interpreting: booleans and integers as
+/// int64_t, floats as double (rounded to float precision where the generated
+/// code computes with floats), and arrays as pointers.
+enum class Kind {Int, Float, Ptr};
+
+/// Thrown while translating a function that cannot be interpreted.
+struct Unsupported {
+  string reason;
+};
+
+/// What to do after a statement has run.
+enum class Flow {Next, Break, Continue};
+
+struct ExprCode {
+  explicit ExprCode(Kind kind) : kind(kind) {}
+  virtual ~ExprCode() = default;
+  virtual int64_t evalInt(Value* frame) const {
+    taco_ierror;
+    return 0;
+  }
+  virtual double evalFloat(Value* frame) const {
+    taco_ierror;
+    return 0.0;
+  }
+  virtual void* evalPtr(Value* frame) const {
+    taco_ierror;
+    return nullptr;
+  }
+  const Kind kind;
+};
+typedef unique_ptr<const ExprCode> ExprPtr;
+
+struct StmtCode {
+  virtual ~StmtCode() = default;
+  virtual Flow exec(Value* frame) const = 0;
+};
+typedef unique_ptr<const StmtCode> StmtPtr;
+
+static Kind getValueKind(Datatype type) {
+  switch (type.getKind()) {
+    case Datatype::Bool:
+    case Datatype::UInt8:
+    case Datatype::UInt16:
+    case Datatype::UInt32:
+    case Datatype::UInt64:
+    case Datatype::Int8:
+    case Datatype::Int16:
+    case Datatype::Int32:
+    case Datatype::Int64:
+      return Kind::Int;
+    case Datatype::Float32:
+    case Datatype::Float64:
+      return Kind::Float;
+    default:
+      throw Unsupported{"values of type " + util::toString(type)};
+  }
+}
+
+/// Create a node templated on the C type of `type`.
+template <typename Base, template <typename> class Node, typename... Args>
+unique_ptr<const Base> makeTyped(Datatype type, Args&&... args) {
+  switch (type.getKind()) {
+    case Datatype::Bool:
+      return unique_ptr<const Base>(new Node<bool>(std::forward<Args>(args)...));
+    case Datatype::UInt8:
+      return unique_ptr<const Base>(
+          new Node<uint8_t>(std::forward<Args>(args)...));
+    case Datatype::UInt16:
+      return unique_ptr<const Base>(
+          new Node<uint16_t>(std::forward<Args>(args)...));
+    case Datatype::UInt32:
+      return unique_ptr<const Base>(
+          new Node<uint32_t>(std::forward<Args>(args)...));
+    case Datatype::UInt64:
+      return unique_ptr<const Base>(
+          new Node<uint64_t>(std::forward<Args>(args)...));
+    case Datatype::Int8:
+      return unique_ptr<const Base>(
+          new Node<int8_t>(std::forward<Args>(args)...));
+    case Datatype::Int16:
+      return unique_ptr<const Base>(
+          new Node<int16_t>(std::forward<Args>(args)...));
+    case Datatype::Int32:
+      return unique_ptr<const Base>(
+          new Node<int32_t>(std::forward<Args>(args)...));
+    case Datatype::Int64:
+      return unique_ptr<const Base>(
+          new Node<int64_t>(std::forward<Args>(args)...));
+    case Datatype::Float32:
+      return unique_ptr<const Base>(
+          new Node<float>(std::forward<Args>(args)...));
+    case Datatype::Float64:
+      return unique_ptr<const Base>(
+          new Node<double>(std::forward<Args>(args)...));
+    default:
+      throw Unsupported{"arrays of type " + util::toString(type)};
+  }
+}
+
+
+// Expressions
+
+struct IntConst : public ExprCode {
+  explicit IntConst(int64_t value) : ExprCode(Kind::Int), value(value) {}
+  int64_t evalInt(Value*) const override {return value;}
+  const int64_t value;
+};
+
+struct FloatConst : public ExprCode {
+  explicit FloatConst(double value) : ExprCode(Kind::Float), value(value) {}
+  double evalFloat(Value*) const override {return value;}
+  const double value;
+};
+
+struct NullPtr : public ExprCode {
+  NullPtr() : ExprCode(Kind::Ptr) {}
+  void* evalPtr(Value*) const override {return nullptr;}
+};
+
+struct Slot : public ExprCode {
+  Slot(Kind kind, int slot) : ExprCode(kind), slot(slot) {}
+  int64_t evalInt(Value* frame) const override {return frame[slot].i;}
+  double evalFloat(Value* frame) const override {return frame[slot].f;}
+  void* evalPtr(Value* frame) const override {return frame[slot].p;}
+  const int slot;
+};
+
+struct IntToFloat : public ExprCode {
+  explicit IntToFloat(ExprPtr a) : ExprCode(Kind::Float), a(std::move(a)) {}
+  double evalFloat(Value* frame) const override {
+    return (double)a->evalInt(frame);
+  }
+  const ExprPtr a;
+};
+
+struct FloatToInt : public ExprCode {
+  explicit FloatToInt(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    return (int64_t)a->evalFloat(frame);
+  }
+  const ExprPtr a;
+};
+
+struct FloatIsNonZero : public ExprCode {
+  explicit FloatIsNonZero(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    return a->evalFloat(frame) != 0.0;
+  }
+  const ExprPtr a;
+};
+
+/// Rounds to float precision.
+struct RoundFloat : public ExprCode {
+  explicit RoundFloat(ExprPtr a) : ExprCode(Kind::Float), a(std::move(a)) {}
+  double evalFloat(Value* frame) const override {
+    return (double)(float)a->evalFloat(frame);
+  }
+  const ExprPtr a;
+};
+
+/// Converts an integer to a narrower integer type (or to bool).
+template <typename T>
+struct Truncate : public ExprCode {
+  explicit Truncate(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    return (int64_t)(T)a->evalInt(frame);
+  }
+  const ExprPtr a;
+};
+
+template <typename Op>
+struct IntBinary : public ExprCode {
+  IntBinary(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return Op()(a->evalInt(frame), b->evalInt(frame));
+  }
+  const ExprPtr a, b;
+};
+
+template <typename Op>
+struct FloatBinary : public ExprCode {
+  FloatBinary(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Float), a(std::move(a)), b(std::move(b)) {}
+  double evalFloat(Value* frame) const override {
+    return Op()(a->evalFloat(frame), b->evalFloat(frame));
+  }
+  const ExprPtr a, b;
+};
+
+template <typename Op>
+struct IntCompare : public ExprCode {
+  IntCompare(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return Op()(a->evalInt(frame), b->evalInt(frame));
+  }
+  const ExprPtr a, b;
+};
+
+template <typename Op>
+struct FloatCompare : public ExprCode {
+  FloatCompare(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return Op()(a->evalFloat(frame), b->evalFloat(frame));
+  }
+  const ExprPtr a, b;
+};
+
+template <typename Op>
+struct PtrCompare : public ExprCode {
+  PtrCompare(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return Op()(a->evalPtr(frame), b->evalPtr(frame));
+  }
+  const ExprPtr a, b;
+};
+
+struct LogicalAnd : public ExprCode {
+  LogicalAnd(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return a->evalInt(frame) && b->evalInt(frame);
+  }
+  const ExprPtr a, b;
+};
+
+struct LogicalOr : public ExprCode {
+  LogicalOr(ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Int), a(std::move(a)), b(std::move(b)) {}
+  int64_t evalInt(Value* frame) const override {
+    return a->evalInt(frame) || b->evalInt(frame);
+  }
+  const ExprPtr a, b;
+};
+
+struct LogicalNot : public ExprCode {
+  explicit LogicalNot(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    return !a->evalInt(frame);
+  }
+  const ExprPtr a;
+};
+
+struct IntNeg : public ExprCode {
+  explicit IntNeg(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    return -a->evalInt(frame);
+  }
+  const ExprPtr a;
+};
+
+struct FloatNeg : public ExprCode {
+  explicit FloatNeg(ExprPtr a) : ExprCode(Kind::Float), a(std::move(a)) {}
+  double evalFloat(Value* frame) const override {
+    return -a->evalFloat(frame);
+  }
+  const ExprPtr a;
+};
+
+struct IntMin {
+  int64_t operator()(int64_t a, int64_t b) const {return a < b ? a : b;}
+};
+struct IntMax {
+  int64_t operator()(int64_t a, int64_t b) const {return a > b ? a : b;}
+};
+struct FloatMin {
+  double operator()(double a, double b) const {return a < b ? a : b;}
+};
+struct FloatMax {
+  double operator()(double a, double b) const {return a > b ? a : b;}
+};
+struct FloatRem {
+  double operator()(double a, double b) const {return std::fmod(a, b);}
+};
+
+template <typename T>
+struct LoadNode : public ExprCode {
+  LoadNode(ExprPtr arr, ExprPtr loc)
+      : ExprCode(std::is_floating_point<T>::value ? Kind::Float : Kind::Int),
+        arr(std::move(arr)), loc(std::move(loc)) {}
+  int64_t evalInt(Value* frame) const override {
+    return (int64_t)load(frame);
+  }
+  double evalFloat(Value* frame) const override {
+    return (double)load(frame);
+  }
+  T load(Value* frame) const {
+    return static_cast<const T*>(arr->evalPtr(frame))[loc->evalInt(frame)];
+  }
+  const ExprPtr arr, loc;
+};
+
+typedef double (*Math1)(double);
+typedef double (*Math2)(double, double);
+
+struct CallMath1 : public ExprCode {
+  CallMath1(Math1 func, ExprPtr a)
+      : ExprCode(Kind::Float), func(func), a(std::move(a)) {}
+  double evalFloat(Value* frame) const override {
+    return func(a->evalFloat(frame));
+  }
+  const Math1 func;
+  const ExprPtr a;
+};
+
+struct CallMath2 : public ExprCode {
+  CallMath2(Math2 func, ExprPtr a, ExprPtr b)
+      : ExprCode(Kind::Float), func(func), a(std::move(a)), b(std::move(b)) {}
+  double evalFloat(Value* frame) const override {
+    return func(a->evalFloat(frame), b->evalFloat(frame));
+  }
+  const Math2 func;
+  const ExprPtr a, b;
+};
+
+struct IntAbs : public ExprCode {
+  explicit IntAbs(ExprPtr a) : ExprCode(Kind::Int), a(std::move(a)) {}
+  int64_t evalInt(Value* frame) const override {
+    const int64_t value = a->evalInt(frame);
+    return value < 0 ? -value : value;
+  }
+  const ExprPtr a;
+};
+
+/// The mask of a coordinate's guard in a bit-packed workspace guard array.
+struct GuardBit : public ExprCode {
+  explicit GuardBit(ExprPtr coord)
+      : ExprCode(Kind::Int), coord(std::move(coord)) {}
+  int64_t evalInt(Value* frame) const override {
+    return (int64_t)((uint64_t)1 << (coord->evalInt(frame) & 63));
+  }
+  const ExprPtr coord;
+};
+
+/// Orders the index list of a workspace like taco_sort_index_list, which
+/// yields the sorted coordinates whichever way it orders them.
+struct SortIndexList : public ExprCode {
+  SortIndexList(ExprPtr list, ExprPtr size)
+      : ExprCode(Kind::Int), list(std::move(list)), size(std::move(size)) {}
+  int64_t evalInt(Value* frame) const override {
+    int32_t* begin = static_cast<int32_t*>(list->evalPtr(frame));
+    const int64_t count = size->evalInt(frame);
+    std::sort(begin, begin + count);
+    return count;
+  }
+  const ExprPtr list, size;
+};
+
+/// The binary searches of the generated code's runtime (see codegen_c.cpp).
+struct BinarySearch : public ExprCode {
+  BinarySearch(bool after, ExprPtr array, ExprPtr start, ExprPtr end,
+               ExprPtr target)
+      : ExprCode(Kind::Int), after(after), array(std::move(array)),
+        start(std::move(start)), end(std::move(end)),
+        target(std::move(target)) {}
+
+  int64_t evalInt(Value* frame) const override {
+    const int32_t* arr = static_cast<const int32_t*>(array->evalPtr(frame));
+    const int64_t arrayStart = start->evalInt(frame);
+    const int64_t arrayEnd = end->evalInt(frame);
+    const int64_t value = target->evalInt(frame);
+    if (after ? arr[arrayStart] >= value : arr[arrayEnd] <= value) {
+      return after ? arrayStart : arrayEnd;
+    }
+    int64_t lowerBound = arrayStart;
+    int64_t upperBound = arrayEnd;
+    while (upperBound - lowerBound > 1) {
+      const int64_t mid = (upperBound + lowerBound) / 2;
+      const int32_t midValue = arr[mid];
+      if (midValue < value) {
+        lowerBound = mid;
+      } else if (midValue > value) {
+        upperBound = mid;
+      } else {
+        return mid;
+      }
+    }
+    return after ? upperBound : lowerBound;
+  }
+
+  const bool after;
+  const ExprPtr array, start, end, target;
+};
+
+static void* allocate(taco_allocator_t* allocator, size_t size) {
+  return allocator->alloc(allocator->context, size, allocator->alignment);
+}
+
+struct CallocTemporary : public ExprCode {
+  CallocTemporary(ExprPtr num, ExprPtr size)
+      : ExprCode(Kind::Ptr), num(std::move(num)), size(std::move(size)) {}
+  void* evalPtr(Value* frame) const override {
+    const size_t bytes = num->evalInt(frame) * size->evalInt(frame);
+    void* ptr = allocate(getKernelTemporaryAllocatorTable(), bytes);
+    memset(ptr, 0, bytes);
+    return ptr;
+  }
+  const ExprPtr num, size;
+};
+
+struct MallocNode : public ExprCode {
+  explicit MallocNode(ExprPtr size)
+      : ExprCode(Kind::Ptr), size(std::move(size)) {}
+  void* evalPtr(Value* frame) const override {
+    return malloc(size->evalInt(frame));
+  }
+  const ExprPtr size;
+};
+
+
+// Statements
+
+struct Sequence : public StmtCode {
+  Flow exec(Value* frame) const override {
+    for (auto& stmt : stmts) {
+      const Flow flow = stmt->exec(frame);
+      if (flow != Flow::Next) {
+        return flow;
+      }
+    }
+    return Flow::Next;
+  }
+  vector<StmtPtr> stmts;
+};
+
+struct AssignInt : public StmtCode {
+  AssignInt(int slot, ExprPtr rhs) : slot(slot), rhs(std::move(rhs)) {}
+  Flow exec(Value* frame) const override {
+    frame[slot].i = rhs->evalInt(frame);
+    return Flow::Next;
+  }
+  const int slot;
+  const ExprPtr rhs;
+};
+
+struct AssignFloat : public StmtCode {
+  AssignFloat(int slot, ExprPtr rhs) : slot(slot), rhs(std::move(rhs)) {}
+  Flow exec(Value* frame) const override {
+    frame[slot].f = rhs->evalFloat(frame);
+    return Flow::Next;
+  }
+  const int slot;
+  const ExprPtr rhs;
+};
+
+struct AssignPtr : public StmtCode {
+  AssignPtr(int slot, ExprPtr rhs) : slot(slot), rhs(std::move(rhs)) {}
+  Flow exec(Value* frame) const override {
+    frame[slot].p = rhs->evalPtr(frame);
+    return Flow::Next;
+  }
+  const int slot;
+  const ExprPtr rhs;
+};
+
+template <typename T>
+struct StoreNode : public StmtCode {
+  StoreNode(ExprPtr arr, ExprPtr loc, ExprPtr data)
+      : arr(std::move(arr)), loc(std::move(loc)), data(std::move(data)) {}
+  Flow exec(Value* frame) const override {
+    T* array = static_cast<T*>(arr->evalPtr(frame));
+    const int64_t i = loc->evalInt(frame);
+    if (std::is_floating_point<T>::value) {
+      array[i] = (T)data->evalFloat(frame);
+    } else {
+      array[i] = (T)data->evalInt(frame);
+    }
+    return Flow::Next;
+  }
+  const ExprPtr arr, loc, data;
+};
+
+struct IfNode : public StmtCode {
+  IfNode(ExprPtr cond, StmtPtr then, StmtPtr otherwise)
+      : cond(std::move(cond)), then(std::move(then)),
+        otherwise(std::move(otherwise)) {}
+  Flow exec(Value* frame) const override {
+    if (cond->evalInt(frame)) {
+      return then->exec(frame);
+    } else if (otherwise) {
+      return otherwise->exec(frame);
+    }
+    return Flow::Next;
+  }
+  const ExprPtr cond;
+  const StmtPtr then, otherwise;
+};
+
+struct SwitchNode : public StmtCode {
+  Flow exec(Value* frame) const override {
+    const int64_t value = control->evalInt(frame);
+    for (auto& switchCase : cases) {
+      if (switchCase.first == value) {
+        // A break in a case leaves the switch
+        const Flow flow = switchCase.second->exec(frame);
+        return flow == Flow::Continue ? flow : Flow::Next;
+      }
+    }
+    return Flow::Next;
+  }
+  ExprPtr control;
+  vector<pair<int64_t,StmtPtr>> cases;
+};
+
+struct ForNode : public StmtCode {
+  ForNode(int slot, ExprPtr start, ExprPtr end, ExprPtr increment,
+          StmtPtr body)
+      : slot(slot), start(std::move(start)), end(std::move(end)),
+        increment(std::move(increment)), body(std::move(body)) {}
+  Flow exec(Value* frame) const override {
+    for (frame[slot].i = start->evalInt(frame);
+         frame[slot].i < end->evalInt(frame);
+         frame[slot].i += increment->evalInt(frame)) {
+      if (body->exec(frame) == Flow::Break) {
+        break;
+      }
+    }
+    return Flow::Next;
+  }
+  const int slot;
+  const ExprPtr start, end, increment;
+  const StmtPtr body;
+};
+
+struct WhileNode : public StmtCode {
+  WhileNode(ExprPtr cond, StmtPtr body)
+      : cond(std::move(cond)), body(std::move(body)) {}
+  Flow exec(Value* frame) const override {
+    while (cond->evalInt(frame)) {
+      if (body->exec(frame) == Flow::Break) {
+        break;
+      }
+    }
+    return Flow::Next;
+  }
+  const ExprPtr cond;
+  const StmtPtr body;
+};
+
+struct FlowNode : public StmtCode {
+  explicit FlowNode(Flow flow) : flow(flow) {}
+  Flow exec(Value*) const override {return flow;}
+  const Flow flow;
+};
+
+struct AllocateNode : public StmtCode {
+  AllocateNode(int slot, size_t elementSize, ExprPtr numElements,
+               bool isRealloc, taco_allocator_t* allocator)
+      : slot(slot), elementSize(elementSize),
+        numElements(std::move(numElements)), isRealloc(isRealloc),
+        allocator(allocator) {}
+  Flow exec(Value* frame) const override {
+    const size_t size = elementSize * numElements->evalInt(frame);
+    frame[slot].p = isRealloc
+        ? allocator->realloc(allocator->context, frame[slot].p, size,
+                             allocator->alignment)
+        : allocate(allocator, size);
+    return Flow::Next;
+  }
+  const int slot;
+  const size_t elementSize;
+  const ExprPtr numElements;
+  const bool isRealloc;
+  taco_allocator_t* const allocator;
+};
+
+struct FreeNode : public StmtCode {
+  explicit FreeNode(ExprPtr ptr) : ptr(std::move(ptr)) {}
+  Flow exec(Value* frame) const override {
+    taco_allocator_t* allocator = getKernelTemporaryAllocatorTable();
+    allocator->free(allocator->context, ptr->evalPtr(frame));
+    return Flow::Next;
+  }
+  const ExprPtr ptr;
+};
+
+/// Sorts coordinates like the generated qsort with the `cmp` comparator.
+struct SortNode : public StmtCode {
+  SortNode(ExprPtr array, ExprPtr size)
+      : array(std::move(array)), size(std::move(size)) {}
+  Flow exec(Value* frame) const override {
+    int32_t* begin = static_cast<int32_t*>(array->evalPtr(frame));
+    std::sort(begin, begin + size->evalInt(frame));
+    return Flow::Next;
+  }
+  const ExprPtr array, size;
+};
+
+/// A conversion of a printf format and the argument it prints, or only the
+/// text that precedes the next conversion if `arg` is null.
+struct PrintPiece {
+  string format;
+  ExprPtr arg;
+};
+
+/// Prints like the generated printf.
+struct PrintNode : public StmtCode {
+  Flow exec(Value* frame) const override {
+    for (auto& piece : pieces) {
+      if (!piece.arg) {
+        fputs(piece.format.c_str(), stdout);
+        continue;
+      }
+      switch (piece.arg->kind) {
+        case Kind::Int:
+          printf(piece.format.c_str(), (long long)piece.arg->evalInt(frame));
+          break;
+        case Kind::Float:
+          printf(piece.format.c_str(), piece.arg->evalFloat(frame));
+          break;
+        case Kind::Ptr:
+          printf(piece.format.c_str(), piece.arg->evalPtr(frame));
+          break;
+      }
+    }
+    return Flow::Next;
+  }
+  vector<PrintPiece> pieces;
+};
+
+/// Replace the escape sequences of a C string literal with the characters
+/// they stand for.
+static string unescape(const string& literal) {
+  string result;
+  for (size_t i = 0; i < literal.size(); i++) {
+    if (literal[i] != '\\' || i + 1 == literal.size()) {
+      result += literal[i];
+      continue;
+    }
+    switch (literal[++i]) {
+      case 'n':  result += '\n'; break;
+      case 't':  result += '\t'; break;
+      case 'r':  result += '\r'; break;
+      default:   result += literal[i]; break;
+    }
+  }
+  return result;
+}
+
+
+// Translation
+
+typedef tuple<const Var*, TensorProperty, int, int> PropertyKey;
+
+/// A tensor property that is unpacked into a slot when the function is called
+/// and, for results, packed back when it returns.
+struct Property {
+  int slot;
+  int parameter;
+  TensorProperty property;
+  int mode;
+  int index;
+  bool isResult;
+};
+
+/// Translates a lowered function into interpreter nodes.
+class Translator {
+public:
+  StmtPtr translateFunction(const Function* func) {
+    if (func->getReturnType().second != Datatype()) {
+      throw Unsupported{"coroutines"};
+    }
+    int parameter = 0;
+    for (auto& output : func->outputs) {
+      addParameter(output, parameter++, true);
+    }
+    for (auto& input : func->inputs) {
+      addParameter(input, parameter++, false);
+    }
+    return translate(func->body);
+  }
+
+  int numSlots = 0;
+  vector<pair<int,bool>> parameters;  ///< slots of tensors, and if results
+  vector<Property> properties;
+
+private:
+  map<const Var*, int> varSlots;
+  map<const Var*, pair<int,bool>> tensorParameters;
+  map<PropertyKey, int> propertySlots;
+
+  void addParameter(Expr param, int parameter, bool isResult) {
+    const Var* var = param.as<Var>();
+    taco_iassert(var != nullptr);
+    if (!var->is_tensor) {
+      throw Unsupported{"scalar parameters"};
+    }
+    const int slot = numSlots++;
+    varSlots.insert({var, slot});
+    tensorParameters.insert({var, {parameter, isResult}});
+    parameters.push_back({slot, isResult});
+  }
+
+  int getSlot(const Var* var) {
+    if (!util::contains(varSlots, var)) {
+      varSlots.insert({var, numSlots++});
+    }
+    return varSlots.at(var);
+  }
+
+  int getSlot(const GetProperty* op) {
+    const Var* tensor = op->tensor.as<Var>();
+    if (tensor == nullptr || !util::contains(tensorParameters, tensor)) {
+      throw Unsupported{"properties of tensors that are not parameters"};
+    }
+    switch (op->property) {
+      case TensorProperty::Dimension:
+      case TensorProperty::Indices:
+      case TensorProperty::Values:
+      case TensorProperty::ValuesSize:
+        break;
+      default:
+        throw Unsupported{"tensor property " + op->name};
+    }
+    const int index = (op->property == TensorProperty::Indices) ? op->index
+                                                                : 0;
+    const PropertyKey key{tensor, op->property, op->mode, index};
+    if (!util::contains(propertySlots, key)) {
+      const int slot = numSlots++;
+      propertySlots.insert({key, slot});
+      auto parameter = tensorParameters.at(tensor);
+      properties.push_back({slot, parameter.first, op->property, op->mode,
+                            index, parameter.second});
+    }
+    return propertySlots.at(key);
+  }
+
+  static Kind getExprKind(Expr expr) {
+    if (const Var* var = expr.as<Var>()) {
+      if (var->is_ptr || var->is_tensor) {
+        return Kind::Ptr;
+      }
+    } else if (const GetProperty* property = expr.as<GetProperty>()) {
+      if (property->property == TensorProperty::Indices ||
+          property->property == TensorProperty::Values) {
+        return Kind::Ptr;
+      }
+    } else if (const Call* call = expr.as<Call>()) {
+      if (call->func == "taco_calloc_temporary") {
+        return Kind::Ptr;
+      }
+    } else if (isa<Malloc>(expr)) {
+      return Kind::Ptr;
+    }
+    return getValueKind(expr.type());
+  }
+
+  static bool isZero(Expr expr) {
+    const Literal* literal = expr.as<Literal>();
+    return literal != nullptr && !literal->type.isFloat() &&
+           !literal->type.isComplex() && literal->equalsScalar(0);
+  }
+
+  /// Convert a value of type `from` to type `to`, like a C cast.
+  static ExprPtr convert(ExprPtr code, Datatype from, Datatype to) {
+    if (code->kind == Kind::Ptr) {
+      throw Unsupported{"conversions of pointers"};
+    }
+    switch (getValueKind(to)) {
+      case Kind::Float:
+        if (code->kind == Kind::Int) {
+          code.reset(new IntToFloat(std::move(code)));
+        }
+        if (to.getKind() == Datatype::Float32 &&
+            from.getKind() != Datatype::Float32) {
+          code.reset(new RoundFloat(std::move(code)));
+        }
+        return code;
+      case Kind::Int:
+        if (to.isBool()) {
+          if (code->kind == Kind::Float) {
+            code.reset(new FloatIsNonZero(std::move(code)));
+          } else if (!from.isBool()) {
+            code.reset(new Truncate<bool>(std::move(code)));
+          }
+          return code;
+        }
+        if (code->kind == Kind::Float) {
+          code.reset(new FloatToInt(std::move(code)));
+        }
+        if (from != to && to.getNumBits() < 64) {
+          code = makeTyped<ExprCode, Truncate>(to, std::move(code));
+        }
+        return code;
+      case Kind::Ptr:
+        break;
+    }
+    taco_ierror;
+    return code;
+  }
+
+  ExprPtr translate(Expr expr, Datatype to) {
+    return convert(translate(expr), expr.type(), to);
+  }
+
+  ExprPtr translatePtr(Expr expr) {
+    if (isZero(expr)) {
+      return ExprPtr(new NullPtr);
+    }
+    ExprPtr code = translate(expr);
+    if (code->kind != Kind::Ptr) {
+      throw Unsupported{"conversions to pointers"};
+    }
+    return code;
+  }
+
+  ExprPtr translateCond(Expr expr) {
+    return translate(expr, Bool);
+  }
+
+  template <template <typename> class Op>
+  ExprPtr translateArithmetic(Expr a, Expr b, Datatype type) {
+    return translateBinary<Op<int64_t>, Op<double>>(a, b, type);
+  }
+
+  template <typename IntOp, typename FloatOp>
+  ExprPtr translateBinary(Expr a, Expr b, Datatype type) {
+    ExprPtr codeA = translate(a, type);
+    ExprPtr codeB = translate(b, type);
+    if (getValueKind(type) == Kind::Float) {
+      ExprPtr code(new FloatBinary<FloatOp>(std::move(codeA),
+                                            std::move(codeB)));
+      return roundIfFloat(std::move(code), type);
+    }
+    return ExprPtr(new IntBinary<IntOp>(std::move(codeA), std::move(codeB)));
+  }
+
+  template <template <typename> class Op>
+  ExprPtr translateCompare(Expr a, Expr b) {
+    const Kind kindA = getExprKind(a);
+    const Kind kindB = getExprKind(b);
+    if (kindA == Kind::Ptr || kindB == Kind::Ptr) {
+      return ExprPtr(new PtrCompare<Op<const void*>>(translatePtr(a),
+                                                     translatePtr(b)));
+    }
+    if (kindA == Kind::Float || kindB == Kind::Float) {
+      return ExprPtr(new FloatCompare<Op<double>>(translate(a, Float64),
+                                                  translate(b, Float64)));
+    }
+    return ExprPtr(new IntCompare<Op<int64_t>>(translate(a, Int64),
+                                               translate(b, Int64)));
+  }
+
+  template <typename IntOp, typename FloatOp>
+  ExprPtr translateMinMax(const vector<Expr>& operands, Datatype type) {
+    taco_iassert(!operands.empty());
+    ExprPtr code = translate(operands[0], type);
+    for (size_t i = 1; i < operands.size(); i++) {
+      code = translateBinaryCode<IntOp, FloatOp>(
+          std::move(code), translate(operands[i], type), type);
+    }
+    return code;
+  }
+
+  template <typename IntOp, typename FloatOp>
+  static ExprPtr translateBinaryCode(ExprPtr a, ExprPtr b, Datatype type) {
+    if (getValueKind(type) == Kind::Float) {
+      return ExprPtr(new FloatBinary<FloatOp>(std::move(a), std::move(b)));
+    }
+    return ExprPtr(new IntBinary<IntOp>(std::move(a), std::move(b)));
+  }
+
+  static ExprPtr roundIfFloat(ExprPtr code, Datatype type) {
+    if (type.getKind() == Datatype::Float32) {
+      return ExprPtr(new RoundFloat(std::move(code)));
+    }
+    return code;
+  }
+
+  ExprPtr translateCall(const Call* op) {
+    static const map<string,Math1> math1 = {
+      {"sqrt",  [](double x) {return std::sqrt(x);}},
+      {"exp",   [](double x) {return std::exp(x);}},
+      {"log",   [](double x) {return std::log(x);}},
+      {"sin",   [](double x) {return std::sin(x);}},
+      {"cos",   [](double x) {return std::cos(x);}},
+      {"tan",   [](double x) {return std::tan(x);}},
+      {"asin",  [](double x) {return std::asin(x);}},
+      {"acos",  [](double x) {return std::acos(x);}},
+      {"atan",  [](double x) {return std::atan(x);}},
+      {"sinh",  [](double x) {return std::sinh(x);}},
+      {"cosh",  [](double x) {return std::cosh(x);}},
+      {"tanh",  [](double x) {return std::tanh(x);}},
+      {"asinh", [](double x) {return std::asinh(x);}},
+      {"acosh", [](double x) {return std::acosh(x);}},
+      {"atanh", [](double x) {return std::atanh(x);}},
+      {"cbrt",  [](double x) {return std::cbrt(x);}},
+      {"fabs",  [](double x) {return std::fabs(x);}}
+    };
+    static const map<string,Math2> math2 = {
+      {"pow",  [](double x, double y) {return std::pow(x, y);}},
+      {"fmod", [](double x, double y) {return std::fmod(x, y);}}
+    };
+
+    const vector<Expr>& args = op->args;
+    string func = op->func;
+    if (func == "taco_binarySearchAfter" || func == "taco_binarySearchBefore") {
+      taco_iassert(args.size() == 4);
+      return ExprPtr(new BinarySearch(func == "taco_binarySearchAfter",
+                                      translatePtr(args[0]),
+                                      translate(args[1], Int64),
+                                      translate(args[2], Int64),
+                                      translate(args[3], Int64)));
+    } else if (func == "taco_calloc_temporary") {
+      taco_iassert(args.size() == 2);
+      return ExprPtr(new CallocTemporary(translate(args[0], Int64),
+                                         translate(args[1], Int64)));
+    } else if (func == "taco_guard_bit") {
+      taco_iassert(args.size() == 1);
+      return ExprPtr(new GuardBit(translate(args[0], Int64)));
+    } else if (func == "taco_sort_index_list") {
+      taco_iassert(args.size() == 4);
+      return ExprPtr(new SortIndexList(translatePtr(args[0]),
+                                       translate(args[1], Int64)));
+    } else if (func == "abs" || func == "labs") {
+      taco_iassert(args.size() == 1);
+      return ExprPtr(new IntAbs(translate(args[0], Int64)));
+    }
+
+    // Single precision variants compute in double precision and round
+    Datatype type = Float64;
+    if (!util::contains(math1, func) && !util::contains(math2, func) &&
+        !func.empty() && func.back() == 'f') {
+      func.pop_back();
+      type = Float32;
+    }
+    if (util::contains(math1, func) && args.size() == 1) {
+      ExprPtr code(new CallMath1(math1.at(func), translate(args[0], type)));
+      return roundIfFloat(std::move(code), type);
+    } else if (util::contains(math2, func) && args.size() == 2) {
+      ExprPtr code(new CallMath2(math2.at(func), translate(args[0], type),
+                                 translate(args[1], type)));
+      return roundIfFloat(std::move(code), type);
+    }
+    throw Unsupported{"calls of " + op->func};
+  }
+
+  ExprPtr translate(Expr expr) {
+    taco_iassert(expr.defined());
+    switch (expr.ptr->type_info()) {
+      case IRNodeType::Literal: {
+        const Literal* op = expr.as<Literal>();
+        if (op->type.isFloat()) {
+          return ExprPtr(new FloatConst(op->getFloatValue()));
+        } else if (op->type.isBool()) {
+          return ExprPtr(new IntConst(op->getBoolValue()));
+        } else if (op->type.isUInt()) {
+          return ExprPtr(new IntConst((int64_t)op->getUIntValue()));
+        } else if (op->type.isInt()) {
+          return ExprPtr(new IntConst(op->getIntValue()));
+        }
+        throw Unsupported{"literals of type " + util::toString(op->type)};
+      }
+      case IRNodeType::Var: {
+        const Var* op = expr.as<Var>();
+        return ExprPtr(new Slot(getExprKind(expr), getSlot(op)));
+      }
+      case IRNodeType::GetProperty: {
+        const GetProperty* op = expr.as<GetProperty>();
+        return ExprPtr(new Slot(getExprKind(expr), getSlot(op)));
+      }
+      case IRNodeType::Neg: {
+        const Neg* op = expr.as<Neg>();
+        if (op->type.isBool()) {
+          return ExprPtr(new LogicalNot(translateCond(op->a)));
+        }
+        ExprPtr a = translate(op->a, op->type);
+        if (a->kind == Kind::Float) {
+          return ExprPtr(new FloatNeg(std::move(a)));
+        }
+        return ExprPtr(new IntNeg(std::move(a)));
+      }
+      case IRNodeType::Sqrt: {
+        const Sqrt* op = expr.as<Sqrt>();
+        ExprPtr code(new CallMath1([](double x) {return std::sqrt(x);},
+                                   translate(op->a, op->type)));
+        return roundIfFloat(std::move(code), op->type);
+      }
+      case IRNodeType::Add: {
+        const Add* op = expr.as<Add>();
+        return translateArithmetic<std::plus>(op->a, op->b, op->type);
+      }
+      case IRNodeType::Sub: {
+        const Sub* op = expr.as<Sub>();
+        return translateArithmetic<std::minus>(op->a, op->b, op->type);
+      }
+      case IRNodeType::Mul: {
+        const Mul* op = expr.as<Mul>();
+        return translateArithmetic<std::multiplies>(op->a, op->b, op->type);
+      }
+      case IRNodeType::Div: {
+        const Div* op = expr.as<Div>();
+        return translateArithmetic<std::divides>(op->a, op->b, op->type);
+      }
+      case IRNodeType::Rem: {
+        const Rem* op = expr.as<Rem>();
+        return translateBinary<std::modulus<int64_t>, FloatRem>(op->a, op->b,
+                                                                op->type);
+      }
+      case IRNodeType::Min: {
+        const Min* op = expr.as<Min>();
+        return translateMinMax<IntMin, FloatMin>(op->operands, op->type);
+      }
+      case IRNodeType::Max: {
+        const Max* op = expr.as<Max>();
+        return translateMinMax<IntMax, FloatMax>(op->operands, op->type);
+      }
+      case IRNodeType::BitAnd: {
+        const BitAnd* op = expr.as<BitAnd>();
+        return ExprPtr(new IntBinary<std::bit_and<int64_t>>(
+            translate(op->a, op->type), translate(op->b, op->type)));
+      }
+      case IRNodeType::BitOr: {
+        const BitOr* op = expr.as<BitOr>();
+        return ExprPtr(new IntBinary<std::bit_or<int64_t>>(
+            translate(op->a, op->type), translate(op->b, op->type)));
+      }
+      case IRNodeType::Eq: {
+        const Eq* op = expr.as<Eq>();
+        return translateCompare<std::equal_to>(op->a, op->b);
+      }
+      case IRNodeType::Neq: {
+        const Neq* op = expr.as<Neq>();
+        return translateCompare<std::not_equal_to>(op->a, op->b);
+      }
+      case IRNodeType::Gt: {
+        const Gt* op = expr.as<Gt>();
+        return translateCompare<std::greater>(op->a, op->b);
+      }
+      case IRNodeType::Lt: {
+        const Lt* op = expr.as<Lt>();
+        return translateCompare<std::less>(op->a, op->b);
+      }
+      case IRNodeType::Gte: {
+        const Gte* op = expr.as<Gte>();
+        return translateCompare<std::greater_equal>(op->a, op->b);
+      }
+      case IRNodeType::Lte: {
+        const Lte* op = expr.as<Lte>();
+        return translateCompare<std::less_equal>(op->a, op->b);
+      }
+      case IRNodeType::And: {
+        const And* op = expr.as<And>();
+        return ExprPtr(new LogicalAnd(translateCond(op->a),
+                                      translateCond(op->b)));
+      }
+      case IRNodeType::Or: {
+        const Or* op = expr.as<Or>();
+        return ExprPtr(new LogicalOr(translateCond(op->a),
+                                     translateCond(op->b)));
+      }
+      case IRNodeType::Cast: {
+        const Cast* op = expr.as<Cast>();
+        return translate(op->a, op->type);
+      }
+      case IRNodeType::Call:
+        return translateCall(expr.as<Call>());
+      case IRNodeType::Load: {
+        const Load* op = expr.as<Load>();
+        return makeTyped<ExprCode, LoadNode>(op->arr.type(),
+                                             translatePtr(op->arr),
+                                             translate(op->loc, Int64));
+      }
+      case IRNodeType::Malloc: {
+        const Malloc* op = expr.as<Malloc>();
+        return ExprPtr(new MallocNode(translate(op->size, Int64)));
+      }
+      case IRNodeType::Sizeof: {
+        const Sizeof* op = expr.as<Sizeof>();
+        return ExprPtr(new IntConst(
+            op->sizeofType.getDataType().getNumBytes()));
+      }
+      default:
+        throw Unsupported{"expression " + util::toString(expr)};
+    }
+  }
+
+  /// Translate an assignment to a variable or tensor property.
+  StmtPtr translateAssign(Expr lhs, Expr rhs) {
+    int slot;
+    if (const Var* var = lhs.as<Var>()) {
+      slot = getSlot(var);
+    } else if (const GetProperty* property = lhs.as<GetProperty>()) {
+      slot = getSlot(property);
+    } else {
+      throw Unsupported{"assignments to " + util::toString(lhs)};
+    }
+    switch (getExprKind(lhs)) {
+      case Kind::Int:
+        return StmtPtr(new AssignInt(slot, translate(rhs, lhs.type())));
+      case Kind::Float:
+        return StmtPtr(new AssignFloat(slot, translate(rhs, lhs.type())));
+      case Kind::Ptr:
+        return StmtPtr(new AssignPtr(slot, translatePtr(rhs)));
+    }
+    taco_ierror;
+    return nullptr;
+  }
+
+  /// Translate a statement, or return nullptr if it does nothing.
+  StmtPtr translate(Stmt stmt) {
+    if (!stmt.defined()) {
+      return nullptr;
+    }
+    switch (stmt.ptr->type_info()) {
+      case IRNodeType::Block: {
+        unique_ptr<Sequence> sequence(new Sequence);
+        for (auto& child : stmt.as<Block>()->contents) {
+          if (StmtPtr code = translate(child)) {
+            sequence->stmts.push_back(std::move(code));
+          }
+        }
+        if (sequence->stmts.size() == 1) {
+          return std::move(sequence->stmts[0]);
+        }
+        return StmtPtr(sequence.release());
+      }
+      case IRNodeType::Scope:
+        return translate(stmt.as<Scope>()->scopedStmt);
+      case IRNodeType::VarDecl: {
+        const VarDecl* op = stmt.as<VarDecl>();
+        return translateAssign(op->var, op->rhs);
+      }
+      case IRNodeType::VarAssign: {
+        const Assign* op = stmt.as<Assign>();
+        return translateAssign(op->lhs, op->rhs);
+      }
+      case IRNodeType::Store: {
+        const Store* op = stmt.as<Store>();
+        const Datatype type = op->arr.type();
+        return makeTyped<StmtCode, StoreNode>(type, translatePtr(op->arr),
+                                              translate(op->loc, Int64),
+                                              translate(op->data, type));
+      }
+      case IRNodeType::IfThenElse: {
+        const IfThenElse* op = stmt.as<IfThenElse>();
+        return StmtPtr(new IfNode(translateCond(op->cond),
+                                  translateOrSkip(op->then),
+                                  translate(op->otherwise)));
+      }
+      case IRNodeType::Case: {
+        // Translate into a chain of conditionals, from the last clause
+        const Case* op = stmt.as<Case>();
+        StmtPtr code;
+        for (size_t i = op->clauses.size(); i > 0; i--) {
+          auto& clause = op->clauses[i - 1];
+          if (i == op->clauses.size() && op->alwaysMatch) {
+            code = translateOrSkip(clause.second);
+          } else {
+            code.reset(new IfNode(translateCond(clause.first),
+                                  translateOrSkip(clause.second),
+                                  std::move(code)));
+          }
+        }
+        return code;
+      }
+      case IRNodeType::Switch: {
+        const Switch* op = stmt.as<Switch>();
+        unique_ptr<SwitchNode> code(new SwitchNode);
+        code->control = translate(op->controlExpr, Int64);
+        for (auto& switchCase : op->cases) {
+          const Literal* value = switchCase.first.as<Literal>();
+          if (value == nullptr) {
+            throw Unsupported{"switch cases that are not literals"};
+          }
+          code->cases.push_back({value->getIntValue(),
+                                 translateOrSkip(switchCase.second)});
+        }
+        return StmtPtr(code.release());
+      }
+      case IRNodeType::For: {
+        const For* op = stmt.as<For>();
+        const Var* var = op->var.as<Var>();
+        if (var == nullptr || getExprKind(op->var) != Kind::Int) {
+          throw Unsupported{"loops over " + util::toString(op->var)};
+        }
+        return StmtPtr(new ForNode(getSlot(var),
+                                   translate(op->start, op->var.type()),
+                                   translate(op->end, Int64),
+                                   translate(op->increment, Int64),
+                                   translateOrSkip(op->contents)));
+      }
+      case IRNodeType::While: {
+        const While* op = stmt.as<While>();
+        return StmtPtr(new WhileNode(translateCond(op->cond),
+                                     translateOrSkip(op->contents)));
+      }
+      case IRNodeType::Allocate: {
+        const Allocate* op = stmt.as<Allocate>();
+        int slot;
+        taco_allocator_t* allocator;
+        if (const GetProperty* property = op->var.as<GetProperty>()) {
+          slot = getSlot(property);
+          allocator = getKernelAllocatorTable();
+        } else if (const Var* var = op->var.as<Var>()) {
+          slot = getSlot(var);
+          allocator = getKernelTemporaryAllocatorTable();
+        } else {
+          throw Unsupported{"allocations of " + util::toString(op->var)};
+        }
+        return StmtPtr(new AllocateNode(slot, op->var.type().getNumBytes(),
+                                        translate(op->num_elements, Int64),
+                                        op->is_realloc, allocator));
+      }
+      case IRNodeType::Free:
+        return StmtPtr(new FreeNode(translatePtr(stmt.as<Free>()->var)));
+      case IRNodeType::Sort: {
+        const Sort* op = stmt.as<Sort>();
+        taco_iassert(op->args.size() == 4);
+        if (op->args[0].type().getKind() != Datatype::Int32) {
+          throw Unsupported{"sorts of " + util::toString(op->args[0].type())};
+        }
+        return StmtPtr(new SortNode(translatePtr(op->args[0]),
+                                    translate(op->args[1], Int64)));
+      }
+      case IRNodeType::Print:
+        return translatePrint(stmt.as<Print>());
+      case IRNodeType::Break:
+        return StmtPtr(new FlowNode(Flow::Break));
+      case IRNodeType::Continue:
+        return StmtPtr(new FlowNode(Flow::Continue));
+      case IRNodeType::Comment:
+      case IRNodeType::BlankLine:
+        return nullptr;
+      default:
+        throw Unsupported{"statement " + util::toString(stmt)};
+    }
+  }
+
+  /// Split a printf into its conversions, each printed with the argument
+  /// converted to the type the conversion expects.
+  StmtPtr translatePrint(const Print* op) {
+    const string fmt = unescape(op->fmt);
+    unique_ptr<PrintNode> code(new PrintNode);
+    string text;
+    size_t arg = 0;
+    for (size_t i = 0; i < fmt.size(); i++) {
+      if (fmt[i] != '%') {
+        text += fmt[i];
+        continue;
+      }
+      if (i + 1 < fmt.size() && fmt[i + 1] == '%') {
+        text += '%';
+        i++;
+        continue;
+      }
+      if (!text.empty()) {
+        code->pieces.push_back({text, nullptr});
+        text.clear();
+      }
+      // Keep the flags, width and precision, and drop the length modifiers
+      string format = "%";
+      size_t end = i + 1;
+      while (end < fmt.size() && strchr("-+ #0123456789.", fmt[end])) {
+        format += fmt[end++];
+      }
+      while (end < fmt.size() && strchr("hlLqjzt", fmt[end])) {
+        end++;
+      }
+      if (end == fmt.size() || arg == op->params.size()) {
+        throw Unsupported{"print format \"" + op->fmt + "\""};
+      }
+      const char conversion = fmt[end];
+      const Expr param = op->params[arg++];
+      if (strchr("di", conversion)) {
+        code->pieces.push_back({format + "lld", translate(param, Int64)});
+      } else if (strchr("ouxX", conversion)) {
+        code->pieces.push_back({format + "ll" + conversion,
+                                translate(param, Int64)});
+      } else if (strchr("fFeEgGaA", conversion)) {
+        code->pieces.push_back({format + conversion,
+                                translate(param, Float64)});
+      } else if (conversion == 'p') {
+        code->pieces.push_back({format + conversion, translatePtr(param)});
+      } else {
+        throw Unsupported{"print format \"" + op->fmt + "\""};
+      }
+      i = end;
+    }
+    if (!text.empty()) {
+      code->pieces.push_back({text, nullptr});
+    }
+    return StmtPtr(code.release());
+  }
+
+  /// Translate a statement that must have code, even if it does nothing.
+  StmtPtr translateOrSkip(Stmt stmt) {
+    StmtPtr code = translate(stmt);
+    return code ? std::move(code) : StmtPtr(new Sequence);
+  }
+};
+
+}
+
+
+// class Interpreter
+struct Interpreter::Content {
+  bool supported = false;
+  string unsupportedReason;
+  StmtPtr body;
+  int numSlots = 0;
+  vector<pair<int,bool>> parameters;
+  vector<Property> properties;
+};
+
+Interpreter::Interpreter() {
+  shared_ptr<Content> content = make_shared<Content>();
+  content->unsupportedReason = "there is no function";
+  this->content = content;
+}
+
+Interpreter::Interpreter(Stmt func) {
+  const Function* function = func.as<Function>();
+  taco_iassert(function != nullptr) << "Only functions can be interpreted";
+
+  shared_ptr<Content> content = make_shared<Content>();
+  Translator translator;
+  try {
+    content->body = translator.translateFunction(function);
+    content->supported = true;
+  } catch (const Unsupported& unsupported) {
+    content->unsupportedReason = unsupported.reason;
+  }
+  content->numSlots = translator.numSlots;
+  content->parameters = translator.parameters;
+  content->properties = translator.properties;
+  this->content = content;
+}
+
+bool Interpreter::isSupported() const {
+  return content->supported;
+}
+
+std::string Interpreter::getUnsupportedReason() const {
+  return content->unsupportedReason;
+}
+
+int Interpreter::call(void** args) const {
+  taco_iassert(isSupported()) << "Cannot interpret the function: "
+                              << getUnsupportedReason();
+  vector<Value> frame(content->numSlots);
+  for (size_t i = 0; i < content->parameters.size(); i++) {
+    frame[content->parameters[i].first].p = args[i];
+  }
+
+  // Unpack the properties of the tensors
+  for (auto& property : content->properties) {
+    const taco_tensor_t* tensor = (taco_tensor_t*)args[property.parameter];
+    Value& value = frame[property.slot];
+    switch (property.property) {
+      case TensorProperty::Dimension:
+        value.i = tensor->dimensions[property.mode];
+        break;
+      case TensorProperty::Indices:
+        value.p = tensor->indices[property.mode][property.index];
+        break;
+      case TensorProperty::Values:
+        value.p = tensor->vals;
+        break;
+      case TensorProperty::ValuesSize:
+        value.i = tensor->vals_size;
+        break;
+      default:
+        taco_ierror;
+    }
+  }
+
+  if (content->body) {
+    content->body->exec(frame.data());
+  }
+
+  // Pack the (possibly reallocated) arrays of the results
+  for (auto& property : content->properties) {
+    if (!property.isResult) {
+      continue;
+    }
+    taco_tensor_t* tensor = (taco_tensor_t*)args[property.parameter];
+    const Value& value = frame[property.slot];
+    switch (property.property) {
+      case TensorProperty::Indices:
+        tensor->indices[property.mode][property.index] = (uint8_t*)value.p;
+        break;
+      case TensorProperty::Values:
+        tensor->vals = (uint8_t*)value.p;
+        break;
+      case TensorProperty::ValuesSize:
+        tensor->vals_size = (int32_t)value.i;
+        break;
+      default:
+        break;
+    }
+  }
+  return 0;
+}
+
+}}
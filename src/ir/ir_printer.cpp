@@ -1,3 +1,5 @@
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <iostream>
 
@@ -88,17 +90,32 @@ void IRPrinter::visit(const Literal* op) {
       stream << op->getValue<int32_t>();
     break;
     case Datatype::Int64:
-      stream << op->getValue<int64_t>();
+      // The negation of 9223372036854775808 does not fit in a long long
+      if (op->getValue<int64_t>() == std::numeric_limits<int64_t>::min()) {
+        stream << "INT64_MIN";
+      } else {
+        stream << op->getValue<int64_t>();
+      }
     break;
     case Datatype::Int128:
       taco_not_supported_yet;
     break;
+    case Datatype::Float16:
+      stream << util::toString((float)op->getValue<float16>());
+    break;
+    case Datatype::BFloat16:
+      stream << util::toString((float)op->getValue<bfloat16>());
+    break;
     case Datatype::Float32:
-      stream << ((op->getValue<float>() != 0.0)
+      stream << (std::isinf(op->getValue<float>())
+                 ? (op->getValue<float>() > 0 ? "INFINITY" : "-INFINITY")
+                 : (op->getValue<float>() != 0.0)
                  ? util::toString(op->getValue<float>()) : "0.0");
     break;
     case Datatype::Float64:
-      stream << ((op->getValue<double>()!=0.0)
+      stream << (std::isinf(op->getValue<double>())
+                 ? (op->getValue<double>() > 0 ? "INFINITY" : "-INFINITY")
+                 : (op->getValue<double>()!=0.0)
                  ? util::toString(op->getValue<double>()) : "0.0");
     break;
     case Datatype::Complex64: {
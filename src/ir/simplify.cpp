@@ -1,5 +1,6 @@
 #include "taco/ir/simplify.h"
 
+#include <algorithm>
 #include <map>
 #include <queue>
 
@@ -413,6 +414,12 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
       Expr rhs = rewrite(decl->rhs);
       stmt = (rhs == decl->rhs) ? decl : VarDecl::make(decl->var, rhs);
 
+      // A variable that is declared again (e.g. in a sibling loop) no longer
+      // holds the copy from its earlier declaration
+      if (decl->var.type().isInt()) {
+        invalidate(decl->var);
+      }
+
       declarations.insert({decl->var, stmt});
       if (decl->var.type().isInt() && isa<Var>(rhs) && 
           !util::contains(loopDependentVars, decl->var)) {
@@ -438,9 +445,12 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
       if (!assign->lhs.type().isInt()) {
         return;
       }
-      
+      invalidate(assign->lhs);
+    }
+
+    void invalidate(const Expr& var) {
       std::queue<Expr> invalidVars;
-      invalidVars.push(assign->lhs);
+      invalidVars.push(var);
 
       while (!invalidVars.empty()) {
         Expr invalidVar = invalidVars.front();
@@ -491,4 +501,1154 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
   return simplifiedStmt;
 }
 
+namespace {
+
+bool equals(const Expr& a, const Expr& b);
+
+template <typename T>
+bool equalsBinary(const Expr& a, const Expr& b) {
+  return equals(to<T>(a)->a, to<T>(b)->a) && equals(to<T>(a)->b, to<T>(b)->b);
+}
+
+template <typename T>
+bool equalsOperands(const Expr& a, const Expr& b) {
+  const auto& operandsA = to<T>(a)->operands;
+  const auto& operandsB = to<T>(b)->operands;
+  if (operandsA.size() != operandsB.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < operandsA.size(); i++) {
+    if (!equals(operandsA[i], operandsB[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Whether two side-effect free expressions compute the same value, comparing
+/// variables by identity and tensor properties by what they refer to.
+bool equals(const Expr& a, const Expr& b) {
+  if (a.ptr == b.ptr) {
+    return true;
+  }
+  if (!a.defined() || !b.defined() || a.type() != b.type() ||
+      a.ptr->type_info() != b.ptr->type_info()) {
+    return false;
+  }
+  switch (a.ptr->type_info()) {
+    case IRNodeType::Literal: {
+      auto literalA = to<Literal>(a);
+      auto literalB = to<Literal>(b);
+      if (literalA->type.isInt()) {
+        return literalA->getIntValue() == literalB->getIntValue();
+      }
+      if (literalA->type.isUInt()) {
+        return literalA->getUIntValue() == literalB->getUIntValue();
+      }
+      return false;
+    }
+    case IRNodeType::GetProperty: {
+      auto propertyA = to<GetProperty>(a);
+      auto propertyB = to<GetProperty>(b);
+      return equals(propertyA->tensor, propertyB->tensor) &&
+             propertyA->property == propertyB->property &&
+             propertyA->mode == propertyB->mode &&
+             propertyA->index == propertyB->index;
+    }
+    case IRNodeType::Neg:
+      return equals(to<Neg>(a)->a, to<Neg>(b)->a);
+    case IRNodeType::Cast:
+      return equals(to<Cast>(a)->a, to<Cast>(b)->a);
+    case IRNodeType::Add:
+      return equalsBinary<Add>(a, b);
+    case IRNodeType::Sub:
+      return equalsBinary<Sub>(a, b);
+    case IRNodeType::Mul:
+      return equalsBinary<Mul>(a, b);
+    case IRNodeType::Div:
+      return equalsBinary<Div>(a, b);
+    case IRNodeType::Rem:
+      return equalsBinary<Rem>(a, b);
+    case IRNodeType::Min:
+      return equalsOperands<Min>(a, b);
+    case IRNodeType::Max:
+      return equalsOperands<Max>(a, b);
+    case IRNodeType::Load:
+      return equals(to<Load>(a)->arr, to<Load>(b)->arr) &&
+             equals(to<Load>(a)->loc, to<Load>(b)->loc);
+    default:
+      return false;
+  }
+}
+
+bool isTrivial(const Expr& expr) {
+  return isa<Var>(expr) || isa<Literal>(expr) || isa<GetProperty>(expr);
+}
+
+/// Whether `expr` is integer arithmetic that can be evaluated anywhere without
+/// side effects or traps, and, if `allowLoads`, loads from index arrays.
+bool isIndexArithmetic(const Expr& expr, bool allowLoads) {
+  if (!expr.type().isInt() && !expr.type().isUInt()) {
+    return false;
+  }
+  switch (expr.ptr->type_info()) {
+    case IRNodeType::Literal:
+    case IRNodeType::GetProperty:
+      return true;
+    case IRNodeType::Var:
+      return !to<Var>(expr)->is_ptr && !to<Var>(expr)->is_tensor;
+    case IRNodeType::Neg:
+      return isIndexArithmetic(to<Neg>(expr)->a, allowLoads);
+    case IRNodeType::Cast:
+      return isIndexArithmetic(to<Cast>(expr)->a, allowLoads);
+    case IRNodeType::Add:
+      return isIndexArithmetic(to<Add>(expr)->a, allowLoads) &&
+             isIndexArithmetic(to<Add>(expr)->b, allowLoads);
+    case IRNodeType::Sub:
+      return isIndexArithmetic(to<Sub>(expr)->a, allowLoads) &&
+             isIndexArithmetic(to<Sub>(expr)->b, allowLoads);
+    case IRNodeType::Mul:
+      return isIndexArithmetic(to<Mul>(expr)->a, allowLoads) &&
+             isIndexArithmetic(to<Mul>(expr)->b, allowLoads);
+    case IRNodeType::Div:
+      // Only divisions that cannot divide by zero
+      return isa<Literal>(to<Div>(expr)->b) &&
+             !to<Literal>(to<Div>(expr)->b)->equalsScalar(0) &&
+             isIndexArithmetic(to<Div>(expr)->a, allowLoads);
+    case IRNodeType::Rem:
+      return isa<Literal>(to<Rem>(expr)->b) &&
+             !to<Literal>(to<Rem>(expr)->b)->equalsScalar(0) &&
+             isIndexArithmetic(to<Rem>(expr)->a, allowLoads);
+    case IRNodeType::Min:
+      for (auto& operand : to<Min>(expr)->operands) {
+        if (!isIndexArithmetic(operand, allowLoads)) return false;
+      }
+      return true;
+    case IRNodeType::Max:
+      for (auto& operand : to<Max>(expr)->operands) {
+        if (!isIndexArithmetic(operand, allowLoads)) return false;
+      }
+      return true;
+    case IRNodeType::Load:
+      return allowLoads && (isa<Var>(to<Load>(expr)->arr) ||
+                            isa<GetProperty>(to<Load>(expr)->arr)) &&
+             isIndexArithmetic(to<Load>(expr)->loc, allowLoads);
+    default:
+      return false;
+  }
+}
+
+/// The variables, tensor properties and arrays that a statement may write.
+struct Writes : IRVisitor {
+  std::vector<Expr> written;
+
+  // Calls and sorts may write to any array
+  bool writesArrays = false;
+
+  using IRVisitor::visit;
+
+  void visit(const VarDecl* op) {
+    written.push_back(op->var);
+    op->rhs.accept(this);
+  }
+
+  void visit(const Assign* op) {
+    written.push_back(op->lhs);
+    op->rhs.accept(this);
+  }
+
+  void visit(const Store* op) {
+    written.push_back(op->arr);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const For* op) {
+    written.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Allocate* op) {
+    written.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Free* op) {
+    written.push_back(op->var);
+  }
+
+  void visit(const Call* op) {
+    writesArrays = true;
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Sort* op) {
+    writesArrays = true;
+    IRVisitor::visit(op);
+  }
+};
+
+Writes getWrites(const Stmt& stmt) {
+  Writes writes;
+  stmt.accept(&writes);
+  return writes;
+}
+
+/// Whether `expr` has the same value before and after the writes.
+bool isInvariant(const Expr& expr, const Writes& writes) {
+  struct Invariance : IRVisitor {
+    const Writes& writes;
+    bool invariant = true;
+
+    using IRVisitor::visit;
+
+    Invariance(const Writes& writes) : writes(writes) {}
+
+    bool isWritten(const Expr& expr) {
+      for (auto& written : writes.written) {
+        if (equals(written, expr)) return true;
+      }
+      return false;
+    }
+
+    void visit(const Var* op) {
+      invariant = invariant && !isWritten(op);
+    }
+
+    void visit(const GetProperty* op) {
+      invariant = invariant && !isWritten(op);
+    }
+
+    void visit(const Load* op) {
+      invariant = invariant && !writes.writesArrays && !isWritten(op->arr);
+      op->loc.accept(this);
+    }
+  };
+  Invariance invariance(writes);
+  expr.accept(&invariance);
+  return invariance.invariant;
+}
+
+/// Names a variable that holds the value of `expr` after its operands.
+std::string getTempName(const Expr& expr) {
+  struct GetOperandNames : IRVisitor {
+    std::vector<std::string> names;
+
+    using IRVisitor::visit;
+
+    void visit(const Var* op) {
+      names.push_back(op->name);
+    }
+
+    void visit(const GetProperty* op) {
+      names.push_back(op->name);
+    }
+  };
+  GetOperandNames operandNames;
+  expr.accept(&operandNames);
+  return operandNames.names.empty() ? "t"
+                                    : util::join(operandNames.names, "_");
+}
+
+Stmt getLoopBody(const Stmt& contents) {
+  return isa<Scope>(contents) ? to<Scope>(contents)->scopedStmt : contents;
+}
+
+Stmt rebuildLoop(const For* op, Expr end, Stmt contents) {
+  if (end == op->end && contents == op->contents) {
+    return op;
+  }
+  return For::make(op->var, op->start, end, op->increment, contents, op->kind,
+                   op->parallel_unit, op->unrollFactor, op->vec_width);
+}
+
+/// Replaces the loop invariant index arithmetic of a loop by variables that
+/// are declared before the loop.  Loads are only hoisted from the loop bounds
+/// and conditions, which are evaluated even if the loop never runs.
+struct InvariantExtractor : IRRewriter {
+  const Writes& writes;
+  std::set<Expr>& hoistedVars;
+  bool allowLoads = false;
+
+  // The name of the variable that holds a hoisted loop bound
+  Expr bound;
+  std::string boundName;
+
+  std::vector<Stmt> decls;
+  std::vector<std::pair<Expr,Expr>> hoisted;
+
+  using IRRewriter::visit;
+
+  InvariantExtractor(const Writes& writes, std::set<Expr>& hoistedVars)
+      : writes(writes), hoistedVars(hoistedVars) {}
+
+  Expr hoist(const Expr& expr, bool loads) {
+    allowLoads = loads;
+    Expr result = rewrite(expr);
+    allowLoads = false;
+    return result;
+  }
+
+  Expr hoistBound(const Expr& end, const Expr& loopVar) {
+    bound = end;
+    boundName = to<Var>(loopVar)->name + "_end";
+    Expr result = hoist(end, true);
+    bound = Expr();
+    return result;
+  }
+
+  Expr hoistCondition(const Expr& cond) {
+    // Only the left operands of short-circuiting conditions are evaluated
+    // whenever the condition is
+    if (isa<And>(cond)) {
+      return And::make(hoistCondition(to<And>(cond)->a),
+                       hoist(to<And>(cond)->b, false));
+    }
+    if (isa<Or>(cond)) {
+      return Or::make(hoistCondition(to<Or>(cond)->a),
+                      hoist(to<Or>(cond)->b, false));
+    }
+    return hoist(cond, true);
+  }
+
+  bool extract(const Expr& op) {
+    if (isTrivial(op) || !isIndexArithmetic(op, allowLoads) ||
+        !isInvariant(op, writes)) {
+      return false;
+    }
+    for (auto& hoistedExpr : hoisted) {
+      if (equals(hoistedExpr.first, op)) {
+        expr = hoistedExpr.second;
+        return true;
+      }
+    }
+    Expr var = Var::make((op == bound) ? boundName : getTempName(op),
+                         op.type());
+    decls.push_back(VarDecl::make(var, op));
+    hoisted.push_back({op, var});
+    hoistedVars.insert(var);
+    expr = var;
+    return true;
+  }
+
+  void visit(const Neg* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Cast* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Add* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Sub* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Mul* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Div* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Rem* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Min* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Max* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Load* op) {
+    if (!extract(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const VarDecl* op) {
+    // Variables hoisted out of inner loops are declared once, so they move
+    // out of this loop with their value
+    if (util::contains(hoistedVars, op->var) &&
+        isIndexArithmetic(op->rhs, false) && isInvariant(op->rhs, writes)) {
+      decls.push_back(op);
+      hoisted.push_back({op->rhs, op->var});
+      stmt = Block::make();
+      return;
+    }
+    IRRewriter::visit(op);
+  }
+};
+
+struct LoopInvariantHoister : IRRewriter {
+  std::set<Expr> hoistedVars;
+
+  using IRRewriter::visit;
+
+  void visit(const For* op) {
+    Stmt contents = rewrite(op->contents);
+    Writes writes = getWrites(contents);
+    writes.written.push_back(op->var);
+
+    InvariantExtractor extractor(writes, hoistedVars);
+    Expr end = extractor.hoistBound(op->end, op->var);
+    contents = extractor.rewrite(contents);
+    extractor.decls.push_back(rebuildLoop(op, end, contents));
+    stmt = Block::make(extractor.decls);
+  }
+
+  void visit(const While* op) {
+    Stmt contents = rewrite(op->contents);
+    Writes writes = getWrites(contents);
+
+    InvariantExtractor extractor(writes, hoistedVars);
+    Expr cond = extractor.hoistCondition(op->cond);
+    contents = extractor.rewrite(contents);
+    if (extractor.decls.empty() && contents == op->contents) {
+      stmt = op;
+      return;
+    }
+    extractor.decls.push_back(While::make(cond, contents, op->kind,
+                                          op->vec_width));
+    stmt = Block::make(extractor.decls);
+  }
+};
+
+struct ContainsContinue : IRVisitor {
+  bool found = false;
+
+  using IRVisitor::visit;
+
+  void visit(const Continue*) {
+    found = true;
+  }
+};
+
+/// Replaces the products of a loop variable and a loop invariant stride by
+/// variables that are incremented by the stride in each iteration.
+struct InductionRewriter : IRRewriter {
+  const Expr& loopVar;
+  const Writes& writes;
+
+  std::vector<std::pair<Expr,Expr>> strides;
+
+  using IRRewriter::visit;
+
+  InductionRewriter(const Expr& loopVar, const Writes& writes)
+      : loopVar(loopVar), writes(writes) {}
+
+  void visit(const Mul* op) {
+    Expr stride = (op->a == loopVar) ? op->b :
+                  (op->b == loopVar) ? op->a : Expr();
+    if (!stride.defined() || !isIndexArithmetic(stride, false) ||
+        !isInvariant(stride, writes)) {
+      IRRewriter::visit(op);
+      return;
+    }
+    for (auto& reduced : strides) {
+      if (equals(reduced.first, stride) && reduced.second.type() == op->type) {
+        expr = reduced.second;
+        return;
+      }
+    }
+    expr = Var::make(getTempName(op), op->type);
+    strides.push_back({stride, expr});
+  }
+};
+
+struct StrengthReducer : IRRewriter {
+  using IRRewriter::visit;
+
+  void visit(const For* op) {
+    Stmt contents = rewrite(op->contents);
+
+    // Parallel loops do not run their iterations in order, and continues
+    // would skip the increments
+    ContainsContinue containsContinue;
+    contents.accept(&containsContinue);
+    Writes writes = getWrites(contents);
+    if (op->kind != LoopKind::Serial || containsContinue.found ||
+        !op->var.type().isInt() || util::contains(writes.written, op->var) ||
+        !isIndexArithmetic(op->increment, false) ||
+        !isInvariant(op->increment, writes)) {
+      stmt = rebuildLoop(op, op->end, contents);
+      return;
+    }
+    writes.written.push_back(op->var);
+
+    InductionRewriter inductionRewriter(op->var, writes);
+    contents = inductionRewriter.rewrite(contents);
+    if (inductionRewriter.strides.empty()) {
+      stmt = rebuildLoop(op, op->end, contents);
+      return;
+    }
+
+    std::vector<Stmt> decls;
+    std::vector<Stmt> body = {getLoopBody(contents)};
+    for (auto& reduced : inductionRewriter.strides) {
+      Expr stride = reduced.first;
+      Expr var = reduced.second;
+      decls.push_back(VarDecl::make(var, simplify(Mul::make(op->start, stride,
+                                                            var.type()))));
+      body.push_back(Assign::make(var, Add::make(var,
+          simplify(Mul::make(stride, op->increment, var.type())))));
+    }
+    decls.push_back(For::make(op->var, op->start, op->end, op->increment,
+                              Block::make(body), op->kind, op->parallel_unit,
+                              op->unrollFactor, op->vec_width));
+    stmt = Block::make(decls);
+  }
+};
+
+/// Replaces expressions by the variables that already hold their value, where
+/// the variable is never assigned and the operands of the expression have not
+/// been written since the variable was declared.
+struct CommonSubexpressionEliminator : IRRewriter {
+  std::set<Expr> assignedVars;
+  std::vector<std::pair<Expr,Expr>> available;
+
+  using IRRewriter::visit;
+
+  CommonSubexpressionEliminator(const Stmt& stmt) {
+    struct FindAssignedVars : IRVisitor {
+      std::set<Expr> assignedVars;
+      using IRVisitor::visit;
+      void visit(const Assign* op) {
+        assignedVars.insert(op->lhs);
+      }
+    };
+    FindAssignedVars findAssignedVars;
+    stmt.accept(&findAssignedVars);
+    assignedVars = findAssignedVars.assignedVars;
+  }
+
+  void kill(const Writes& writes) {
+    std::vector<std::pair<Expr,Expr>> live;
+    for (auto& entry : available) {
+      if (isInvariant(entry.first, writes) &&
+          !util::contains(writes.written, entry.second)) {
+        live.push_back(entry);
+      }
+    }
+    available = live;
+  }
+
+  bool replace(const Expr& op) {
+    for (auto& entry : available) {
+      if (equals(entry.first, op)) {
+        expr = entry.second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void visit(const Neg* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Cast* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Add* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Sub* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Mul* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Div* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Rem* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Min* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Max* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Load* op) {
+    if (!replace(op)) IRRewriter::visit(op);
+  }
+
+  void visit(const Block* op) {
+    auto outerAvailable = available;
+    std::vector<Stmt> contents;
+    bool changed = false;
+    for (auto& s : op->contents) {
+      // Statements that evaluate their expressions once, before they write,
+      // are rewritten before the values they overwrite are killed
+      Stmt rewritten;
+      Writes writes = getWrites(s);
+      if (isa<VarDecl>(s) || isa<Assign>(s) || isa<Store>(s)) {
+        rewritten = rewrite(s);
+        kill(writes);
+      } else {
+        kill(writes);
+        rewritten = rewrite(s);
+      }
+      if (isa<VarDecl>(rewritten)) {
+        auto decl = to<VarDecl>(rewritten);
+        if (!util::contains(assignedVars, decl->var) && !isTrivial(decl->rhs) &&
+            isIndexArithmetic(decl->rhs, true)) {
+          available.push_back({decl->rhs, decl->var});
+        }
+      }
+      changed = changed || rewritten.ptr != s.ptr;
+      contents.push_back(rewritten);
+    }
+
+    // Declarations in the block go out of scope, but its writes stay killed
+    std::vector<std::pair<Expr,Expr>> live;
+    for (auto& entry : outerAvailable) {
+      for (auto& current : available) {
+        if (entry.first == current.first && entry.second == current.second) {
+          live.push_back(entry);
+          break;
+        }
+      }
+    }
+    available = live;
+    stmt = changed ? Block::make(contents) : op;
+  }
+};
+
+
+/// Counts the references to a variable, tensor property or array.
+struct References : IRVisitor {
+  const Expr& target;
+  int count = 0;
+
+  using IRVisitor::visit;
+
+  References(const Expr& target) : target(target) {}
+
+  void visit(const Var* op) {
+    if (equals(op, target)) count++;
+  }
+
+  void visit(const GetProperty* op) {
+    if (equals(op, target)) count++;
+    IRVisitor::visit(op);
+  }
+};
+
+template <typename Node>
+int countReferences(const Node& node, const Expr& target) {
+  References references(target);
+  node.accept(&references);
+  return references.count;
+}
+
+/// The variables that a statement declares.
+struct Declarations : IRVisitor {
+  std::vector<Expr> declared;
+
+  using IRVisitor::visit;
+
+  void visit(const VarDecl* op) {
+    declared.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const For* op) {
+    declared.push_back(op->var);
+    IRVisitor::visit(op);
+  }
+};
+
+struct ContainsExit : IRVisitor {
+  bool found = false;
+
+  using IRVisitor::visit;
+
+  void visit(const Continue*) {
+    found = true;
+  }
+
+  void visit(const Break*) {
+    found = true;
+  }
+
+  void visit(const Yield*) {
+    found = true;
+  }
+};
+
+/// Matches `x op e` or `e op x`, where op is one of the associative and
+/// commutative operators that reductions are lowered to and `e` does not
+/// reference `target`, returning `e` and the operator.
+bool getReduction(const Expr& data, const Expr& x, const Expr& target,
+                  Expr* operand, IRNodeType* op) {
+  std::vector<Expr> operands;
+  switch (data.ptr->type_info()) {
+    case IRNodeType::Add:
+      operands = {to<Add>(data)->a, to<Add>(data)->b};
+      break;
+    case IRNodeType::Or:
+      operands = {to<Or>(data)->a, to<Or>(data)->b};
+      break;
+    case IRNodeType::And:
+      operands = {to<And>(data)->a, to<And>(data)->b};
+      break;
+    case IRNodeType::Min:
+      operands = to<Min>(data)->operands;
+      break;
+    case IRNodeType::Max:
+      operands = to<Max>(data)->operands;
+      break;
+    default:
+      return false;
+  }
+  if (operands.size() != 2) {
+    return false;
+  }
+  for (int i = 0; i < 2; i++) {
+    if (equals(operands[i], x) && countReferences(operands[1-i], target) == 0) {
+      *operand = operands[1-i];
+      *op = data.ptr->type_info();
+      return true;
+    }
+  }
+  return false;
+}
+
+Expr makeReduction(IRNodeType op, Expr a, Expr b) {
+  switch (op) {
+    case IRNodeType::Add:
+      return Add::make(a, b);
+    case IRNodeType::Or:
+      return Or::make(a, b);
+    case IRNodeType::And:
+      return And::make(a, b);
+    case IRNodeType::Min:
+      return Min::make(a, b);
+    case IRNodeType::Max:
+      return Max::make(a, b);
+    default:
+      taco_ierror;
+      return Expr();
+  }
+}
+
+/// Whether a statement reduces into `x` (e.g. `x[loc] = x[loc] + e`).
+bool isReductionInto(const Stmt& stmt, const Expr& x) {
+  Expr operand;
+  IRNodeType op;
+  if (isa<Store>(stmt)) {
+    auto store = to<Store>(stmt);
+    return !store->use_atomics && equals(store->arr, x) &&
+           countReferences(store->loc, x) == 0 &&
+           getReduction(store->data, Load::make(store->arr, store->loc), x,
+                        &operand, &op);
+  }
+  if (isa<Assign>(stmt)) {
+    auto assign = to<Assign>(stmt);
+    return !assign->use_atomics && equals(assign->lhs, x) &&
+           getReduction(assign->rhs, assign->lhs, x, &operand, &op);
+  }
+  return false;
+}
+
+/// Whether `x` is only reduced into by the statements of a loop body, so that
+/// the order of the reductions only changes the rounding of the result.
+bool isOnlyReducedInto(const Stmt& body, const Expr& x) {
+  struct Reductions : IRVisitor {
+    const Expr& x;
+    int references = 0;
+
+    using IRVisitor::visit;
+
+    Reductions(const Expr& x) : x(x) {}
+
+    void visit(const Store* op) {
+      if (isReductionInto(op, x)) references += 2;
+    }
+
+    void visit(const Assign* op) {
+      if (isReductionInto(op, x)) references += 2;
+    }
+  };
+  Reductions reductions(x);
+  body.accept(&reductions);
+  return reductions.references == countReferences(body, x);
+}
+
+/// Replaces variables by expressions.
+struct Substituter : IRRewriter {
+  std::map<Expr,Expr> substitutions;
+
+  using IRRewriter::visit;
+
+  Substituter(const std::map<Expr,Expr>& substitutions)
+      : substitutions(substitutions) {}
+
+  void visit(const Var* op) {
+    auto substitution = substitutions.find(op);
+    expr = (substitution != substitutions.end()) ? substitution->second : op;
+  }
+};
+
+/// Copies statements for an iteration of an unrolled loop, replacing the loop
+/// variable and declaring fresh variables in place of those they declare.
+struct IterationCopier : Substituter {
+  using Substituter::visit;
+
+  IterationCopier(const Expr& loopVar, const Expr& value)
+      : Substituter(std::map<Expr,Expr>({{loopVar, value}})) {}
+
+  void visit(const VarDecl* op) {
+    Expr rhs = rewrite(op->rhs);
+    auto var = op->var.as<Var>();
+    Expr copy = Var::make(var->name, var->type, var->is_ptr, var->is_tensor,
+                          var->is_parameter);
+    substitutions[op->var] = copy;
+    stmt = VarDecl::make(copy, rhs);
+  }
+};
+
+/// Returns the statements of nested blocks.
+std::vector<Stmt> getStatements(const Stmt& stmt) {
+  if (!stmt.defined()) {
+    return {};
+  }
+  if (!isa<Block>(stmt)) {
+    return {stmt};
+  }
+  std::vector<Stmt> statements;
+  for (auto& s : to<Block>(stmt)->contents) {
+    util::append(statements, getStatements(s));
+  }
+  return statements;
+}
+
+/// Merges the declarations of iterations that compute the same index (e.g.
+/// `int32_t jA = iA + j;`) and accumulates the reductions of iterations into
+/// the same location in a scalar, which is stored once.  All the arrays and
+/// variables that are written by the statements and outlive them must only
+/// be reduced into.
+std::vector<Stmt> promoteReductions(std::vector<Stmt> statements) {
+  Stmt block = Block::make(statements);
+  Writes writes = getWrites(block);
+  Declarations declarations;
+  block.accept(&declarations);
+  auto isAssigned = [&](const Expr& var) {
+    return std::count(writes.written.begin(), writes.written.end(), var) >
+           std::count(declarations.declared.begin(),
+                      declarations.declared.end(), var);
+  };
+  auto hasAssignedOperands = [&](const Expr& expr) {
+    for (auto& written : writes.written) {
+      if (isAssigned(written) && countReferences(expr, written) > 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Merge the declarations of the same values
+  std::vector<std::pair<Expr,Expr>> declared;
+  std::map<Expr,Expr> merged;
+  for (auto& statement : statements) {
+    if (!merged.empty()) {
+      statement = Substituter(merged).rewrite(statement);
+    }
+    if (!isa<VarDecl>(statement)) {
+      continue;
+    }
+    auto decl = to<VarDecl>(statement);
+    if (isAssigned(decl->var) || hasAssignedOperands(decl->rhs) ||
+        !isIndexArithmetic(decl->rhs, true)) {
+      continue;
+    }
+    for (auto& available : declared) {
+      if (equals(available.first, decl->rhs)) {
+        merged[decl->var] = available.second;
+        statement = Stmt();
+        break;
+      }
+    }
+    if (statement.defined()) {
+      declared.push_back({decl->rhs, decl->var});
+    }
+  }
+
+  // Group the reductions into the same locations
+  std::vector<std::vector<size_t>> groups;
+  for (size_t i = 0; i < statements.size(); i++) {
+    if (!isa<Store>(statements[i]) ||
+        !isReductionInto(statements[i], to<Store>(statements[i])->arr) ||
+        hasAssignedOperands(to<Store>(statements[i])->loc)) {
+      continue;
+    }
+    auto store = to<Store>(statements[i]);
+    bool grouped = false;
+    for (auto& group : groups) {
+      auto first = to<Store>(statements[group[0]]);
+      if (equals(first->arr, store->arr) && equals(first->loc, store->loc) &&
+          first->data.ptr->type_info() == store->data.ptr->type_info()) {
+        group.push_back(i);
+        grouped = true;
+        break;
+      }
+    }
+    if (!grouped) {
+      groups.push_back({i});
+    }
+  }
+
+  for (auto& group : groups) {
+    if (group.size() < 2) {
+      continue;
+    }
+    auto first = to<Store>(statements[group[0]]);
+    Expr value = Load::make(first->arr, first->loc);
+    Expr accumulator = Var::make(getTempName(value), first->data.type());
+    for (size_t i = 0; i < group.size(); i++) {
+      auto store = to<Store>(statements[group[i]]);
+      Expr operand;
+      IRNodeType op;
+      getReduction(store->data, value, store->arr, &operand, &op);
+      if (i == 0) {
+        statements[group[i]] = VarDecl::make(accumulator, operand);
+      } else {
+        statements[group[i]] = Assign::make(accumulator,
+                                            makeReduction(op, accumulator,
+                                                          operand));
+      }
+      if (i == group.size() - 1) {
+        statements[group[i]] = Block::make(statements[group[i]],
+            Store::make(first->arr, first->loc,
+                        makeReduction(op, value, accumulator)));
+      }
+    }
+  }
+
+  std::vector<Stmt> promoted;
+  for (auto& statement : statements) {
+    if (statement.defined()) {
+      util::append(promoted, getStatements(statement));
+    }
+  }
+  return promoted;
+}
+
+/// Unrolls serial loops that are tagged with an unroll factor.  If the body
+/// of a loop declares variables, runs an inner loop and then finishes the
+/// iteration, the inner loops of the unrolled iterations are jammed into one
+/// loop, so that values that the iterations share are loaded once and each
+/// iteration keeps its accumulators in registers.
+struct LoopUnroller : IRRewriter {
+  // Loops of GPU kernels are left to the `#pragma unroll` of nvcc
+  int gpuDepth = 0;
+
+  using IRRewriter::visit;
+
+  void visit(const For* op) {
+    bool gpuLoop = op->parallel_unit == ParallelUnit::GPUBlock ||
+                   op->parallel_unit == ParallelUnit::GPUWarp ||
+                   op->parallel_unit == ParallelUnit::GPUThread;
+    gpuDepth += gpuLoop;
+    Stmt contents = rewrite(op->contents);
+    gpuDepth -= gpuLoop;
+    Stmt loop = rebuildLoop(op, op->end, contents);
+
+    ContainsExit containsExit;
+    contents.accept(&containsExit);
+    if (op->unrollFactor < 2 || gpuDepth > 0 ||
+        op->kind != LoopKind::Serial ||
+        op->parallel_unit != ParallelUnit::NotParallel ||
+        !isa<Literal>(op->increment) ||
+        !to<Literal>(op->increment)->equalsScalar(1) ||
+        containsExit.found) {
+      stmt = loop;
+      return;
+    }
+
+    const int factor = (int)op->unrollFactor;
+    Expr start = op->start;
+    Expr end = op->end;
+    bool constantBounds = isa<Literal>(start) && isa<Literal>(end) &&
+                          start.type().isInt() && end.type().isInt();
+    const int64_t tripCount = constantBounds
+        ? to<Literal>(end)->getIntValue() - to<Literal>(start)->getIntValue()
+        : 0;
+    if (constantBounds && tripCount < factor) {
+      stmt = loop;
+      return;
+    }
+
+    // Loops that run exactly `factor` iterations are unrolled completely
+    if (constantBounds && tripCount == factor) {
+      stmt = Scope::make(getUnrolledBody(op->var, start,
+                                         getLoopBody(contents), factor));
+      return;
+    }
+
+    // Otherwise the iterations that do not fill an unrolled iteration are run
+    // by a remainder loop
+    std::vector<Stmt> loops;
+    Expr unrolledEnd = end;
+    if (!constantBounds || tripCount % factor != 0) {
+      unrolledEnd = Var::make(to<Var>(op->var)->name + "_unrolled_end",
+                              op->var.type());
+      Expr remainder = Rem::make(Sub::make(end, start),
+                                 Literal::make(factor, op->var.type()));
+      loops.push_back(VarDecl::make(unrolledEnd,
+                                    simplify(Sub::make(end, remainder))));
+    }
+    Stmt body = getUnrolledBody(op->var, op->var, getLoopBody(contents),
+                                factor);
+    loops.push_back(For::make(op->var, start, unrolledEnd,
+                              Literal::make(factor, op->var.type()), body,
+                              op->kind, op->parallel_unit, 0, op->vec_width));
+    if (unrolledEnd != end) {
+      loops.push_back(For::make(op->var, unrolledEnd, end, op->increment,
+                                contents, op->kind, op->parallel_unit, 0,
+                                op->vec_width));
+    }
+    stmt = Block::make(loops);
+  }
+
+  /// Returns `factor` iterations of a loop body, where `loopVar` starts at
+  /// `start`.
+  static Stmt getUnrolledBody(const Expr& loopVar, const Expr& start,
+                              const Stmt& body, int factor) {
+    std::vector<IterationCopier> copiers;
+    for (int c = 0; c < factor; c++) {
+      copiers.emplace_back(loopVar, simplify(Add::make(start,
+          Literal::make(c, loopVar.type()))));
+    }
+
+    // Iterations that run one inner loop can be jammed
+    std::vector<Stmt> statements = getStatements(body);
+    std::vector<size_t> innerLoops;
+    for (size_t i = 0; i < statements.size(); i++) {
+      if (isa<For>(statements[i]) || isa<While>(statements[i])) {
+        innerLoops.push_back(i);
+      }
+    }
+    if (innerLoops.size() == 1 && isa<For>(statements[innerLoops[0]]) &&
+        canJam(loopVar, statements, innerLoops[0])) {
+      size_t innerLoop = innerLoops[0];
+      auto inner = to<For>(statements[innerLoop]);
+      std::vector<Stmt> jammed;
+      std::vector<Stmt> innerBody;
+      for (auto& copier : copiers) {
+        for (size_t i = 0; i < innerLoop; i++) {
+          jammed.push_back(copier.rewrite(statements[i]));
+        }
+        util::append(innerBody, getStatements(
+            copier.rewrite(getLoopBody(inner->contents))));
+      }
+      jammed.push_back(For::make(inner->var, inner->start, inner->end,
+                                 inner->increment,
+                                 Block::make(promoteReductions(innerBody)),
+                                 inner->kind, inner->parallel_unit,
+                                 inner->unrollFactor, inner->vec_width));
+      for (auto& copier : copiers) {
+        for (size_t i = innerLoop + 1; i < statements.size(); i++) {
+          jammed.push_back(copier.rewrite(statements[i]));
+        }
+      }
+      return Block::make(jammed);
+    }
+
+    std::vector<Stmt> unrolled;
+    for (auto& copier : copiers) {
+      unrolled.push_back(copier.rewrite(body));
+    }
+    return Block::make(unrolled);
+  }
+
+  /// Whether the iterations of a loop can run their declarations, then their
+  /// inner loops in lockstep, then the rest of their iterations.  The inner
+  /// loop bounds must be the same for each iteration, and the arrays and
+  /// variables that outlive an iteration must be written only by its inner
+  /// loop, which may only reduce into them, or only by the rest of it.
+  static bool canJam(const Expr& loopVar, const std::vector<Stmt>& statements,
+                     size_t innerLoop) {
+    auto inner = to<For>(statements[innerLoop]);
+    if (inner->kind != LoopKind::Serial ||
+        inner->parallel_unit != ParallelUnit::NotParallel) {
+      return false;
+    }
+    std::vector<Stmt> declarations(statements.begin(),
+                                   statements.begin() + innerLoop);
+    std::vector<Stmt> rest(statements.begin() + innerLoop + 1,
+                           statements.end());
+    for (auto& declaration : declarations) {
+      if (!isa<VarDecl>(declaration)) {
+        return false;
+      }
+    }
+
+    Stmt body = Block::make(statements);
+    Writes writes = getWrites(body);
+    writes.written.push_back(loopVar);
+    if (writes.writesArrays || !isInvariant(inner->start, writes) ||
+        !isInvariant(inner->end, writes) ||
+        !isInvariant(inner->increment, writes)) {
+      return false;
+    }
+
+    Declarations declared;
+    body.accept(&declared);
+    auto outlives = [&](const Expr& written) {
+      return !util::contains(declared.declared, written);
+    };
+    Stmt declarationsBlock = Block::make(declarations);
+    Stmt restBlock = Block::make(rest);
+    for (auto& written : getWrites(inner->contents).written) {
+      if (outlives(written) &&
+          (!isOnlyReducedInto(inner->contents, written) ||
+           countReferences(declarationsBlock, written) > 0 ||
+           countReferences(restBlock, written) > 0)) {
+        return false;
+      }
+    }
+    for (auto& written : getWrites(restBlock).written) {
+      if (outlives(written) &&
+          (countReferences(declarationsBlock, written) > 0 ||
+           countReferences(statements[innerLoop], written) > 0)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+}
+
+ir::Stmt hoistLoopInvariants(const ir::Stmt& stmt) {
+  return LoopInvariantHoister().rewrite(stmt);
+}
+
+ir::Stmt reduceStrength(const ir::Stmt& stmt) {
+  return StrengthReducer().rewrite(stmt);
+}
+
+ir::Stmt eliminateCommonSubexpressions(const ir::Stmt& stmt) {
+  return CommonSubexpressionEliminator(stmt).rewrite(stmt);
+}
+
+ir::Stmt unrollLoops(const ir::Stmt& stmt) {
+  return LoopUnroller().rewrite(stmt);
+}
+
 }}
@@ -50,6 +50,7 @@ ir::Stmt lower(IndexStmt stmt, std::string name,
   taco_iassert(isLowerable(stmt, &reason))
       << "Not lowerable, because " << reason << ": " << stmt;
   ir::Stmt lowered = lowerer.getLowererImpl()->lower(stmt, name, assemble, compute, pack, unpack);
+  lowered = ir::unrollLoops(lowered);
 
   // TODO: re-enable this
   // std::string messages;
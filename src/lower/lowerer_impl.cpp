@@ -4,6 +4,7 @@
 #include "taco/index_notation/index_notation.h"
 #include "taco/index_notation/index_notation_nodes.h"
 #include "taco/index_notation/index_notation_visitor.h"
+#include "taco/index_notation/semiring.h"
 #include "taco/ir/ir.h"
 #include "ir/ir_generators.h"
 #include "taco/ir/ir_visitor.h"
@@ -64,6 +65,62 @@ private:
 LowererImpl::LowererImpl() : visitor(new Visitor(this)) {
 }
 
+void LowererImpl::setPresizeResults(bool presizeResults) {
+  this->presizeResults = presizeResults;
+}
+
+void LowererImpl::setFirstTouch(bool firstTouch) {
+  this->firstTouch = firstTouch;
+}
+
+void LowererImpl::setAccumulatorType(Datatype accumulatorType) {
+  this->accumulatorType = accumulatorType;
+}
+
+void LowererImpl::setAnalysis(shared_ptr<LoweringAnalysis> analysis) {
+  this->analysis = analysis;
+}
+
+/// Returns the type that values stored as `type` are computed in.  16-bit
+/// floats and 8-bit integers lose too much precision when sums are rounded to
+/// them after every addition, so they are only used for storage.
+static Datatype getComputeType(Datatype type, Datatype accumulatorType) {
+  switch (type.getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
+      return accumulatorType.isFloat() ? accumulatorType : Float32;
+    case Datatype::Int8:
+      return accumulatorType.isInt() ? accumulatorType : Int32;
+    default:
+      return type;
+  }
+}
+
+/// Returns `value` rounded to the 16-bit float or 8-bit integer `type`
+static Expr narrowValue(Expr value, Datatype type) {
+  switch (type.getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
+      if (value.type() != Float32) {
+        value = ir::Cast::make(value, Float32);
+      }
+      return ir::Call::make((type.getKind() == Datatype::Float16)
+                            ? "taco_float_to_half" : "taco_float_to_bfloat16",
+                            {value}, type);
+    default:
+      return (value.type() != type) ? ir::Cast::make(value, type) : value;
+  }
+}
+
+static bool hasAppendIterators(const vector<Iterator>& iterators) {
+  for (auto& iterator : iterators) {
+    if (iterator.hasAppend()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 
 static void createCapacityVars(const map<TensorVar, Expr>& tensorVars,
                                map<Expr, Expr>* capacityVars) {
@@ -75,11 +132,13 @@ static void createCapacityVars(const map<TensorVar, Expr>& tensorVars,
 }
 
 static void createReducedValueVars(const vector<Access>& inputAccesses,
+                                   Datatype accumulatorType,
                                    map<Access, Expr>* reducedValueVars) {
   for (const auto& access : inputAccesses) {
     const TensorVar inputTensor = access.getTensorVar();
     const std::string name = inputTensor.getName() + "_val";
-    const Datatype type = inputTensor.getType().getDataType();
+    const Datatype type = getComputeType(inputTensor.getType().getDataType(),
+                                         accumulatorType);
     reducedValueVars->insert({access, Var::make(name, type)});
   }
 }
@@ -104,6 +163,17 @@ static bool hasStores(Stmt stmt) {
   return stmt.defined() && FindStores().hasStores(stmt);
 }
 
+/// Returns the word of a bit-packed workspace guard array that holds the guard
+/// of coordinate `coord`
+static Expr getGuardWord(Expr coord) {
+  return ir::Div::make(coord, ir::Literal::make(64));
+}
+
+/// Returns the mask of the guard of coordinate `coord` within its word
+static Expr getGuardBit(Expr coord) {
+  return ir::Call::make("taco_guard_bit", {coord}, UInt64);
+}
+
 Stmt
 LowererImpl::lower(IndexStmt stmt, string name, 
                    bool assemble, bool compute, bool pack, bool unpack)
@@ -121,34 +191,87 @@ LowererImpl::lower(IndexStmt stmt, string name,
   // Create datastructure needed for temporary workspace hoisting/reuse
   temporaryInitialization = getTemporaryLocations(stmt);
 
+  // Reuse the analysis of the statement if another lowerer already made it
+  const bool reuseAnalysis = analysis != nullptr &&
+                             analysis->stmt.ptr == stmt.ptr &&
+                             analysis->pack == pack &&
+                             analysis->unpack == unpack;
+
   // Convert tensor results and arguments IR variables
   map<TensorVar, Expr> resultVars;
-  vector<Expr> resultsIR = createVars(results, &resultVars, unpack);
-  tensorVars.insert(resultVars.begin(), resultVars.end());
-  vector<Expr> argumentsIR = createVars(arguments, &tensorVars, pack);
+  vector<Expr> resultsIR;
+  vector<Expr> argumentsIR;
+  if (reuseAnalysis) {
+    resultsIR = analysis->resultsIR;
+    argumentsIR = analysis->argumentsIR;
+    for (size_t i = 0; i < results.size(); i++) {
+      resultVars.insert({results[i], resultsIR[i]});
+    }
+    tensorVars.insert(analysis->tensorVars.begin(),
+                      analysis->tensorVars.end());
+  } else {
+    resultsIR = createVars(results, &resultVars, unpack);
+    tensorVars.insert(resultVars.begin(), resultVars.end());
+    argumentsIR = createVars(arguments, &tensorVars, pack);
 
-  // Create variables for temporaries
-  // TODO Remove this
-  for (auto& temp : temporaries) {
-    ir::Expr irVar = ir::Var::make(temp.getName(), temp.getType().getDataType(),
-                                   true, true);
-    tensorVars.insert({temp, irVar});
+    // Create variables for temporaries
+    // TODO Remove this
+    for (auto& temp : temporaries) {
+      ir::Expr irVar = ir::Var::make(temp.getName(),
+                                     getComputeType(temp.getType().getDataType()),
+                                     true, true);
+      tensorVars.insert({temp, irVar});
+    }
   }
 
   // Create variables for keeping track of result values array capacity
   createCapacityVars(resultVars, &capacityVars);
 
-  // Create iterators
-  iterators = Iterators(stmt, tensorVars);
+  // Collect the tensors that are not reduced into with sums, since they are
+  // initialized to the identities of their reduction operators
+  match(stmt,
+    function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+      if (!isSumReduction(op->op)) {
+        TensorVar var = op->lhs.getTensorVar();
+        taco_uassert(!util::contains(reductionOperators, var) ||
+                     equals(reductionOperators.at(var), op->op))
+            << var.getName() << " is reduced into with different operators";
+        reductionOperators.insert({var, op->op});
+      }
+    })
+  );
 
-  provGraph = ProvenanceGraph(stmt);
+  if (reuseAnalysis) {
+    iterators = analysis->iterators;
+    provGraph = analysis->provGraph;
+    indexVarToExprMap.insert(analysis->indexVarToExprMap.begin(),
+                             analysis->indexVarToExprMap.end());
+  } else {
+    // Create iterators
+    iterators = Iterators(stmt, tensorVars);
+
+    provGraph = ProvenanceGraph(stmt);
 
-  for (const IndexVar& indexVar : provGraph.getAllIndexVars()) {
-    if (iterators.modeIterators().count(indexVar)) {
-      indexVarToExprMap.insert({indexVar, iterators.modeIterators()[indexVar].getIteratorVar()});
+    for (const IndexVar& indexVar : provGraph.getAllIndexVars()) {
+      if (iterators.modeIterators().count(indexVar)) {
+        indexVarToExprMap.insert({indexVar, iterators.modeIterators()[indexVar].getIteratorVar()});
+      }
+      else {
+        indexVarToExprMap.insert({indexVar, Var::make(indexVar.getName(), Int())});
+      }
     }
-    else {
-      indexVarToExprMap.insert({indexVar, Var::make(indexVar.getName(), Int())});
+
+    if (analysis != nullptr) {
+      analysis->stmt = stmt;
+      analysis->pack = pack;
+      analysis->unpack = unpack;
+      analysis->resultsIR = resultsIR;
+      analysis->argumentsIR = argumentsIR;
+      analysis->tensorVars = tensorVars;
+      analysis->iterators = iterators;
+      analysis->provGraph = provGraph;
+      analysis->indexVarToExprMap = indexVarToExprMap;
+      analysis->mergeLattices.clear();
     }
   }
 
@@ -159,7 +282,7 @@ LowererImpl::lower(IndexStmt stmt, string name,
 
   // Create variables that represent the reduced values of duplicated tensor 
   // components
-  createReducedValueVars(inputAccesses, &reducedValueVars);
+  createReducedValueVars(inputAccesses, accumulatorType, &reducedValueVars);
 
   map<TensorVar, Expr> scalars;
 
@@ -249,7 +372,7 @@ LowererImpl::lower(IndexStmt stmt, string name,
         Expr resultIR = scalars.at(result);
         Expr varValueIR = tensorVars.at(result);
         Expr valuesArrIR = GetProperty::make(resultIR, TensorProperty::Values);
-        footer.push_back(Store::make(valuesArrIR, 0, varValueIR, markAssignsAtomicDepth > 0, atomicParallelUnit));
+        footer.push_back(storeValue(valuesArrIR, 0, varValueIR, markAssignsAtomicDepth > 0, atomicParallelUnit));
       }
     }
   }
@@ -279,10 +402,16 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment)
         return Assign::make(var, rhs, markAssignsAtomicDepth > 0 && !util::contains(whereTemps, result), atomicParallelUnit);
         // TODO: we don't need to mark all assigns/stores just when scattering/reducing
       }
-      else {
-        taco_iassert(isa<taco::Add>(assignment.getOperator()));
+      else if (isSumReduction(assignment.getOperator())) {
         return compoundAssign(var, rhs, markAssignsAtomicDepth > 0 && !util::contains(whereTemps, result), atomicParallelUnit);
       }
+      else {
+        taco_uassert(markAssignsAtomicDepth == 0 ||
+                     util::contains(whereTemps, result))
+            << "Semiring reductions cannot be computed with atomics";
+        return Assign::make(var, lowerReduction(assignment.getOperator(),
+                                                var, rhs));
+      }
     }
     // Assignments to tensor variables (non-scalar).
     else {
@@ -290,11 +419,20 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment)
       Expr loc = generateValueLocExpr(assignment.getLhs());
 
       if (!assignment.getOperator().defined()) {
-        computeStmt = Store::make(values, loc, rhs, markAssignsAtomicDepth > 0, atomicParallelUnit);
+        computeStmt = storeValue(values, loc, rhs, markAssignsAtomicDepth > 0, atomicParallelUnit);
       }
-      else {
+      else if (isSumReduction(assignment.getOperator()) &&
+               getComputeType(values.type()) == values.type()) {
         computeStmt = compoundStore(values, loc, rhs, markAssignsAtomicDepth > 0, atomicParallelUnit);
       }
+      else {
+        taco_uassert(markAssignsAtomicDepth == 0)
+            << "Reductions into " << values.type() << " tensors and semiring "
+            << "reductions cannot be computed with atomics";
+        Expr reduced = lowerReduction(assignment.getOperator(),
+                                      loadValue(values, loc), rhs);
+        computeStmt = storeValue(values, loc, reduced);
+      }
       taco_iassert(computeStmt.defined());
     }
   }
@@ -314,14 +452,18 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment)
       Stmt initialStorage = computeStmt;
       if(assignment.getOperator().defined()) {
         // computeStmt is a compund stmt so we need to emit an initial store into the temporary
-        initialStorage =  Store::make(values, loc, rhs, markAssignsAtomicDepth > 0, atomicParallelUnit);
+        initialStorage = storeValue(values, loc, rhs, markAssignsAtomicDepth > 0, atomicParallelUnit);
       }
 
       Expr bitGuardArr = tempToBitGuard.at(result);
       Expr indexList = tempToIndexList.at(result);
       Expr indexListSize = tempToIndexListSize.at(result);
 
-      Stmt markBitGuardAsTrue = Store::make(bitGuardArr, loc, ir::Literal::make(true), markAssignsAtomicDepth > 0, atomicParallelUnit);
+      Expr guardWord = getGuardWord(loc);
+      Expr guardBit = getGuardBit(loc);
+      Stmt markBitGuardAsTrue = Store::make(bitGuardArr, guardWord,
+                                            ir::BitOr::make(Load::make(bitGuardArr, guardWord), guardBit),
+                                            markAssignsAtomicDepth > 0, atomicParallelUnit);
       Stmt trackIndex = Store::make(indexList, indexListSize, loc, markAssignsAtomicDepth > 0, atomicParallelUnit);
       Expr incrementSize = ir::Add::make(indexListSize, ir::Literal::make(1));
       Stmt incrementStmt = Assign::make(indexListSize, incrementSize, markAssignsAtomicDepth > 0, atomicParallelUnit);
@@ -331,8 +473,9 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment)
         firstWriteAtIndex = Block::make(trackIndex, markBitGuardAsTrue, incrementStmt);
       }
 
-      Expr readBitGuard = Load::make(bitGuardArr, loc);
-      Stmt finalStmt = IfThenElse::make(ir::Neg::make(readBitGuard), firstWriteAtIndex, computeStmt);
+      Expr isUnset = ir::Eq::make(ir::BitAnd::make(Load::make(bitGuardArr, guardWord), guardBit),
+                                  ir::Literal::zero(guardBit.type()));
+      Stmt finalStmt = IfThenElse::make(isUnset, firstWriteAtIndex, computeStmt);
       return finalStmt;
     }
 
@@ -352,7 +495,12 @@ Stmt LowererImpl::lowerYield(Yield yield) {
   for (auto& indexVar : yield.getIndexVars()) {
     coords.push_back(getCoordinateVar(indexVar));
   }
+  // Values are yielded into a buffer of the type they are stored in
   Expr val = lower(yield.getExpr());
+  Datatype type = yield.getExpr().getDataType();
+  if (getComputeType(type) != type) {
+    val = narrowValue(val, type);
+  }
   return ir::Yield::make(coords, val);
 }
 
@@ -384,9 +532,17 @@ Stmt LowererImpl::lowerForall(Forall forall)
 {
   bool hasExactBound = provGraph.hasExactBound(forall.getIndexVar());
   bool forallNeedsUnderivedGuards = !hasExactBound && emitUnderivedGuards;
+  // Splits with the peel tail strategy check once per strip whether it runs
+  // past the end, like vectorized loops, so that full strips need no guards
+  bool recoversPeeledVar = false;
+  for (const IndexVar& var : provGraph.newlyRecoverableParents(forall.getIndexVar(), definedIndexVars)) {
+    if (provGraph.getTailStrategy(var) == TailStrategy::Peel) {
+      recoversPeeledVar = true;
+    }
+  }
   if (!ignoreVectorize && forallNeedsUnderivedGuards &&
       (forall.getParallelUnit() == ParallelUnit::CPUVector ||
-       forall.getUnrollFactor() > 0)) {
+       forall.getUnrollFactor() > 0 || recoversPeeledVar)) {
     return lowerForallCloned(forall);
   }
 
@@ -438,7 +594,8 @@ Stmt LowererImpl::lowerForall(Forall forall)
     // place underived guard
     std::vector<ir::Expr> iterBounds = provGraph.deriveIterBounds(varToRecover, definedIndexVarsOrdered, underivedBounds, indexVarToExprMap, iterators);
     if (forallNeedsUnderivedGuards && underivedBounds.count(varToRecover) &&
-        !provGraph.hasPosDescendant(varToRecover)) {
+        !provGraph.hasPosDescendant(varToRecover) &&
+        provGraph.getTailStrategy(varToRecover) != TailStrategy::RoundUp) {
 
       // FIXME: [Olivia] Check this with someone
       // Removed underived guard if indexVar is bounded is divisible by its split child indexVar
@@ -475,7 +632,7 @@ Stmt LowererImpl::lowerForall(Forall forall)
     parallelUnitSizes[forall.getParallelUnit()] = ir::Sub::make(bounds[1], bounds[0]);
   }
 
-  MergeLattice lattice = MergeLattice::make(forall, iterators, provGraph, definedIndexVars, whereTempsToResult);
+  MergeLattice lattice = getMergeLattice(forall);
   vector<Access> resultAccesses;
   set<Access> reducedAccesses;
   std::tie(resultAccesses, reducedAccesses) = getResultAccesses(forall);
@@ -604,6 +761,9 @@ Stmt LowererImpl::lowerForallCloned(Forall forall) {
     if (provGraph.isRecoverable(var, definedIndexVars)) {
       continue; // already recovered
     }
+    if (provGraph.getTailStrategy(var) == TailStrategy::RoundUp) {
+      continue; // iterations are never past the end
+    }
     if (provGraph.isUnderived(var) && !provGraph.hasPosDescendant(var)) { // if there is pos descendant then will be guarded already
       varsWithGuard.push_back(var);
     }
@@ -617,6 +777,10 @@ Stmt LowererImpl::lowerForallCloned(Forall forall) {
 
   // determine min and max values for vars given already defined variables.
   // we do a recovery where we fill in undefined variables with either 0's or the max of their iteration
+  // loops that are only cloned to peel the tail of a split are recovered from
+  // the last iteration instead, which checks exactly whether a strip is full
+  bool peelOnly = forall.getParallelUnit() != ParallelUnit::CPUVector &&
+                  forall.getUnrollFactor() == 0;
   std::map<IndexVar, Expr> minVarValues;
   std::map<IndexVar, Expr> maxVarValues;
   set<IndexVar> definedForGuard = definedIndexVars;
@@ -635,7 +799,8 @@ Stmt LowererImpl::lowerForallCloned(Forall forall) {
         std::vector<ir::Expr> childBounds = provGraph.deriveIterBounds(child, currentDefinedVarOrder, underivedBounds, indexVarToExprMap, iterators);
 
         minChildValues[child] = childBounds[0];
-        maxChildValues[child] = childBounds[1];
+        maxChildValues[child] = peelOnly ? ir::Sub::make(childBounds[1], 1)
+                                         : childBounds[1];
 
         // recover new parents
         for (const IndexVar& varToRecover : provGraph.newlyRecoverableParents(child, definedForGuard)) {
@@ -643,10 +808,16 @@ Stmt LowererImpl::lowerForallCloned(Forall forall) {
                                                           minChildValues, iterators);
           Expr maxRecoveredValue = provGraph.recoverVariable(varToRecover, definedIndexVarsOrdered, underivedBounds,
                                                              maxChildValues, iterators);
-          if (!setMaxOffset) { // TODO: work on simplifying this
+          if (!setMaxOffset && !peelOnly) { // TODO: work on simplifying this
             maxOffset = ir::Add::make(maxOffset, ir::Sub::make(maxRecoveredValue, recoveredValue));
             setMaxOffset = true;
           }
+          if (peelOnly) {
+            // the intermediate variables of multi-level splits must also be
+            // recovered from the last iteration
+            minChildValues[varToRecover] = recoveredValue;
+            maxChildValues[varToRecover] = maxRecoveredValue;
+          }
           taco_iassert(indexVarToExprMap.count(varToRecover));
 
           guardRecoverySteps.push_back(VarDecl::make(indexVarToExprMap[varToRecover], recoveredValue));
@@ -694,6 +865,10 @@ Stmt LowererImpl::lowerForallCloned(Forall forall) {
   Stmt vectorizedLoop = lowerForall(forall);
   emitUnderivedGuards = true;
 
+  if (!guardCondition.defined()) {
+    return vectorizedLoop;
+  }
+
   // return guarded loops
   return Block::make(Block::make(guardRecoverySteps), IfThenElse::make(guardCondition, unvectorizedLoop, vectorizedLoop));
 }
@@ -957,7 +1132,10 @@ Stmt LowererImpl::lowerForallDimension(Forall forall,
 
     Stmt declareVar = VarDecl::make(coordinate, Load::make(indexList, loopVar));
     Stmt body = lowerForallBody(coordinate, forall.getStmt(), locators, inserters, appenders, reducedAccesses);
-    Stmt resetGuard = ir::Store::make(bitGuard, coordinate, ir::Literal::make(false), markAssignsAtomicDepth > 0, atomicParallelUnit);
+    // All coordinates whose guards share a word are in the index list, so the
+    // whole word can be cleared
+    Stmt resetGuard = ir::Store::make(bitGuard, getGuardWord(coordinate), ir::Literal::zero(UInt64),
+                                      markAssignsAtomicDepth > 0, atomicParallelUnit);
     body = Block::make(declareVar, body, resetGuard);
 
     if (forall.getParallelUnit() != ParallelUnit::NotParallel && forall.getOutputRaceStrategy() == OutputRaceStrategy::Atomics) {
@@ -1178,7 +1356,8 @@ Stmt LowererImpl::lowerForallFusedPosition(Forall forall, Iterator iterator,
   // Code to write results if using temporary and reset temporary
   if (!whereConsumers.empty() && whereConsumers.back().defined()) {
     Expr temp = tensorVars.find(whereTemps.back())->second;
-    Stmt writeResults = Block::make(whereConsumers.back(), ir::Assign::make(temp, ir::Literal::zero(temp.type())));
+    Expr identity = getReductionIdentity(whereTemps.back());
+    Stmt writeResults = Block::make(whereConsumers.back(), ir::Assign::make(temp, identity));
     body = Block::make(body, IfThenElse::make(writeResultCond, writeResults));
   }
 
@@ -1470,10 +1649,12 @@ Expr LowererImpl::getTemporarySize(Where where) {
 vector<Stmt> LowererImpl::codeToInitializeDenseAcceleratorArrays(Where where) {
   TensorVar temporary = where.getTemporary();
 
-  // TODO: emit as uint64 and manually emit bit pack code
-  const Datatype bitGuardType = taco::Bool;
+  // The guards are packed into 64-bit words
+  const Datatype bitGuardType = taco::UInt64;
   const std::string bitGuardName = temporary.getName() + "_already_set";
-  const Expr bitGuardSize = getTemporarySize(where);
+  const Expr temporarySize = getTemporarySize(where);
+  const Expr bitGuardSize = ir::Div::make(ir::Add::make(temporarySize, ir::Literal::make(63)),
+                                          ir::Literal::make(64));
   const Expr alreadySetArr = ir::Var::make(bitGuardName,
                                            bitGuardType,
                                            true, false);
@@ -1500,7 +1681,7 @@ vector<Stmt> LowererImpl::codeToInitializeDenseAcceleratorArrays(Where where) {
   tempToIndexListSize[temporary] = indexListSizeExpr;
   tempToBitGuard[temporary] = alreadySetArr;
 
-  Stmt allocateIndexList = Allocate::make(indexListArr, bitGuardSize);
+  Stmt allocateIndexList = Allocate::make(indexListArr, temporarySize);
   if(should_use_CUDA_codegen()) {
     Stmt allocateAlreadySet = Allocate::make(alreadySetArr, bitGuardSize);
     Expr p = Var::make("p" + temporary.getName(), Int());
@@ -1511,7 +1692,8 @@ vector<Stmt> LowererImpl::codeToInitializeDenseAcceleratorArrays(Where where) {
     return {inits, freeTemps};
   } else {
     Expr sizeOfElt = Sizeof::make(bitGuardType);
-    Expr callocAlreadySet = ir::Call::make("calloc", {bitGuardSize, sizeOfElt}, Int());
+    Expr callocAlreadySet = ir::Call::make("taco_calloc_temporary",
+                                           {bitGuardSize, sizeOfElt}, Int());
     Stmt allocateAlreadySet = VarDecl::make(alreadySetArr, callocAlreadySet);
     Stmt inits = Block::make(indexListDecl, allocateIndexList, allocateAlreadySet);
     return {inits, freeTemps};
@@ -1593,7 +1775,7 @@ vector<Stmt> LowererImpl::codeToInitializeTemporary(Where where) {
 
     if (generateComputeCode()) {
       Expr values = ir::Var::make(temporary.getName(),
-                                  temporary.getType().getDataType(),
+                                  getComputeType(temporary.getType().getDataType()),
                                   true, false);
       taco_iassert(temporary.getType().getOrder() == 1) << " Temporary order was "
                                                         << temporary.getType().getOrder();  // TODO
@@ -1648,13 +1830,14 @@ Stmt LowererImpl::lowerWhere(Where where) {
 
   Stmt consumer = lower(where.getConsumer());
   if(accelarateDenseWorkSpace) {
-    // We need to sort the indices array
+    // We need to sort the indices array, either by scanning the set guards in
+    // order or by radix sorting the list, depending on how full it is
     Expr listOfIndices = tempToIndexList.at(temporary);
     Expr listOfIndicesSize = tempToIndexListSize.at(temporary);
-    Expr sizeOfElt = ir::Sizeof::make(listOfIndices.type());
-    Expr cmpName = ir::Var::make("cmp", Int());
-    Stmt sortCall = ir::Sort::make( {listOfIndices, listOfIndicesSize, sizeOfElt, cmpName});
-    consumer = Block::make(sortCall, consumer);
+    Expr sortCall = ir::Call::make("taco_sort_index_list",
+                                   {listOfIndices, listOfIndicesSize, tempToBitGuard.at(temporary),
+                                    getTemporarySize(where)}, taco::Int32);
+    consumer = Block::make(ir::Assign::make(listOfIndicesSize, sortCall), consumer);
   }
 
   // Now that temporary allocations are hoisted, we always need to emit an initialization loop before entering the
@@ -1666,11 +1849,23 @@ Stmt LowererImpl::lowerWhere(Where where) {
 
     Expr p = Var::make("p" + temporary.getName(), Int());
     Expr values = ir::Var::make(temporary.getName(),
-                                temporary.getType().getDataType(),
+                                getComputeType(temporary.getType().getDataType()),
                                 true, false);
     Expr size = getTemporarySize(where);
-    Stmt zeroInit = Store::make(values, p, ir::Literal::zero(temporary.getType().getDataType()));
-    Stmt loopInit = For::make(p, 0, size, 1, zeroInit, LoopKind::Serial);
+    Stmt zeroInit = Store::make(values, p, getReductionIdentity(temporary));
+    // Temporaries filled by parallel loops are first touched in parallel too
+    bool parallelProducer = false;
+    match(where.getProducer(),
+      std::function<void(const ForallNode*)>([&](const ForallNode* op) {
+        if (op->parallel_unit != ParallelUnit::NotParallel) {
+          parallelProducer = true;
+        }
+      })
+    );
+    LoopKind kind = (firstTouch && parallelProducer &&
+                     inParallelLoopDepth == 0 && !should_use_CUDA_codegen())
+                    ? LoopKind::Runtime : LoopKind::Serial;
+    Stmt loopInit = For::make(p, 0, size, 1, zeroInit, kind);
     initializeTemporary = Block::make(initializeTemporary, loopInit);
   }
 
@@ -1733,7 +1928,7 @@ Expr LowererImpl::lowerAccess(Access access) {
     if (var.getType().getDataType() == Datatype::Bool && getIterators(access).back().isZeroless())  {
       return true;
     } else {
-      return Load::make(getValuesArray(var), generateValueLocExpr(access));
+      return loadValue(getValuesArray(var), generateValueLocExpr(access));
     }
   } else {
     return getReducedValueVar(access);
@@ -1767,6 +1962,10 @@ Expr LowererImpl::lowerLiteral(Literal literal) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+      return ir::Literal::make((float)literal.getVal<float16>());
+    case Datatype::BFloat16:
+      return ir::Literal::make((float)literal.getVal<bfloat16>());
     case Datatype::Float32:
       return ir::Literal::make(literal.getVal<float>());
     case Datatype::Float64:
@@ -1879,6 +2078,26 @@ Expr LowererImpl::getDimension(IndexVar indexVar) const {
 }
 
 
+MergeLattice LowererImpl::getMergeLattice(Forall forall) {
+  if (analysis == nullptr) {
+    return MergeLattice::make(forall, iterators, provGraph, definedIndexVars,
+                              whereTempsToResult);
+  }
+  for (auto& mergeLattice : analysis->mergeLattices) {
+    if (get<0>(mergeLattice).ptr == forall.ptr &&
+        get<1>(mergeLattice) == definedIndexVars &&
+        get<2>(mergeLattice) == whereTempsToResult) {
+      return get<3>(mergeLattice);
+    }
+  }
+  MergeLattice lattice = MergeLattice::make(forall, iterators, provGraph,
+                                            definedIndexVars,
+                                            whereTempsToResult);
+  analysis->mergeLattices.emplace_back(forall, definedIndexVars,
+                                       whereTempsToResult, lattice);
+  return lattice;
+}
+
 std::vector<Iterator> LowererImpl::getIterators(Access access) const {
   vector<Iterator> result;
   TensorVar tensor = access.getTensorVar();
@@ -1989,11 +2208,25 @@ Stmt LowererImpl::initResultArrays(vector<Access> writes,
 
     Expr parentSize = 1;
     if (generateAssembleCode()) {
+      // Presize appended levels for the capacity hint passed in the result's
+      // values size
+      Expr capacityHint;
+      if (presizeResults && hasAppendIterators(iterators)) {
+        capacityHint = Var::make(util::toString(tensor) + "_capacity_hint",
+                                 Int());
+        Expr hint = GetProperty::make(tensor, TensorProperty::ValuesSize);
+        initArrays.push_back(VarDecl::make(capacityHint, Max::make(hint, 1)));
+      }
+
       for (const auto& iterator : iterators) {
         Expr size;
         Stmt init;
         // Initialize data structures for storing levels
         if (iterator.hasAppend()) {
+          if (capacityHint.defined()) {
+            Mode mode = iterator.getMode();
+            mode.addVar(capacityHintVarName, capacityHint);
+          }
           size = 0;
           init = iterator.getAppendInitLevel(parentSize, size);
         } else if (iterator.hasInsert()) {
@@ -2020,8 +2253,9 @@ Stmt LowererImpl::initResultArrays(vector<Access> writes,
         taco_iassert(!iterators.empty());
         
         Expr capacityVar = getCapacityVar(tensor);
-        Expr allocSize = isValue(parentSize, 0) 
-                         ? DEFAULT_ALLOC_SIZE : parentSize;
+        Expr allocSize = !isValue(parentSize, 0) ? parentSize
+                       : capacityHint.defined() ? capacityHint
+                       : DEFAULT_ALLOC_SIZE;
         initArrays.push_back(VarDecl::make(capacityVar, allocSize));
         initArrays.push_back(Allocate::make(valuesArr, capacityVar));
       }
@@ -2086,7 +2320,12 @@ ir::Stmt LowererImpl::finalizeResultArrays(std::vector<Access> writes) {
       Stmt finalize;
       // Post-process data structures for storing levels
       if (iterator.hasAppend()) {
-        size = iterator.getPosVar();
+        // Append modes above a branchless mode share its position variable
+        Iterator sizeIterator = iterator;
+        while (!sizeIterator.isLeaf() && sizeIterator.getChild().isBranchless()) {
+          sizeIterator = sizeIterator.getChild();
+        }
+        size = sizeIterator.getPosVar();
         finalize = iterator.getAppendFinalizeLevel(parentSize, size);
       } else if (iterator.hasInsert()) {
         size = simplify(ir::Mul::make(parentSize, iterator.getWidth()));
@@ -2098,22 +2337,26 @@ ir::Stmt LowererImpl::finalizeResultArrays(std::vector<Access> writes) {
       parentSize = size;
     }
 
+    Expr tensor = getTensorVar(write.getTensorVar());
+    Expr valuesArr = GetProperty::make(tensor, TensorProperty::Values);
     if (!generateComputeCode()) {
       // Allocate memory for values array after assembly if not also computing
-      Expr tensor = getTensorVar(write.getTensorVar());
-      Expr valuesArr = GetProperty::make(tensor, TensorProperty::Values);
       result.push_back(Allocate::make(valuesArr, parentSize));
+    } else if (presizeResults && hasAppendIterators(iterators)) {
+      // Shrink the presized values array to fit
+      result.push_back(Allocate::make(valuesArr, Max::make(parentSize, 1), true,
+                                      getCapacityVar(tensor)));
     }
   }
   return result.empty() ? Stmt() : Block::blanks(result);
 }
 
 Stmt LowererImpl::defineScalarVariable(TensorVar var, bool zero) {
-  Datatype type = var.getType().getDataType();
+  Datatype type = getComputeType(var.getType().getDataType());
   Expr varValueIR = Var::make(var.getName() + "_val", type, false, false);
-  Expr init = (zero) ? ir::Literal::zero(type)
-                     : Load::make(GetProperty::make(tensorVars.at(var),
-                                                    TensorProperty::Values));
+  Expr init = (zero) ? getReductionIdentity(var)
+                     : loadValue(GetProperty::make(tensorVars.at(var),
+                                                   TensorProperty::Values), 0);
   tensorVars.find(var)->second = varValueIR;
   return VarDecl::make(varValueIR, init);
 }
@@ -2248,8 +2491,7 @@ Stmt LowererImpl::resizeAndInitValues(const std::vector<Iterator>& appenders,
     }
 
     if (util::contains(reducedTensors, tensor)) {
-      Expr zero = ir::Literal::zero(tensor.type());
-      result.push_back(Store::make(values, pos, zero));
+      result.push_back(storeValue(values, pos, getReductionIdentity(tensor)));
     }
   }
 
@@ -2262,11 +2504,15 @@ Stmt LowererImpl::zeroInitValues(Expr tensor, Expr begin, Expr size) {
   Expr upper = simplify(ir::Mul::make(ir::Add::make(begin, 1), size));
   Expr p = Var::make("p" + util::toString(tensor), Int());
   Expr values = GetProperty::make(tensor, TensorProperty::Values);
-  Stmt zeroInit = Store::make(values, p, ir::Literal::zero(tensor.type()));
+  Expr identity = getReductionIdentity(tensor);
+  Stmt zeroInit = storeValue(values, p, identity);
   LoopKind parallel = (isa<ir::Literal>(size) && 
                        to<ir::Literal>(size)->getIntValue() < (1 << 10))
-                      ? LoopKind::Serial : LoopKind::Static_Chunked;
-  if (should_use_CUDA_codegen() && util::contains(parallelUnitSizes, ParallelUnit::GPUBlock)) {
+                      ? LoopKind::Serial
+                      : (firstTouch ? LoopKind::Runtime
+                                    : LoopKind::Static_Chunked);
+  if (should_use_CUDA_codegen() && util::contains(parallelUnitSizes, ParallelUnit::GPUBlock) &&
+      to<ir::Literal>(identity)->equalsScalar(0)) {
     return ir::VarDecl::make(ir::Var::make("status", Int()),
                                     ir::Call::make("cudaMemset", {values, ir::Literal::make(0, Int()), ir::Mul::make(ir::Sub::make(upper, lower), ir::Literal::make(values.type().getNumBytes()))}, Int()));
   }
@@ -2274,6 +2520,53 @@ Stmt LowererImpl::zeroInitValues(Expr tensor, Expr begin, Expr size) {
 }
 
 
+Expr LowererImpl::getReductionIdentity(TensorVar var) const {
+  Datatype type = getComputeType(var.getType().getDataType());
+  return util::contains(reductionOperators, var)
+         ? taco::getReductionIdentity(reductionOperators.at(var), type)
+         : ir::Literal::zero(type);
+}
+
+Expr LowererImpl::getReductionIdentity(Expr tensor) const {
+  for (auto& reductionOperator : reductionOperators) {
+    TensorVar var = reductionOperator.first;
+    if (util::contains(tensorVars, var) && tensorVars.at(var) == tensor) {
+      return getReductionIdentity(var);
+    }
+  }
+  return ir::Literal::zero(getComputeType(tensor.type()));
+}
+
+Datatype LowererImpl::getComputeType(Datatype type) const {
+  return taco::getComputeType(type, accumulatorType);
+}
+
+Expr LowererImpl::loadValue(Expr values, Expr loc) const {
+  Expr value = Load::make(values, loc);
+  Datatype computeType = getComputeType(values.type());
+  switch (values.type().getKind()) {
+    case Datatype::Float16:
+      value = ir::Call::make("taco_half_to_float", {value}, Float32);
+      break;
+    case Datatype::BFloat16:
+      value = ir::Call::make("taco_bfloat16_to_float", {value}, Float32);
+      break;
+    default:
+      break;
+  }
+  return (value.type() != computeType) ? ir::Cast::make(value, computeType)
+                                       : value;
+}
+
+Stmt LowererImpl::storeValue(Expr values, Expr loc, Expr value, bool atomic,
+                             ParallelUnit atomicParallelUnit) const {
+  if (getComputeType(values.type()) != values.type()) {
+    value = narrowValue(value, values.type());
+  }
+  return Store::make(values, loc, value, atomic, atomicParallelUnit);
+}
+
+
 Stmt LowererImpl::declLocatePosVars(vector<Iterator> locators) {
   vector<Stmt> result;
   for (Iterator& locator : locators) {
@@ -2329,7 +2622,7 @@ Stmt LowererImpl::reduceDuplicateCoordinates(Expr coordinate,
     // Initialize variable storing reduced component value.
     if (reducedVal.defined()) {
       Expr reducedValInit = alwaysReduce 
-                          ? Load::make(tensorVals, iterVar)
+                          ? loadValue(tensorVals, iterVar)
                           : ir::Literal::zero(reducedVal.type());
       result.push_back(VarDecl::make(reducedVal, reducedValInit));
     }
@@ -2349,7 +2642,7 @@ Stmt LowererImpl::reduceDuplicateCoordinates(Expr coordinate,
     
     vector<Stmt> dedupStmts;
     if (reducedVal.defined()) {
-      Expr partialVal = Load::make(tensorVals, segendVar);
+      Expr partialVal = loadValue(tensorVals, segendVar);
       dedupStmts.push_back(compoundAssign(reducedVal, partialVal));
     }
     dedupStmts.push_back(compoundAssign(segendVar, 1));
@@ -262,7 +262,16 @@ private:
 
   void visit(const AssignmentNode* node) {
     lattice = build(node->rhs);
-    latticesOfTemporaries.insert({node->lhs.getTensorVar(), lattice});
+    // A temporary that is updated by a sequence of statements is merged over
+    // the iteration spaces of all of them
+    TensorVar temporary = node->lhs.getTensorVar();
+    if (util::contains(latticesOfTemporaries, temporary)) {
+      latticesOfTemporaries.at(temporary) =
+          unionLattices(latticesOfTemporaries.at(temporary), lattice);
+    }
+    else {
+      latticesOfTemporaries.insert({temporary, lattice});
+    }
 
     // This is to allow for scalar temporaries to be used (for example
     // to reduce teh number of atomic instructions). In this case, we still
@@ -324,7 +333,8 @@ private:
   }
 
   void visit(const SequenceNode* node) {
-    taco_not_supported_yet;
+    // Both statements execute in every iteration of the enclosing loops
+    lattice = unionLattices(build(node->definition), build(node->mutation));
   }
 
   void visit(const SuchThatNode* node) {
@@ -143,9 +143,11 @@ Stmt CompressedModeFormat::getAppendInitLevel(Expr szPrev, Expr sz,
   const bool szPrevIsZero = isa<Literal>(szPrev) && 
                             to<Literal>(szPrev)->equalsScalar(0);
 
-  Expr defaultCapacity = Literal::make(allocSize, Datatype::Int32); 
+  Expr defaultCapacity = getInitialCapacity(mode, allocSize);
   Expr posArray = getPosArray(mode.getModePack());
-  Expr initCapacity = szPrevIsZero ? defaultCapacity : Add::make(szPrev, 1);
+  Expr initCapacity = !szPrevIsZero ? Add::make(szPrev, 1)
+                    : isPresized(mode) ? Add::make(defaultCapacity, 1)
+                    : defaultCapacity;
   Expr posCapacity = initCapacity;
   
   std::vector<Stmt> initStmts;
@@ -175,23 +177,39 @@ Stmt CompressedModeFormat::getAppendInitLevel(Expr szPrev, Expr sz,
 
 Stmt CompressedModeFormat::getAppendFinalizeLevel(Expr szPrev, 
     Expr sz, Mode mode) const {
-    ModeFormat parentModeType = mode.getParentModeType();
-  if ((isa<Literal>(szPrev) && to<Literal>(szPrev)->equalsScalar(1)) || 
-      !parentModeType.defined() || parentModeType.hasAppend()) {
-    return Stmt();
+  ModeFormat parentModeType = mode.getParentModeType();
+  std::vector<Stmt> finalizeStmts;
+  if (!((isa<Literal>(szPrev) && to<Literal>(szPrev)->equalsScalar(1)) || 
+        !parentModeType.defined() || parentModeType.hasAppend())) {
+    Expr csVar = Var::make("cs" + mode.getName(), Int());
+    Stmt initCs = VarDecl::make(csVar, 0);
+
+    Expr pVar = Var::make("p" + mode.getName(), Int());
+    Expr loadPos = Load::make(getPosArray(mode.getModePack()), pVar);
+    Stmt incCs = Assign::make(csVar, Add::make(csVar, loadPos));
+    Stmt updatePos = Store::make(getPosArray(mode.getModePack()), pVar, csVar);
+    Stmt body = Block::make({incCs, updatePos});
+    Stmt finalizeLoop = For::make(pVar, 1, Add::make(szPrev, 1), 1, body);
+
+    finalizeStmts.push_back(initCs);
+    finalizeStmts.push_back(finalizeLoop);
   }
 
-  Expr csVar = Var::make("cs" + mode.getName(), Int());
-  Stmt initCs = VarDecl::make(csVar, 0);
-  
-  Expr pVar = Var::make("p" + mode.getName(), Int());
-  Expr loadPos = Load::make(getPosArray(mode.getModePack()), pVar);
-  Stmt incCs = Assign::make(csVar, Add::make(csVar, loadPos));
-  Stmt updatePos = Store::make(getPosArray(mode.getModePack()), pVar, csVar);
-  Stmt body = Block::make({incCs, updatePos});
-  Stmt finalizeLoop = For::make(pVar, 1, Add::make(szPrev, 1), 1, body);
+  // Shrink presized arrays to fit
+  if (isPresized(mode)) {
+    if (mode.hasVar(mode.getName() + "_pos_size")) {
+      finalizeStmts.push_back(Allocate::make(getPosArray(mode.getModePack()),
+                                             Add::make(szPrev, 1), true,
+                                             getPosCapacity(mode)));
+    }
+    if (mode.getPackLocation() == (mode.getModePack().getNumModes() - 1)) {
+      finalizeStmts.push_back(Allocate::make(getCoordArray(mode.getModePack()),
+                                             Max::make(sz, 1), true,
+                                             getCoordCapacity(mode)));
+    }
+  }
 
-  return Block::make({initCs, finalizeLoop});
+  return finalizeStmts.empty() ? Stmt() : Block::make(finalizeStmts);
 }
 
 vector<Expr> CompressedModeFormat::getArrays(Expr tensor, int mode, 
@@ -154,6 +154,15 @@ Stmt ModeFormatImpl::getAppendFinalizeLevel(Expr szPrev,
   return Stmt();
 }
 
+Expr ModeFormatImpl::getInitialCapacity(Mode mode, long long allocSize) {
+  return isPresized(mode) ? mode.getVar(capacityHintVarName)
+                          : Literal::make(allocSize, Datatype::Int32);
+}
+
+bool ModeFormatImpl::isPresized(Mode mode) {
+  return mode.hasVar(capacityHintVarName);
+}
+
 bool ModeFormatImpl::equals(const ModeFormatImpl& other) const {
   return (isFull == other.isFull &&
           isOrdered == other.isOrdered &&
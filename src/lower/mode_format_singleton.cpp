@@ -104,7 +104,11 @@ Stmt SingletonModeFormat::getAppendInitLevel(Expr parentSize, Expr size,
     return Stmt();
   }
 
-  Expr defaultCapacity = Literal::make(allocSize, Datatype::Int32); 
+  Expr defaultCapacity = getInitialCapacity(mode, allocSize);
+  if (isPresized(mode) && mode.getModePack().getNumModes() > 1) {
+    defaultCapacity = Mul::make(defaultCapacity,
+                                (int)mode.getModePack().getNumModes());
+  }
   Expr crdCapacity = getCoordCapacity(mode);
   Expr crdArray = getCoordArray(mode.getModePack());
   Stmt initCrdCapacity = VarDecl::make(crdCapacity, defaultCapacity);
@@ -115,7 +119,16 @@ Stmt SingletonModeFormat::getAppendInitLevel(Expr parentSize, Expr size,
 
 Stmt SingletonModeFormat::getAppendFinalizeLevel(Expr parentSize, Expr size, 
                                                  Mode mode) const {
-  return Stmt();
+  if (!isPresized(mode) || 
+      mode.getPackLocation() != (mode.getModePack().getNumModes() - 1)) {
+    return Stmt();
+  }
+
+  // Shrink the presized coordinate array to fit
+  Expr crdSize = Mul::make(Max::make(size, 1),
+                           (int)mode.getModePack().getNumModes());
+  return Allocate::make(getCoordArray(mode.getModePack()), simplify(crdSize),
+                        true, getCoordCapacity(mode));
 }
 
 std::vector<Expr> SingletonModeFormat::getArrays(Expr tensor, int mode, 
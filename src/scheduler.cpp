@@ -0,0 +1,374 @@
+#include "taco/scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+
+// The current schedulers
+static taco_scheduler_t processScheduler;
+static bool processSchedulerSet = false;
+static thread_local taco_scheduler_t threadScheduler;
+static thread_local bool threadSchedulerSet = false;
+
+static void checkScheduler(const taco_scheduler_t& scheduler) {
+  taco_uassert(scheduler.parallel_for != nullptr)
+      << "Schedulers must define parallel_for";
+}
+
+void setScheduler(const taco_scheduler_t& scheduler) {
+  checkScheduler(scheduler);
+  processScheduler = scheduler;
+  processSchedulerSet = true;
+}
+
+void resetScheduler() {
+  processSchedulerSet = false;
+}
+
+void setThreadScheduler(const taco_scheduler_t& scheduler) {
+  checkScheduler(scheduler);
+  threadScheduler = scheduler;
+  threadSchedulerSet = true;
+}
+
+void resetThreadScheduler() {
+  threadSchedulerSet = false;
+}
+
+static taco_scheduler_t* getKernelScheduler() {
+  if (threadSchedulerSet) {
+    return &threadScheduler;
+  }
+  return processSchedulerSet ? &processScheduler : nullptr;
+}
+
+const taco_scheduler_t* getScheduler() {
+  return getKernelScheduler();
+}
+
+SchedulerGetter getKernelSchedulerGetter() {
+  return getKernelScheduler;
+}
+
+
+// class WorkStealingPool
+
+/// A parallel loop that is being run by the pool.
+struct LoopJob {
+  taco_task_t task;
+  void*       closure;
+  int64_t     grain;
+  atomic<int64_t> remaining;  ///< iterations that have not completed yet
+};
+
+/// A range of iterations of a loop that has not been started.
+struct Range {
+  LoopJob* job;
+  int64_t  begin;
+  int64_t  end;
+};
+
+/// A Chase-Lev work-stealing deque (Chase and Lev, "Dynamic Circular
+/// Work-Stealing Deque", SPAA'05, with the C11 memory orderings of Lê et al.,
+/// PPoPP'13). The owner pushes and pops at the bottom and other threads steal
+/// from the top; only the owner may push and pop.
+class RangeDeque {
+public:
+  RangeDeque() {
+    buffers.emplace_back(new Buffer(256));
+    buffer.store(buffers.back().get(), memory_order_relaxed);
+  }
+
+  void push(Range* range) {
+    const int64_t b = bottom.load(memory_order_relaxed);
+    const int64_t t = top.load(memory_order_acquire);
+    Buffer* a = buffer.load(memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = grow(a, t, b);
+    }
+    a->put(b, range);
+    atomic_thread_fence(memory_order_release);
+    bottom.store(b + 1, memory_order_relaxed);
+  }
+
+  Range* pop() {
+    const int64_t b = bottom.load(memory_order_relaxed) - 1;
+    Buffer* a = buffer.load(memory_order_relaxed);
+    bottom.store(b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = top.load(memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, memory_order_relaxed);
+      return nullptr;
+    }
+    Range* range = a->get(b);
+    if (t == b) {
+      // Race thieves for the last range
+      if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst,
+                                       memory_order_relaxed)) {
+        range = nullptr;
+      }
+      bottom.store(b + 1, memory_order_relaxed);
+    }
+    return range;
+  }
+
+  Range* steal() {
+    int64_t t = top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t b = bottom.load(memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Buffer* a = buffer.load(memory_order_acquire);
+    Range* range = a->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst,
+                                     memory_order_relaxed)) {
+      return nullptr;
+    }
+    return range;
+  }
+
+private:
+  struct Buffer {
+    explicit Buffer(int64_t capacity)
+        : capacity(capacity), slots(new atomic<Range*>[capacity]) {}
+
+    Range* get(int64_t i) const {
+      return slots[i & (capacity - 1)].load(memory_order_relaxed);
+    }
+
+    void put(int64_t i, Range* range) {
+      slots[i & (capacity - 1)].store(range, memory_order_relaxed);
+    }
+
+    const int64_t capacity;
+    unique_ptr<atomic<Range*>[]> slots;
+  };
+
+  Buffer* grow(Buffer* a, int64_t t, int64_t b) {
+    // Thieves may still read the old buffer, so it is kept until the deque is
+    // destroyed
+    buffers.emplace_back(new Buffer(2 * a->capacity));
+    Buffer* grown = buffers.back().get();
+    for (int64_t i = t; i < b; i++) {
+      grown->put(i, a->get(i));
+    }
+    buffer.store(grown, memory_order_release);
+    return grown;
+  }
+
+  atomic<int64_t> top{0};
+  atomic<int64_t> bottom{0};
+  atomic<Buffer*> buffer;
+  vector<unique_ptr<Buffer>> buffers;
+};
+
+/// The pool and worker index of the calling thread, if it is a worker.
+static thread_local WorkStealingPool::Content* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+struct WorkStealingPool::Content {
+  vector<unique_ptr<RangeDeque>> deques;
+  vector<thread> workers;
+
+  /// Ranges submitted by threads that are not workers of the pool.
+  mutex injectionMutex;
+  std::deque<Range*> injection;
+  atomic<size_t> injectionSize{0};
+
+  /// Idle threads sleep until the epoch changes, which happens whenever a
+  /// range is submitted or a loop completes.
+  mutex sleepMutex;
+  condition_variable sleepCondition;
+  atomic<uint64_t> epoch{0};
+  atomic<int> sleeping{0};
+  atomic<bool> stop{false};
+
+  bool isWorker() const {
+    return currentPool == this && currentWorker >= 0;
+  }
+
+  void signal() {
+    epoch.fetch_add(1);
+    if (sleeping.load() > 0) {
+      lock_guard<mutex> lock(sleepMutex);
+      sleepCondition.notify_all();
+    }
+  }
+
+  void submit(Range* range) {
+    if (isWorker()) {
+      deques[currentWorker]->push(range);
+    } else {
+      lock_guard<mutex> lock(injectionMutex);
+      injection.push_back(range);
+      injectionSize++;
+    }
+    signal();
+  }
+
+  Range* findRange() {
+    if (isWorker()) {
+      if (Range* range = deques[currentWorker]->pop()) {
+        return range;
+      }
+    }
+    if (injectionSize.load(memory_order_relaxed) > 0) {
+      lock_guard<mutex> lock(injectionMutex);
+      if (!injection.empty()) {
+        Range* range = injection.front();
+        injection.pop_front();
+        injectionSize--;
+        return range;
+      }
+    }
+
+    // Steal, starting from a random victim
+    static thread_local uint32_t seed = 2463534242u;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    const size_t numDeques = deques.size();
+    for (size_t i = 0; i < numDeques; i++) {
+      const size_t victim = (seed + i) % numDeques;
+      if (isWorker() && (int)victim == currentWorker) {
+        continue;
+      }
+      if (Range* range = deques[victim]->steal()) {
+        return range;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Split a range in half until it is no larger than the grain of its loop,
+  /// submitting the upper halves, and run the rest.
+  void run(Range* range) {
+    LoopJob* job = range->job;
+    const int64_t begin = range->begin;
+    int64_t end = range->end;
+    delete range;
+    while (end - begin > job->grain) {
+      const int64_t mid = begin + (end - begin) / 2;
+      submit(new Range{job, mid, end});
+      end = mid;
+    }
+    job->task(job->closure, begin, end);
+    if (job->remaining.fetch_sub(end - begin) == end - begin) {
+      signal();
+    }
+  }
+
+  /// Run ranges until `done` returns true, sleeping while there are none.
+  template <typename Done>
+  void runUntil(Done done) {
+    int idle = 0;
+    while (!done()) {
+      const uint64_t seen = epoch.load();
+      if (Range* range = findRange()) {
+        run(range);
+        idle = 0;
+        continue;
+      }
+      if (++idle < 64) {
+        this_thread::yield();
+        continue;
+      }
+      unique_lock<mutex> lock(sleepMutex);
+      sleeping++;
+      if (!done() && epoch.load() == seen) {
+        sleepCondition.wait(lock);
+      }
+      sleeping--;
+    }
+  }
+
+  void parallelFor(int64_t begin, int64_t end, taco_task_t task,
+                   void* closure) {
+    if (end <= begin) {
+      return;
+    }
+    const int64_t iterations = end - begin;
+    LoopJob job;
+    job.task = task;
+    job.closure = closure;
+    job.grain = std::max<int64_t>(1, iterations / (8 * (deques.size() + 1)));
+    job.remaining = iterations;
+    run(new Range{&job, begin, end});
+    runUntil([&job] { return job.remaining.load() == 0; });
+  }
+};
+
+static void poolParallelFor(void* context, int64_t begin, int64_t end,
+                            taco_task_t task, void* closure) {
+  static_cast<WorkStealingPool::Content*>(context)->parallelFor(begin, end,
+                                                                task, closure);
+}
+
+WorkStealingPool::WorkStealingPool(int numWorkers) : content(new Content) {
+  if (numWorkers <= 0) {
+    numWorkers = std::max(1, (int)thread::hardware_concurrency() - 1);
+  }
+  for (int i = 0; i < numWorkers; i++) {
+    content->deques.emplace_back(new RangeDeque);
+  }
+  Content* pool = content.get();
+  for (int i = 0; i < numWorkers; i++) {
+    content->workers.emplace_back([pool, i] {
+      currentPool = pool;
+      currentWorker = i;
+      pool->runUntil([pool] { return pool->stop.load(); });
+    });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  content->stop = true;
+  {
+    lock_guard<mutex> lock(content->sleepMutex);
+    content->epoch++;
+    content->sleepCondition.notify_all();
+  }
+  for (auto& worker : content->workers) {
+    worker.join();
+  }
+}
+
+taco_scheduler_t WorkStealingPool::getScheduler() {
+  taco_scheduler_t scheduler;
+  scheduler.parallel_for = poolParallelFor;
+  scheduler.context      = content.get();
+  return scheduler;
+}
+
+int WorkStealingPool::getNumWorkers() const {
+  return (int)content->workers.size();
+}
+
+static void runFunction(void* closure, int64_t begin, int64_t end) {
+  (*static_cast<const function<void(int64_t,int64_t)>*>(closure))(begin, end);
+}
+
+void WorkStealingPool::parallelFor(int64_t begin, int64_t end,
+    const function<void(int64_t,int64_t)>& task) {
+  content->parallelFor(begin, end, runFunction,
+                       const_cast<function<void(int64_t,int64_t)>*>(&task));
+}
+
+WorkStealingPool& WorkStealingPool::getDefault() {
+  static WorkStealingPool pool;
+  return pool;
+}
+
+}
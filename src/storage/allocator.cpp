@@ -0,0 +1,351 @@
+#include "taco/storage/allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+
+// The allocators
+static void* mallocAlloc(void*, size_t size, size_t) {
+  return malloc(size);
+}
+
+static void* mallocRealloc(void*, void* ptr, size_t size, size_t) {
+  return realloc(ptr, size);
+}
+
+static void mallocFree(void*, void* ptr) {
+  free(ptr);
+}
+
+taco_allocator_t mallocAllocator() {
+  taco_allocator_t allocator;
+  allocator.alloc     = mallocAlloc;
+  allocator.realloc   = mallocRealloc;
+  allocator.free      = mallocFree;
+  allocator.alignment = alignof(max_align_t);
+  allocator.context   = nullptr;
+  return allocator;
+}
+
+/// Aligned allocations are carved out of larger malloc allocations. A header
+/// in front of each allocation records the malloc allocation and the size, so
+/// that it can be freed and reallocated.
+struct AlignedHeader {
+  void*  base;
+  size_t size;
+};
+
+static AlignedHeader* getHeader(void* ptr) {
+  return static_cast<AlignedHeader*>(ptr) - 1;
+}
+
+static void* allocateAligned(size_t size, size_t alignment) {
+  alignment = std::max(alignment, alignof(AlignedHeader));
+  taco_iassert((alignment & (alignment - 1)) == 0)
+      << "Alignment must be a power of two";
+  char* base = static_cast<char*>(malloc(size + alignment +
+                                         sizeof(AlignedHeader)));
+  if (base == nullptr) {
+    return nullptr;
+  }
+  uintptr_t begin = reinterpret_cast<uintptr_t>(base + sizeof(AlignedHeader));
+  uintptr_t aligned = (begin + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  void* ptr = reinterpret_cast<void*>(aligned);
+  getHeader(ptr)->base = base;
+  getHeader(ptr)->size = size;
+  return ptr;
+}
+
+static void* alignedAlloc(void*, size_t size, size_t alignment) {
+  return allocateAligned(size, alignment);
+}
+
+static void alignedFree(void*, void* ptr) {
+  if (ptr != nullptr) {
+    free(getHeader(ptr)->base);
+  }
+}
+
+static void* reallocateAligned(void* context, void* ptr, size_t size,
+                               size_t alignment,
+                               void* (*alloc)(void*, size_t, size_t)) {
+  void* result = alloc(context, size, alignment);
+  if (ptr != nullptr && result != nullptr) {
+    memcpy(result, ptr, std::min(size, getHeader(ptr)->size));
+    alignedFree(context, ptr);
+  }
+  return result;
+}
+
+static void* alignedRealloc(void* context, void* ptr, size_t size,
+                            size_t alignment) {
+  return reallocateAligned(context, ptr, size, alignment, alignedAlloc);
+}
+
+taco_allocator_t alignedAllocator(size_t alignment) {
+  taco_uassert(alignment > 0 && (alignment & (alignment - 1)) == 0)
+      << "Alignment must be a power of two";
+  taco_allocator_t allocator;
+  allocator.alloc     = alignedAlloc;
+  allocator.realloc   = alignedRealloc;
+  allocator.free      = alignedFree;
+  allocator.alignment = alignment;
+  allocator.context   = nullptr;
+  return allocator;
+}
+
+static const size_t hugePageSize = 2 << 20;
+
+static void* hugePageAlloc(void*, size_t size, size_t alignment) {
+#if defined(__linux__)
+  if (size < hugePageSize) {
+    return allocateAligned(size, alignment);
+  }
+
+  // The header is put in front of the data in the first huge page, and the
+  // allocation is rounded up to whole huge pages
+  alignment = std::max(alignment, alignof(AlignedHeader));
+  const size_t offset = (sizeof(AlignedHeader) + alignment - 1) &
+                        ~(alignment - 1);
+  const size_t allocationSize = (size + offset + hugePageSize - 1) &
+                                ~(hugePageSize - 1);
+  void* base = nullptr;
+  if (posix_memalign(&base, hugePageSize, allocationSize) != 0) {
+    return nullptr;
+  }
+#if defined(MADV_HUGEPAGE)
+  madvise(base, allocationSize, MADV_HUGEPAGE);
+#endif
+  void* ptr = static_cast<char*>(base) + offset;
+  getHeader(ptr)->base = base;
+  getHeader(ptr)->size = size;
+  return ptr;
+#else
+  return allocateAligned(size, alignment);
+#endif
+}
+
+static void* hugePageRealloc(void* context, void* ptr, size_t size,
+                             size_t alignment) {
+  return reallocateAligned(context, ptr, size, alignment, hugePageAlloc);
+}
+
+taco_allocator_t hugePageAllocator() {
+  taco_allocator_t allocator;
+  allocator.alloc     = hugePageAlloc;
+  allocator.realloc   = hugePageRealloc;
+  allocator.free      = alignedFree;
+  allocator.alignment = 64;
+  allocator.context   = nullptr;
+  return allocator;
+}
+
+bool operator==(const taco_allocator_t& a, const taco_allocator_t& b) {
+  return a.alloc == b.alloc && a.realloc == b.realloc && a.free == b.free &&
+         a.context == b.context;
+}
+
+bool operator!=(const taco_allocator_t& a, const taco_allocator_t& b) {
+  return !(a == b);
+}
+
+
+// The current allocators
+static taco_allocator_t kernelAllocator = mallocAllocator();
+static taco_allocator_t kernelTemporaryAllocator = mallocAllocator();
+static bool temporaryAllocatorSet = false;
+
+static void checkAllocator(const taco_allocator_t& allocator) {
+  taco_uassert(allocator.alloc != nullptr && allocator.realloc != nullptr &&
+               allocator.free != nullptr)
+      << "Allocators must define alloc, realloc and free";
+}
+
+void setAllocator(const taco_allocator_t& allocator) {
+  checkAllocator(allocator);
+  kernelAllocator = allocator;
+  if (!temporaryAllocatorSet) {
+    kernelTemporaryAllocator = allocator;
+  }
+}
+
+const taco_allocator_t& getAllocator() {
+  return kernelAllocator;
+}
+
+void setTemporaryAllocator(const taco_allocator_t& allocator) {
+  checkAllocator(allocator);
+  kernelTemporaryAllocator = allocator;
+  temporaryAllocatorSet = true;
+}
+
+void resetTemporaryAllocator() {
+  kernelTemporaryAllocator = kernelAllocator;
+  temporaryAllocatorSet = false;
+}
+
+const taco_allocator_t& getTemporaryAllocator() {
+  return kernelTemporaryAllocator;
+}
+
+taco_allocator_t* getKernelAllocatorTable() {
+  return &kernelAllocator;
+}
+
+taco_allocator_t* getKernelTemporaryAllocatorTable() {
+  return &kernelTemporaryAllocator;
+}
+
+
+// class BumpArena
+struct ArenaState {
+  size_t blockSize;
+  mutable mutex arenaMutex;
+
+  /// The blocks of the arena (data and size); allocations bump `offset` in the
+  /// last block. Each allocation is preceded by its size.
+  vector<pair<char*,size_t>> blocks;
+  size_t offset = 0;
+  size_t bytesAllocated = 0;
+
+  void* allocate(size_t size, size_t alignment) {
+    alignment = std::max(alignment, alignof(size_t));
+    if (blocks.empty() || !fits(size, alignment)) {
+      const size_t newBlockSize = std::max(blockSize,
+                                           size + alignment + sizeof(size_t));
+      char* block = static_cast<char*>(malloc(newBlockSize));
+      if (block == nullptr) {
+        return nullptr;
+      }
+      blocks.push_back({block, newBlockSize});
+      offset = 0;
+    }
+    char* ptr = align(alignment);
+    reinterpret_cast<size_t*>(ptr)[-1] = size;
+    offset = (ptr + size) - blocks.back().first;
+    bytesAllocated += size;
+    return ptr;
+  }
+
+  char* align(size_t alignment) const {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(blocks.back().first + offset +
+                                                  sizeof(size_t));
+    return reinterpret_cast<char*>((begin + alignment - 1) &
+                                   ~(uintptr_t)(alignment - 1));
+  }
+
+  bool fits(size_t size, size_t alignment) const {
+    return align(alignment) + size <=
+           blocks.back().first + blocks.back().second;
+  }
+
+  /// True if `ptr` is the last allocation from the arena.
+  bool isLast(char* ptr) const {
+    return !blocks.empty() &&
+           ptr + reinterpret_cast<size_t*>(ptr)[-1] ==
+           blocks.back().first + offset;
+  }
+};
+
+struct BumpArena::Content : public ArenaState {
+};
+
+static void* arenaAlloc(void* context, size_t size, size_t alignment) {
+  auto content = static_cast<ArenaState*>(context);
+  lock_guard<mutex> lock(content->arenaMutex);
+  return content->allocate(size, alignment);
+}
+
+static void* arenaRealloc(void* context, void* ptr, size_t size,
+                          size_t alignment) {
+  auto content = static_cast<ArenaState*>(context);
+  lock_guard<mutex> lock(content->arenaMutex);
+  if (ptr == nullptr) {
+    return content->allocate(size, alignment);
+  }
+
+  // Grow the last allocation in place if it fits in its block
+  char* data = static_cast<char*>(ptr);
+  size_t& oldSize = reinterpret_cast<size_t*>(data)[-1];
+  char* blockEnd = content->blocks.back().first + content->blocks.back().second;
+  if (content->isLast(data) && data + size <= blockEnd) {
+    if (size > oldSize) {
+      content->bytesAllocated += size - oldSize;
+    }
+    oldSize = size;
+    content->offset = (data + size) - content->blocks.back().first;
+    return ptr;
+  }
+
+  const size_t copySize = std::min(size, oldSize);
+  void* result = content->allocate(size, alignment);
+  if (result != nullptr) {
+    memcpy(result, ptr, copySize);
+  }
+  return result;
+}
+
+static void arenaFree(void*, void*) {
+  // Arena memory is released by BumpArena::reset
+}
+
+BumpArena::BumpArena(size_t blockSize) : content(new Content) {
+  content->blockSize = blockSize;
+}
+
+BumpArena::~BumpArena() {
+  for (auto& block : content->blocks) {
+    free(block.first);
+  }
+}
+
+taco_allocator_t BumpArena::getAllocator() {
+  taco_allocator_t allocator;
+  allocator.alloc     = arenaAlloc;
+  allocator.realloc   = arenaRealloc;
+  allocator.free      = arenaFree;
+  allocator.alignment = 64;
+  allocator.context   = static_cast<ArenaState*>(content.get());
+  return allocator;
+}
+
+void BumpArena::reset() {
+  lock_guard<mutex> lock(content->arenaMutex);
+  auto& blocks = content->blocks;
+  if (!blocks.empty()) {
+    auto largest = std::max_element(blocks.begin(), blocks.end(),
+        [](const pair<char*,size_t>& a, const pair<char*,size_t>& b) {
+          return a.second < b.second;
+        });
+    pair<char*,size_t> kept = *largest;
+    for (auto& block : blocks) {
+      if (block.first != kept.first) {
+        free(block.first);
+      }
+    }
+    blocks = {kept};
+  }
+  content->offset = 0;
+  content->bytesAllocated = 0;
+}
+
+size_t BumpArena::getBytesAllocated() const {
+  lock_guard<mutex> lock(content->arenaMutex);
+  return content->bytesAllocated;
+}
+
+}
@@ -8,6 +8,7 @@
 #include "taco/util/uncopyable.h"
 #include "taco/util/strings.h"
 #include "taco/cuda.h"
+#include "taco/storage/allocator.h"
 
 using namespace std;
 
@@ -15,9 +16,10 @@ namespace taco {
 
 struct Array::Content : util::Uncopyable {
   Datatype   type;
-  void*  data;
-  size_t size;
+  void*  data = nullptr;
+  size_t size = 0;
   Policy policy = Array::UserOwns;
+  taco_allocator_t allocator = mallocAllocator();
 
   ~Content() {
     switch (policy) {
@@ -29,7 +31,7 @@ struct Array::Content : util::Uncopyable {
           cuda_unified_free(data);
         }
         else {
-          free(data);
+          allocator.free(allocator.context, data);
         }
         break;
       case Delete:
@@ -67,6 +69,12 @@ struct Array::Content : util::Uncopyable {
           case Datatype::Int128:
             delete[] ((long long*)data);
             break;
+          case Datatype::Float16:
+            delete[] ((float16*)data);
+            break;
+          case Datatype::BFloat16:
+            delete[] ((bfloat16*)data);
+            break;
           case Datatype::Float32:
             delete[] ((float*)data);
             break;
@@ -98,10 +106,20 @@ Array::Array(Datatype type, void* data, size_t size, Policy policy) : Array() {
   content->policy = policy;
 }
 
+Array::Array(Datatype type, void* data, size_t size,
+             const taco_allocator_t& allocator)
+    : Array(type, data, size, Array::Free) {
+  content->allocator = allocator;
+}
+
 const Datatype& Array::getType() const {
   return content->type;
 }
 
+Array::Policy Array::getPolicy() const {
+  return content->policy;
+}
+
 size_t Array::getSize() const {
   return content->size;
 }
@@ -175,6 +193,12 @@ std::ostream& operator<<(std::ostream& os, const Array& array) {
     case Datatype::Int128:
       printData<long long>(os, array);
       break;
+    case Datatype::Float16:
+      printData<float16>(os, array);
+      break;
+    case Datatype::BFloat16:
+      printData<bfloat16>(os, array);
+      break;
     case Datatype::Float32:
       printData<float>(os, array);
       break;
@@ -214,7 +238,10 @@ Array makeArray(Datatype type, size_t size) {
     return Array(type, cuda_unified_alloc(size * type.getNumBytes()), size, Array::Free);
   }
   else {
-    return Array(type, malloc(size * type.getNumBytes()), size, Array::Free);
+    const taco_allocator_t& allocator = getAllocator();
+    void* data = allocator.alloc(allocator.context, size * type.getNumBytes(),
+                                 allocator.alignment);
+    return Array(type, data, size, allocator);
   }
 }
 
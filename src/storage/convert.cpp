@@ -0,0 +1,528 @@
+#include "taco/storage/convert.h"
+
+#include <algorithm>
+#include <climits>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "taco/error.h"
+#include "taco/float16.h"
+#include "taco/storage/array.h"
+#include "taco/storage/index.h"
+
+using namespace std;
+
+namespace taco {
+
+/// A level of a tensor index that conversions read or build.
+struct ConvertLevel {
+  enum Kind {Dense, Compressed, Singleton, Unsupported} kind;
+  int mode;
+  bool ordered;
+  bool unique;
+};
+
+static ConvertLevel getLevel(const Format& format, int level) {
+  const ModeFormat modeFormat = format.getModeFormats()[level];
+  ConvertLevel result = {ConvertLevel::Unsupported,
+                         format.getModeOrdering()[level],
+                         modeFormat.isOrdered(), modeFormat.isUnique()};
+  const string name = modeFormat.getName();
+  if (name == Dense.getName()) {
+    result.kind = ConvertLevel::Dense;
+  } else if (name == Sparse.getName()) {
+    if (format.getCoordinateTypePos(level) == Int32 &&
+        format.getCoordinateTypeIdx(level) == Int32) {
+      result.kind = ConvertLevel::Compressed;
+    }
+  } else if (name == Singleton.getName()) {
+    if (level > 0 && format.getCoordinateTypeIdx(level) == Int32) {
+      result.kind = ConvertLevel::Singleton;
+    }
+  }
+  return result;
+}
+
+bool canConvert(const Format& source, const Format& target) {
+  if (source.getOrder() != target.getOrder() || source.getOrder() == 0) {
+    return false;
+  }
+  for (int i = 0; i < source.getOrder(); i++) {
+    if (getLevel(source, i).kind == ConvertLevel::Unsupported ||
+        getLevel(target, i).kind == ConvertLevel::Unsupported) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static int getMaxThreads() {
+#if USE_OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/// The first of `size` items in chunk `chunk` of `numChunks` even chunks.
+static size_t getChunkBegin(size_t size, int numChunks, int chunk) {
+  return size / numChunks * chunk + std::min((size_t)chunk, size % numChunks);
+}
+
+/// Stably sort `entries` by `keys[entry]`, where the keys are in
+/// [0,`numKeys`). Threads count and scatter their own chunk of the entries,
+/// so there are at most as many chunks as keys fit in the entries to bound
+/// the size of the per-chunk counts.
+static void countingSort(vector<size_t>& entries, const int32_t* keys,
+                         size_t numKeys, vector<size_t>& buffer) {
+  const size_t size = entries.size();
+  const int numChunks = (int)std::max<size_t>(1,
+      std::min<size_t>(getMaxThreads(), size / std::max<size_t>(numKeys, 1)));
+  vector<size_t> counts(numChunks * numKeys, 0);
+  buffer.resize(size);
+
+#if USE_OPENMP
+  #pragma omp parallel for num_threads(numChunks)
+#endif
+  for (int chunk = 0; chunk < numChunks; chunk++) {
+    size_t* chunkCounts = &counts[chunk * numKeys];
+    const size_t end = getChunkBegin(size, numChunks, chunk + 1);
+    for (size_t e = getChunkBegin(size, numChunks, chunk); e < end; e++) {
+      chunkCounts[keys[entries[e]]]++;
+    }
+  }
+
+  size_t offset = 0;
+  for (size_t key = 0; key < numKeys; key++) {
+    for (int chunk = 0; chunk < numChunks; chunk++) {
+      const size_t count = counts[chunk * numKeys + key];
+      counts[chunk * numKeys + key] = offset;
+      offset += count;
+    }
+  }
+
+#if USE_OPENMP
+  #pragma omp parallel for num_threads(numChunks)
+#endif
+  for (int chunk = 0; chunk < numChunks; chunk++) {
+    size_t* chunkOffsets = &counts[chunk * numKeys];
+    const size_t end = getChunkBegin(size, numChunks, chunk + 1);
+    for (size_t e = getChunkBegin(size, numChunks, chunk); e < end; e++) {
+      buffer[chunkOffsets[keys[entries[e]]]++] = entries[e];
+    }
+  }
+  entries.swap(buffer);
+}
+
+template <typename T>
+static bool isZero(const char* component) {
+  T value;
+  memcpy(&value, component, sizeof(T));
+  return value == T(0);
+}
+
+typedef bool (*ZeroTest)(const char*);
+
+static ZeroTest getZeroTest(Datatype type) {
+  switch (type.getKind()) {
+    case Datatype::Bool:       return isZero<bool>;
+    case Datatype::UInt8:      return isZero<uint8_t>;
+    case Datatype::UInt16:     return isZero<uint16_t>;
+    case Datatype::UInt32:     return isZero<uint32_t>;
+    case Datatype::UInt64:     return isZero<uint64_t>;
+    case Datatype::Int8:       return isZero<int8_t>;
+    case Datatype::Int16:      return isZero<int16_t>;
+    case Datatype::Int32:      return isZero<int32_t>;
+    case Datatype::Int64:      return isZero<int64_t>;
+    case Datatype::Float16:    return isZero<float16>;
+    case Datatype::BFloat16:   return isZero<bfloat16>;
+    case Datatype::Float32:    return isZero<float>;
+    case Datatype::Float64:    return isZero<double>;
+    case Datatype::Complex64:  return isZero<std::complex<float>>;
+    case Datatype::Complex128: return isZero<std::complex<double>>;
+    default:
+      taco_not_supported_yet;
+      return nullptr;
+  }
+}
+
+/// The components of `size` bytes, stored as a unit so that they are copied
+/// with single moves.
+template <size_t size>
+struct Component {
+  char bytes[size];
+};
+
+/// Copy component `entries[e]` of `source` to component `positions[e]` of
+/// `target`.
+template <typename T>
+static void scatterComponents(const vector<size_t>& entries,
+                              const vector<size_t>& positions,
+                              const void* source, void* target) {
+  const T* sourceComponents = static_cast<const T*>(source);
+  T* targetComponents = static_cast<T*>(target);
+#if USE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long long e = 0; e < (long long)entries.size(); e++) {
+    targetComponents[positions[e]] = sourceComponents[entries[e]];
+  }
+}
+
+static void scatterComponents(const vector<size_t>& entries,
+                              const vector<size_t>& positions,
+                              const void* source, void* target,
+                              size_t componentSize) {
+  switch (componentSize) {
+    case 1:
+      scatterComponents<Component<1>>(entries, positions, source, target);
+      break;
+    case 2:
+      scatterComponents<Component<2>>(entries, positions, source, target);
+      break;
+    case 4:
+      scatterComponents<Component<4>>(entries, positions, source, target);
+      break;
+    case 8:
+      scatterComponents<Component<8>>(entries, positions, source, target);
+      break;
+    case 16:
+      scatterComponents<Component<16>>(entries, positions, source, target);
+      break;
+    default:
+      taco_not_supported_yet;
+  }
+}
+
+/// Read the coordinates of every component of `source`, by level. The
+/// components are numbered by their position in the values array, which
+/// orders them lexicographically by level if every level is ordered.
+static vector<vector<int32_t>> getCoordinates(const TensorStorage& source,
+                                              size_t* numComponents) {
+  const Format& format = source.getFormat();
+  const Index& index = source.getIndex();
+  const int order = source.getOrder();
+
+  // The number of positions of each level
+  vector<size_t> levelSizes(order);
+  size_t numPositions = 1;
+  for (int k = 0; k < order; k++) {
+    const ConvertLevel level = getLevel(format, k);
+    if (level.kind == ConvertLevel::Dense) {
+      numPositions *= source.getDimensions()[level.mode];
+    } else if (level.kind == ConvertLevel::Compressed) {
+      const int32_t* pos =
+          (const int32_t*)index.getModeIndex(k).getIndexArray(0).getData();
+      numPositions = pos[numPositions];
+    }
+    levelSizes[k] = numPositions;
+  }
+  *numComponents = numPositions;
+
+  // Walk up from the components, replacing the position of each component in
+  // a level with the position of its parent
+  vector<vector<int32_t>> coordinates(order);
+  vector<size_t> positions(numPositions);
+#if USE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long long e = 0; e < (long long)numPositions; e++) {
+    positions[e] = e;
+  }
+  vector<size_t> parents;
+  for (int k = order - 1; k >= 0; k--) {
+    const ConvertLevel level = getLevel(format, k);
+    coordinates[k].resize(numPositions);
+    int32_t* coords = coordinates[k].data();
+    switch (level.kind) {
+      case ConvertLevel::Dense: {
+        const size_t width = source.getDimensions()[level.mode];
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long e = 0; e < (long long)numPositions; e++) {
+          coords[e] = positions[e] % width;
+          positions[e] /= width;
+        }
+        break;
+      }
+      case ConvertLevel::Compressed: {
+        const ModeIndex& modeIndex = index.getModeIndex(k);
+        const int32_t* pos = (const int32_t*)modeIndex.getIndexArray(0).getData();
+        const int32_t* crd = (const int32_t*)modeIndex.getIndexArray(1).getData();
+        const size_t numParents = (k > 0) ? levelSizes[k - 1] : 1;
+        parents.resize(levelSizes[k]);
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long q = 0; q < (long long)numParents; q++) {
+          for (int32_t c = pos[q]; c < pos[q + 1]; c++) {
+            parents[c] = q;
+          }
+        }
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long e = 0; e < (long long)numPositions; e++) {
+          coords[e] = crd[positions[e]];
+          positions[e] = parents[positions[e]];
+        }
+        break;
+      }
+      case ConvertLevel::Singleton: {
+        const int32_t* crd =
+            (const int32_t*)index.getModeIndex(k).getIndexArray(1).getData();
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long e = 0; e < (long long)numPositions; e++) {
+          coords[e] = crd[positions[e]];
+        }
+        break;
+      }
+      case ConvertLevel::Unsupported:
+        taco_ierror;
+    }
+  }
+  return coordinates;
+}
+
+/// Get the components that are not zero, in order.
+static vector<size_t> getNonzeros(const TensorStorage& source,
+                                  size_t numComponents) {
+  const ZeroTest isZero = getZeroTest(source.getComponentType());
+  const char* values = (const char*)source.getValues().getData();
+  const size_t componentSize = source.getComponentType().getNumBytes();
+
+  const int numChunks = std::max(1, getMaxThreads());
+  vector<size_t> offsets(numChunks + 1, 0);
+#if USE_OPENMP
+  #pragma omp parallel for num_threads(numChunks)
+#endif
+  for (int chunk = 0; chunk < numChunks; chunk++) {
+    const size_t end = getChunkBegin(numComponents, numChunks, chunk + 1);
+    for (size_t e = getChunkBegin(numComponents, numChunks, chunk); e < end;
+         e++) {
+      offsets[chunk + 1] += !isZero(&values[e * componentSize]);
+    }
+  }
+  for (int chunk = 0; chunk < numChunks; chunk++) {
+    offsets[chunk + 1] += offsets[chunk];
+  }
+
+  vector<size_t> nonzeros(offsets[numChunks]);
+#if USE_OPENMP
+  #pragma omp parallel for num_threads(numChunks)
+#endif
+  for (int chunk = 0; chunk < numChunks; chunk++) {
+    size_t offset = offsets[chunk];
+    const size_t end = getChunkBegin(numComponents, numChunks, chunk + 1);
+    for (size_t e = getChunkBegin(numComponents, numChunks, chunk); e < end;
+         e++) {
+      if (!isZero(&values[e * componentSize])) {
+        nonzeros[offset++] = e;
+      }
+    }
+  }
+  return nonzeros;
+}
+
+/// The number of leading levels of `targetLevels` that must be sorted, by
+/// stable sorts from the last of them to the first, to order components that
+/// are ordered by the source levels into the target levels. A transpose of a
+/// matrix, for example, sorts only by the first target level.
+static int getNumLevelsToSort(const Format& format,
+                              const vector<int>& targetLevels) {
+  const int order = format.getOrder();
+  for (int k = 0; k < order; k++) {
+    if (!getLevel(format, k).ordered) {
+      return order;
+    }
+  }
+  for (int numSorted = 0; numSorted < order; numSorted++) {
+    // The source levels, without the sorted ones, must be the remaining
+    // target levels in order
+    vector<int> remaining;
+    for (int k = 0; k < order; k++) {
+      if (std::find(targetLevels.begin(), targetLevels.begin() + numSorted,
+                    k) == targetLevels.begin() + numSorted) {
+        remaining.push_back(k);
+      }
+    }
+    if (std::equal(remaining.begin(), remaining.end(),
+                   targetLevels.begin() + numSorted)) {
+      return numSorted;
+    }
+  }
+  return order;
+}
+
+TensorStorage convert(const TensorStorage& source,
+                      const vector<int>& modeOrdering, const Format& format,
+                      bool removeZeros) {
+  const Format& sourceFormat = source.getFormat();
+  const int order = source.getOrder();
+  taco_iassert(canConvert(sourceFormat, format));
+  taco_iassert((int)modeOrdering.size() == order);
+
+  vector<int> dimensions(order);
+  vector<int> sourceLevels(order);
+  for (int k = 0; k < order; k++) {
+    sourceLevels[getLevel(sourceFormat, k).mode] = k;
+  }
+  for (int i = 0; i < order; i++) {
+    dimensions[i] = source.getDimensions()[modeOrdering[i]];
+  }
+
+  // The source level with the coordinates of each target level
+  vector<int> targetLevels(order);
+  for (int k = 0; k < order; k++) {
+    targetLevels[k] = sourceLevels[modeOrdering[getLevel(format, k).mode]];
+  }
+
+  size_t numComponents;
+  const vector<vector<int32_t>> coordinates = getCoordinates(source,
+                                                             &numComponents);
+  vector<size_t> entries;
+  if (removeZeros) {
+    entries = getNonzeros(source, numComponents);
+  } else {
+    entries.resize(numComponents);
+#if USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long long e = 0; e < (long long)numComponents; e++) {
+      entries[e] = e;
+    }
+  }
+  const size_t size = entries.size();
+
+  vector<size_t> buffer;
+  for (int k = getNumLevelsToSort(sourceFormat, targetLevels) - 1; k >= 0;
+       k--) {
+    const int sourceLevel = targetLevels[k];
+    countingSort(entries, coordinates[sourceLevel].data(),
+                 source.getDimensions()[getLevel(sourceFormat,
+                                                 sourceLevel).mode],
+                 buffer);
+  }
+
+  // Build the target levels from the top, tracking the position of each
+  // component in the last level built
+  vector<ModeIndex> modeIndices;
+  vector<size_t> positions(size, 0);
+  vector<size_t> children;
+  size_t numPositions = 1;
+  for (int k = 0; k < order; k++) {
+    const ConvertLevel level = getLevel(format, k);
+    const int32_t* coords = coordinates[targetLevels[k]].data();
+    switch (level.kind) {
+      case ConvertLevel::Dense: {
+        const int width = dimensions[level.mode];
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long e = 0; e < (long long)size; e++) {
+          positions[e] = positions[e] * width + coords[entries[e]];
+        }
+        numPositions *= width;
+        modeIndices.push_back(ModeIndex({makeArray({width})}));
+        break;
+      }
+      case ConvertLevel::Compressed: {
+        // A component starts a new child unless it has the same parent and
+        // coordinate as the component before it in a unique level
+        auto isNewChild = [&](size_t e) {
+          return !level.unique || e == 0 ||
+                 positions[e] != positions[e - 1] ||
+                 coords[entries[e]] != coords[entries[e - 1]];
+        };
+        const int numChunks = std::max(1, getMaxThreads());
+        vector<size_t> offsets(numChunks + 1, 0);
+#if USE_OPENMP
+        #pragma omp parallel for num_threads(numChunks)
+#endif
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+          const size_t end = getChunkBegin(size, numChunks, chunk + 1);
+          for (size_t e = getChunkBegin(size, numChunks, chunk); e < end; e++) {
+            offsets[chunk + 1] += isNewChild(e);
+          }
+        }
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+          offsets[chunk + 1] += offsets[chunk];
+        }
+        const size_t numChildren = offsets[numChunks];
+        taco_uassert(numChildren <= (size_t)INT32_MAX)
+            << "Converted tensor has too many components for 32-bit indices";
+
+        Array pos = makeArray(Int32, numPositions + 1);
+        Array crd = makeArray(Int32, numChildren);
+        int32_t* posData = (int32_t*)pos.getData();
+        int32_t* crdData = (int32_t*)crd.getData();
+        children.resize(size);
+#if USE_OPENMP
+        #pragma omp parallel for num_threads(numChunks)
+#endif
+        for (int chunk = 0; chunk < numChunks; chunk++) {
+          size_t child = offsets[chunk];
+          const size_t end = getChunkBegin(size, numChunks, chunk + 1);
+          for (size_t e = getChunkBegin(size, numChunks, chunk); e < end; e++) {
+            if (isNewChild(e)) {
+              crdData[child] = coords[entries[e]];
+              // The first child of a parent begins the segments of the
+              // parents up to it that have no children
+              if (e == 0 || positions[e] != positions[e - 1]) {
+                const size_t first = (e == 0) ? 0 : positions[e - 1] + 1;
+                for (size_t q = first; q <= positions[e]; q++) {
+                  posData[q] = (int32_t)child;
+                }
+              }
+              child++;
+            }
+            children[e] = child - 1;
+          }
+        }
+        const size_t last = (size == 0) ? 0 : positions[size - 1] + 1;
+        for (size_t q = last; q <= numPositions; q++) {
+          posData[q] = (int32_t)numChildren;
+        }
+        positions.swap(children);
+        numPositions = numChildren;
+        modeIndices.push_back(ModeIndex({pos, crd}));
+        break;
+      }
+      case ConvertLevel::Singleton: {
+        Array crd = makeArray(Int32, numPositions);
+        int32_t* crdData = (int32_t*)crd.getData();
+#if USE_OPENMP
+        #pragma omp parallel for
+#endif
+        for (long long e = 0; e < (long long)size; e++) {
+          crdData[positions[e]] = coords[entries[e]];
+        }
+        modeIndices.push_back(ModeIndex({makeArray(Int32, 0), crd}));
+        break;
+      }
+      case ConvertLevel::Unsupported:
+        taco_ierror;
+    }
+  }
+
+  const Datatype componentType = source.getComponentType();
+  Array values = makeArray(componentType, numPositions);
+  memset(values.getData(), 0, numPositions * componentType.getNumBytes());
+  scatterComponents(entries, positions, source.getValues().getData(),
+                    values.getData(), componentType.getNumBytes());
+
+  TensorStorage storage(componentType, dimensions, format);
+  storage.setIndex(Index(format, modeIndices));
+  storage.setValues(values);
+  return storage;
+}
+
+}
@@ -1,6 +1,8 @@
 #include "taco/storage/pack.h"
 
 #include <climits>
+#include <cstdint>
+#include <cstring>
 
 #include "taco/format.h"
 #include "taco/error.h"
@@ -188,4 +190,128 @@ TensorStorage pack(Datatype                             componentType,
   return storage;
 }
 
+
+/// The arrays of a level of a tensor index, and their first-touch copies.
+struct FirstTouchLevel {
+  enum Kind {Dense, Compressed, Singleton} kind;
+  size_t width;
+  const int32_t* pos;
+  const int32_t* crd;
+  int32_t* newPos;
+  int32_t* newCrd;
+};
+
+/// Copy the positions [begin,end) of level 0 and everything below them.
+static void copyFirstTouchPositions(const vector<FirstTouchLevel>& levels,
+                                    size_t begin, size_t end,
+                                    const char* vals, char* newVals,
+                                    size_t valSize) {
+  for (size_t k = 0; k < levels.size(); k++) {
+    const FirstTouchLevel& level = levels[k];
+    if (k > 0) {
+      switch (level.kind) {
+        case FirstTouchLevel::Dense:
+          begin *= level.width;
+          end *= level.width;
+          break;
+        case FirstTouchLevel::Compressed:
+          memcpy(&level.newPos[begin + 1], &level.pos[begin + 1],
+                 (end - begin) * sizeof(int32_t));
+          begin = level.pos[begin];
+          end = level.pos[end];
+          break;
+        case FirstTouchLevel::Singleton:
+          break;
+      }
+    }
+    if (level.kind != FirstTouchLevel::Dense) {
+      memcpy(&level.newCrd[begin], &level.crd[begin],
+             (end - begin) * sizeof(int32_t));
+    }
+  }
+  memcpy(&newVals[begin * valSize], &vals[begin * valSize],
+         (end - begin) * valSize);
+}
+
+void distributeFirstTouch(TensorStorage& storage) {
+  const Format& format = storage.getFormat();
+  const int order = storage.getOrder();
+  if (order == 0) {
+    return;
+  }
+  Index index = storage.getIndex();
+
+  vector<FirstTouchLevel> levels;
+  vector<ModeIndex> modeIndices;
+  size_t numPositions = 1;
+  for (int i = 0; i < order; i++) {
+    const string name = format.getModeFormats()[i].getName();
+    ModeIndex modeIndex = index.getModeIndex(i);
+    FirstTouchLevel level = {FirstTouchLevel::Dense, 1, nullptr, nullptr,
+                             nullptr, nullptr};
+    if (name == Dense.getName()) {
+      Array size = modeIndex.getIndexArray(0);
+      if (size.getType() != Int32) {
+        return;
+      }
+      level.width = ((const int32_t*)size.getData())[0];
+      numPositions *= level.width;
+      modeIndices.push_back(modeIndex);
+    } else if (name == Sparse.getName() || name == Singleton.getName()) {
+      Array pos = modeIndex.getIndexArray(0);
+      Array crd = modeIndex.getIndexArray(1);
+      if (crd.getType() != Int32 || (name == Sparse.getName() &&
+                                     pos.getType() != Int32)) {
+        return;
+      }
+      level.crd = (const int32_t*)crd.getData();
+      Array newCrd = makeArray(Int32, crd.getSize());
+      level.newCrd = (int32_t*)newCrd.getData();
+      if (name == Sparse.getName()) {
+        level.kind = FirstTouchLevel::Compressed;
+        level.pos = (const int32_t*)pos.getData();
+        Array newPos = makeArray(Int32, pos.getSize());
+        level.newPos = (int32_t*)newPos.getData();
+        level.newPos[0] = level.pos[0];
+        numPositions = level.pos[numPositions];
+        modeIndices.push_back(ModeIndex({newPos, newCrd}));
+      } else {
+        if (i == 0) {
+          return;
+        }
+        level.kind = FirstTouchLevel::Singleton;
+        modeIndices.push_back(ModeIndex({pos, newCrd}));
+      }
+    } else {
+      return;
+    }
+    levels.push_back(level);
+  }
+
+  // Level 0 positions are distributed, so a top-level pos array is copied
+  // up front
+  size_t numTopPositions = levels[0].width;
+  if (levels[0].kind == FirstTouchLevel::Compressed) {
+    numTopPositions = levels[0].pos[1];
+    levels[0].newPos[1] = levels[0].pos[1];
+  }
+
+  Array values = storage.getValues();
+  Array newValues = makeArray(values.getType(), values.getSize());
+  const char* vals = (const char*)values.getData();
+  char* newVals = (char*)newValues.getData();
+  const size_t valSize = values.getType().getNumBytes();
+  taco_iassert(numPositions <= values.getSize());
+
+#if USE_OPENMP
+  #pragma omp parallel for schedule(runtime)
+#endif
+  for (long long p = 0; p < (long long)numTopPositions; p++) {
+    copyFirstTouchPositions(levels, p, p + 1, vals, newVals, valSize);
+  }
+
+  storage.setIndex(Index(format, modeIndices));
+  storage.setValues(newValues);
+}
+
 }
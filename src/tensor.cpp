@@ -1,11 +1,13 @@
 #include "taco/tensor.h"
 
 #include <set>
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
 #include <climits>
+#include <limits>
 #include <vector>
 #include <utility>
 #include <mutex>
@@ -15,31 +17,43 @@
 #include "taco/taco_tensor_t.h"
 #include "taco/codegen/module.h"
 #include "taco/error/error_messages.h"
+#include "taco/instrumentation.h"
 #include "taco/index_notation/index_notation.h"
 #include "taco/index_notation/index_notation_nodes.h"
 //#include "codegen/codegen_c.h"
 //#include "codegen/codegen_cuda.h"
 //#include "taco/taco_tensor_t.h"
 #include "taco/index_notation/index_notation_visitor.h"
+#include "taco/index_notation/index_notation_rewriter.h"
 #include "taco/index_notation/transformations.h"
 #include "taco/ir/ir.h"
 #include "taco/ir/ir_printer.h"
 #include "taco/lower/lower.h"
+#include "taco/lower/lowerer_impl.h"
 #include "taco/storage/storage.h"
 #include "taco/storage/index.h"
 #include "taco/storage/array.h"
+#include "taco/storage/allocator.h"
 #include "taco/storage/pack.h"
+#include "taco/storage/convert.h"
 #include "taco/storage/file_io_tns.h"
 #include "taco/storage/file_io_mtx.h"
 #include "taco/storage/file_io_rb.h"
 #include "taco/storage/typed_vector.h"
 #include "taco/util/collections.h"
+#include "taco/util/env.h"
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
+#include "taco/util/numa.h"
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
 #include "taco/util/name_generator.h"
 
 #include "codegen/codegen_c.h"
 #include "codegen/codegen_cuda.h"
+#include "codegen/compile_pool.h"
 #include "error/error_checks.h"
 #include "taco/cuda.h"
 #include "lower/iteration_graph.h"
@@ -130,6 +144,12 @@ TensorBase::TensorBase(string name, Datatype ctype, vector<int> dimensions,
   content->needsAssemble = false;
   content->needsCompute = false;
 
+  content->indexFrozen = false;
+  content->frozenOperandIndicesHash = 0;
+
+  content->presizeResult = false;
+  content->capacityHint = 0;
+
   content->coordinateBuffer = shared_ptr<vector<char>>(new vector<char>);
   content->coordinateBufferUsed = 0;
   content->coordinateSize = getOrder()*sizeof(int) + ctype.getNumBytes();
@@ -190,6 +210,28 @@ size_t TensorBase::getAllocSize() const {
   return content->allocSize;
 }
 
+void TensorBase::setPresizeResult(bool presizeResult) {
+  if (presizeResult != content->presizeResult && getAssignment().defined()) {
+    setNeedsCompile(true);
+  }
+  content->presizeResult = presizeResult;
+}
+
+bool TensorBase::isResultPresized() const {
+  return content->presizeResult;
+}
+
+void TensorBase::setCapacityHint(size_t capacityHint) {
+  content->capacityHint = capacityHint;
+  if (capacityHint > 0) {
+    setPresizeResult(true);
+  }
+}
+
+size_t TensorBase::getCapacityHint() const {
+  return content->capacityHint;
+}
+
 void TensorBase::unsetNeverPacked() {
   content->neverPacked = false;
 }
@@ -272,16 +314,46 @@ static size_t unpackTensorData(const taco_tensor_t& tensorData,
     }
   }
   storage.setIndex(Index(format, modeIndices));
-  storage.setValues(Array(tensor.getComponentType(), tensorData.vals, numVals));
+  storage.setValues(Array(tensor.getComponentType(), tensorData.vals, numVals,
+                          getAllocator()));
   return numVals;
 }
 
+#if USE_OPENMP
+/// Set the schedule, number of threads and thread placement of the parallel
+/// regions that the calling thread starts.
+static void setParallelExecution(ParallelSchedule sched, int chunkSize,
+                                 int numThreads, ThreadPlacement placement) {
+  omp_set_schedule(sched == ParallelSchedule::Dynamic ? omp_sched_dynamic
+                                                      : omp_sched_static,
+                   chunkSize);
+  omp_set_num_threads(numThreads);
+  util::placeOpenMPThreads(numThreads,
+                           placement != ThreadPlacement::Default,
+                           placement == ThreadPlacement::Spread);
+}
+
+/// Set the schedule, number of threads and thread placement of parallel
+/// regions to the ones of tensor computations.
+static void setParallelExecution() {
+  ParallelSchedule sched;
+  int chunkSize;
+  taco_get_parallel_schedule(&sched, &chunkSize);
+  setParallelExecution(sched, chunkSize, taco_get_num_threads(),
+                       taco_get_thread_placement());
+}
+
+/// Tensors with fewer components are not worth distributing across threads.
+static const size_t minFirstTouchSize = 1 << 10;
+#endif
+
 /// Pack coordinates into a data structure given by the tensor format.
 void TensorBase::pack() {
   if (!needsPack()) {
     return;
   }
   setNeedsPack(false);
+  ScopedPhaseTimer timer("pack", getName());
 
   if (neverPacked()) {
     unsetNeverPacked();
@@ -321,6 +393,12 @@ void TensorBase::pack() {
       case Datatype::Int64:
         reinsertPackedComponents<int64_t>();
         break;
+      case Datatype::Float16:
+        reinsertPackedComponents<float16>();
+        break;
+      case Datatype::BFloat16:
+        reinsertPackedComponents<bfloat16>();
+        break;
       case Datatype::Float32:
         reinsertPackedComponents<float>();
         break;
@@ -401,7 +479,10 @@ void TensorBase::pack() {
 
   // The pack code expects the coordinates to be sorted
   numIntegersToCompare = order;
-  qsort(coordinatesPtr, numCoordinates, coordSize, lexicographicalCmp);
+  {
+    ScopedPhaseTimer sortTimer("pack.sort", getName());
+    qsort(coordinatesPtr, numCoordinates, coordSize, lexicographicalCmp);
+  }
 
 
   // Move coords into separate arrays
@@ -442,6 +523,48 @@ void TensorBase::pack() {
 
   free(values);
   deinit_taco_tensor_t(bufferStorage);
+
+#if USE_OPENMP
+  // Spread the pages of the arrays across the nodes of the threads that will
+  // compute with them
+  if (taco_get_numa_first_touch() && content->valuesSize >= minFirstTouchSize) {
+    omp_sched_t existingSched;
+    int existingChunkSize;
+    const int existingNumThreads = omp_get_max_threads();
+    omp_get_schedule(&existingSched, &existingChunkSize);
+    setParallelExecution();
+    distributeFirstTouch(content->storage);
+    omp_set_schedule(existingSched, existingChunkSize);
+    omp_set_num_threads(existingNumThreads);
+  }
+#endif
+}
+
+bool TensorBase::convertInto(TensorBase& result,
+                             const std::vector<int>& modeOrdering,
+                             bool removeZeros) const {
+  if (!canConvert(getFormat(), result.getFormat())) {
+    return false;
+  }
+  const_cast<TensorBase*>(this)->syncValues();
+
+  ScopedPhaseTimer timer("convert", result.getName());
+#if USE_OPENMP
+  omp_sched_t existingSched;
+  int existingChunkSize;
+  const int existingNumThreads = omp_get_max_threads();
+  omp_get_schedule(&existingSched, &existingChunkSize);
+  setParallelExecution();
+#endif
+  TensorStorage storage = convert(getStorage(), modeOrdering,
+                                  result.getFormat(), removeZeros);
+#if USE_OPENMP
+  omp_set_schedule(existingSched, existingChunkSize);
+  omp_set_num_threads(existingNumThreads);
+#endif
+  result.setStorage(storage);
+  result.content->valuesSize = storage.getValues().getSize();
+  return true;
 }
 
 void TensorBase::setStorage(TensorStorage storage) {
@@ -513,29 +636,202 @@ const Access TensorBase::operator()() const {
 TensorBase::KernelsCache TensorBase::computeKernels;
 std::mutex TensorBase::computeKernelsMutex;
 
-std::shared_ptr<Module> TensorBase::getComputeKernel(const IndexStmt stmt) {
-  computeKernelsMutex.lock();
+bool TensorBase::findComputeKernel(
+    const IndexStmt scheduledStmt, bool assembleWhileCompute,
+    bool presizeResult, bool firstTouch, bool interpret,
+    Datatype accumulatorType, ModuleFuture* kernel) {
+  std::lock_guard<std::mutex> lock(computeKernelsMutex);
+  const auto computeKernelsReverse =
+      util::ReverseConstIterable<TensorBase::KernelsCache>(computeKernels);
+  for (const auto& computeKernel : computeKernelsReverse) {
+    if (std::get<2>(computeKernel) == assembleWhileCompute &&
+        std::get<3>(computeKernel) == presizeResult &&
+        std::get<4>(computeKernel) == firstTouch &&
+        std::get<5>(computeKernel) == interpret &&
+        std::get<6>(computeKernel) == accumulatorType &&
+        isomorphic(scheduledStmt, std::get<1>(computeKernel))) {
+      *kernel = std::get<7>(computeKernel);
+      return true;
+    }
+  }
+  return false;
+}
+
+TensorBase::ModuleFuture TensorBase::getComputeKernel(
+    const IndexStmt stmt, const IndexStmt scheduledStmt,
+    bool assembleWhileCompute, bool presizeResult, bool firstTouch,
+    bool interpret, Datatype accumulatorType, const ModuleFuture& compiled,
+    bool* reserved) {
+  std::lock_guard<std::mutex> lock(computeKernelsMutex);
   const auto computeKernelsReverse =
       util::ReverseConstIterable<TensorBase::KernelsCache>(computeKernels);
   for (const auto& computeKernel : computeKernelsReverse) {
-    if (isomorphic(stmt, computeKernel.first)) {
-      const auto kernelModule = computeKernel.second;
-      computeKernelsMutex.unlock();
-      return kernelModule;
+    if (std::get<2>(computeKernel) == assembleWhileCompute &&
+        std::get<3>(computeKernel) == presizeResult &&
+        std::get<4>(computeKernel) == firstTouch &&
+        std::get<5>(computeKernel) == interpret &&
+        std::get<6>(computeKernel) == accumulatorType &&
+        isomorphic(stmt, std::get<0>(computeKernel))) {
+      *reserved = false;
+      return std::get<7>(computeKernel);
     }
   }
-  computeKernelsMutex.unlock();
-  return nullptr;
+  computeKernels.emplace_back(stmt, scheduledStmt, assembleWhileCompute,
+                              presizeResult, firstTouch, interpret,
+                              accumulatorType, compiled);
+  *reserved = true;
+  return compiled;
+}
+
+void TensorBase::uncacheComputeKernel(const IndexStmt stmt) {
+  std::lock_guard<std::mutex> lock(computeKernelsMutex);
+  computeKernels.erase(
+      std::remove_if(computeKernels.begin(), computeKernels.end(),
+                     [&](const KernelsCache::value_type& computeKernel) {
+                       return std::get<0>(computeKernel) == stmt;
+                     }),
+      computeKernels.end());
+}
+
+/// The accesses that are factors of an expression, i.e. that are reached from
+/// the root only through multiplications, negations and reductions.
+static vector<Access> getFactors(const IndexExpr& expr) {
+  vector<Access> factors;
+  if (isa<Access>(expr)) {
+    factors.push_back(to<Access>(expr));
+  } else if (isa<Mul>(expr)) {
+    factors = getFactors(to<Mul>(expr).getA());
+    util::append(factors, getFactors(to<Mul>(expr).getB()));
+  } else if (isa<Neg>(expr)) {
+    factors = getFactors(to<Neg>(expr).getA());
+  } else if (isa<Reduction>(expr)) {
+    factors = getFactors(to<Reduction>(expr).getExpr());
+  }
+  return factors;
+}
+
+/// The number of times each tensor is accessed in an expression.
+static map<TensorBase,int> countAccesses(const IndexExpr& expr) {
+  map<TensorBase,int> counts;
+  match(expr,
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      if (isa<AccessTensorNode>(op)) {
+        counts[to<AccessTensorNode>(op)->tensor]++;
+      }
+    })
+  );
+  return counts;
 }
 
-void TensorBase::cacheComputeKernel(const IndexStmt stmt,
-                                    const std::shared_ptr<Module> kernel) {
-  computeKernelsMutex.lock();
-  computeKernels.emplace_back(stmt, kernel);
-  computeKernelsMutex.unlock();
+static bool hasDistinctVars(const vector<IndexVar>& vars) {
+  return set<IndexVar>(vars.begin(), vars.end()).size() == vars.size();
+}
+
+/// Rewrites the pending assignment of a producer tensor into an expression
+/// that computes the producer at the given access, renaming its free variables
+/// to the variables of the access and its reduction variables to fresh ones.
+static IndexExpr inlineProducer(const Assignment& producer,
+                                const Access& access) {
+  struct RenameIndexVars : public IndexNotationRewriter {
+    using IndexNotationRewriter::visit;
+
+    map<IndexVar,IndexVar> renames;
+
+    IndexVar rename(const IndexVar& var) {
+      if (!util::contains(renames, var)) {
+        renames.insert({var, IndexVar()});
+      }
+      return renames.at(var);
+    }
+
+    void visit(const AccessNode* op) {
+      vector<IndexVar> vars;
+      for (auto& var : op->indexVars) {
+        vars.push_back(rename(var));
+      }
+      if (isa<AccessTensorNode>(op)) {
+        expr = new AccessTensorNode(to<AccessTensorNode>(op)->tensor, vars);
+      } else {
+        expr = Access(op->tensorVar, vars);
+      }
+    }
+
+    void visit(const ReductionNode* op) {
+      IndexVar var = rename(op->var);
+      expr = new ReductionNode(op->op, var, rewrite(op->a));
+    }
+  };
+
+  RenameIndexVars renamer;
+  const vector<IndexVar>& freeVars = producer.getLhs().getIndexVars();
+  for (size_t i = 0; i < freeVars.size(); i++) {
+    renamer.renames.insert({freeVars[i], access.getIndexVars()[i]});
+  }
+  return renamer.rewrite(producer.getRhs());
+}
+
+void TensorBase::fusePendingOperands() {
+  Assignment assignment = getAssignment();
+  bool fused = true;
+  while (fused) {
+    fused = false;
+    const map<TensorBase,int> accessCounts = countAccesses(assignment.getRhs());
+    for (const Access& access : getFactors(assignment.getRhs())) {
+      if (!isa<AccessTensorNode>(access.ptr)) {
+        continue;
+      }
+      TensorBase producer = to<AccessTensorNode>(access.ptr)->tensor;
+      Assignment producerAssignment = producer.getAssignment();
+
+      // Only fuse plain assignments that have not been computed yet, into
+      // consumers that access the producer once, without repeated variables.
+      if (producer == *this || accessCounts.at(producer) != 1 ||
+          !producer.needsCompute() || !producerAssignment.defined() ||
+          producerAssignment.getOperator().defined() ||
+          !hasDistinctVars(access.getIndexVars()) ||
+          !hasDistinctVars(producerAssignment.getLhs().getIndexVars())) {
+        continue;
+      }
+      auto producerOperands = getTensors(producerAssignment.getRhs());
+      if (util::contains(producerOperands, getTensorVar()) ||
+          util::contains(producerOperands, producer.getTensorVar())) {
+        continue;
+      }
+
+      IndexExpr producerExpr = inlineProducer(producerAssignment, access);
+      struct ReplaceAccess : public IndexNotationRewriter {
+        using IndexNotationRewriter::visit;
+        const AccessNode* target;
+        IndexExpr replacement;
+        void visit(const AccessNode* op) {
+          expr = (op == target) ? replacement : IndexExpr(op);
+        }
+      } replaceAccess;
+      replaceAccess.target = to<AccessNode>(access.ptr);
+      replaceAccess.replacement = producerExpr;
+      assignment = Assignment(assignment.getLhs(),
+                              replaceAccess.rewrite(assignment.getRhs()),
+                              assignment.getOperator());
+
+      // This tensor now depends on the producer's operands instead of on the
+      // producer, which is left pending (and computed only if it is read).
+      producer.removeDependentTensor(*this);
+      for (auto& operand : producerOperands) {
+        operand.second.addDependentTensor(*this);
+      }
+      addToCounter(counters::fusedAssignments);
+      fused = true;
+      break;
+    }
+  }
+  setAssignment(assignment);
 }
 
 void TensorBase::compile() {
+  if (taco_get_kernel_fusion() && needsCompile()) {
+    fusePendingOperands();
+  }
+
   Assignment assignment = getAssignment();
   taco_uassert(assignment.defined())
       << error::compile_without_expr;
@@ -567,42 +863,161 @@ void TensorBase::compile() {
   assignment.getLhs().accept(&dupes);
   assignment.accept(&dupes);
 
-  IndexStmt stmt = makeConcreteNotation(makeReductionNotation(assignment));
-  stmt = reorderLoopsTopologically(stmt);
-  stmt = insertTemporaries(stmt);
-  stmt = parallelizeOuterLoop(stmt);
+  IndexStmt stmt;
+  {
+    ScopedPhaseTimer timer("concretize", getName());
+    stmt = makeConcreteNotation(makeReductionNotation(assignment));
+    stmt = reorderLoopsTopologically(stmt);
+    stmt = insertTemporaries(stmt);
+    stmt = parallelizeOuterLoop(stmt);
+  }
   compile(stmt, content->assembleWhileCompute);
 }
+/// Splits with the RoundUp tail strategy emit no checks, so their factors must
+/// divide the dimensions that the split index variables index.
+static void checkRoundUpSplits(IndexStmt stmt) {
+  map<IndexVar, size_t> roundUpFactors;
+  match(stmt,
+    function<void(const SuchThatNode*)>([&](const SuchThatNode* op) {
+      for (const IndexVarRel& rel : op->predicate) {
+        if (rel.getRelType() == SPLIT &&
+            rel.getNode<SplitRelNode>()->getTailStrategy() ==
+                TailStrategy::RoundUp) {
+          roundUpFactors.insert({rel.getNode<SplitRelNode>()->getParentVar(),
+                                 rel.getNode<SplitRelNode>()->getSplitFactor()});
+        }
+      }
+    })
+  );
+  if (roundUpFactors.empty()) {
+    return;
+  }
+  match(stmt,
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      const Shape shape = op->tensorVar.getType().getShape();
+      for (size_t mode = 0; mode < op->indexVars.size(); mode++) {
+        const IndexVar& var = op->indexVars[mode];
+        if (!roundUpFactors.count(var) ||
+            !shape.getDimension(mode).isFixed()) {
+          continue;
+        }
+        const size_t dimension = shape.getDimension(mode).getSize();
+        taco_uassert(dimension % roundUpFactors.at(var) == 0)
+            << "The RoundUp split factor " << roundUpFactors.at(var) << " of "
+            << var << " does not divide its dimension " << dimension << " in "
+            << op->tensorVar.getName();
+      }
+    })
+  );
+}
+
 void TensorBase::compile(taco::IndexStmt stmt, bool assembleWhileCompute) {
   if (!needsCompile()) {
     return;
   }
+  checkRoundUpSplits(stmt);
   setNeedsCompile(false);
+  ScopedPhaseTimer timer("compile", getName());
+
+  // Presizing relies on shrinking arrays with realloc, which the CUDA backend
+  // does not support
+  const bool presizeResult = content->presizeResult &&
+                             !should_use_CUDA_codegen();
+  const bool firstTouch = taco_get_numa_first_touch();
+
+  // Kernels of small problems are interpreted rather than compiled
+  const bool interpret = !should_use_CUDA_codegen() &&
+                         getEstimatedWork() < taco_get_interpreter_threshold();
+  const Datatype accumulatorType = taco_get_accumulator_type();
+
+  // Kernels are first looked up by the statement they were scheduled from,
+  // which for repeated expressions skips concretizing the statement again
+  const bool cacheKernels = !std::getenv("CACHE_KERNELS") ||
+                            std::string(std::getenv("CACHE_KERNELS")) != "0";
+  ModuleFuture cachedKernel;
+  if (cacheKernels &&
+      findComputeKernel(stmt, assembleWhileCompute, presizeResult, firstTouch,
+                        interpret, accumulatorType, &cachedKernel)) {
+    addToCounter(counters::kernelCacheHits);
+    content->module = cachedKernel.get();
+    return;
+  }
 
   IndexStmt concretizedAssign = stmt;
   IndexStmt stmtToCompile = stmt.concretize();
   stmtToCompile = scalarPromote(stmtToCompile);
 
-  if (!std::getenv("CACHE_KERNELS") ||
-      std::string(std::getenv("CACHE_KERNELS")) != "0") {
+  // Concurrent compilations of the same kernel are deduplicated: the first one
+  // caches a future of the kernel and compiles it, while the others wait for
+  // the future
+  std::promise<std::shared_ptr<Module>> compiled;
+  bool reserved = false;
+  if (cacheKernels) {
     concretizedAssign = stmtToCompile;
-    const auto cachedKernel = getComputeKernel(concretizedAssign);
-    if (cachedKernel) {
-      content->module = cachedKernel;
+    cachedKernel = getComputeKernel(concretizedAssign, stmt,
+                                    assembleWhileCompute, presizeResult,
+                                    firstTouch, interpret, accumulatorType,
+                                    compiled.get_future().share(), &reserved);
+    if (!reserved) {
+      addToCounter(counters::kernelCacheHits);
+      content->module = cachedKernel.get();
       return;
     }
   }
+  addToCounter(counters::kernelCacheMisses);
 
-  content->assembleFunc = lower(stmtToCompile, "assemble", true, false);
-  content->computeFunc = lower(stmtToCompile, "compute",  assembleWhileCompute, true);
+  try {
+    compileKernel(stmtToCompile, assembleWhileCompute, presizeResult,
+                  firstTouch, interpret, accumulatorType);
+  } catch (...) {
+    if (reserved) {
+      uncacheComputeKernel(concretizedAssign);
+      compiled.set_exception(std::current_exception());
+    }
+    throw;
+  }
+  if (reserved) {
+    compiled.set_value(content->module);
+  }
+}
+
+void TensorBase::compileKernel(IndexStmt stmtToCompile,
+                               bool assembleWhileCompute, bool presizeResult,
+                               bool firstTouch, bool interpret,
+                               Datatype accumulatorType) {
+  {
+    ScopedPhaseTimer lowerTimer("lower", getName());
+    Lowerer assembleLowerer;
+    Lowerer computeLowerer;
+    assembleLowerer.getLowererImpl()->setPresizeResults(presizeResult);
+    computeLowerer.getLowererImpl()->setPresizeResults(presizeResult);
+    assembleLowerer.getLowererImpl()->setFirstTouch(firstTouch);
+    computeLowerer.getLowererImpl()->setFirstTouch(firstTouch);
+    assembleLowerer.getLowererImpl()->setAccumulatorType(accumulatorType);
+    computeLowerer.getLowererImpl()->setAccumulatorType(accumulatorType);
+    // The compute function is lowered from the analysis of the assemble one
+    auto analysis = make_shared<LoweringAnalysis>();
+    assembleLowerer.getLowererImpl()->setAnalysis(analysis);
+    computeLowerer.getLowererImpl()->setAnalysis(analysis);
+    content->assembleFunc = lower(stmtToCompile, "assemble", true, false,
+                                  false, false, assembleLowerer);
+    content->computeFunc = lower(stmtToCompile, "compute",  assembleWhileCompute,
+                                 true, false, false, computeLowerer);
+  }
   // If we have to recompile the kernel, we need to create a new Module. Since
   // the module we are holding on to could have been retrieved from the cache,
   // we can't modify it.
   content->module = make_shared<Module>();
   content->module->addFunction(content->assembleFunc);
   content->module->addFunction(content->computeFunc);
-  content->module->compile();
-  cacheComputeKernel(concretizedAssign, content->module);
+  if (interpret && content->module->interpret()) {
+    return;
+  }
+  if (taco_get_background_compile()) {
+    content->module->compileInBackground();
+  } else {
+    content->module->compile();
+  }
 }
 
 taco_tensor_t* TensorBase::getTacoTensorT() {
@@ -620,10 +1035,12 @@ void TensorBase::syncValues() {
 }
 
 void TensorBase::addDependentTensor(TensorBase& tensor) {
+  std::lock_guard<std::mutex> lock(content->dependentTensorsMutex);
   content->dependentTensors.push_back(tensor.content);
 }
 
 void TensorBase::removeDependentTensor(TensorBase& tensor) {
+  std::lock_guard<std::mutex> lock(content->dependentTensorsMutex);
   int size = content->dependentTensors.size();
   if (size == 0) {
     return;
@@ -647,6 +1064,7 @@ void TensorBase::removeDependentTensor(TensorBase& tensor) {
 }
 
 vector<TensorBase> TensorBase::getDependentTensors() {
+  std::lock_guard<std::mutex> lock(content->dependentTensorsMutex);
   vector<TensorBase> dependents;
   for(std::weak_ptr<Content> dependentContent : content->dependentTensors) {
     TensorBase current;
@@ -657,11 +1075,20 @@ vector<TensorBase> TensorBase::getDependentTensors() {
 }
 
 void TensorBase::syncDependentTensors() {
-  vector<TensorBase> dependents = getDependentTensors();
-  for (TensorBase dependent : dependents) {
-    dependent.syncValues();
+  // Take the dependents before syncing them, since syncing may update the
+  // dependents of this tensor
+  std::vector<std::weak_ptr<Content>> dependents;
+  {
+    std::lock_guard<std::mutex> lock(content->dependentTensorsMutex);
+    std::swap(dependents, content->dependentTensors);
+  }
+  for (std::weak_ptr<Content> dependentContent : dependents) {
+    TensorBase dependent;
+    dependent.content = dependentContent.lock();
+    if (dependent.content != nullptr) {
+      dependent.syncValues();
+    }
   }
-  content->dependentTensors.clear();
 }
 
 static inline map<TensorVar, TensorBase> getTensors(const IndexExpr& expr) {
@@ -712,6 +1139,229 @@ vector<void*> packArguments(const TensorBase& tensor) {
   return arguments;
 }
 
+static size_t saturatingAdd(size_t a, size_t b) {
+  return (b > numeric_limits<size_t>::max() - a)
+         ? numeric_limits<size_t>::max() : a + b;
+}
+
+static size_t saturatingMul(size_t a, size_t b) {
+  return (a != 0 && b > numeric_limits<size_t>::max() / a)
+         ? numeric_limits<size_t>::max() : a * b;
+}
+
+/// An upper bound on the number of nonzeros of an expression over the result
+/// index variables, computed from the number of components stored by the
+/// operands. Operands that are not indexed by every result variable are
+/// broadcast along the dimensions of the others.
+static size_t getNonzeroBound(const IndexExpr& expr,
+                              const map<IndexVar,size_t>& resultDimensions,
+                              const map<TensorVar,TensorBase>& operands,
+                              size_t resultSize) {
+  auto bound = [&](const IndexExpr& operand) {
+    return getNonzeroBound(operand, resultDimensions, operands, resultSize);
+  };
+
+  if (isa<Access>(expr)) {
+    Access access = to<Access>(expr);
+    if (!util::contains(operands, access.getTensorVar())) {
+      return resultSize;
+    }
+    const TensorBase& operand = operands.at(access.getTensorVar());
+    size_t nonzeros = operand.getStorage().getValues().getSize();
+    for (auto& resultDimension : resultDimensions) {
+      if (!util::contains(access.getIndexVars(), resultDimension.first)) {
+        nonzeros = saturatingMul(nonzeros, resultDimension.second);
+      }
+    }
+    return nonzeros;
+  } else if (isa<Add>(expr)) {
+    return saturatingAdd(bound(to<Add>(expr).getA()),
+                         bound(to<Add>(expr).getB()));
+  } else if (isa<Sub>(expr)) {
+    return saturatingAdd(bound(to<Sub>(expr).getA()),
+                         bound(to<Sub>(expr).getB()));
+  } else if (isa<Mul>(expr)) {
+    return std::min(bound(to<Mul>(expr).getA()), bound(to<Mul>(expr).getB()));
+  } else if (isa<Div>(expr)) {
+    return bound(to<Div>(expr).getA());
+  } else if (isa<Neg>(expr)) {
+    return bound(to<Neg>(expr).getA());
+  } else if (isa<Sqrt>(expr)) {
+    return bound(to<Sqrt>(expr).getA());
+  } else if (isa<Cast>(expr)) {
+    return bound(to<Cast>(expr).getA());
+  } else if (isa<Reduction>(expr)) {
+    return bound(to<Reduction>(expr).getExpr());
+  }
+  return resultSize;
+}
+
+size_t TensorBase::getResultCapacity() const {
+  const size_t maxCapacity = numeric_limits<int32_t>::max();
+  if (content->capacityHint > 0) {
+    return std::min(content->capacityHint, maxCapacity);
+  }
+
+  Assignment assignment = getAssignment();
+  const vector<IndexVar>& resultVars = assignment.getLhs().getIndexVars();
+  map<IndexVar,size_t> resultDimensions;
+  size_t resultSize = 1;
+  for (size_t i = 0; i < resultVars.size(); i++) {
+    resultDimensions[resultVars[i]] = getDimension(i);
+    resultSize = saturatingMul(resultSize, getDimension(i));
+  }
+
+  auto operands = getTensors(assignment.getRhs());
+  size_t capacity = std::min(getNonzeroBound(assignment.getRhs(),
+                                             resultDimensions, operands,
+                                             resultSize), resultSize);
+  if (assignment.getOperator().defined()) {
+    capacity = saturatingAdd(capacity, getStorage().getValues().getSize());
+  }
+
+  // Bounds larger than the operands are loose (e.g. of products that
+  // contract), so clamp them and let the arrays grow if needed
+  size_t operandsSize = 0;
+  for (auto& operand : operands) {
+    operandsSize = saturatingAdd(operandsSize,
+                                 operand.second.getStorage().getValues().getSize());
+  }
+  capacity = std::min(capacity, std::max(operandsSize, content->allocSize));
+  return std::min(capacity, maxCapacity);
+}
+
+size_t TensorBase::getEstimatedWork() const {
+  size_t work = 0;
+  for (auto& operand : getTensors(getAssignment().getRhs())) {
+    work = saturatingAdd(work,
+                         operand.second.getStorage().getValues().getSize());
+  }
+
+  // Kernels iterate over the dense modes of the result that precede its first
+  // compressed mode
+  size_t resultSize = 1;
+  for (int i = 0; i < getOrder(); i++) {
+    const int mode = getFormat().getModeOrdering()[i];
+    if (getFormat().getModeFormats()[i] != Dense) {
+      break;
+    }
+    resultSize = saturatingMul(resultSize, getDimension(mode));
+  }
+  return saturatingAdd(work, resultSize);
+}
+
+/// Pass the number of nonzeros to presize the result arrays for to a kernel.
+static void setResultCapacity(const vector<void*>& arguments, size_t capacity) {
+  ((taco_tensor_t*)arguments[0])->vals_size = (int32_t)capacity;
+}
+
+void TensorBase::freezeIndex() {
+  if (content->indexFrozen) {
+    return;
+  }
+  content->indexFrozen = true;
+
+  // The index has already been assembled if the tensor has been computed
+  const bool isAssembled = getAssignment().defined() && !needsAssemble();
+  if (content->assembleWhileCompute) {
+    content->assembleWhileCompute = false;
+    if (getAssignment().defined()) {
+      setNeedsCompile(true);
+    }
+  }
+  if (isAssembled) {
+    recordFrozenIndex();
+  }
+}
+
+void TensorBase::unfreezeIndex() {
+  content->indexFrozen = false;
+  content->frozenAssignment = Assignment();
+  content->frozenOperandIndices.clear();
+  content->frozenOperandIndicesHash = 0;
+}
+
+bool TensorBase::isIndexFrozen() const {
+  return content->indexFrozen;
+}
+
+/// The index arrays of the operands of an expression, in operand order.
+static vector<Array>
+getIndexArrays(const map<TensorVar,TensorBase>& operands) {
+  vector<Array> arrays;
+  for (auto& operand : operands) {
+    const Index& index = operand.second.getStorage().getIndex();
+    for (int i = 0; i < index.numModeIndices(); i++) {
+      const ModeIndex& modeIndex = index.getModeIndex(i);
+      for (int j = 0; j < modeIndex.numIndexArrays(); j++) {
+        arrays.push_back(modeIndex.getIndexArray(j));
+      }
+    }
+  }
+  return arrays;
+}
+
+static size_t getNumBytes(const Array& array) {
+  return array.getSize() * array.getType().getNumBytes();
+}
+
+/// FNV-1a hash of the contents of index arrays.
+static size_t hashIndexArrays(const vector<Array>& arrays) {
+  uint64_t hash = 14695981039346656037ull;
+  for (auto& array : arrays) {
+    const unsigned char* bytes = (const unsigned char*)array.getData();
+    const size_t numBytes = getNumBytes(array);
+    for (size_t i = 0; i < numBytes; i++) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    hash = (hash ^ numBytes) * 1099511628211ull;
+  }
+  return (size_t)hash;
+}
+
+void TensorBase::recordFrozenIndex() {
+  auto operands = getTensors(getAssignment().getRhs());
+  content->frozenAssignment = getAssignment();
+  content->frozenOperandIndices = getIndexArrays(operands);
+  content->frozenOperandIndicesHash =
+      hashIndexArrays(content->frozenOperandIndices);
+}
+
+bool TensorBase::isFrozenIndexValid() {
+  if (!content->frozenAssignment.defined() ||
+      !equals(content->frozenAssignment, getAssignment())) {
+    return false;
+  }
+
+  // The index arrays of packed tensors are immutable, so the frozen index is
+  // valid if the operands still have the same arrays. Arrays that the tensors
+  // own are held by the frozen index, so their memory cannot have been reused
+  // for other arrays. Otherwise the operands may have been repacked with the
+  // same structure, so compare the contents.
+  auto operands = getTensors(getAssignment().getRhs());
+  auto arrays = getIndexArrays(operands);
+  if (arrays.size() != content->frozenOperandIndices.size()) {
+    return false;
+  }
+  bool sameArrays = true;
+  for (size_t i = 0; i < arrays.size(); i++) {
+    const Array& frozenArray = content->frozenOperandIndices[i];
+    if (getNumBytes(arrays[i]) != getNumBytes(frozenArray)) {
+      return false;
+    }
+    sameArrays = sameArrays && arrays[i].getData() == frozenArray.getData() &&
+                 frozenArray.getPolicy() != Array::UserOwns;
+  }
+  if (sameArrays) {
+    return true;
+  }
+  if (hashIndexArrays(arrays) != content->frozenOperandIndicesHash) {
+    return false;
+  }
+  content->frozenOperandIndices = arrays;
+  return true;
+}
+
 void TensorBase::assemble() {
   taco_uassert(!needsCompile()) << error::assemble_without_compile;
   if (!needsAssemble()) {
@@ -723,13 +1373,29 @@ void TensorBase::assemble() {
     operand.second.syncValues();
   }
 
+  if (content->indexFrozen && !content->assembleWhileCompute) {
+    if (isFrozenIndexValid()) {
+      addToCounter(counters::frozenIndexReuses);
+      setNeedsAssemble(false);
+      return;
+    }
+    addToCounter(counters::frozenIndexRebuilds);
+  }
+
+  ScopedPhaseTimer timer("assemble", getName());
   auto arguments = packArguments(*this);
+  if (content->presizeResult) {
+    setResultCapacity(arguments, getResultCapacity());
+  }
   content->module->callFuncPacked("assemble", arguments.data());
 
   if (!content->assembleWhileCompute) {
     setNeedsAssemble(false);
     taco_tensor_t* tensorData = ((taco_tensor_t*)arguments[0]);
     content->valuesSize = unpackTensorData(*tensorData, *this);
+    if (content->indexFrozen) {
+      recordFrozenIndex();
+    }
   }
 }
 
@@ -746,7 +1412,11 @@ void TensorBase::compute() {
     operand.second.removeDependentTensor(*this);
   }
 
+  ScopedPhaseTimer timer("compute", getName());
   auto arguments = packArguments(*this);
+  if (content->presizeResult && content->assembleWhileCompute) {
+    setResultCapacity(arguments, getResultCapacity());
+  }
   this->content->module->callFuncPacked("compute", arguments.data());
 
   if (content->assembleWhileCompute) {
@@ -764,6 +1434,103 @@ void TensorBase::evaluate() {
   this->compute();
 }
 
+BoundKernel TensorBase::bindKernel() {
+  compile();
+  if (!content->assembleWhileCompute) {
+    assemble();
+  }
+  return BoundKernel(*this);
+}
+
+BoundKernel::BoundKernel() : function(nullptr), assembleWhileCompute(false),
+                             resultCapacity(0),
+                             schedule(ParallelSchedule::Static), chunkSize(0),
+                             numThreads(1),
+                             placement(ThreadPlacement::Default) {
+}
+
+BoundKernel::BoundKernel(TensorBase result)
+    : result(result), module(result.content->module),
+      assembleWhileCompute(result.content->assembleWhileCompute),
+      resultCapacity(0), numThreads(taco_get_num_threads()),
+      placement(taco_get_thread_placement()) {
+  taco_uassert(module != nullptr) << error::compute_without_compile;
+  static_assert(sizeof(void*) == sizeof(KernelFunction),
+    "Unable to cast dlsym() returned void pointer to function pointer");
+  void* funcPtr = module->getFuncPtr("_shim_compute");
+  taco_iassert(funcPtr != nullptr);
+  *reinterpret_cast<void**>(&function) = funcPtr;
+
+  // Bind the storage of the result and operands in the order that
+  // `packArguments` passes them to the kernel
+  boundTensors.push_back(result);
+  auto operands = getArguments(makeConcreteNotation(result.getAssignment()));
+  auto tensors = getTensors(result.getAssignment().getRhs());
+  for (auto& operand : operands) {
+    taco_iassert(util::contains(tensors, operand));
+    TensorBase& tensor = tensors.at(operand);
+    tensor.syncValues();
+    operandArguments.insert({tensor, boundTensors.size()});
+    boundTensors.push_back(tensor);
+  }
+  refresh();
+  taco_get_parallel_schedule(&schedule, &chunkSize);
+}
+
+void BoundKernel::operator()() {
+  taco_uassert(defined()) << "Cannot call an undefined bound kernel";
+#if USE_OPENMP
+  if (configuredThread != std::this_thread::get_id()) {
+    setParallelExecution(schedule, chunkSize, numThreads, placement);
+    configuredThread = std::this_thread::get_id();
+  }
+#endif
+  if (assembleWhileCompute && result.content->presizeResult) {
+    setResultCapacity(arguments, resultCapacity);
+  }
+  function(arguments.data());
+  if (assembleWhileCompute) {
+    TensorBase::Content* content = result.content.get();
+    content->valuesSize = unpackTensorData(*((taco_tensor_t*)arguments[0]),
+                                           result);
+    content->needsAssemble = false;
+  }
+  result.content->needsCompute = false;
+}
+
+void BoundKernel::bind(const TensorBase& operand, const TensorBase& tensor) {
+  taco_uassert(defined()) << "Cannot bind operands of an undefined kernel";
+  taco_uassert(util::contains(operandArguments, operand))
+      << operand.getName() << " is not an operand of " << result.getName();
+  taco_uassert(operand.getComponentType() == tensor.getComponentType() &&
+               operand.getFormat() == tensor.getFormat() &&
+               operand.getDimensions() == tensor.getDimensions())
+      << "Cannot bind " << tensor.getName() << " in place of "
+      << operand.getName() << ", as their types, formats or dimensions differ";
+
+  const size_t argument = operandArguments.at(operand);
+  boundTensors[argument] = tensor;
+  boundTensors[argument].syncValues();
+  arguments[argument] = boundTensors[argument].getStorage();
+}
+
+void BoundKernel::refresh() {
+  arguments.clear();
+  for (auto& tensor : boundTensors) {
+    arguments.push_back(tensor.getStorage());
+  }
+  resultCapacity = result.content->presizeResult ? result.getResultCapacity()
+                                                 : 0;
+}
+
+const TensorBase& BoundKernel::getResult() const {
+  return result;
+}
+
+bool BoundKernel::defined() const {
+  return function != nullptr;
+}
+
 void TensorBase::operator=(const IndexExpr& expr) {
   taco_uassert(getOrder() == 0)
       << "Must use index variable on the left-hand-side when assigning an "
@@ -836,27 +1603,12 @@ void TensorBase::compileSource(std::string source) {
   setNeedsCompile(false);
 }
 
-TensorBase::HelperFuncsCache TensorBase::helperFunctions;
-std::mutex TensorBase::helperFunctionsMutex;
-
-std::shared_ptr<ir::Module>
-TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
-                               const std::vector<int>& dimensions) {
-  helperFunctionsMutex.lock();
-  const auto helperFunctionsReverse =
-      util::ReverseConstIterable<TensorBase::HelperFuncsCache>(helperFunctions);
-  for (const auto& helperFuncs : helperFunctionsReverse) {
-    if (std::get<0>(helperFuncs) == format &&
-        std::get<1>(helperFuncs) == ctype &&
-        std::get<2>(helperFuncs) == dimensions) {
-      // If helper functions had already been generated for specified tensor
-      // format and type, then use cached version.
-      const auto helperFuncsModule = std::get<3>(helperFuncs);
-      helperFunctionsMutex.unlock();
-      return helperFuncsModule;
-    }
-  }
-  helperFunctionsMutex.unlock();
+/// Lower and compile the pack and iterate functions of tensors with the given
+/// format, component type and dimensions.
+static std::shared_ptr<Module>
+compileHelperFunctions(const Format& format, Datatype ctype,
+                       const std::vector<int>& dimensions) {
+  ScopedPhaseTimer timer("helpers", util::toString(format));
 
   std::shared_ptr<Module> helperModule = std::make_shared<Module>();
 
@@ -902,11 +1654,64 @@ TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
     helperModule->addFunction(lower(iterateStmt, "iterate", false, true));
   }
   helperModule->compile();
+  return helperModule;
+}
 
-  helperFunctionsMutex.lock();
-  helperFunctions.emplace_back(format, ctype, dimensions, helperModule);
-  helperFunctionsMutex.unlock();
+TensorBase::HelperFuncsCache TensorBase::helperFunctions;
+std::mutex TensorBase::helperFunctionsMutex;
 
+std::shared_ptr<ir::Module>
+TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
+                               const std::vector<int>& dimensions) {
+  std::promise<std::shared_ptr<Module>> compiled;
+  ModuleFuture cached;
+  {
+    std::lock_guard<std::mutex> lock(helperFunctionsMutex);
+    const auto helperFunctionsReverse =
+        util::ReverseConstIterable<TensorBase::HelperFuncsCache>(
+            helperFunctions);
+    for (const auto& helperFuncs : helperFunctionsReverse) {
+      if (std::get<0>(helperFuncs) == format &&
+          std::get<1>(helperFuncs) == ctype &&
+          std::get<2>(helperFuncs) == dimensions) {
+        // If helper functions had already been generated (or are being
+        // generated by another thread) for specified tensor format and type,
+        // then use cached version.
+        cached = std::get<3>(helperFuncs);
+        break;
+      }
+    }
+    if (!cached.valid()) {
+      helperFunctions.emplace_back(format, ctype, dimensions,
+                                   compiled.get_future().share());
+    }
+  }
+  if (cached.valid()) {
+    addToCounter(counters::helperCacheHits);
+    return cached.get();
+  }
+  addToCounter(counters::helperCacheMisses);
+
+  std::shared_ptr<Module> helperModule;
+  try {
+    helperModule = compileHelperFunctions(format, ctype, dimensions);
+  } catch (...) {
+    // Let later calls retry
+    {
+      std::lock_guard<std::mutex> lock(helperFunctionsMutex);
+      helperFunctions.erase(
+          std::remove_if(helperFunctions.begin(), helperFunctions.end(),
+                         [&](const HelperFuncsCache::value_type& helperFuncs) {
+                           return std::get<0>(helperFuncs) == format &&
+                                  std::get<1>(helperFuncs) == ctype &&
+                                  std::get<2>(helperFuncs) == dimensions;
+                         }),
+          helperFunctions.end());
+    }
+    compiled.set_exception(std::current_exception());
+    throw;
+  }
+  compiled.set_value(helperModule);
   return helperModule;
 }
 
@@ -1024,6 +1829,8 @@ bool equals(const TensorBase& a, const TensorBase& b) {
     case Datatype::Int32: return equalsTyped<int32_t>(a, b);
     case Datatype::Int64: return equalsTyped<int64_t>(a, b);
     case Datatype::Int128: return equalsTyped<long long>(a, b);
+    case Datatype::Float16: return equalsTyped<float16>(a, b);
+    case Datatype::BFloat16: return equalsTyped<bfloat16>(a, b);
     case Datatype::Float32: return equalsTyped<float>(a, b);
     case Datatype::Float64: return equalsTyped<double>(a, b);
     case Datatype::Complex64: return equalsTyped<std::complex<float>>(a, b);
@@ -1083,6 +1890,8 @@ ostream& operator<<(ostream& os, const TensorBase& tensor) {
       case Datatype::Int32: os << ((int32_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int64: os << ((int64_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int128: os << ((long long*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::Float16: os << ((float16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::BFloat16: os << ((bfloat16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float32: os << ((float*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float64: os << ((double*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Complex64: os << ((std::complex<float>*)(ptr+tensor.getOrder()))[0] << std::endl; break;
@@ -1123,6 +1932,8 @@ ostream& operator<<(ostream& os, TensorBase& tensor) {
       case Datatype::Int32: os << ((int32_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int64: os << ((int64_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int128: os << ((long long*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::Float16: os << ((float16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::BFloat16: os << ((bfloat16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float32: os << ((float*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float64: os << ((double*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Complex64: os << ((std::complex<float>*)(ptr+tensor.getOrder()))[0] << std::endl; break;
@@ -1273,6 +2084,14 @@ void packOperands(const TensorBase& tensor) {
 static ParallelSchedule taco_parallel_sched = ParallelSchedule::Static;
 static int taco_chunk_size = 0;
 static int taco_num_threads = 1;
+static ThreadPlacement taco_thread_placement = ThreadPlacement::Default;
+static bool taco_numa_first_touch = false;
+static bool taco_kernel_fusion = false;
+static bool taco_background_compile = false;
+static Datatype taco_accumulator_type;
+static size_t taco_interpreter_threshold =
+    std::strtoull(util::getFromEnv("TACO_INTERPRETER_THRESHOLD", "0").c_str(),
+                  nullptr, 10);
 
 void taco_set_parallel_schedule(ParallelSchedule sched, int chunk_size) {
   taco_parallel_sched = sched;
@@ -1290,8 +2109,74 @@ void taco_set_num_threads(int num_threads) {
   }
 }
 
+void taco_set_num_threads(int num_threads, ThreadPlacement placement) {
+  taco_set_num_threads(num_threads);
+  taco_set_thread_placement(placement);
+}
+
 int taco_get_num_threads() {
   return taco_num_threads;
 }
 
+void taco_set_thread_placement(ThreadPlacement placement) {
+  taco_thread_placement = placement;
+}
+
+ThreadPlacement taco_get_thread_placement() {
+  return taco_thread_placement;
+}
+
+void taco_set_numa_first_touch(bool enabled) {
+  taco_numa_first_touch = enabled;
+}
+
+bool taco_get_numa_first_touch() {
+  return taco_numa_first_touch;
+}
+
+void taco_set_kernel_fusion(bool enabled) {
+  taco_kernel_fusion = enabled;
+}
+
+bool taco_get_kernel_fusion() {
+  return taco_kernel_fusion;
+}
+
+void taco_set_max_compile_threads(int num_threads) {
+  taco_uassert(num_threads > 0) << "The number of compile threads must be "
+                                << "positive";
+  ir::CompilePool::getDefault().setMaxWorkers(num_threads);
+}
+
+int taco_get_max_compile_threads() {
+  return ir::CompilePool::getDefault().getMaxWorkers();
+}
+
+void taco_set_background_compile(bool enabled) {
+  taco_background_compile = enabled;
+}
+
+bool taco_get_background_compile() {
+  return taco_background_compile;
+}
+
+void taco_set_interpreter_threshold(size_t work) {
+  taco_interpreter_threshold = work;
+}
+
+size_t taco_get_interpreter_threshold() {
+  return taco_interpreter_threshold;
+}
+
+void taco_set_accumulator_type(Datatype type) {
+  taco_uassert(type.getKind() == Datatype::Undefined ||
+               ((type.isFloat() || type.isInt()) && type.getNumBits() >= 32))
+      << "Values cannot be accumulated in " << type;
+  taco_accumulator_type = type;
+}
+
+Datatype taco_get_accumulator_type() {
+  return taco_accumulator_type;
+}
+
 }
@@ -38,7 +38,8 @@ bool Datatype::isInt() const {
 }
 
 bool Datatype::isFloat() const {
-  return getKind() == Float32 || getKind() == Float64;
+  return getKind() == Float16 || getKind() == BFloat16 ||
+         getKind() == Float32 || getKind() == Float64;
 }
 
 bool Datatype::isComplex() const {
@@ -90,6 +91,8 @@ int Datatype::getNumBits() const {
       return 8;
     case UInt16:
     case Int16:
+    case Float16:
+    case BFloat16:
       return 16;
     case UInt32:
     case Int32:
@@ -114,6 +117,8 @@ std::ostream& operator<<(std::ostream& os, const Datatype& type) {
   if (type.isBool()) os << "bool";
   else if (type.isInt()) os << "int" << type.getNumBits() << "_t";
   else if (type.isUInt()) os << "uint" << type.getNumBits() << "_t";
+  else if (type == Datatype::Float16) os << "float16";
+  else if (type == Datatype::BFloat16) os << "bfloat16";
   else if (type == Datatype::Float32) os << "float";
   else if (type == Datatype::Float64) os << "double";
   else if (type == Datatype::Complex64) os << "float complex";
@@ -135,6 +140,8 @@ std::ostream& operator<<(std::ostream& os, const Datatype::Kind& kind) {
     case Datatype::Int32: os << "Int32"; break;
     case Datatype::Int64: os << "Int64"; break;
     case Datatype::Int128: os << "Int128"; break;
+    case Datatype::Float16: os << "Float16"; break;
+    case Datatype::BFloat16: os << "BFloat16"; break;
     case Datatype::Float32: os << "Float32"; break;
     case Datatype::Float64: os << "Float64"; break;
     case Datatype::Complex64: os << "Complex64"; break;
@@ -194,6 +201,7 @@ Datatype Int128 = Datatype(Datatype::UInt128);
   
 Datatype Float(int bits) {
   switch (bits) {
+    case 16: return Datatype(Datatype::Float16);
     case 32: return Datatype(Datatype::Float32);
     case 64: return Datatype(Datatype::Float64);
     default: 
@@ -202,6 +210,8 @@ Datatype Float(int bits) {
   }
 }
 
+Datatype Float16 = Datatype(Datatype::Float16);
+Datatype BFloat16 = Datatype(Datatype::BFloat16);
 Datatype Float32 = Datatype(Datatype::Float32);
 Datatype Float64 = Datatype(Datatype::Float64);
 
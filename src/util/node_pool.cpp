@@ -0,0 +1,164 @@
+#include "taco/util/node_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace taco {
+namespace util {
+
+namespace {
+
+// Blocks are multiples of 16 bytes, up to 256 bytes
+const size_t BlockAlignment = 16;
+const size_t NumSizeClasses = 16;
+const size_t MaxBlockSize = BlockAlignment * NumSizeClasses;
+const size_t ChunkSize = 64 * 1024;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+/// Blocks freed by threads that have exited, and by any thread after its own
+/// pool is released.  Blocks are never returned to the system, since nodes
+/// allocated by one thread may be freed by another.
+struct SharedPool {
+  std::mutex mutex;
+  FreeBlock* freeLists[NumSizeClasses] = {};
+
+  // Lets threads skip the lock when there are no shared blocks
+  std::atomic<size_t> numBlocks{0};
+};
+
+SharedPool& getSharedPool() {
+  // Never destroyed, since nodes in static objects may be freed after it
+  static SharedPool* pool = new SharedPool;
+  return *pool;
+}
+
+std::atomic<size_t> chunkBytes(0);
+
+// The pool of each thread is trivially destructible, so that destructors that
+// free nodes after it is released can still check whether it is
+thread_local FreeBlock* freeLists[NumSizeClasses] = {};
+thread_local char* chunkNext = nullptr;
+thread_local char* chunkEnd = nullptr;
+thread_local bool released = false;
+thread_local long liveNodes = 0;
+
+/// Hands the free blocks of a thread to the shared pool when it exits.
+struct PoolReleaser {
+  void use() {}
+
+  ~PoolReleaser() {
+    SharedPool& shared = getSharedPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (size_t c = 0; c < NumSizeClasses; c++) {
+      while (freeLists[c] != nullptr) {
+        FreeBlock* block = freeLists[c];
+        freeLists[c] = block->next;
+        block->next = shared.freeLists[c];
+        shared.freeLists[c] = block;
+        shared.numBlocks++;
+      }
+    }
+    released = true;
+  }
+};
+
+thread_local PoolReleaser releaser;
+
+size_t getSizeClass(size_t size) {
+  return (size + BlockAlignment - 1) / BlockAlignment - 1;
+}
+
+void* allocateBlock(size_t sizeClass) {
+  const size_t blockSize = (sizeClass + 1) * BlockAlignment;
+  SharedPool& shared = getSharedPool();
+
+  if (released) {
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    FreeBlock* block = shared.freeLists[sizeClass];
+    if (block != nullptr) {
+      shared.freeLists[sizeClass] = block->next;
+      shared.numBlocks--;
+      return block;
+    }
+    return ::operator new(blockSize);
+  }
+
+  // Take the blocks that exited threads freed before carving new ones
+  if (shared.numBlocks > 0) {
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    FreeBlock* blocks = shared.freeLists[sizeClass];
+    if (blocks != nullptr) {
+      shared.freeLists[sizeClass] = nullptr;
+      for (FreeBlock* block = blocks; block != nullptr; block = block->next) {
+        shared.numBlocks--;
+      }
+      freeLists[sizeClass] = blocks->next;
+      return blocks;
+    }
+  }
+
+  if (chunkNext == nullptr || (size_t)(chunkEnd - chunkNext) < blockSize) {
+    chunkNext = static_cast<char*>(::operator new(ChunkSize));
+    chunkEnd = chunkNext + ChunkSize;
+    chunkBytes += ChunkSize;
+  }
+  void* block = chunkNext;
+  chunkNext += blockSize;
+  return block;
+}
+
+}
+
+void* allocateNode(size_t size) {
+  if (size > MaxBlockSize) {
+    return ::operator new(size);
+  }
+  const size_t sizeClass = getSizeClass(size);
+  liveNodes++;
+  if (released) {
+    return allocateBlock(sizeClass);
+  }
+  // Any block this thread holds, whether carved, taken from the shared pool or
+  // freed here, must be handed back when it exits
+  releaser.use();
+  FreeBlock* block = freeLists[sizeClass];
+  if (block != nullptr) {
+    freeLists[sizeClass] = block->next;
+    return block;
+  }
+  return allocateBlock(sizeClass);
+}
+
+void freeNode(void* node, size_t size) {
+  if (node == nullptr) {
+    return;
+  }
+  if (size > MaxBlockSize) {
+    ::operator delete(node);
+    return;
+  }
+  const size_t sizeClass = getSizeClass(size);
+  liveNodes--;
+  FreeBlock* block = static_cast<FreeBlock*>(node);
+  if (released) {
+    SharedPool& shared = getSharedPool();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    block->next = shared.freeLists[sizeClass];
+    shared.freeLists[sizeClass] = block;
+    shared.numBlocks++;
+    return;
+  }
+  releaser.use();
+  block->next = freeLists[sizeClass];
+  freeLists[sizeClass] = block;
+}
+
+NodePoolStatistics getNodePoolStatistics() {
+  return {liveNodes, chunkBytes};
+}
+
+}}
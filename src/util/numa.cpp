@@ -0,0 +1,188 @@
+#include "taco/util/numa.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace taco {
+namespace util {
+
+/// Parse a Linux CPU list such as "0-3,8,10-11".
+static vector<int> parseCpuList(const string& list) {
+  vector<int> cpus;
+  stringstream ranges(list);
+  string range;
+  while (getline(ranges, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    const int first = stoi(range.substr(0, dash));
+    const int last = (dash == string::npos) ? first
+                                            : stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/// The CPUs that the process may run on. They are read once, before taco pins
+/// any thread, so that pinned threads do not narrow them down.
+static const vector<int>& getAllowedCpus() {
+  static const vector<int> allowed = [] {
+    vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+#endif
+    return cpus;
+  }();
+  return allowed;
+}
+
+/// Restrict the calling thread to a set of CPUs.
+static bool setThreadCpus(const vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return !cpus.empty() && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+vector<vector<int>> getNumaNodeCpus() {
+  const vector<int>& allowed = getAllowedCpus();
+  vector<bool> isAllowed;
+  for (int cpu : allowed) {
+    if ((size_t)cpu >= isAllowed.size()) {
+      isAllowed.resize(cpu + 1, false);
+    }
+    isAllowed[cpu] = true;
+  }
+
+  vector<vector<int>> nodes;
+  for (int node = 0; ; node++) {
+    ifstream cpulist("/sys/devices/system/node/node" + to_string(node) +
+                     "/cpulist");
+    if (!cpulist) {
+      break;
+    }
+    string list;
+    getline(cpulist, list);
+
+    vector<int> cpus;
+    for (int cpu : parseCpuList(list)) {
+      if ((size_t)cpu < isAllowed.size() && isAllowed[cpu]) {
+        cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty()) {
+      nodes.push_back(cpus);
+    }
+  }
+
+  if (nodes.empty() && !allowed.empty()) {
+    nodes.push_back(allowed);
+  }
+  return nodes;
+}
+
+int getPlacementCpu(const vector<vector<int>>& nodeCpus, int thread,
+                    bool spread) {
+  size_t numCpus = 0;
+  for (auto& cpus : nodeCpus) {
+    numCpus += cpus.size();
+  }
+  if (numCpus == 0) {
+    return -1;
+  }
+  size_t slot = (size_t)thread % numCpus;
+
+  if (!spread) {
+    for (auto& cpus : nodeCpus) {
+      if (slot < cpus.size()) {
+        return cpus[slot];
+      }
+      slot -= cpus.size();
+    }
+  }
+
+  // Deal slots round-robin across the nodes that still have free CPUs
+  for (size_t round = 0; ; round++) {
+    for (auto& cpus : nodeCpus) {
+      if (round < cpus.size()) {
+        if (slot == 0) {
+          return cpus[round];
+        }
+        slot--;
+      }
+    }
+  }
+}
+
+bool pinThread(int cpu) {
+  return setThreadCpus({cpu});
+}
+
+void placeOpenMPThreads(int numThreads, bool pin, bool spread) {
+#if USE_OPENMP
+  // Each thread that starts parallel regions gets its own team of OpenMP
+  // threads, so the placement is tracked per calling thread. Threads start
+  // out unpinned.
+  thread_local tuple<int,bool,bool> placement{0, false, false};
+
+  if (!pin && !get<1>(placement)) {
+    return;
+  }
+  if (placement == make_tuple(numThreads, pin, spread)) {
+    return;
+  }
+  // Unpin every thread that may have been pinned before
+  const int regionThreads = pin ? numThreads
+                                : std::max(numThreads, get<0>(placement));
+  placement = make_tuple(numThreads, pin, spread);
+
+  const vector<vector<int>> nodeCpus = getNumaNodeCpus();
+  #pragma omp parallel num_threads(regionThreads)
+  {
+    // The calling thread belongs to the user, so only the workers are placed
+    const int thread = omp_get_thread_num();
+    if (thread != 0) {
+      if (pin) {
+        pinThread(getPlacementCpu(nodeCpus, thread, spread));
+      } else {
+        setThreadCpus(getAllowedCpus());
+      }
+    }
+  }
+#endif
+}
+
+}}
@@ -0,0 +1,221 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "taco/tensor.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/transformations.h"
+#include "taco/storage/allocator.h"
+#include "taco/ir/ir.h"
+#include "taco/util/node_pool.h"
+
+using namespace taco;
+
+namespace allocator_tests {
+
+/// Restores the default allocators when going out of scope.
+class AllocatorScope {
+public:
+  ~AllocatorScope() {
+    resetTemporaryAllocator();
+    setAllocator(mallocAllocator());
+  }
+};
+
+/// Counts the allocations and frees of an aligned allocator.
+struct Counts {
+  int allocs = 0;
+  int reallocs = 0;
+  int frees = 0;
+};
+
+static void* countingAlloc(void* context, size_t size, size_t alignment) {
+  static_cast<Counts*>(context)->allocs++;
+  return alignedAllocator().alloc(nullptr, size, alignment);
+}
+
+static void* countingRealloc(void* context, void* ptr, size_t size,
+                             size_t alignment) {
+  static_cast<Counts*>(context)->reallocs++;
+  return alignedAllocator().realloc(nullptr, ptr, size, alignment);
+}
+
+static void countingFree(void* context, void* ptr) {
+  static_cast<Counts*>(context)->frees++;
+  alignedAllocator().free(nullptr, ptr);
+}
+
+static taco_allocator_t countingAllocator(Counts* counts) {
+  taco_allocator_t allocator = alignedAllocator();
+  allocator.alloc   = countingAlloc;
+  allocator.realloc = countingRealloc;
+  allocator.free    = countingFree;
+  allocator.context = counts;
+  return allocator;
+}
+
+static bool isAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+static Tensor<double> sparseAdd(const std::string& name) {
+  Tensor<double> B(name + "B", {4,4}, CSR);
+  Tensor<double> C(name + "C", {4,4}, CSR);
+  B.insert({0,1}, 1.0);
+  B.insert({2,3}, 2.0);
+  C.insert({0,1}, 3.0);
+  C.insert({3,0}, 4.0);
+  B.pack();
+  C.pack();
+
+  IndexVar i("i"), j("j");
+  Tensor<double> A(name + "A", {4,4}, CSR);
+  A(i,j) = B(i,j) + C(i,j);
+  return A;
+}
+
+TEST(allocator, aligned) {
+  AllocatorScope scope;
+  setAllocator(alignedAllocator(128));
+  ASSERT_TRUE(alignedAllocator(128) == getTemporaryAllocator());
+
+  Array array = makeArray(Float64, 10);
+  ASSERT_TRUE(isAligned(array.getData(), 128));
+
+  Tensor<double> A = sparseAdd("aligned");
+  A.evaluate();
+
+  ASSERT_TRUE(isAligned(A.getStorage().getValues().getData(), 128));
+  auto index = A.getStorage().getIndex().getModeIndex(1);
+  ASSERT_TRUE(isAligned(index.getIndexArray(0).getData(), 128));
+  ASSERT_TRUE(isAligned(index.getIndexArray(1).getData(), 128));
+
+  ASSERT_EQ(3u, A.getStorage().getValues().getSize());
+  ASSERT_EQ(4.0, A.at({0,1}));
+  ASSERT_EQ(4.0, A.at({3,0}));
+}
+
+TEST(allocator, counting) {
+  AllocatorScope scope;
+  Counts counts;
+  setAllocator(countingAllocator(&counts));
+  {
+    Tensor<double> A = sparseAdd("counting");
+    A.evaluate();
+    ASSERT_LE(3, counts.allocs);
+  }
+
+  // Arrays are freed with the allocator they were allocated with
+  const int frees = counts.frees;
+  {
+    Array array = makeArray(Float64, 10);
+    setAllocator(mallocAllocator());
+  }
+  ASSERT_EQ(frees + 1, counts.frees);
+}
+
+TEST(allocator, huge_pages) {
+  taco_allocator_t allocator = hugePageAllocator();
+  const size_t size = (3 << 20) + 100;
+  char* a = static_cast<char*>(allocator.alloc(allocator.context, size, 64));
+  ASSERT_TRUE(isAligned(a, 64));
+  a[0] = 1;
+  a[size - 1] = 2;
+
+  char* b = static_cast<char*>(allocator.realloc(allocator.context, a,
+                                                 2 * size, 64));
+  ASSERT_TRUE(isAligned(b, 64));
+  ASSERT_EQ(1, b[0]);
+  ASSERT_EQ(2, b[size - 1]);
+  allocator.free(allocator.context, b);
+}
+
+TEST(allocator, bump_arena) {
+  BumpArena arena(1024);
+  taco_allocator_t allocator = arena.getAllocator();
+
+  void* a = allocator.alloc(allocator.context, 100, 64);
+  ASSERT_TRUE(isAligned(a, 64));
+  ASSERT_EQ(100u, arena.getBytesAllocated());
+
+  // The last allocation grows in place
+  ASSERT_EQ(a, allocator.realloc(allocator.context, a, 200, 64));
+  ASSERT_EQ(200u, arena.getBytesAllocated());
+
+  void* b = allocator.alloc(allocator.context, 10, 64);
+  ASSERT_TRUE(isAligned(b, 64));
+  static_cast<char*>(a)[0] = 42;
+  void* c = allocator.realloc(allocator.context, a, 4096, 64);
+  ASSERT_NE(a, c);
+  ASSERT_EQ(42, static_cast<char*>(c)[0]);
+  allocator.free(allocator.context, c);
+
+  arena.reset();
+  ASSERT_EQ(0u, arena.getBytesAllocated());
+}
+
+TEST(allocator, temporary_arena) {
+  AllocatorScope scope;
+  BumpArena arena;
+  setTemporaryAllocator(arena.getAllocator());
+  ASSERT_TRUE(mallocAllocator() == getAllocator());
+
+  Tensor<double> A("A", {16}, Format{Dense});
+  Tensor<double> B("B", {16}, Format{Dense});
+  Tensor<double> C("C", {16}, Format{Dense});
+  for (int i = 0; i < 16; i++) {
+    B.insert({i}, (double) i);
+    C.insert({i}, 2.0);
+  }
+  B.pack();
+  C.pack();
+
+  IndexVar i("i"), i_bounded("i_bounded"), i0("i0"), i1("i1");
+  IndexExpr precomputedExpr = B(i) * C(i);
+  A(i) = precomputedExpr;
+
+  IndexStmt stmt = A.getAssignment().concretize();
+  TensorVar precomputed("precomputed", Type(Float64, {Dimension(i1)}),
+                        taco::dense);
+  stmt = stmt.bound(i, i_bounded, 16, BoundType::MaxExact)
+             .split(i_bounded, i0, i1, 4)
+             .precompute(precomputedExpr, i1, i1, precomputed);
+  A.compile(stmt);
+  A.assemble();
+  A.compute();
+
+  ASSERT_LT(0u, arena.getBytesAllocated());
+  for (int i = 0; i < 16; i++) {
+    ASSERT_EQ(2.0 * i, A.at({i}));
+  }
+  arena.reset();
+}
+
+
+TEST(allocator, node_pool) {
+  const long liveNodes = util::getNodePoolStatistics().liveNodes;
+  const ir::IRNode* freed;
+  {
+    ir::Expr var = ir::Var::make("x", Int32);
+    freed = var.ptr;
+    ASSERT_EQ(liveNodes + 1, util::getNodePoolStatistics().liveNodes);
+  }
+  ASSERT_EQ(liveNodes, util::getNodePoolStatistics().liveNodes);
+
+  // The block of the freed node is reused for the next node of its size
+  ir::Expr var = ir::Var::make("y", Int32);
+  ASSERT_EQ(freed, var.ptr);
+}
+
+TEST(allocator, interned_literals) {
+  ASSERT_EQ(ir::Literal::make(1).ptr, ir::Literal::make(1).ptr);
+  ASSERT_EQ(ir::Literal::make(true).ptr, ir::Literal::make(true).ptr);
+  ASSERT_NE(ir::Literal::make(1).ptr, ir::Literal::make((int64_t)1).ptr);
+  ASSERT_NE(ir::Literal::make(1000).ptr, ir::Literal::make(1000).ptr);
+  ASSERT_NE(ir::Literal::make(1.0).ptr, ir::Literal::make(1.0).ptr);
+  ASSERT_EQ(1, ir::Literal::make(1).as<ir::Literal>()->getIntValue());
+}
+
+}
@@ -0,0 +1,103 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <atomic>
+#include <thread>
+
+#include "taco/tensor.h"
+#include "taco/instrumentation.h"
+#include "taco/index_notation/index_notation.h"
+#include "codegen/compile_pool.h"
+
+using namespace taco;
+
+namespace compile_tests {
+
+TEST(compile, pool_bounds_jobs) {
+  ir::CompilePool pool(2);
+  ASSERT_EQ(2, pool.getMaxWorkers());
+
+  std::atomic<int> running(0);
+  std::atomic<int> maxRunning(0);
+  std::vector<std::future<void>> jobs;
+  for (int i = 0; i < 8; i++) {
+    jobs.push_back(pool.submit([&] {
+      int now = ++running;
+      int seen = maxRunning.load();
+      while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {}
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      running--;
+    }));
+  }
+  for (auto& job : jobs) {
+    job.get();
+  }
+  ASSERT_LE(1, maxRunning.load());
+  ASSERT_GE(2, maxRunning.load());
+
+  // Exceptions are rethrown by the futures of the jobs that threw them
+  pool.setMaxWorkers(1);
+  std::future<void> failed = pool.submit([] {
+    throw TacoException("failed");
+  });
+  ASSERT_THROW(failed.get(), TacoException);
+  int ran = 0;
+  pool.submit([&] { ran++; }).get();
+  ASSERT_EQ(1, ran);
+}
+
+TEST(compile, max_compile_threads) {
+  const int threads = taco_get_max_compile_threads();
+  ASSERT_LE(1, threads);
+  taco_set_max_compile_threads(3);
+  ASSERT_EQ(3, taco_get_max_compile_threads());
+  taco_set_max_compile_threads(threads);
+  ASSERT_THROW(taco_set_max_compile_threads(0), TacoException);
+}
+
+TEST(compile, single_flight) {
+  resetInstrumentation();
+  setInstrumentationEnabled(true);
+
+  // Threads that evaluate the same new expression at the same time compile
+  // its pack functions and its kernel once
+  const Format format({Sparse, Dense, Sparse});
+  const int numThreads = 8;
+  std::vector<double> results(numThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t] {
+      Tensor<double> B("B", {3, 5, 7}, format);
+      Tensor<double> c("c", {7}, Format{Dense});
+      Tensor<double> a("a", {3, 5}, Format({Dense, Dense}));
+      B.insert({1, 2, 3}, (double)t);
+      B.insert({2, 4, 6}, 2.0);
+      c.insert({3}, 3.0);
+      c.insert({6}, 1.0);
+      B.pack();
+      c.pack();
+      IndexVar i("i"), j("j"), k("k");
+      a(i,j) = B(i,j,k) * c(k);
+      a.evaluate();
+      results[t] = a.at({1, 2}) + a.at({2, 4});
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::map<std::string,int64_t> counters = getCounters();
+  setInstrumentationEnabled(false);
+  resetInstrumentation();
+
+  for (int t = 0; t < numThreads; t++) {
+    ASSERT_DOUBLE_EQ(3.0 * t + 2.0, results[t]);
+  }
+  ASSERT_EQ(1, counters[counters::kernelCacheMisses]);
+  ASSERT_EQ(numThreads - 1, counters[counters::kernelCacheHits]);
+  // The helper functions of the dense vectors may have been cached by earlier
+  // tests, but those of B cannot have been
+  ASSERT_LE(1, counters[counters::helperCacheMisses]);
+  ASSERT_GE(3, counters[counters::helperCacheMisses]);
+}
+
+}
@@ -0,0 +1,180 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include "taco/tensor.h"
+#include "taco/storage/convert.h"
+
+using namespace taco;
+
+namespace convert_tests {
+
+static const Format CSF3({Sparse, Sparse, Sparse});
+
+static std::vector<int> getArray(const Tensor<double>& tensor, int level,
+                                 int array) {
+  const Array& indexArray =
+      tensor.getStorage().getIndex().getModeIndex(level).getIndexArray(array);
+  const int* data = (const int*)indexArray.getData();
+  return std::vector<int>(data, data + indexArray.getSize());
+}
+
+static std::vector<double> getValues(const Tensor<double>& tensor) {
+  const Array& values = tensor.getStorage().getValues();
+  const double* data = (const double*)values.getData();
+  return std::vector<double>(data, data + values.getSize());
+}
+
+static Tensor<double> makeMatrix(Format format) {
+  // [1 0 2 0]
+  // [0 0 0 0]
+  // [3 4 0 5]
+  Tensor<double> B("B", {3, 4}, format);
+  B.insert({0, 0}, 1.0);
+  B.insert({0, 2}, 2.0);
+  B.insert({2, 0}, 3.0);
+  B.insert({2, 1}, 4.0);
+  B.insert({2, 3}, 5.0);
+  B.pack();
+  return B;
+}
+
+TEST(convert, csr_to_csc) {
+  Tensor<double> B = makeMatrix(CSR);
+  Tensor<double> C = B.transpose({1, 0}, CSR);
+  ASSERT_EQ(std::vector<int>({4, 3}), C.getDimensions());
+  ASSERT_EQ(std::vector<int>({0, 2, 3, 4, 5}), getArray(C, 1, 0));
+  ASSERT_EQ(std::vector<int>({0, 2, 2, 0, 2}), getArray(C, 1, 1));
+  ASSERT_EQ(std::vector<double>({1, 3, 4, 2, 5}), getValues(C));
+
+  // Reformatting CSR as CSC keeps the modes but reorders the levels
+  Tensor<double> D = B.transpose({0, 1}, CSC);
+  ASSERT_EQ(std::vector<int>({3, 4}), D.getDimensions());
+  ASSERT_EQ(std::vector<int>({0, 2, 3, 4, 5}), getArray(D, 1, 0));
+  ASSERT_EQ(std::vector<int>({0, 2, 2, 0, 2}), getArray(D, 1, 1));
+
+  Tensor<double> E = D.transpose({0, 1}, CSR);
+  ASSERT_EQ(getArray(B, 1, 0), getArray(E, 1, 0));
+  ASSERT_EQ(getArray(B, 1, 1), getArray(E, 1, 1));
+  ASSERT_EQ(getValues(B), getValues(E));
+}
+
+TEST(convert, coo_to_csf) {
+  TensorData<double> data({3, 4, 5}, {
+    {{0, 1, 4}, 1.0},
+    {{0, 3, 0}, 2.0},
+    {{2, 0, 2}, 3.0},
+    {{2, 0, 3}, 4.0},
+    {{2, 3, 1}, 5.0},
+  });
+  Tensor<double> coo = data.makeTensor("coo", COO(3));
+  coo.pack();
+  Tensor<double> csf = coo.transpose({0, 1, 2}, CSF3);
+  ASSERT_EQ(std::vector<int>({0, 2}), getArray(csf, 0, 0));
+  ASSERT_EQ(std::vector<int>({0, 2}), getArray(csf, 0, 1));
+  ASSERT_EQ(std::vector<int>({0, 2, 4}), getArray(csf, 1, 0));
+  ASSERT_EQ(std::vector<int>({1, 3, 0, 3}), getArray(csf, 1, 1));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 4, 5}), getArray(csf, 2, 0));
+  ASSERT_EQ(std::vector<int>({4, 0, 2, 3, 1}), getArray(csf, 2, 1));
+  ASSERT_EQ(std::vector<double>({1, 2, 3, 4, 5}), getValues(csf));
+
+  // And back, permuted
+  Tensor<double> permuted = csf.transpose({2, 0, 1}, COO(3));
+  ASSERT_TRUE(data.compare(permuted.transpose({1, 2, 0}, CSF3)));
+  ASSERT_EQ(std::vector<int>({5, 3, 4}), permuted.getDimensions());
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 4}), getArray(permuted, 0, 1));
+}
+
+TEST(convert, permutations) {
+  TensorData<double> data({4, 3, 5}, {
+    {{0, 0, 0}, 1.0},
+    {{0, 2, 4}, 2.0},
+    {{1, 1, 1}, 3.0},
+    {{3, 0, 2}, 4.0},
+    {{3, 2, 2}, 5.0},
+    {{3, 2, 4}, 6.0},
+  });
+  const std::vector<Format> formats = {
+    Format({Dense, Dense, Dense}),
+    Format({Dense, Sparse, Sparse}),
+    Format({Sparse, Dense, Sparse}, {2, 0, 1}),
+    Format({Sparse, Sparse, Dense}, {1, 2, 0}),
+    CSF3,
+    COO(3),
+  };
+  const std::vector<std::vector<int>> orderings = {
+    {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+  };
+  for (auto& sourceFormat : formats) {
+    Tensor<double> source = data.makeTensor("source", sourceFormat);
+    source.pack();
+    for (auto& format : formats) {
+      for (auto& ordering : orderings) {
+        Tensor<double> converted = source.transpose(ordering, format);
+        std::vector<int> inverse(3);
+        for (int i = 0; i < 3; i++) {
+          inverse[ordering[i]] = i;
+        }
+        Tensor<double> back = converted.transpose(inverse, CSF3);
+        ASSERT_TRUE(data.compare(back))
+            << sourceFormat << " to " << format << " by "
+            << util::join(ordering);
+      }
+    }
+  }
+}
+
+TEST(convert, chunks) {
+  // Enough nonzeros per column that the sorts split them across threads
+  Tensor<double> B("B", {200, 30}, CSR);
+  for (int i = 0; i < 200; i++) {
+    for (int j = (i * 7) % 3; j < 30; j += 1 + (i + j) % 4) {
+      B.insert({i, j}, (double)(i * 30 + j));
+    }
+  }
+  B.pack();
+  Tensor<double> C = B.transpose({1, 0}, CSR);
+  for (auto& component : C) {
+    ASSERT_EQ((double)(component.first[1] * 30 + component.first[0]),
+              component.second);
+  }
+  ASSERT_EQ(getValues(B).size(), getValues(C).size());
+  Tensor<double> D = C.transpose({1, 0}, CSR);
+  ASSERT_EQ(getArray(B, 1, 0), getArray(D, 1, 0));
+  ASSERT_EQ(getArray(B, 1, 1), getArray(D, 1, 1));
+  ASSERT_EQ(getValues(B), getValues(D));
+}
+
+TEST(convert, remove_explicit_zeros) {
+  Tensor<double> B("B", {3, 3}, Format({Dense, Dense}));
+  B.insert({0, 1}, 1.0);
+  B.insert({2, 2}, 2.0);
+  B.pack();
+  Tensor<double> C = B.removeExplicitZeros(CSR);
+  ASSERT_EQ(std::vector<int>({0, 1, 1, 2}), getArray(C, 1, 0));
+  ASSERT_EQ(std::vector<int>({1, 2}), getArray(C, 1, 1));
+  ASSERT_EQ(std::vector<double>({1, 2}), getValues(C));
+
+  // Explicit zeros are kept by transposes
+  Tensor<double> D = B.transpose({1, 0}, CSR);
+  ASSERT_EQ(9u, getValues(D).size());
+  ASSERT_TENSOR_EQ(B.transpose({1, 0}, Format({Dense, Dense})),
+                   D.removeExplicitZeros(Format({Dense, Dense})));
+}
+
+TEST(convert, remove_explicit_zeros_float16) {
+  Tensor<float16> B("B", {2, 2}, Format({Dense, Dense}));
+  B.insert({1, 0}, float16(1.5f));
+  B.pack();
+  Tensor<float16> C = B.removeExplicitZeros(CSR);
+  ASSERT_EQ(1u, C.getStorage().getValues().getSize());
+  ASSERT_EQ(1.5f, (float)C.at({1, 0}));
+}
+
+TEST(convert, supported_formats) {
+  ASSERT_TRUE(canConvert(CSR, CSC));
+  ASSERT_TRUE(canConvert(COO(3), CSF3));
+  ASSERT_FALSE(canConvert(CSR, CSF3));
+  ASSERT_FALSE(canConvert(Format(), Format()));
+}
+
+}
@@ -9,10 +9,19 @@ using taco::ir::Assign;
 using taco::ir::Block;
 using taco::Int32;
 using taco::ir::simplify;
+using taco::ir::hoistLoopInvariants;
+using taco::ir::reduceStrength;
+using taco::ir::eliminateCommonSubexpressions;
+using taco::ir::unrollLoops;
 using taco::ir::Neg;
 using taco::ir::Add;
+using taco::ir::Mul;
+using taco::ir::Load;
+using taco::ir::Literal;
+using taco::ir::isa;
 using taco::ir::While;
 using taco::ir::Scope;
+using taco::ir::Store;
 
 TEST(expr, simplify_copy) {
   auto a = Var::make("a", Int32), 
@@ -76,3 +85,146 @@ TEST(expr, simplify_dont_copy_loop_dependent_var) {
   ASSERT_EQ(simplifiedInc->lhs, b);
   ASSERT_EQ(simplifiedInc->rhs.as<Add>()->a, b);
 }
+
+TEST(expr, simplify_copy_redeclared) {
+  auto a = Var::make("a", Int32),
+       b = Var::make("b", Int32),
+       i = Var::make("i", Int32);
+
+  // `b` is declared again in the loop, where it is no longer a copy of `a`
+  auto aDecl = VarDecl::make(a, Neg::make(i)),
+       bDecl = VarDecl::make(b, a),
+       bRedecl = VarDecl::make(b, Add::make(a, 1)),
+       use = Assign::make(i, b),
+       loop = taco::ir::For::make(i, 0, 8, 1, Block::make(bRedecl, use));
+  auto block = Block::make(aDecl, bDecl, loop);
+
+  auto simplified = simplify(block);
+  auto *simplifiedLoop = simplified.as<Block>()->contents[1]
+                             .as<taco::ir::For>();
+  auto *simplifiedBody = simplifiedLoop->contents.as<Scope>()->scopedStmt
+                             .as<Block>();
+  ASSERT_EQ(simplifiedBody->contents[1].as<Assign>()->rhs, b);
+}
+
+TEST(expr, hoist_loop_invariants) {
+  auto i = Var::make("i", Int32),
+       j = Var::make("j", Int32),
+       n = Var::make("n", Int32),
+       jA = Var::make("jA", Int32),
+       pos = Var::make("pos", Int32, true);
+
+  // for (j = pos[i]; j < pos[i + 1]; j++) { jA = i * n + j; }
+  auto body = VarDecl::make(jA, Add::make(Mul::make(i, n), j));
+  auto loop = taco::ir::For::make(j, Load::make(pos, i),
+                                  Load::make(pos, Add::make(i, 1)), 1, body);
+
+  auto hoistedStmt = hoistLoopInvariants(loop);
+  auto *hoisted = hoistedStmt.as<Block>();
+  ASSERT_EQ(size_t(3), hoisted->contents.size());
+  auto *endDecl = hoisted->contents[0].as<VarDecl>();
+  auto *productDecl = hoisted->contents[1].as<VarDecl>();
+  auto *hoistedLoop = hoisted->contents[2].as<taco::ir::For>();
+  ASSERT_TRUE(isa<Load>(endDecl->rhs));
+  ASSERT_EQ(endDecl->var, hoistedLoop->end);
+  ASSERT_TRUE(isa<Mul>(productDecl->rhs));
+  auto *hoistedBody = hoistedLoop->contents.as<Scope>()->scopedStmt
+                          .as<VarDecl>();
+  ASSERT_EQ(productDecl->var, hoistedBody->rhs.as<Add>()->a);
+
+  // Loads in loop bodies may not be safe to evaluate if the loop never runs
+  auto loadBody = VarDecl::make(jA, Load::make(pos, i));
+  auto loadLoop = taco::ir::For::make(j, 0, n, 1, loadBody);
+  ASSERT_EQ(loadLoop, hoistLoopInvariants(loadLoop).as<Block>()->contents[0]);
+}
+
+TEST(expr, reduce_strength) {
+  auto k = Var::make("k", Int32),
+       n = Var::make("n", Int32),
+       kB = Var::make("kB", Int32);
+
+  // for (k = 0; k < 8; k++) { kB = k * n; }
+  auto loop = taco::ir::For::make(k, 0, 8, 1, VarDecl::make(kB,
+                                                            Mul::make(k, n)));
+  auto reducedStmt = reduceStrength(loop);
+  auto *reduced = reducedStmt.as<Block>();
+  ASSERT_EQ(size_t(2), reduced->contents.size());
+  auto *strideDecl = reduced->contents[0].as<VarDecl>();
+  ASSERT_TRUE(isa<Literal>(strideDecl->rhs));
+  auto *reducedBody = reduced->contents[1].as<taco::ir::For>()->contents
+                          .as<Scope>()->scopedStmt.as<Block>();
+  ASSERT_EQ(strideDecl->var, reducedBody->contents[0].as<VarDecl>()->rhs);
+  auto *increment = reducedBody->contents[1].as<Assign>();
+  ASSERT_EQ(strideDecl->var, increment->lhs);
+  ASSERT_EQ(n, increment->rhs.as<Add>()->b);
+
+  // Parallel loops do not run their iterations in order
+  auto parallelLoop = taco::ir::For::make(k, 0, 8, 1,
+                                          VarDecl::make(kB, Mul::make(k, n)),
+                                          taco::ir::LoopKind::Static);
+  ASSERT_EQ(parallelLoop, reduceStrength(parallelLoop));
+}
+
+TEST(expr, eliminate_common_subexpressions) {
+  auto i = Var::make("i", Int32),
+       n = Var::make("n", Int32),
+       a = Var::make("a", Int32),
+       b = Var::make("b", Int32),
+       c = Var::make("c", Int32);
+
+  auto aDecl = VarDecl::make(a, Mul::make(i, n)),
+       bDecl = VarDecl::make(b, Add::make(Mul::make(i, n), 1)),
+       iInc = Assign::make(i, Add::make(i, 1)),
+       cDecl = VarDecl::make(c, Mul::make(i, n));
+  auto block = Block::make(aDecl, bDecl, iInc, cDecl);
+
+  auto eliminatedStmt = eliminateCommonSubexpressions(block);
+  auto *eliminated = eliminatedStmt.as<Block>();
+  ASSERT_EQ(a, eliminated->contents[1].as<VarDecl>()->rhs.as<Add>()->a);
+
+  // `i` changes before `c` is declared
+  ASSERT_TRUE(isa<Mul>(eliminated->contents[3].as<VarDecl>()->rhs));
+}
+
+TEST(expr, unroll_and_jam) {
+  auto o = Var::make("o", Int32),
+       j = Var::make("j", Int32),
+       n = Var::make("n", Int32),
+       x = Var::make("x", Int32),
+       a = Var::make("a", Int32, true);
+
+  // for (o = 0; o < 8; o++) { x = o * 2; for (j = 0; j < n; j++) a[j] += x; }
+  auto makeLoop = [&](taco::ir::Expr data) {
+    auto inner = taco::ir::For::make(j, 0, n, 1, Store::make(a, j, data));
+    return taco::ir::For::make(o, 0, 8, 1,
+                               Block::make(VarDecl::make(x, Mul::make(o, 2)),
+                                           inner),
+                               taco::ir::LoopKind::Serial,
+                               taco::ParallelUnit::NotParallel, 4);
+  };
+  auto unrolledStmt = unrollLoops(makeLoop(Add::make(Load::make(a, j), x)));
+
+  // 4 divides the trip count, so there is no remainder loop
+  auto *unrolled = unrolledStmt.as<Block>();
+  ASSERT_EQ(size_t(1), unrolled->contents.size());
+  auto *outer = unrolled->contents[0].as<taco::ir::For>();
+  ASSERT_EQ(0u, outer->unrollFactor);
+  ASSERT_TRUE(outer->increment.as<Literal>()->equalsScalar(4));
+  auto *body = outer->contents.as<Scope>()->scopedStmt.as<Block>();
+  ASSERT_EQ(size_t(5), body->contents.size());
+
+  // The inner loops are jammed, and accumulate into a[j] in a scalar
+  auto *jammed = body->contents[4].as<taco::ir::For>()->contents
+                     .as<Scope>()->scopedStmt.as<Block>();
+  ASSERT_EQ(size_t(5), jammed->contents.size());
+  ASSERT_TRUE(isa<VarDecl>(jammed->contents[0]));
+  ASSERT_TRUE(isa<Assign>(jammed->contents[3]));
+  ASSERT_TRUE(isa<Store>(jammed->contents[4]));
+
+  // Reading other elements of a in the inner loops prevents jamming them
+  auto shiftedStmt = unrollLoops(makeLoop(Add::make(Load::make(a, Add::make(j, 1)),
+                                                    x)));
+  auto *shifted = shiftedStmt.as<Block>()->contents[0].as<taco::ir::For>()
+                      ->contents.as<Scope>()->scopedStmt.as<Block>();
+  ASSERT_EQ(size_t(4), shifted->contents.size());
+}
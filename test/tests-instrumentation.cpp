@@ -0,0 +1,184 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <cstdlib>
+
+#include "taco/tensor.h"
+#include "taco/instrumentation.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/codegen/module.h"
+#include "taco/ir/ir.h"
+
+using namespace taco;
+
+namespace instrumentation_tests {
+
+/// Enables instrumentation with fresh counters while in scope.
+class InstrumentationScope {
+public:
+  InstrumentationScope() {
+    resetInstrumentation();
+    setInstrumentationEnabled(true);
+  }
+
+  ~InstrumentationScope() {
+    setInstrumentationEnabled(false);
+    resetInstrumentation();
+  }
+};
+
+static Tensor<double> sparseAdd(const std::string& name) {
+  Tensor<double> B(name + "B", {4,4}, CSR);
+  Tensor<double> C(name + "C", {4,4}, CSR);
+  B.insert({0,1}, 1.0);
+  B.insert({2,3}, 2.0);
+  C.insert({0,1}, 3.0);
+  C.insert({3,0}, 4.0);
+  B.pack();
+  C.pack();
+
+  IndexVar i("i"), j("j");
+  Tensor<double> A(name + "A", {4,4}, CSR);
+  A(i,j) = B(i,j) + C(i,j);
+  return A;
+}
+
+TEST(instrumentation, disabled) {
+  resetInstrumentation();
+  ASSERT_FALSE(isInstrumentationEnabled());
+
+  Tensor<double> A = sparseAdd("disabled");
+  A.evaluate();
+  addToCounter("test.counter");
+
+  ASSERT_TRUE(getCounters().empty());
+  ASSERT_TRUE(getPhaseStatistics().empty());
+  ASSERT_TRUE(getPhaseEvents().empty());
+}
+
+TEST(instrumentation, phases) {
+  InstrumentationScope scope;
+
+  Tensor<double> A = sparseAdd("phases");
+  A.evaluate();
+
+  auto phases = getPhaseStatistics();
+  for (auto& phase : {"pack", "pack.sort", "concretize", "compile", "assemble",
+                      "compute"}) {
+    ASSERT_EQ(1u, phases.count(phase)) << phase;
+    ASSERT_GE(phases.at(phase).totalTime, phases.at(phase).maxTime);
+    ASSERT_GE(phases.at(phase).maxTime, phases.at(phase).minTime);
+  }
+  ASSERT_EQ(2u, phases.at("pack").count);
+  ASSERT_LE(1u, phases.at("kernel").count);
+
+  size_t numEvents = 0;
+  for (auto& phase : phases) {
+    numEvents += phase.second.count;
+  }
+  ASSERT_EQ(numEvents, getPhaseEvents().size());
+}
+
+TEST(instrumentation, kernel_cache) {
+  InstrumentationScope scope;
+
+  Tensor<double> A1 = sparseAdd("cache1");
+  A1.compile();
+  const int64_t lookups = getCounter(counters::kernelCacheHits) +
+                          getCounter(counters::kernelCacheMisses);
+  ASSERT_EQ(1, lookups);
+
+  const int64_t hits = getCounter(counters::kernelCacheHits);
+  Tensor<double> A2 = sparseAdd("cache2");
+  A2.compile();
+  ASSERT_EQ(hits + 1, getCounter(counters::kernelCacheHits));
+}
+
+TEST(instrumentation, allocations) {
+  // Bypass the kernel cache so that the kernel is generated with allocation
+  // statistics.
+  const char* cacheKernels = std::getenv("CACHE_KERNELS");
+  const std::string oldCacheKernels = cacheKernels ? cacheKernels : "";
+  setenv("CACHE_KERNELS", "0", 1);
+
+  InstrumentationScope scope;
+  Tensor<double> A = sparseAdd("alloc");
+  A.evaluate();
+
+  if (cacheKernels) {
+    setenv("CACHE_KERNELS", oldCacheKernels.c_str(), 1);
+  } else {
+    unsetenv("CACHE_KERNELS");
+  }
+
+  // A has 5 rows and 3 nonzeros
+  ASSERT_LE((int64_t)(5 * sizeof(int32_t)), getCounter(counters::posBytes));
+  ASSERT_LE((int64_t)(3 * sizeof(int32_t)), getCounter(counters::crdBytes));
+  ASSERT_LE((int64_t)(3 * sizeof(double)), getCounter(counters::valsBytes));
+  ASSERT_EQ(3u, A.getStorage().getValues().getSize());
+}
+
+TEST(instrumentation, chrome_trace) {
+  InstrumentationScope scope;
+
+  Tensor<double> A = sparseAdd("trace");
+  A.evaluate();
+  addToCounter("test.counter", 42);
+
+  std::string trace = getChromeTrace();
+  ASSERT_EQ(0u, trace.find("{\"traceEvents\":["));
+  ASSERT_NE(std::string::npos, trace.find("\"name\":\"compute\""));
+  ASSERT_NE(std::string::npos, trace.find("\"detail\":\"traceA\""));
+  ASSERT_NE(std::string::npos,
+            trace.find("\"name\":\"test.counter\",\"cat\":\"taco\",\"ph\":\"C\""));
+  ASSERT_NE(std::string::npos, trace.find("\"value\":42"));
+}
+
+TEST(instrumentation, kernel_profile) {
+  // x = 0;
+  // for (i = 0; i < 10; i++) { if (i < 3) x += 1; else x += 2; }
+  // while (x < 100) x += 10;
+  ir::Expr x = ir::Var::make("x", Int32);
+  ir::Expr i = ir::Var::make("i", Int32);
+  ir::Stmt lattice = ir::Case::make(
+      {{ir::Lt::make(i, 3), ir::Assign::make(x, ir::Add::make(x, 1))},
+       {ir::Expr(true),     ir::Assign::make(x, ir::Add::make(x, 2))}}, true);
+  ir::Stmt body = ir::Block::make(
+      ir::VarDecl::make(x, 0),
+      ir::For::make(i, 0, 10, 1, lattice),
+      ir::While::make(ir::Lt::make(x, 100),
+                      ir::Assign::make(x, ir::Add::make(x, 10))));
+
+  setKernelProfilingEnabled(true);
+  ir::Module module;
+  module.addFunction(ir::Function::make("profiled", {}, {}, body));
+  module.compile();
+  setKernelProfilingEnabled(false);
+
+  KernelProfile profile;
+  ASSERT_EQ(0, module.callFuncPacked("profiled", nullptr, &profile));
+
+  std::map<std::string,int64_t> counts;
+  for (auto& counter : profile) {
+    counts[counter.name] = counter.count;
+  }
+  ASSERT_EQ(4u, counts.size());
+  ASSERT_EQ(10, counts.at("for i"));
+  ASSERT_EQ(3, counts.at("case (i < 3)"));
+  ASSERT_EQ(7, counts.at("case else"));
+  ASSERT_EQ(9, counts.at("while (x < 100)"));
+
+  // Counters are reset on every call
+  ASSERT_EQ(0, module.callFuncPacked("profiled", nullptr, &profile));
+  ASSERT_EQ(10, profile[0].count);
+
+  // Kernels generated without profiling have no counters
+  ir::Module unprofiled;
+  unprofiled.addFunction(ir::Function::make("unprofiled", {}, {}, body));
+  unprofiled.compile();
+  ASSERT_EQ(std::string::npos, unprofiled.getSource().find("taco_profile"));
+  ASSERT_EQ(0, unprofiled.callFuncPacked("unprofiled", nullptr, &profile));
+  ASSERT_TRUE(profile.empty());
+}
+
+}
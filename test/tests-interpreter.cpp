@@ -0,0 +1,228 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <cstdlib>
+#include <functional>
+
+#include "taco/tensor.h"
+#include "taco/instrumentation.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/ir/ir.h"
+#include "taco/ir/ir_interpreter.h"
+
+using namespace taco;
+
+namespace interpreter_tests {
+
+/// Sets an environment variable while in scope.
+class EnvironmentScope {
+public:
+  EnvironmentScope(const std::string& name, const std::string& value)
+      : name(name), hadValue(std::getenv(name.c_str()) != nullptr) {
+    if (hadValue) {
+      oldValue = std::getenv(name.c_str());
+    }
+    setenv(name.c_str(), value.c_str(), 1);
+  }
+
+  ~EnvironmentScope() {
+    if (hadValue) {
+      setenv(name.c_str(), oldValue.c_str(), 1);
+    } else {
+      unsetenv(name.c_str());
+    }
+  }
+
+private:
+  std::string name;
+  bool hadValue;
+  std::string oldValue;
+};
+
+typedef std::function<Tensor<double>(const std::string&)> Expression;
+
+static Tensor<double> spmv(const std::string& name) {
+  Tensor<double> B(name + "B", {5, 6}, CSR);
+  Tensor<double> c(name + "c", {6}, Format{Dense});
+  B.insert({0, 1}, 1.0);
+  B.insert({0, 5}, 2.0);
+  B.insert({3, 2}, 3.0);
+  B.insert({4, 0}, 4.0);
+  c.insert({0}, 5.0);
+  c.insert({1}, 6.0);
+  c.insert({5}, 7.0);
+  B.pack();
+  c.pack();
+  IndexVar i("i"), j("j");
+  Tensor<double> a(name + "a", {5}, Format{Dense});
+  a(i) = B(i,j) * c(j);
+  return a;
+}
+
+static Tensor<double> sparseAdd(const std::string& name) {
+  Tensor<double> B(name + "B", {4, 5}, CSR);
+  Tensor<double> C(name + "C", {4, 5}, CSR);
+  B.insert({0, 1}, 1.0);
+  B.insert({2, 3}, 2.0);
+  B.insert({3, 4}, 3.0);
+  C.insert({0, 1}, 4.0);
+  C.insert({1, 0}, 5.0);
+  C.insert({3, 2}, 6.0);
+  B.pack();
+  C.pack();
+  IndexVar i("i"), j("j");
+  Tensor<double> A(name + "A", {4, 5}, CSR);
+  A(i,j) = B(i,j) + C(i,j);
+  return A;
+}
+
+static Tensor<double> spgemm(const std::string& name) {
+  Tensor<double> B(name + "B", {4, 4}, CSR);
+  Tensor<double> C(name + "C", {4, 4}, CSR);
+  B.insert({0, 0}, 1.0);
+  B.insert({0, 3}, 2.0);
+  B.insert({2, 1}, 3.0);
+  B.insert({3, 2}, 4.0);
+  C.insert({0, 2}, 5.0);
+  C.insert({1, 1}, 6.0);
+  C.insert({3, 0}, 7.0);
+  C.insert({3, 3}, 8.0);
+  B.pack();
+  C.pack();
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> A(name + "A", {4, 4}, CSR);
+  A(i,j) = B(i,k) * C(k,j);
+  return A;
+}
+
+static Tensor<double> denseScale(const std::string& name) {
+  Tensor<double> B(name + "B", {3, 4}, Format({Dense, Dense}));
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      B.insert({i, j}, (double)(i * 4 + j));
+    }
+  }
+  B.pack();
+  Tensor<double> alpha(name + "alpha");
+  alpha = 0.5;
+  IndexVar i("i"), j("j");
+  Tensor<double> A(name + "A", {3, 4}, Format({Dense, Dense}));
+  A(i,j) = alpha() * B(i,j) - B(i,j);
+  return A;
+}
+
+TEST(interpreter, unsupported) {
+  ir::Expr x = ir::Var::make("x", Int32);
+  ir::Stmt call = ir::VarDecl::make(x, ir::Call::make("rand", {}, Int32));
+  ir::Interpreter interpreter(ir::Function::make("call", {}, {}, call));
+  ASSERT_FALSE(interpreter.isSupported());
+  ASSERT_FALSE(interpreter.getUnsupportedReason().empty());
+
+  ir::Stmt body = ir::Block::make(ir::VarDecl::make(x, 0),
+                                  ir::Assign::make(x, ir::Add::make(x, 1)));
+  ir::Interpreter supported(ir::Function::make("inc", {}, {}, body));
+  ASSERT_TRUE(supported.isSupported());
+  ASSERT_EQ(0, supported.call(nullptr));
+}
+
+TEST(interpreter, print) {
+  ir::Expr i = ir::Var::make("i", Int32);
+  ir::Expr x = ir::Var::make("x", Float64);
+  ir::Stmt body = ir::Block::make(
+      ir::VarDecl::make(x, ir::Literal::make(0.5)),
+      ir::For::make(i, 0, 2, 1,
+                    ir::Print::make("%d: %4.2f%%\\n", {i, x})));
+  ir::Interpreter interpreter(ir::Function::make("print", {}, {}, body));
+  ASSERT_TRUE(interpreter.isSupported());
+
+  testing::internal::CaptureStdout();
+  interpreter.call(nullptr);
+  ASSERT_EQ("0: 0.50%\n1: 0.50%\n", testing::internal::GetCapturedStdout());
+}
+
+TEST(interpreter, small_problems) {
+  // Kernels whose estimated work is below the threshold are not compiled, and
+  // are cached apart from compiled kernels
+  const std::vector<Expression> expressions = {spmv, sparseAdd, spgemm,
+                                               denseScale};
+  std::vector<Tensor<double>> expected;
+  for (auto& expression : expressions) {
+    Tensor<double> result = expression("compiled");
+    result.evaluate();
+    expected.push_back(result);
+  }
+
+  const size_t threshold = taco_get_interpreter_threshold();
+  taco_set_interpreter_threshold(1000);
+  ASSERT_EQ(1000u, taco_get_interpreter_threshold());
+  resetInstrumentation();
+  setInstrumentationEnabled(true);
+  for (size_t e = 0; e < expressions.size(); e++) {
+    Tensor<double> result = expressions[e]("small");
+    result.evaluate();
+    ASSERT_TENSOR_EQ(expected[e], result);
+    ASSERT_NE(std::string::npos, result.getSource().find("compute"));
+  }
+  std::map<std::string,PhaseStatistics> phases = getPhaseStatistics();
+  resetInstrumentation();
+
+  // Larger problems are compiled
+  Tensor<double> large("large", {2000}, Format{Dense});
+  Tensor<double> b("b", {2000}, Format{Dense});
+  b.insert({7}, 2.0);
+  b.pack();
+  IndexVar i("i");
+  large(i) = b(i) * b(i);
+  large.evaluate();
+  ASSERT_DOUBLE_EQ(4.0, large.at({7}));
+  std::map<std::string,PhaseStatistics> largePhases = getPhaseStatistics();
+  setInstrumentationEnabled(false);
+  resetInstrumentation();
+  taco_set_interpreter_threshold(threshold);
+
+  // Only the pack functions of the operands may have been compiled
+  auto count = [](const std::map<std::string,PhaseStatistics>& phases,
+                  const std::string& phase) {
+    return phases.count(phase) ? phases.at(phase).count : 0;
+  };
+  ASSERT_LE(2 * expressions.size(), count(phases, "interpret"));
+  ASSERT_EQ(count(phases, "helpers"), count(phases, "cc"));
+  ASSERT_EQ(0u, largePhases.count("interpret"));
+  ASSERT_EQ(1u, largePhases.count("cc"));
+}
+
+TEST(interpreter, background_compile) {
+  // Compile every kernel on its own, with a compiler slow enough that the
+  // kernels are interpreted
+  EnvironmentScope cacheKernels("CACHE_KERNELS", "0");
+  const std::vector<Expression> expressions = {spmv, sparseAdd, spgemm,
+                                               denseScale};
+  std::vector<Tensor<double>> expected;
+  for (auto& expression : expressions) {
+    Tensor<double> result = expression("native");
+    result.evaluate();
+    expected.push_back(result);
+  }
+
+  resetInstrumentation();
+  setInstrumentationEnabled(true);
+  taco_set_background_compile(true);
+  {
+    EnvironmentScope compiler("TACO_CC", "sleep 2; cc");
+    for (size_t e = 0; e < expressions.size(); e++) {
+      Tensor<double> result = expressions[e]("interpreted");
+      result.evaluate();
+      ASSERT_TENSOR_EQ(expected[e], result);
+    }
+  }
+  taco_set_background_compile(false);
+  std::map<std::string,PhaseStatistics> phases = getPhaseStatistics();
+  setInstrumentationEnabled(false);
+  resetInstrumentation();
+
+  // Every kernel was interpreted at least once
+  ASSERT_EQ(1u, phases.count("interpret"));
+  ASSERT_LE(expressions.size(), phases.at("interpret").count);
+}
+
+}
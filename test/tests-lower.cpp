@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include "taco/lower/lower.h"
+#include "taco/lower/lowerer_impl.h"
 #include "taco/ir/ir.h"
 #include "taco/index_notation/index_notation.h"
 #include "taco/index_notation/index_notation_rewriter.h"
@@ -1556,4 +1557,65 @@ TEST_STMT(vector_not,
   }
 )
 
+TEST(lowerer, shared_analysis) {
+  TensorVar y("y", vectype, dense);
+  TensorVar M("M", mattype, CSR);
+  TensorVar x("x", vectype, dense);
+  IndexStmt stmt = makeConcreteNotation(makeReductionNotation(
+      y(i) = M(i,j) * x(j)));
+
+  Lowerer assembleLowerer;
+  Lowerer computeLowerer;
+  auto analysis = std::make_shared<LoweringAnalysis>();
+  assembleLowerer.getLowererImpl()->setAnalysis(analysis);
+  computeLowerer.getLowererImpl()->setAnalysis(analysis);
+
+  ir::Stmt assemble = taco::lower(stmt, "assemble", true, false, false,
+                                  false, assembleLowerer);
+  const size_t numLattices = analysis->mergeLattices.size();
+  ASSERT_LT(0u, numLattices);
+  ir::Stmt compute = taco::lower(stmt, "compute", false, true, false, false,
+                                 computeLowerer);
+
+  // The compute function is lowered from the analysis of the assemble one
+  ASSERT_EQ(numLattices, analysis->mergeLattices.size());
+  const ir::Function* assembleFunc = assemble.as<ir::Function>();
+  const ir::Function* computeFunc = compute.as<ir::Function>();
+  ASSERT_EQ(assembleFunc->outputs.size(), computeFunc->outputs.size());
+  for (size_t n = 0; n < assembleFunc->outputs.size(); n++) {
+    ASSERT_EQ(assembleFunc->outputs[n].ptr, computeFunc->outputs[n].ptr);
+  }
+  for (size_t n = 0; n < assembleFunc->inputs.size(); n++) {
+    ASSERT_EQ(assembleFunc->inputs[n].ptr, computeFunc->inputs[n].ptr);
+  }
+}
+
+TEST(lowerer, shared_analysis_sparse_add) {
+  // Lowering the cases of the merge lattices makes and frees foralls, whose
+  // lattices must not be reused for foralls made later at the same address
+  Format dcsr({Sparse, Sparse});
+  Tensor<double> X("X", {4, 4}, dcsr);
+  Tensor<double> Y("Y", {4, 4}, dcsr);
+  Tensor<double> Z("Z", {4, 4}, dcsr);
+  Tensor<double> expected("expected", {4, 4}, Format({Dense, Dense}));
+  for (int n = 0; n < 4; n++) {
+    X.insert({n, n}, 1.0);
+    Y.insert({n, (n + 1) % 4}, 2.0);
+    Z.insert({(n + 2) % 4, n}, 3.0);
+    expected.insert({n, n}, 1.0);
+    expected.insert({n, (n + 1) % 4}, 2.0);
+    expected.insert({(n + 2) % 4, n}, 3.0);
+  }
+  X.pack();
+  Y.pack();
+  Z.pack();
+  expected.pack();
+
+  Tensor<double> W("W", {4, 4}, dcsr);
+  IndexVar i, j;
+  W(i,j) = X(i,j) + Y(i,j) + Z(i,j);
+  W.evaluate();
+  ASSERT_TENSOR_EQ(expected, W);
+}
+
 }}
@@ -0,0 +1,140 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include "taco/tensor.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/storage/pack.h"
+#include "taco/util/numa.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using namespace taco;
+
+namespace numa_tests {
+
+/// Disables first-touch initialization when going out of scope.
+class FirstTouchScope {
+public:
+  FirstTouchScope() {
+    taco_set_numa_first_touch(true);
+  }
+  ~FirstTouchScope() {
+    taco_set_numa_first_touch(false);
+  }
+};
+
+TEST(numa, topology) {
+  auto nodes = util::getNumaNodeCpus();
+  ASSERT_LE(1u, nodes.size());
+  for (auto& cpus : nodes) {
+    ASSERT_FALSE(cpus.empty());
+  }
+}
+
+TEST(numa, placement) {
+  std::vector<std::vector<int>> nodes = {{0,1}, {2,3}};
+  std::vector<int> close, spread;
+  for (int thread = 0; thread < 5; thread++) {
+    close.push_back(util::getPlacementCpu(nodes, thread, false));
+    spread.push_back(util::getPlacementCpu(nodes, thread, true));
+  }
+  ASSERT_EQ(std::vector<int>({0,1,2,3,0}), close);
+  ASSERT_EQ(std::vector<int>({0,2,1,3,0}), spread);
+
+  std::vector<std::vector<int>> uneven = {{0,1,2}, {3}};
+  spread.clear();
+  for (int thread = 0; thread < 4; thread++) {
+    spread.push_back(util::getPlacementCpu(uneven, thread, true));
+  }
+  ASSERT_EQ(std::vector<int>({0,3,1,2}), spread);
+  ASSERT_EQ(-1, util::getPlacementCpu({}, 0, true));
+}
+
+TEST(numa, thread_placement_api) {
+  taco_set_num_threads(2, ThreadPlacement::Spread);
+  ASSERT_EQ(2, taco_get_num_threads());
+  ASSERT_TRUE(ThreadPlacement::Spread == taco_get_thread_placement());
+  taco_set_num_threads(1, ThreadPlacement::Default);
+  ASSERT_TRUE(ThreadPlacement::Default == taco_get_thread_placement());
+}
+
+#if defined(__linux__)
+TEST(numa, placement_keeps_caller_unpinned) {
+  cpu_set_t before, after;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(before), &before));
+  util::placeOpenMPThreads(2, true, false);
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(after), &after));
+  util::placeOpenMPThreads(2, false, false);
+  ASSERT_TRUE(CPU_EQUAL(&before, &after));
+}
+#endif
+
+struct DistributeTest : public TestWithParam<Format> {};
+
+TEST_P(DistributeTest, copies) {
+  Format format = GetParam();
+  Tensor<double> expected("expected", {5,4,6}, format);
+  Tensor<double> distributed("distributed", {5,4,6}, format);
+  for (int i = 0; i < 5; i += 2) {
+    for (int j = 1; j < 4; j++) {
+      for (int k = j; k < 6; k += 3) {
+        expected.insert({i,j,k}, (double)(i*100 + j*10 + k));
+        distributed.insert({i,j,k}, (double)(i*100 + j*10 + k));
+      }
+    }
+  }
+  expected.pack();
+  distributed.pack();
+
+  TensorStorage storage = distributed.getStorage();
+  const void* vals = storage.getValues().getData();
+  distributeFirstTouch(storage);
+  ASSERT_NE(vals, distributed.getStorage().getValues().getData());
+  ASSERT_TRUE(equals(expected, distributed));
+}
+
+INSTANTIATE_TEST_CASE_P(numa, DistributeTest,
+    Values(Format({Dense, Dense, Dense}),
+           Format({Dense, Sparse, Sparse}),
+           Format({Sparse, Dense, Sparse}),
+           Format({Sparse, Sparse, Sparse})));
+
+TEST(numa, first_touch_kernels) {
+  FirstTouchScope scope;
+  Tensor<double> a("a", {2048}, Format{Dense});
+  Tensor<double> B("B", {8, 2048}, CSR);
+  Tensor<double> c("c", {8}, Format{Dense});
+  for (int i = 0; i < 2048; i += 3) {
+    B.insert({i % 8, i}, 2.0);
+  }
+  for (int j = 0; j < 8; j++) {
+    c.insert({j}, (double)j);
+  }
+  B.pack();
+  c.pack();
+
+  // The result is scattered into, so it is zero-initialized first
+  IndexVar i("i"), j("j");
+  a(i) = B(j,i) * c(j);
+  a.compile(a.getAssignment().concretize().reorder(i,j));
+  a.assemble();
+  a.compute();
+
+  std::string source = a.getSource();
+  ASSERT_EQ(std::string::npos, source.find("schedule(static)"));
+  ASSERT_NE(std::string::npos, source.find("schedule(runtime)"));
+  for (int i = 0; i < 2048; i++) {
+    ASSERT_EQ((i % 3 == 0) ? 2.0 * (i % 8) : 0.0, a.at({i}));
+  }
+
+  // Kernels compiled without first touch are cached separately
+  taco_set_numa_first_touch(false);
+  Tensor<double> b("b", {2048}, Format{Dense});
+  b(i) = B(j,i) * c(j);
+  b.compile(b.getAssignment().concretize().reorder(i,j));
+  ASSERT_NE(std::string::npos, b.getSource().find("schedule(static)"));
+}
+
+}
@@ -0,0 +1,178 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <atomic>
+#include <thread>
+
+#include "taco/tensor.h"
+#include "taco/scheduler.h"
+#include "taco/index_notation/index_notation.h"
+
+using namespace taco;
+
+namespace scheduler_tests {
+
+/// Restores the default (OpenMP) scheduling when going out of scope.
+class SchedulerScope {
+public:
+  ~SchedulerScope() {
+    resetThreadScheduler();
+    resetScheduler();
+  }
+};
+
+/// A scheduler that counts the loops it runs and runs them on a pool.
+struct CountingScheduler {
+  taco_scheduler_t pool;
+  std::atomic<int> loops{0};
+};
+
+static void countingParallelFor(void* context, int64_t begin, int64_t end,
+                                taco_task_t task, void* closure) {
+  auto scheduler = static_cast<CountingScheduler*>(context);
+  scheduler->loops++;
+  scheduler->pool.parallel_for(scheduler->pool.context, begin, end, task,
+                               closure);
+}
+
+static taco_scheduler_t countingScheduler(CountingScheduler* counts) {
+  taco_scheduler_t scheduler;
+  scheduler.parallel_for = countingParallelFor;
+  scheduler.context = counts;
+  return scheduler;
+}
+
+static void checkCoverage(WorkStealingPool& pool, int64_t begin, int64_t end) {
+  std::vector<std::atomic<int>> visits(end > begin ? end - begin : 0);
+  for (auto& visit : visits) {
+    visit = 0;
+  }
+  pool.parallelFor(begin, end, [&](int64_t b, int64_t e) {
+    ASSERT_LE(begin, b);
+    ASSERT_LE(e, end);
+    for (int64_t i = b; i < e; i++) {
+      visits[i - begin]++;
+    }
+  });
+  for (auto& visit : visits) {
+    ASSERT_EQ(1, visit.load());
+  }
+}
+
+TEST(scheduler, pool_coverage) {
+  WorkStealingPool pool(3);
+  ASSERT_EQ(3, pool.getNumWorkers());
+  checkCoverage(pool, 0, 0);
+  checkCoverage(pool, 5, 6);
+  checkCoverage(pool, -17, 100);
+  checkCoverage(pool, 0, 100000);
+}
+
+TEST(scheduler, pool_concurrent_and_nested) {
+  WorkStealingPool pool(2);
+  std::atomic<int64_t> sum(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      pool.parallelFor(0, 64, [&](int64_t b, int64_t e) {
+        for (int64_t i = b; i < e; i++) {
+          pool.parallelFor(0, 100, [&](int64_t bi, int64_t ei) {
+            sum += ei - bi;
+          });
+        }
+      });
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(4 * 64 * 100, sum.load());
+}
+
+TEST(scheduler, current_scheduler) {
+  SchedulerScope scope;
+  ASSERT_EQ(nullptr, getScheduler());
+
+  WorkStealingPool pool(1);
+  CountingScheduler counts;
+  counts.pool = pool.getScheduler();
+  taco_scheduler_t process = pool.getScheduler();
+  taco_scheduler_t thread = countingScheduler(&counts);
+
+  setScheduler(process);
+  ASSERT_EQ(process.context, getScheduler()->context);
+  setThreadScheduler(thread);
+  ASSERT_EQ(thread.context, getScheduler()->context);
+
+  // Other threads use the process scheduler
+  void* otherContext = nullptr;
+  std::thread([&] { otherContext = getScheduler()->context; }).join();
+  ASSERT_EQ(process.context, otherContext);
+
+  resetThreadScheduler();
+  ASSERT_EQ(process.context, getScheduler()->context);
+}
+
+TEST(scheduler, kernels) {
+  SchedulerScope scope;
+  WorkStealingPool pool(2);
+  CountingScheduler counts;
+  counts.pool = pool.getScheduler();
+  setThreadScheduler(countingScheduler(&counts));
+
+  Tensor<double> a("a", {1000}, Format{Dense});
+  Tensor<double> B("B", {1000, 50}, CSR);
+  Tensor<double> c("c", {50}, Format{Dense});
+  for (int i = 0; i < 1000; i++) {
+    B.insert({i, i % 50}, 2.0);
+    B.insert({i, (i * 7) % 50}, 1.0);
+  }
+  for (int j = 0; j < 50; j++) {
+    c.insert({j}, (double)j);
+  }
+  B.pack();
+  c.pack();
+
+  IndexVar i("i"), j("j");
+  a(i) = B(i,j) * c(j);
+  IndexStmt stmt = a.getAssignment().concretize();
+  a.compile(stmt.parallelize(i, ParallelUnit::CPUThread,
+                             OutputRaceStrategy::NoRaces));
+  a.assemble();
+  a.compute();
+
+  ASSERT_NE(std::string::npos, a.getSource().find("compute_task0"));
+  ASSERT_LT(0, counts.loops.load());
+  for (int i = 0; i < 1000; i++) {
+    const double expected = (i % 50 == (i * 7) % 50) ? 3.0 * (i % 50)
+                          : 2.0 * (i % 50) + (i * 7) % 50;
+    ASSERT_DOUBLE_EQ(expected, a.at({i}));
+  }
+
+  // Loops that update the result atomically run with OpenMP, while the loop
+  // that zero-initializes the result runs on the scheduler
+  Tensor<double> y("y", {50}, Format{Dense});
+  Tensor<double> x("x", {1000}, Format{Dense});
+  for (int i = 0; i < 1000; i++) {
+    x.insert({i}, 1.0);
+  }
+  x.pack();
+  y(j) = B(i,j) * x(i);
+  stmt = y.getAssignment().concretize().reorder(i,j);
+  y.compile(stmt.parallelize(i, ParallelUnit::CPUThread,
+                             OutputRaceStrategy::Atomics));
+  y.assemble();
+  const int loops = counts.loops.load();
+  y.compute();
+  ASSERT_EQ(loops + 1, counts.loops.load());
+  ASSERT_NE(std::string::npos, y.getSource().find("compute_task0"));
+  ASSERT_EQ(std::string::npos, y.getSource().find("compute_task1"));
+
+  double total = 0.0;
+  for (int j = 0; j < 50; j++) {
+    total += y.at({j});
+  }
+  ASSERT_DOUBLE_EQ(3000.0, total);
+}
+
+}
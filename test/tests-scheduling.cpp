@@ -5,6 +5,8 @@
 #include "test_tensors.h"
 #include "taco/tensor.h"
 #include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/index_notation_nodes.h"
+#include "taco/index_notation/index_notation_visitor.h"
 #include "codegen/codegen.h"
 #include "taco/lower/lower.h"
 
@@ -19,11 +21,14 @@ TEST(scheduling, splitEquality) {
   IndexVarRel rel3 = IndexVarRel(new SplitRelNode(j, i1, i1, 2));
   IndexVarRel rel4 = IndexVarRel(new SplitRelNode(i, i1, i2, 4));
   IndexVarRel rel5 = IndexVarRel(new SplitRelNode(i, j1, j2, 2));
+  IndexVarRel rel6 = IndexVarRel(new SplitRelNode(i, i1, i2, 2,
+                                                  TailStrategy::Peel));
 
   ASSERT_EQ(rel1, rel2);
   ASSERT_NE(rel1, rel3);
   ASSERT_NE(rel1, rel4);
   ASSERT_NE(rel1, rel5);
+  ASSERT_NE(rel1, rel6);
 }
 
 TEST(scheduling, forallReplace) {
@@ -797,6 +802,233 @@ TEST(scheduling, pos_wrong_access) {
   ASSERT_THROW(stmt.pos(i, ipos, y(i)), taco::TacoException);
 }
 
+// Multiplies a CSR matrix by a dense matrix with the dense i and j loops tiled
+static void tileSpMM(int iSize, int jSize, std::vector<size_t> sizes,
+                     TailStrategy tailStrategy, std::string* source=nullptr) {
+  Tensor<double> B("B", {iSize, 20}, CSR);
+  Tensor<double> C("C", {20, jSize}, Format({Dense, Dense}));
+  for (int i = 0; i < iSize; i++) {
+    for (int k = 0; k < 20; k++) {
+      if ((i + 2 * k) % 7 == 0) {
+        B.insert({i, k}, (double) (i + k));
+      }
+    }
+  }
+  for (int k = 0; k < 20; k++) {
+    for (int j = 0; j < jSize; j++) {
+      C.insert({k, j}, (double) (k - j));
+    }
+  }
+  B.pack();
+  C.pack();
+
+  Tensor<double> expected("expected", {iSize, jSize}, Format({Dense, Dense}));
+  expected(i,j) = B(i,k) * C(k,j);
+  expected.evaluate();
+
+  Tensor<double> A("A", {iSize, jSize}, Format({Dense, Dense}));
+  A(i,j) = B(i,k) * C(k,j);
+  IndexStmt stmt = A.getAssignment().concretize().reorder({i, j, k});
+  stmt = stmt.tile({i, j}, sizes, tailStrategy);
+  A.compile(stmt);
+  A.assemble();
+  A.compute();
+  ASSERT_TENSOR_EQ(expected, A);
+  if (source != nullptr) {
+    *source = A.getSource();
+  }
+}
+
+TEST(scheduling, tile_guard) {
+  tileSpMM(35, 21, {16, 8}, TailStrategy::Guard);
+}
+
+TEST(scheduling, tile_peel) {
+  std::string source;
+  tileSpMM(35, 21, {16, 8}, TailStrategy::Peel, &source);
+  // Only the peeled copy of the tiles is guarded
+  ASSERT_NE(std::string::npos, source.find("else {"));
+  tileSpMM(32, 24, {16, 8}, TailStrategy::Peel);
+}
+
+TEST(scheduling, tile_round_up) {
+  std::string source;
+  tileSpMM(32, 24, {16, 8}, TailStrategy::RoundUp, &source);
+  ASSERT_EQ(std::string::npos, source.find("continue"));
+}
+
+TEST(scheduling, tile_multilevel) {
+  Tensor<double> B("B", {37, 29}, Format({Dense, Dense}));
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 29; j++) {
+      B.insert({i, j}, (double) (i * j % 11));
+    }
+  }
+  B.pack();
+
+  Tensor<double> expected("expected", {37, 29}, Format({Dense, Dense}));
+  expected(i,j) = B(i,j) * 2;
+  expected.evaluate();
+
+  IndexVar i0("i0"), i1("i1"), i2("i2"), j0("j0"), j1("j1"), j2("j2");
+  for (TailStrategy tailStrategy : {TailStrategy::Guard, TailStrategy::Peel}) {
+    Tensor<double> A("A", {37, 29}, Format({Dense, Dense}));
+    A(i,j) = B(i,j) * 2;
+    IndexStmt stmt = A.getAssignment().concretize();
+    stmt = stmt.tile({i, j}, {{i0, i1, i2}, {j0, j1, j2}}, {{16, 4}, {8, 2}},
+                     tailStrategy);
+
+    // The loops are nested level by level
+    std::vector<IndexVar> order;
+    match(stmt, function<void(const ForallNode*)>([&](const ForallNode* op) {
+      order.push_back(op->indexVar);
+    }));
+    ASSERT_EQ(std::vector<IndexVar>({i0, j0, i1, j1, i2, j2}), order);
+
+    A.compile(stmt);
+    A.assemble();
+    A.compute();
+    ASSERT_TENSOR_EQ(expected, A);
+  }
+}
+
+// Doubles a dense matrix whose rows are tiled, with its result values padded by
+// a row of tiles so that the kernel's writes past the end can be detected
+static void tileDoublePadded(int iSize, int jSize, std::vector<size_t> sizes,
+                             TailStrategy tailStrategy, double* firstValue) {
+  Tensor<double> B("B", {iSize, jSize}, Format({Dense, Dense}));
+  for (int i = 0; i < iSize; i++) {
+    for (int j = 0; j < jSize; j++) {
+      B.insert({i, j}, (double) (i + j + 1));
+    }
+  }
+  B.pack();
+
+  IndexVar i0("i0"), i1("i1"), i2("i2");
+  Tensor<double> A("A", {iSize, jSize}, Format({Dense, Dense}));
+  A(i,j) = B(i,j) * 2;
+  IndexStmt stmt = A.getAssignment().concretize();
+  stmt = stmt.tile({i}, {{i0, i1, i2}}, {sizes}, tailStrategy);
+  A.compile(stmt);
+  A.assemble();
+
+  const size_t size = (size_t)iSize * jSize;
+  const size_t padding = sizes[0] * jSize;
+  Array padded = makeArray(Float64, size + padding);
+  double* vals = (double*)padded.getData();
+  for (size_t p = 0; p < size + padding; p++) {
+    vals[p] = -1.0;
+  }
+  A.getStorage().setValues(padded);
+  A.compute();
+  for (size_t p = size; p < size + padding; p++) {
+    ASSERT_EQ(-1.0, vals[p]) << "Write past the end at " << p;
+  }
+  *firstValue = vals[0];
+}
+
+TEST(scheduling, tile_peel_in_bounds) {
+  // The peeled strips of the inner tiles must be checked against the last
+  // iteration of the tile loops they are nested in, not the first
+  double first;
+  tileDoublePadded(37, 5, {16, 4}, TailStrategy::Peel, &first);
+  ASSERT_EQ(2.0, first);
+  tileDoublePadded(37, 5, {16, 4}, TailStrategy::Guard, &first);
+  ASSERT_EQ(2.0, first);
+}
+
+TEST(scheduling, tile_round_up_check) {
+  double first;
+  tileDoublePadded(32, 5, {16, 4}, TailStrategy::RoundUp, &first);
+  ASSERT_EQ(2.0, first);
+  // A tile size that does not divide the extent is rejected when compiling
+  ASSERT_THROW(tileDoublePadded(37, 5, {16, 4}, TailStrategy::RoundUp, &first),
+               taco::TacoException);
+}
+
+TEST(scheduling, split_round_up_error) {
+  Tensor<double> x("x", {8}, Format({Dense}));
+  Tensor<double> y("y", {8}, Format({Dense}));
+  Tensor<double> B("B", {8, 8}, CSR);
+  IndexVar jpos("jpos"), j0("j0"), j1("j1"), i0("i0"), i1("i1"), i10("i10"),
+           i11("i11");
+  y(i) = B(i,j) * x(j);
+  IndexStmt stmt = y.getAssignment().concretize();
+
+  // The number of positions is not known to be a multiple of the factor
+  IndexStmt posStmt = stmt.pos(j, jpos, B(i,j));
+  ASSERT_THROW(posStmt.split(jpos, j0, j1, 8, TailStrategy::RoundUp),
+               taco::TacoException);
+  posStmt.split(jpos, j0, j1, 8, TailStrategy::Peel);
+
+  // The inner variable of a split iterates over the factor of that split
+  IndexStmt splitStmt = stmt.split(i, i0, i1, 6);
+  ASSERT_THROW(splitStmt.split(i1, i10, i11, 4, TailStrategy::RoundUp),
+               taco::TacoException);
+  splitStmt.split(i1, i10, i11, 3, TailStrategy::RoundUp);
+}
+
+TEST(scheduling, tile_error) {
+  Tensor<double> x("x", {8, 8}, Format({Dense, Dense}));
+  Tensor<double> y("y", {8, 8}, Format({Dense, Dense}));
+  IndexVar i0("i0"), i1("i1"), i2("i2"), j0("j0"), j1("j1"), j2("j2");
+  y(i,j) = x(i,j);
+
+  IndexStmt stmt = y.getAssignment().concretize();
+  ASSERT_THROW(stmt.tile({i, j}, {4}), taco::TacoException);
+  ASSERT_THROW(stmt.tile({i, j}, {4, 0}), taco::TacoException);
+  ASSERT_THROW(stmt.tile({i, j}, {{i0, i1, i2}, {j0, j1, j2}},
+                         {{4, 3}, {4, 2}}), taco::TacoException);
+  ASSERT_THROW(stmt.tile({i, j}, {{i0, i1}, {j0, j1, j2}},
+                         {{4, 2}, {4, 2}}), taco::TacoException);
+}
+
+TEST(scheduling, unroll_and_jam) {
+  Tensor<double> B("B", {35, 30}, CSR);
+  Tensor<double> C("C", {30, 21}, Format({Dense, Dense}));
+  for (int i = 0; i < 35; i++) {
+    for (int k = 0; k < 30; k++) {
+      if ((i * k) % 5 == 1 || i == k) {
+        B.insert({i, k}, (double) (i - k));
+      }
+    }
+  }
+  for (int k = 0; k < 30; k++) {
+    for (int j = 0; j < 21; j++) {
+      C.insert({k, j}, (double) (k + j));
+    }
+  }
+  B.pack();
+  C.pack();
+
+  Tensor<double> expected("expected", {35, 21}, Format({Dense, Dense}));
+  expected(i,j) = B(i,k) * C(k,j);
+  expected.evaluate();
+
+  // Blocks of four columns of A accumulate in registers over each row of B
+  IndexVar j0("j0"), j1("j1");
+  Tensor<double> A("A", {35, 21}, Format({Dense, Dense}));
+  A(i,j) = B(i,k) * C(k,j);
+  IndexStmt stmt = A.getAssignment().concretize().reorder({i, j, k})
+                    .split(j, j0, j1, 4).unroll(j1, 4);
+  A.compile(stmt);
+  A.assemble();
+  A.compute();
+  ASSERT_TENSOR_EQ(expected, A);
+  ASSERT_EQ(std::string::npos, A.getSource().find("#pragma unroll"));
+
+  // Rows of C are accumulated into each row of A four at a time, followed by
+  // the remaining rows
+  Tensor<double> D("D", {35, 21}, Format({Dense, Dense}));
+  D(i,j) = B(i,k) * C(k,j);
+  stmt = D.getAssignment().concretize().unroll(k, 4);
+  D.compile(stmt);
+  D.assemble();
+  D.compute();
+  ASSERT_TENSOR_EQ(expected, D);
+  ASSERT_NE(std::string::npos, D.getSource().find("+= 4"));
+}
+
 TEST(scheduling_eval_test, spmv_fuse) {
   if (!should_use_CUDA_codegen()) return;
   int NUM_I = 1021/10;
@@ -0,0 +1,199 @@
+#include "test.h"
+#include "test_tensors.h"
+
+#include <limits>
+
+#include "taco/tensor.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/semiring.h"
+
+using namespace taco;
+
+namespace semiring_tests {
+
+static const double inf = std::numeric_limits<double>::infinity();
+
+// Weighted graph with the edges
+//   0 -> 1 (4), 0 -> 2 (1), 2 -> 1 (2), 1 -> 3 (5), 2 -> 3 (8), 3 -> 4 (3)
+static Tensor<double> makeGraph(Format format) {
+  Tensor<double> A("A", {5, 5}, format);
+  A.insert({0, 1}, 4.0);
+  A.insert({0, 2}, 1.0);
+  A.insert({2, 1}, 2.0);
+  A.insert({1, 3}, 5.0);
+  A.insert({2, 3}, 8.0);
+  A.insert({3, 4}, 3.0);
+  A.pack();
+  return A;
+}
+
+// Relaxes the edges of A once from the distances d, which sparse vectors
+// store only if they are not the semiring zero
+static std::vector<double> relax(Semiring semiring, Tensor<double> A,
+                                 const std::vector<double>& d,
+                                 Format format=Format({Dense})) {
+  Tensor<double> x("x", {5}, format);
+  double zero = ir::to<ir::Literal>(semiring.getZero(Float64))
+                    ->getValue<double>();
+  for (int i = 0; i < 5; i++) {
+    if (d[i] != zero || format == Format({Dense})) {
+      x.insert({i}, d[i]);
+    }
+  }
+  x.pack();
+  IndexVar i("i"), j("j");
+  Tensor<double> y("y", {5}, Format({Dense}));
+  y(j) = semiring.reduce(i, semiring.multiply(x(i), A(i,j)));
+  y.evaluate();
+  std::vector<double> result(5);
+  for (int j = 0; j < 5; j++) {
+    result[j] = y.at({j});
+  }
+  return result;
+}
+
+TEST(semiring, identities) {
+  ASSERT_EQ(Semiring(), plusTimes());
+  ASSERT_NE(minPlus(), maxPlus());
+  ASSERT_TRUE(ir::to<ir::Literal>(minPlus().getZero(Float64))->getValue<double>()
+              == inf);
+  ASSERT_EQ(0.0, ir::to<ir::Literal>(minPlus().getOne(Float64))
+                     ->getValue<double>());
+  ASSERT_EQ(std::numeric_limits<int32_t>::lowest(),
+            ir::to<ir::Literal>(maxMin().getZero(Int32))->getValue<int32_t>());
+  ASSERT_FALSE(ir::to<ir::Literal>(orAnd().getZero(type<bool>()))->getValue<bool>());
+  ASSERT_TRUE(ir::to<ir::Literal>(orAnd().getOne(type<bool>()))->getValue<bool>());
+  ASSERT_EQ("(min, +)", util::toString(minPlus()));
+}
+
+TEST(semiring, print) {
+  Tensor<double> A("A", {5, 5}, CSR);
+  Tensor<double> x("x", {5}, Format({Dense}));
+  Tensor<double> y("y", {5}, Format({Dense}));
+  IndexVar i("i"), j("j");
+  Semiring s = minPlus();
+  ASSERT_EQ("y(j) = reduction(min)(i, semiring_plus(x(i), A(i,j)))",
+            util::toString(Assignment(y(j), s.reduce(i, s.multiply(x(i),
+                                                                   A(i,j))))));
+  ASSERT_EQ("y(j) min= semiring_plus(x(i), A(i,j))",
+            util::toString(Assignment(y(j), s.multiply(x(i), A(i,j)),
+                                      s.getAddOperator())));
+}
+
+TEST(semiring, shortest_paths) {
+  // Bellman-Ford from vertex 0, relaxing edges until the distances converge
+  std::vector<double> d = {0.0, inf, inf, inf, inf};
+  for (int iteration = 0; iteration < 4; iteration++) {
+    std::vector<double> relaxed = relax(minPlus(), makeGraph(CSR), d);
+    for (int v = 0; v < 5; v++) {
+      d[v] = std::min(d[v], relaxed[v]);
+    }
+  }
+  ASSERT_EQ(std::vector<double>({0.0, 3.0, 1.0, 8.0, 11.0}), d);
+
+  // Column-major graphs reduce each destination into a scalar instead
+  std::vector<double> d0 = {0.0, 3.0, 1.0, inf, inf};
+  std::vector<double> expected = {inf, 3.0, 1.0, 8.0, inf};
+  ASSERT_EQ(expected, relax(minPlus(), makeGraph(CSR), d0));
+  ASSERT_EQ(expected, relax(minPlus(), makeGraph(CSC), d0));
+  ASSERT_EQ(expected, relax(minPlus(), makeGraph(CSR), d0,
+                            Format({Sparse})));
+}
+
+TEST(semiring, widest_paths) {
+  // The widest path of one or two edges from vertex 0
+  std::vector<double> w = {inf, -inf, -inf, -inf, -inf};
+  std::vector<double> oneEdge = relax(maxMin(), makeGraph(CSR), w);
+  ASSERT_EQ(std::vector<double>({-inf, 4.0, 1.0, -inf, -inf}), oneEdge);
+  ASSERT_EQ(std::vector<double>({-inf, 1.0, -inf, 4.0, -inf}),
+            relax(maxMin(), makeGraph(CSC), oneEdge));
+  ASSERT_EQ(std::vector<double>({-inf, 1.0, -inf, 4.0, -inf}),
+            relax(maxMin(), makeGraph(CSR), oneEdge, Format({Sparse})));
+
+  // Longest paths of one edge
+  ASSERT_EQ(std::vector<double>({-inf, 4.0, 1.0, 8.0, 3.0}),
+            relax(maxPlus(), makeGraph(CSR), {0.0, -2.0, 0.0, 0.0, inf}));
+}
+
+TEST(semiring, reachability) {
+  // Breadth-first search from vertex 0 over boolean frontiers
+  Tensor<bool> A("A", {5, 5}, CSR);
+  A.insert({0, 1}, true);
+  A.insert({1, 2}, true);
+  A.insert({1, 3}, true);
+  A.insert({3, 4}, true);
+  A.pack();
+  Tensor<bool> frontier("frontier", {5}, Format({Sparse}));
+  frontier.insert({0}, true);
+  frontier.pack();
+
+  Semiring s = orAnd();
+  IndexVar i("i"), j("j");
+  std::vector<int> levels = {0, -1, -1, -1, -1};
+  for (int level = 1; level < 4; level++) {
+    Tensor<bool> next("next", {5}, Format({Dense}));
+    next(j) = s.reduce(i, s.multiply(frontier(i), A(i,j)));
+    next.evaluate();
+    ASSERT_NE(std::string::npos, next.getSource().find("||"));
+    Tensor<bool> unvisited("frontier", {5}, Format({Sparse}));
+    for (int v = 0; v < 5; v++) {
+      if (next.at({v}) && levels[v] < 0) {
+        levels[v] = level;
+        unvisited.insert({v}, true);
+      }
+    }
+    unvisited.pack();
+    frontier = unvisited;
+  }
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 2, 3}), levels);
+}
+
+TEST(semiring, annihilator) {
+  // Products are only computed where both operands are stored, so the sparse
+  // result stores their intersection
+  Tensor<double> a("a", {8}, Format({Sparse}));
+  Tensor<double> b("b", {8}, Format({Sparse}));
+  a.insert({1}, 1.0);
+  a.insert({3}, 2.0);
+  a.insert({6}, 3.0);
+  b.insert({3}, 4.0);
+  b.insert({5}, 5.0);
+  b.insert({6}, 6.0);
+  a.pack();
+  b.pack();
+  IndexVar i("i");
+  Tensor<double> c("c", {8}, Format({Sparse}));
+  c(i) = minPlus().multiply(a(i), b(i));
+  c.evaluate();
+  ASSERT_EQ(2u, c.getStorage().getValues().getSize());
+  ASSERT_EQ(6.0, c.at({3}));
+  ASSERT_EQ(9.0, c.at({6}));
+}
+
+TEST(semiring, matrix_product) {
+  // All-pairs shortest paths of at most two hops through B and then C
+  Tensor<double> B("B", {3, 3}, CSR);
+  Tensor<double> C("C", {3, 3}, Format({Dense, Dense}));
+  B.insert({0, 0}, 2.0);
+  B.insert({0, 2}, 1.0);
+  B.insert({2, 1}, 4.0);
+  B.pack();
+  for (int k = 0; k < 3; k++) {
+    for (int j = 0; j < 3; j++) {
+      C.insert({k, j}, (double)(3 * k + j));
+    }
+  }
+  C.pack();
+  IndexVar i("i"), j("j"), k("k");
+  Semiring s = minPlus();
+  Tensor<double> A("A", {3, 3}, Format({Dense, Dense}));
+  A(i,j) = s.reduce(k, s.multiply(B(i,k), C(k,j)));
+  A.evaluate();
+  ASSERT_NE(std::string::npos, A.getSource().find("INFINITY"));
+  ASSERT_EQ(2.0, A.at({0, 0}));
+  ASSERT_EQ(4.0, A.at({0, 2}));
+  ASSERT_EQ(inf, A.at({1, 1}));
+  ASSERT_EQ(7.0, A.at({2, 0}));
+}
+
+}
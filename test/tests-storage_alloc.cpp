@@ -115,4 +115,78 @@ INSTANTIATE_TEST_CASE_P(vector_add, alloc,
     )
 );
 
+
+static Tensor<double> presizeOperand(const std::string& name, int n,
+                                     Format format, int seed) {
+  Tensor<double> tensor(name, {n,n}, format);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      if ((i * 7 + j * 3 + seed) % 5 == 0) {
+        tensor.insert({i,j}, (double)(i + j + seed));
+      }
+    }
+  }
+  tensor.pack();
+  return tensor;
+}
+
+TEST(alloc, presize_result) {
+  Tensor<double> B = presizeOperand("presizeB", 40, CSR, 0);
+  Tensor<double> C = presizeOperand("presizeC", 40, CSR, 1);
+
+  for (bool assembleWhileCompute : {false, true}) {
+    Tensor<double> expectedSum("expectedSum", {40,40}, CSR);
+    expectedSum(i,j) = B(i,j) + C(i,j);
+    expectedSum.evaluate();
+    Tensor<double> expectedProduct("expectedProduct", {40,40}, CSR);
+    expectedProduct(i,j) = B(i,k) * C(k,j);
+    expectedProduct.evaluate();
+
+    Tensor<double> sum("sum", {40,40}, CSR);
+    sum(i,j) = B(i,j) + C(i,j);
+    sum.setPresizeResult(true);
+    sum.setAssembleWhileCompute(assembleWhileCompute);
+    sum.evaluate();
+    ASSERT_TRUE(sum.isResultPresized());
+    ASSERT_NE(std::string::npos, sum.getSource().find("sum_capacity_hint"));
+    ASSERT_TENSOR_EQ(expectedSum, sum);
+
+    // The bound of a matrix product is loose, so the arrays grow from the
+    // clamped bound
+    Tensor<double> product("product", {40,40}, CSR);
+    product(i,j) = B(i,k) * C(k,j);
+    product.setAllocSize(1);
+    product.setPresizeResult(true);
+    product.setAssembleWhileCompute(assembleWhileCompute);
+    product.evaluate();
+    ASSERT_TENSOR_EQ(expectedProduct, product);
+
+    // Capacity hints that are too small also grow
+    Tensor<double> hinted("hinted", {40,40}, CSR);
+    hinted(i,j) = B(i,k) * C(k,j);
+    hinted.setCapacityHint(1);
+    hinted.setAssembleWhileCompute(assembleWhileCompute);
+    hinted.evaluate();
+    ASSERT_TRUE(hinted.isResultPresized());
+    ASSERT_EQ(1u, hinted.getCapacityHint());
+    ASSERT_TENSOR_EQ(expectedProduct, hinted);
+  }
+}
+
+TEST(alloc, presize_coo_result) {
+  Tensor<double> B = presizeOperand("presizeCooB", 30, COO(2), 2);
+  Tensor<double> C = presizeOperand("presizeCooC", 30, COO(2), 3);
+
+  Tensor<double> expected("expected", {30,30}, COO(2));
+  expected(i,j) = B(i,j) * C(i,j);
+  expected.evaluate();
+
+  Tensor<double> A("A", {30,30}, COO(2));
+  A(i,j) = B(i,j) * C(i,j);
+  A.setPresizeResult(true);
+  A.setAssembleWhileCompute(true);
+  A.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
+
 }
@@ -5,6 +5,7 @@
 
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "taco/util/collections.h"
 
@@ -494,3 +495,174 @@ TEST(tensor, cache) {
   // ability to answer a request for the first query.
   c(i, j) = a(i, j); c.evaluate();
 }
+
+TEST(tensor, frozen_index) {
+  IndexVar i("i"), j("j");
+  Tensor<double> B("B", {4,4}, CSR);
+  Tensor<double> C("C", {4,4}, CSR);
+  B.insert({0,1}, 1.0);
+  B.insert({2,2}, 2.0);
+  C.insert({0,1}, 3.0);
+  C.insert({3,0}, 4.0);
+
+  Tensor<double> A("A", {4,4}, CSR);
+  A.setAssembleWhileCompute(true);
+  A.freezeIndex();
+  ASSERT_TRUE(A.isIndexFrozen());
+  A(i,j) = B(i,j) + C(i,j);
+  A.evaluate();
+
+  Tensor<double> expected("expected", {4,4}, CSR);
+  expected.insert({0,1}, 4.0);
+  expected.insert({2,2}, 2.0);
+  expected.insert({3,0}, 4.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+
+  // Changing values of operands reuses the index and value array of A
+  const void* crd = A.getStorage().getIndex().getModeIndex(1)
+                     .getIndexArray(1).getData();
+  const void* vals = A.getStorage().getValues().getData();
+  B.insert({0,1}, 1.0);
+  B.pack();
+  A(i,j) = B(i,j) + C(i,j);
+  A.evaluate();
+  ASSERT_EQ(crd, A.getStorage().getIndex().getModeIndex(1)
+                  .getIndexArray(1).getData());
+  ASSERT_EQ(vals, A.getStorage().getValues().getData());
+
+  expected.insert({0,1}, 1.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+
+  // Changing the structure of an operand rebuilds the index
+  C.insert({1,3}, 5.0);
+  C.pack();
+  A(i,j) = B(i,j) + C(i,j);
+  A.evaluate();
+  ASSERT_EQ(4u, A.getStorage().getValues().getSize());
+
+  expected.insert({1,3}, 5.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+
+  // Assigning a different expression rebuilds the index
+  A(i,j) = B(i,j) * C(i,j);
+  A.evaluate();
+  ASSERT_EQ(1u, A.getStorage().getValues().getSize());
+
+  A.unfreezeIndex();
+  ASSERT_FALSE(A.isIndexFrozen());
+}
+
+TEST(tensor, kernel_fusion) {
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> B("B", {4,3}, Format({Dense,Dense}));
+  Tensor<double> C("C", {3,4}, Format({Dense,Dense}));
+  Tensor<double> D("D", {4,4}, CSR);
+  Tensor<double> x("x", {4}, Format({Dense}));
+  for (int m = 0; m < 4; m++) {
+    for (int n = 0; n < 3; n++) {
+      B.insert({m,n}, (double)(m + n));
+      C.insert({n,m}, (double)(m * n + 1));
+    }
+    x.insert({m}, (double)(m + 1));
+  }
+  D.insert({0,1}, 2.0);
+  D.insert({2,3}, 3.0);
+  D.insert({3,3}, 1.0);
+  B.pack();
+  C.pack();
+  D.pack();
+  x.pack();
+
+  Tensor<double> expected("expected", {4}, Format({Dense}));
+  {
+    Tensor<double> T("T", {4,4}, Format({Dense,Dense}));
+    Tensor<double> U("U", {4,4}, CSR);
+    T(i,j) = B(i,k) * C(k,j);
+    U(i,j) = T(i,j) * D(i,j);
+    expected(i) = U(i,j) * x(j);
+    expected.evaluate();
+  }
+
+  taco_set_kernel_fusion(true);
+  Tensor<double> T("T", {4,4}, Format({Dense,Dense}));
+  Tensor<double> U("U", {4,4}, CSR);
+  Tensor<double> a("a", {4}, Format({Dense}));
+  T(i,j) = B(i,k) * C(k,j);
+  U(i,j) = T(i,j) * D(i,j);
+  a(i) = U(i,j) * x(j);
+  a.evaluate();
+  taco_set_kernel_fusion(false);
+
+  // The chain is computed by one kernel that reads neither intermediate
+  ASSERT_TRUE(equals(expected, a));
+  ASSERT_EQ(std::string::npos, a.getSource().find("T_vals"));
+  ASSERT_EQ(std::string::npos, a.getSource().find("U_vals"));
+  ASSERT_TRUE(T.needsCompute());
+  ASSERT_TRUE(U.needsCompute());
+
+  // Fused intermediates are still computed when they are read
+  ASSERT_DOUBLE_EQ(2.0 * (0*1 + 1*2 + 2*3), (double)U(0,1));
+}
+
+TEST(tensor, bound_kernel) {
+  Tensor<double> B("B", {3,3}, CSR);
+  B.insert({0,0}, 1.0);
+  B.insert({0,2}, 2.0);
+  B.insert({2,1}, 3.0);
+  B.pack();
+  Tensor<double> x("x", {3}, Format({Dense}));
+  x.insert({0}, 1.0);
+  x.insert({1}, 2.0);
+  x.insert({2}, 3.0);
+  x.pack();
+
+  IndexVar i, j;
+  Tensor<double> y("y", {3}, Format({Dense}));
+  y(i) = B(i,j) * x(j);
+  BoundKernel kernel = y.bindKernel();
+  ASSERT_TRUE(kernel.defined());
+  ASSERT_TRUE(kernel.getResult() == y);
+
+  kernel();
+  ASSERT_FALSE(y.needsCompute());
+  ASSERT_DOUBLE_EQ(7.0, (double)y(0));
+  ASSERT_DOUBLE_EQ(0.0, (double)y(1));
+  ASSERT_DOUBLE_EQ(6.0, (double)y(2));
+
+  // New values written into a bound operand are read by the next call
+  double* xvals = (double*)x.getStorage().getValues().getData();
+  xvals[0] = 2.0;
+  kernel();
+  ASSERT_DOUBLE_EQ(8.0, (double)y(0));
+
+  // Rebind the vector to another tensor
+  Tensor<double> z("z", {3}, Format({Dense}));
+  z.insert({1}, 1.0);
+  z.pack();
+  kernel.bind(x, z);
+  kernel();
+  ASSERT_DOUBLE_EQ(0.0, (double)y(0));
+  ASSERT_DOUBLE_EQ(3.0, (double)y(2));
+
+  // Kernels may be called from other threads than the one that bound them
+  ((double*)z.getStorage().getValues().getData())[1] = 2.0;
+  std::thread caller([&kernel]() { kernel(); });
+  caller.join();
+  ASSERT_DOUBLE_EQ(6.0, (double)y(2));
+
+  Tensor<double> w("w", {3,3}, CSR);
+  ASSERT_THROW(kernel.bind(x, w), taco::TacoException);
+  ASSERT_THROW(kernel.bind(w, z), taco::TacoException);
+
+  // Kernels that assemble while computing assemble on every call
+  Tensor<double> A("A", {3,3}, CSR);
+  A(i,j) = B(i,j) * 2.0;
+  A.setAssembleWhileCompute(true);
+  BoundKernel scale = A.bindKernel();
+  scale();
+  ASSERT_FALSE(A.needsAssemble());
+  ASSERT_DOUBLE_EQ(6.0, (double)A(2,1));
+}
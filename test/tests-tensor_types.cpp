@@ -21,7 +21,7 @@ TYPED_TEST_P(ScalarTensorTest, types) {
 }
 REGISTER_TYPED_TEST_CASE_P(ScalarTensorTest, types);
 
-typedef ::testing::Types<int8_t, int16_t, int32_t, int64_t, long long, uint8_t, uint16_t, uint32_t, uint64_t, unsigned long long, float, double, std::complex<float>, std::complex<double>> AllTypes;
+typedef ::testing::Types<int8_t, int16_t, int32_t, int64_t, long long, uint8_t, uint16_t, uint32_t, uint64_t, unsigned long long, float16, bfloat16, float, double, std::complex<float>, std::complex<double>> AllTypes;
 INSTANTIATE_TYPED_TEST_CASE_P(tensor_types, ScalarTensorTest, AllTypes);
 
 
@@ -45,7 +45,7 @@ TYPED_TEST_P(VectorTensorTest, types) {
   ASSERT_EQ(t, a.getComponentType());
   ASSERT_EQ(1, a.getOrder());
   ASSERT_EQ(5, a.getDimension(0));
-  map<vector<int>,TypeParam> vals = {{{0}, 1.0}, {{2}, 2.0}};
+  map<vector<int>,TypeParam> vals = {{{0}, (TypeParam)1.0}, {{2}, (TypeParam)2.0}};
   for (auto& val : vals) {
     a.insert(val.first, val.second);
   }
@@ -379,6 +379,146 @@ TEST(tensor_types, int_float_promotion) {
   ASSERT_TRUE(equalsExact(a, expected));
 }
 
+TEST(tensor_types, float16_conversions) {
+  ASSERT_EQ(0x3c00, float16(1.0f).getBits());
+  ASSERT_EQ(0xc000, float16(-2.0f).getBits());
+  ASSERT_EQ(0x7bff, float16(65504.0f).getBits());
+  ASSERT_EQ(0x7c00, float16(65520.0f).getBits());
+  ASSERT_EQ(0x0001, float16(std::ldexp(1.0f, -24)).getBits());
+  ASSERT_EQ(std::ldexp(1.0f, -24), (float)float16::fromBits(0x0001));
+  ASSERT_EQ(std::ldexp(1.0f, -14), (float)float16::fromBits(0x0400));
+  ASSERT_TRUE(std::isinf((float)float16::fromBits(0xfc00)));
+  ASSERT_TRUE(std::isnan((float)float16(NAN)));
+
+  // Ties round to even
+  ASSERT_EQ(0x3c00, float16(1.0f + std::ldexp(1.0f, -11)).getBits());
+  ASSERT_EQ(0x3c02, float16(1.0f + 3 * std::ldexp(1.0f, -11)).getBits());
+
+  ASSERT_EQ(0x3f80, bfloat16(1.0f).getBits());
+  ASSERT_EQ(0x4049, bfloat16(3.140625f).getBits());
+  ASSERT_EQ(256.0f, (float)bfloat16(257.0f));
+  ASSERT_EQ(260.0f, (float)bfloat16(259.0f));
+  ASSERT_TRUE(std::isnan((float)bfloat16(NAN)));
+}
+
+TEST(tensor_types, float16_accumulate) {
+  // Sums past 2048 no longer change when rounded to half precision after
+  // every addition, so the dot product is only exact if it is accumulated in
+  // single precision
+  Tensor<float16> b("b", {4096}, Format({Dense}));
+  Tensor<float16> c("c", {4096}, Format({Dense}));
+  for (int n = 0; n < 4096; n++) {
+    b.insert({n}, float16(1.0f));
+    c.insert({n}, float16(1.0f));
+  }
+  b.pack();
+  c.pack();
+
+  Tensor<float16> a("a");
+  a = sum(i, b(i)*c(i));
+  a.evaluate();
+  ASSERT_EQ(4096.0f, (float)a.begin()->second);
+  ASSERT_NE(std::string::npos, a.getSource().find("taco_half_to_float"));
+  ASSERT_NE(std::string::npos, a.getSource().find("taco_float_to_half"));
+}
+
+TEST(tensor_types, float16_spmv) {
+  Tensor<float16> A("A", {3, 4}, CSR);
+  Tensor<float16> x("x", {4}, Format({Dense}));
+  A.insert({0, 0}, float16(0.5f));
+  A.insert({0, 3}, float16(1.25f));
+  A.insert({1, 1}, float16(-3.0f));
+  A.insert({2, 0}, float16(0.1f));
+  A.insert({2, 2}, float16(2.0f));
+  A.pack();
+  for (int n = 0; n < 4; n++) {
+    x.insert({n}, float16(1.5f + n));
+  }
+  x.pack();
+
+  Tensor<float16> y("y", {3}, Format({Dense}));
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+
+  Tensor<float16> expected("expected", {3}, Format({Dense}));
+  expected.insert({0}, float16(0.5f * 1.5f + 1.25f * 4.5f));
+  expected.insert({1}, float16(-3.0f * 2.5f));
+  expected.insert({2}, float16((float)float16(0.1f) * 1.5f + 2.0f * 3.5f));
+  expected.pack();
+  ASSERT_TRUE(equals(expected, y)) << expected << endl << y;
+}
+
+TEST(tensor_types, bfloat16_accumulate) {
+  // Brain floats only have 8 significant bits, so 256 + 1 rounds to 256
+  Tensor<bfloat16> b("b", {1024}, Format({Sparse}));
+  for (int n = 0; n < 1024; n++) {
+    b.insert({n}, bfloat16(1.0f));
+  }
+  b.pack();
+
+  Tensor<bfloat16> a("a");
+  a = sum(i, b(i));
+  a.evaluate();
+  ASSERT_EQ(1024.0f, (float)a.begin()->second);
+
+  Tensor<bfloat16> c("c", {1024}, Format({Dense}));
+  c(i) = b(i) * bfloat16(3.0f);
+  c.evaluate();
+  ASSERT_EQ(3.0f, (float)c.at({1023}));
+}
+
+TEST(tensor_types, int8_scaled_matvec) {
+  // Quantized values are widened before they are multiplied and summed, and
+  // their scale factors out of the sum
+  Tensor<int8_t> A("A", {2, 64}, Format({Dense, Dense}));
+  Tensor<int8_t> x("x", {64}, Format({Dense}));
+  for (int n = 0; n < 64; n++) {
+    A.insert({0, n}, (int8_t)100);
+    A.insert({1, n}, (int8_t)-7);
+    x.insert({n}, (int8_t)(n % 2 ? 100 : 1));
+  }
+  A.pack();
+  x.pack();
+
+  Tensor<float> scale("scale");
+  scale.insert({}, 0.5f);
+  scale.pack();
+
+  Tensor<float> y("y", {2}, Format({Dense}));
+  y(i) = scale() * sum(j, A(i,j) * x(j));
+  y.evaluate();
+  ASSERT_EQ(0.5f * 32 * (100 * 100 + 100 * 1), y.at({0}));
+  ASSERT_EQ(0.5f * 32 * (-7 * 100 + -7 * 1), y.at({1}));
+  ASSERT_NE(std::string::npos, y.getSource().find("(int32_t)"));
+}
+
+TEST(tensor_types, accumulator_type) {
+  Tensor<float16> b("b", {8}, Format({Dense}));
+  for (int n = 0; n < 8; n++) {
+    b.insert({n}, float16(0.25f * n));
+  }
+  b.pack();
+
+  taco_set_accumulator_type(Float64);
+  ASSERT_EQ(Float64, taco_get_accumulator_type());
+  Tensor<float16> a("a");
+  a = sum(i, b(i));
+  a.evaluate();
+  taco_set_accumulator_type(Datatype());
+  ASSERT_EQ(7.0f, (float)a.begin()->second);
+  ASSERT_NE(std::string::npos, a.getSource().find("double"));
+
+  // Integer accumulators do not apply to floats
+  taco_set_accumulator_type(Int64);
+  Tensor<float16> c("c");
+  c = sum(i, b(i));
+  c.evaluate();
+  taco_set_accumulator_type(Datatype());
+  ASSERT_EQ(7.0f, (float)c.begin()->second);
+
+  ASSERT_THROW(taco_set_accumulator_type(Float16), taco::TacoException);
+}
+
 TEST(DISABLED_tensor_types, coordinate_types) {
   TensorData<double> testData = TensorData<double>({5, 3, 2}, {
     {{0,0,0}, 0.0},
@@ -330,7 +330,57 @@ INSTANTIATE_TEST_CASE_P(spmm, insertTemporaries, Values(
                                    A(i,j) = w(j)),
                             forall(k,
                                    forall(j,
-                                          w(j) += B(i,k) * C(k,j))))))
+                                          w(j) += B(i,k) * C(k,j)))))),
+  NotationTest(forall(i,
+                      forall(k,
+                             forall(j,
+                                    A(i,j) += G(i,j) * B(i,k) * C(k,j)))),
+               forall(i,
+                      where(forall(j,
+                                   A(i,j) = w(j)),
+                            forall(k,
+                                   forall(j,
+                                          w(j) += G(i,j) * B(i,k) * C(k,j))))))
+));
+
+static TensorVar t("t", Type(Float64, {}));
+
+INSTANTIATE_TEST_CASE_P(inner_product, insertTemporaries, Values(
+  NotationTest(forall(i,
+                      forall(j,
+                             where(A(i,j) = t() + C(i,j),
+                                   forall(k,
+                                          t() += B(i,k) * C(k,j))))),
+               forall(i,
+                      where(forall(j,
+                                   A(i,j) = w(j)),
+                            sequence(forall(k,
+                                            forall(j,
+                                                   w(j) += B(i,k) * C(k,j))),
+                                     forall(j,
+                                            w(j) += C(i,j)))))),
+  NotationTest(forall(i,
+                      forall(j,
+                             where(A(i,j) = t() * G(i,j),
+                                   forall(k,
+                                          t() += B(i,k) * C(k,j))))),
+               forall(i,
+                      where(forall(j,
+                                   A(i,j) = w(j) * G(i,j)),
+                            forall(k,
+                                   forall(j,
+                                          w(j) += B(i,k) * C(k,j)))))),
+  // Dense operands can be located into, so the loops are left alone
+  NotationTest(forall(i,
+                      forall(j,
+                             where(A(i,j) = t(),
+                                   forall(k,
+                                          t() += G(i,k) * W(k,j))))),
+               forall(i,
+                      forall(j,
+                             where(A(i,j) = t(),
+                                   forall(k,
+                                          t() += G(i,k) * W(k,j))))))
 ));
 
 TEST(schedule, workspace_spmspm) {
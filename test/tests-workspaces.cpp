@@ -186,3 +186,135 @@ TEST(workspaces, tile_denseMatMul) {
 //  codegen->compile(compute, false);
   
 }
+
+static Tensor<double> makeSparse(std::string name, std::vector<int> dimensions,
+                                 Format format, int seed) {
+  Tensor<double> tensor(name, dimensions, format);
+  int size = 1;
+  for (int dimension : dimensions) {
+    size *= dimension;
+  }
+  for (int p = 0; p < size; p++) {
+    if ((p * 7 + seed) % 5 != 0) {
+      continue;
+    }
+    std::vector<int> coordinate(dimensions.size());
+    for (int mode = (int)dimensions.size() - 1, q = p; mode >= 0; mode--) {
+      coordinate[mode] = q % dimensions[mode];
+      q /= dimensions[mode];
+    }
+    tensor.insert(coordinate, (double)(p % 11 + seed));
+  }
+  tensor.pack();
+  return tensor;
+}
+
+static Tensor<double> makeDense(std::string name, const Tensor<double>& tensor) {
+  Tensor<double> dense(name, tensor.getDimensions(),
+                       Format(std::vector<ModeFormatPack>(tensor.getOrder(),
+                                                          taco::dense)));
+  for (auto& component : tensor) {
+    dense.insert(component.first.toVector(), component.second);
+  }
+  dense.pack();
+  return dense;
+}
+
+TEST(workspaces, auto_spmm_add) {
+  for (auto& format : {CSR, DCSR}) {
+    Tensor<double> B = makeSparse("B", {6, 7}, format, 1);
+    Tensor<double> C = makeSparse("C", {7, 5}, format, 2);
+    Tensor<double> D = makeSparse("D", {6, 5}, format, 3);
+    IndexVar i("i"), j("j"), k("k");
+
+    Tensor<double> A("A", {6, 5}, format);
+    A(i,j) = B(i,k) * C(k,j) + D(i,j);
+    A.evaluate();
+
+    Tensor<double> expected("expected", {6, 5}, Format({Dense, Dense}));
+    expected(i,j) = makeDense("Bd", B)(i,k) * makeDense("Cd", C)(k,j) +
+                    makeDense("Dd", D)(i,j);
+    expected.evaluate();
+    ASSERT_TENSOR_EQ(expected, A);
+  }
+}
+
+TEST(workspaces, auto_masked_spmm) {
+  Tensor<double> M = makeSparse("M", {6, 5}, CSR, 4);
+  Tensor<double> B = makeSparse("B", {6, 7}, CSR, 1);
+  Tensor<double> C = makeSparse("C", {7, 5}, CSR, 2);
+  IndexVar i("i"), j("j"), k("k");
+
+  Tensor<double> A("A", {6, 5}, CSR);
+  A(i,j) = M(i,j) * B(i,k) * C(k,j);
+  A.evaluate();
+
+  Tensor<double> expected("expected", {6, 5}, Format({Dense, Dense}));
+  expected(i,j) = makeDense("Md", M)(i,j) * makeDense("Bd", B)(i,k) *
+                  makeDense("Cd", C)(k,j);
+  expected.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
+
+TEST(workspaces, auto_tensor_contraction) {
+  const Format CSF({Dense, Sparse, Sparse});
+  Tensor<double> B = makeSparse("B", {4, 5, 3}, CSF, 1);
+  Tensor<double> C = makeSparse("C", {5, 3, 6}, CSF, 2);
+  IndexVar i("i"), j("j"), k("k"), l("l");
+
+  Tensor<double> A("A", {4, 6}, CSR);
+  A(i,j) = B(i,k,l) * C(k,l,j);
+  A.evaluate();
+
+  Tensor<double> expected("expected", {4, 6}, Format({Dense, Dense}));
+  expected(i,j) = makeDense("Bd", B)(i,k,l) * makeDense("Cd", C)(k,l,j);
+  expected.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
+
+TEST(workspaces, auto_csf_spmm) {
+  const Format CSF({Dense, Sparse, Sparse});
+  Tensor<double> B = makeSparse("B", {4, 5, 3}, CSF, 1);
+  Tensor<double> C = makeSparse("C", {3, 6}, CSR, 2);
+  IndexVar i("i"), j("j"), k("k"), l("l");
+
+  Tensor<double> A("A", {4, 5, 6}, CSF);
+  A(i,j,l) = B(i,j,k) * C(k,l);
+  A.evaluate();
+
+  Tensor<double> expected("expected", {4, 5, 6}, Format({Dense, Dense, Dense}));
+  expected(i,j,l) = makeDense("Bd", B)(i,j,k) * makeDense("Cd", C)(k,l);
+  expected.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
+
+TEST(workspaces, index_list_flush) {
+  // The first two rows of C interleave into a sparse result row, whose index
+  // list is radix sorted, and the last two into a dense result row, whose
+  // coordinates are collected by scanning the workspace guards
+  const int N = 100000;
+  Tensor<double> B("B", {2, 4}, CSR);
+  B.insert({0, 0}, 1.0);
+  B.insert({0, 1}, 2.0);
+  B.insert({1, 2}, 3.0);
+  B.insert({1, 3}, 4.0);
+  B.pack();
+  Tensor<double> C("C", {4, N}, CSR);
+  for (int k = 0; k < 4; k++) {
+    const int nnz = (k < 2) ? 60 : 1500;
+    for (int p = 0; p < nnz; p++) {
+      C.insert({k, (int)(((long long)p * 7919 + k * 13) % N)}, (double)(p + k));
+    }
+  }
+  C.pack();
+  IndexVar i("i"), j("j"), k("k");
+
+  Tensor<double> A("A", {2, N}, CSR);
+  A(i,j) = B(i,k) * C(k,j);
+  A.evaluate();
+
+  Tensor<double> expected("expected", {2, N}, Format({Dense, Dense}));
+  expected(i,j) = makeDense("Bd", B)(i,k) * makeDense("Cd", C)(k,j);
+  expected.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
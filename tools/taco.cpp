@@ -229,7 +229,17 @@ static void printSchedulingHelp() {
     printFlag("s=split(i, i0, i1, factor)", "Splits (strip-mines) an index "
               "variable `i` into two nested index variables `i0` and `i1`. The "
               "size of the inner index variable `i1` is then held constant at "
-              "`factor`, which must be a positive integer.");
+              "`factor`, which must be a positive integer. An optional tail "
+              "strategy sets how the iterations past the end of `i` are handled: "
+              "Guard (the default) checks each iteration, Peel checks each strip "
+              "of `factor` iterations, and RoundUp assumes that `factor` divides "
+              "the extent of `i` and checks nothing.");
+    cout << endl;
+    printFlag("s=tile(i, j, ..., si, sj, ...)", "Tiles directly nested index "
+              "variables `i`, `j`, ... by the tile sizes `si`, `sj`, ... in one "
+              "step. Each variable `i` is split into `i0` and `i1`, and the "
+              "loops are reordered to iterate over `i0, j0, ..., i1, j1, ...`. "
+              "An optional last parameter sets the tail strategy of the splits.");
     cout << endl;
     printFlag("s=precompute(expr, i, iw)", "Leverages scratchpad memories and "
               "reorders computations to increase locality.  Given a subexpression "
@@ -281,6 +291,17 @@ static void printCommandLine(ostream& os, int argc, char* argv[]) {
   }
 }
 
+static TailStrategy parseTailStrategy(string strategy) {
+  for (TailStrategy tailStrategy : {TailStrategy::Guard, TailStrategy::Peel,
+                                    TailStrategy::RoundUp}) {
+    if (strategy == TailStrategy_NAMES[(int)tailStrategy]) {
+      return tailStrategy;
+    }
+  }
+  taco_uerror << "Tail strategy " << strategy << " not defined.";
+  return TailStrategy::Guard;
+}
+
 static bool setSchedulingCommands(vector<vector<string>> scheduleCommands, parser::Parser& parser, IndexStmt& stmt) {
   auto findVar = [&stmt](string name) {
     ProvenanceGraph graph(stmt);
@@ -326,17 +347,40 @@ static bool setSchedulingCommands(vector<vector<string>> scheduleCommands, parse
       stmt = stmt.fuse(findVar(i), findVar(j), fused);
 
     } else if (command == "split") {
-      taco_uassert(scheduleCommand.size() == 4) << "'split' scheduling directive takes 4 parameters: split(i, i1, i2, splitFactor)";
+      taco_uassert(scheduleCommand.size() == 4 || scheduleCommand.size() == 5) << "'split' scheduling directive takes 4 or 5 parameters: split(i, i1, i2, splitFactor[, tailStrategy])";
       string i, i1, i2;
       size_t splitFactor;
       i  = scheduleCommand[0];
       i1 = scheduleCommand[1];
       i2 = scheduleCommand[2];
       taco_uassert(sscanf(scheduleCommand[3].c_str(), "%zu", &splitFactor) == 1) << "failed to parse fourth parameter to `split` directive as a size_t";
+      TailStrategy tailStrategy = TailStrategy::Guard;
+      if (scheduleCommand.size() == 5) {
+        tailStrategy = parseTailStrategy(scheduleCommand[4]);
+      }
 
       IndexVar split1(i1);
       IndexVar split2(i2);
-      stmt = stmt.split(findVar(i), split1, split2, splitFactor);
+      stmt = stmt.split(findVar(i), split1, split2, splitFactor, tailStrategy);
+
+    } else if (command == "tile") {
+      taco_uassert(scheduleCommand.size() > 1) << "'tile' scheduling directive needs at least 2 parameters: tile(i, ..., iSize, ...[, tailStrategy])";
+      TailStrategy tailStrategy = TailStrategy::Guard;
+      if (scheduleCommand.size() % 2 == 1) {
+        tailStrategy = parseTailStrategy(scheduleCommand.back());
+        scheduleCommand.pop_back();
+      }
+      size_t numVars = scheduleCommand.size() / 2;
+      vector<IndexVar> tiledVars;
+      vector<size_t> tileSizes;
+      for (size_t v = 0; v < numVars; v++) {
+        size_t tileSize;
+        taco_uassert(sscanf(scheduleCommand[numVars + v].c_str(), "%zu", &tileSize) == 1) << "failed to parse tile size of " << scheduleCommand[v] << " in `tile` directive as a size_t";
+        tiledVars.push_back(findVar(scheduleCommand[v]));
+        tileSizes.push_back(tileSize);
+      }
+
+      stmt = stmt.tile(tiledVars, tileSizes, tailStrategy);
 
     // } else if (command == "divide") {
     //   string i, i1, i2;